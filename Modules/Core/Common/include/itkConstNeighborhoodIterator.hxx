@@ -649,8 +649,8 @@ void ConstNeighborhoodIterator< TImage, TBoundaryCondition >
                                                           - static_cast< OffsetValueType >( radius[i] ) );
     m_InnerBoundsLow[i] = static_cast< IndexValueType >( imageBRStart[i]
                                                          + static_cast< OffsetValueType >( radius[i] ) );
-    m_WrapOffset[i]     = ( static_cast< OffsetValueType >( imageBRSize[i] )
-                            - ( m_Bound[i] - m_BeginIndex[i] ) ) * offset[i];
+    // The offset table accounts for the padding of the rows, if any
+    m_WrapOffset[i]     = offset[i + 1] - ( m_Bound[i] - m_BeginIndex[i] ) * offset[i];
     }
   m_WrapOffset[Dimension - 1] = 0; // last offset is zero because there are no
                                    // higher dimensions
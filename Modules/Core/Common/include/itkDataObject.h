@@ -453,6 +453,14 @@ public:
    * need regions (for instance itk::EquivalencyTable). */
   virtual bool VerifyRequestedRegion() { return true; }
 
+  /** Estimate the number of bytes needed to buffer the RequestedRegion,
+   * or taken by the BufferedRegion. These are used to estimate the
+   * memory used by a pipeline before updating it, see
+   * StreamingImageFilter::SetMemoryBudget(). Default implementation
+   * returns 0 for DataObjects that do not support Regions. */
+  virtual SizeValueType GetRequestedRegionSizeInBytes() const { return 0; }
+  virtual SizeValueType GetBufferedRegionSizeInBytes() const { return 0; }
+
   /** Copy information from the specified data set.  This method is
    * part of the pipeline execution model. By default, a ProcessObject
    * will copy meta-data from the first input to all of its
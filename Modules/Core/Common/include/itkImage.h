@@ -175,6 +175,16 @@ public:
    * memory. */
   virtual void Initialize();
 
+  /** Set how the pages of the pixel container allocated by the next
+   * call to Allocate() are placed on the memory nodes.
+   * \sa MemoryPlacement */
+  virtual void SetMemoryPlacement(MemoryPlacement::PlacementType placement);
+
+  /** Touch the pages of the pixel container holding the pixels of the
+   * given region, without modifying them.
+   * \sa MemoryPlacement */
+  virtual void TouchBufferPages(const RegionType & region);
+
   /** Fill the image buffer with a value.  Be sure to call Allocate()
    * first. */
   void FillBuffer(const TPixel & value);
@@ -272,6 +282,9 @@ public:
 
   virtual unsigned int GetNumberOfComponentsPerPixel() const;
 
+  virtual SizeValueType GetPixelSizeInBytes() const
+  { return sizeof( TPixel ); }
+
 protected:
   Image();
   void PrintSelf(std::ostream & os, Indent indent) const;
@@ -52,12 +52,29 @@ Image< TPixel, VImageDimension >
 {
   SizeValueType num;
 
-  this->ComputeOffsetTable();
+  this->ComputeBufferRowPadding( sizeof( TPixel ) );
   num = static_cast<SizeValueType>(this->GetOffsetTable()[VImageDimension]);
 
+  m_Buffer->SetAlignment( this->GetBufferAlignment() );
   m_Buffer->Reserve(num);
 }
 
+template< typename TPixel, unsigned int VImageDimension >
+void
+Image< TPixel, VImageDimension >
+::SetMemoryPlacement(MemoryPlacement::PlacementType placement)
+{
+  m_Buffer->SetMemoryPlacement(placement);
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+void
+Image< TPixel, VImageDimension >
+::TouchBufferPages(const RegionType & region)
+{
+  this->TouchRegionPages( m_Buffer->GetBufferPointer(), sizeof( TPixel ), region );
+}
+
 template< typename TPixel, unsigned int VImageDimension >
 void
 Image< TPixel, VImageDimension >
@@ -82,8 +99,9 @@ void
 Image< TPixel, VImageDimension >
 ::FillBuffer(const TPixel & value)
 {
+  // Includes the padding of the rows, if any
   const SizeValueType numberOfPixels =
-    this->GetBufferedRegion().GetNumberOfPixels();
+    static_cast< SizeValueType >( this->GetOffsetTable()[VImageDimension] );
 
   std::fill_n( &( *m_Buffer )[0], numberOfPixels, value );
 
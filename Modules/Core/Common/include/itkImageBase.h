@@ -37,6 +37,7 @@
 #include "itkFixedArray.h"
 #include "itkImageHelper.h"
 #include "itkFloatTypes.h"
+#include "itkMemoryPlacement.h"
 
 //HACK:  vnl/vnl_matrix_fixed.txx is needed here?
 //      to avoid undefined symbol vnl_matrix_fixed<double, 8u, 8u>::set_identity()", referenced from
@@ -235,6 +236,44 @@ public:
    */
   virtual void Allocate() {}
 
+  /** Set how the pages of the buffer allocated by the next call to
+   * Allocate() are placed on the memory nodes. Images without a pixel
+   * buffer ignore it.
+   * \sa MemoryPlacement */
+  virtual void SetMemoryPlacement(MemoryPlacement::PlacementType) {}
+
+  /** Touch, from the calling thread and without modifying them, the
+   * pages of the buffer holding the pixels of the given region. Used by
+   * ImageSource to place the pages of its outputs on the memory nodes of
+   * the threads generating them. Images without a pixel buffer ignore
+   * it.
+   * \sa MemoryPlacement */
+  virtual void TouchBufferPages(const RegionType &) {}
+
+  /** Set/Get the alignment, in bytes, of the address of the buffer
+   * allocated by Allocate(). It must be zero or a power of two; 64
+   * matches the cache lines and the widest vector registers. Zero, the
+   * default, keeps the alignment of new[]. Images without a pixel buffer
+   * ignore it. */
+  itkSetMacro(BufferAlignment, SizeValueType);
+  itkGetConstMacro(BufferAlignment, SizeValueType);
+
+  /** Set/Get whether Allocate() pads the rows of the buffer, so that
+   * every row starts on a BufferAlignment boundary. The pixels of a row
+   * are still contiguous, but consecutive rows are GetBufferRowStride()
+   * pixels apart instead of the size of the buffered region along the
+   * first dimension. Off by default. Code which walks
+   * GetBufferPointer() as a contiguous array of pixels, instead of using
+   * the offset table or the iterators, must not be given padded
+   * images. */
+  itkSetMacro(PadBufferRows, bool);
+  itkGetConstMacro(PadBufferRows, bool);
+  itkBooleanMacro(PadBufferRows);
+
+  /** Get the distance, in pixels, between the starts of consecutive rows
+   * of the buffer. This is GetOffsetTable()[1]. */
+  OffsetValueType GetBufferRowStride() const { return m_OffsetTable[1]; }
+
   /** Set the region object that defines the size and starting index
    * for the largest possible region this image could represent.  This
    * is used in determining how much memory would be needed to load an
@@ -312,7 +351,8 @@ public:
    * etc..  This table if of size [VImageDimension+1], because its
    * values are computed progressively as: {1, N1, N1*N2,
    * N1*N2*N3,...,(N1*...*Nn)} Where the values {N1,...,Nn} are the
-   * elements of the BufferedRegion::Size array.  The last element of
+   * elements of the BufferedRegion::Size array, N1 being rounded up
+   * when the rows of the buffer are padded.  The last element of
    * the OffsetTable is equivalent to the BufferSize.  Having a
    * [VImageDimension+1] size array, simplifies the implementation of
    * some data accessing algorithms. The entries in the offset table
@@ -647,6 +687,17 @@ public:
    * region is not within the LargestPossibleRegion. */
   virtual bool VerifyRequestedRegion() ITK_OVERRIDE;
 
+  /** Number of pixels of the RequestedRegion, or of the BufferedRegion,
+   * times GetPixelSizeInBytes(). */
+  virtual SizeValueType GetRequestedRegionSizeInBytes() const ITK_OVERRIDE
+  {
+    return static_cast< SizeValueType >( m_RequestedRegion.GetNumberOfPixels() ) * this->GetPixelSizeInBytes();
+  }
+  virtual SizeValueType GetBufferedRegionSizeInBytes() const ITK_OVERRIDE
+  {
+    return static_cast< SizeValueType >( m_BufferedRegion.GetNumberOfPixels() ) * this->GetPixelSizeInBytes();
+  }
+
   /** INTERNAL This method is used internally by filters to copy meta-data from
    * the output to the input. Users should not have a need to use this method.
    *
@@ -668,6 +719,12 @@ public:
   virtual unsigned int GetNumberOfComponentsPerPixel() const;
   virtual void SetNumberOfComponentsPerPixel(unsigned int);
 
+  /** Get the number of bytes taken by one pixel in the buffer of the
+   * image, to estimate the memory needed to buffer a region before
+   * allocating it. The ImageBase implementation returns 0, which stands
+   * for images, like adaptors, that do not own a pixel buffer. */
+  virtual SizeValueType GetPixelSizeInBytes() const { return 0; }
+
 protected:
   ImageBase();
   ~ImageBase();
@@ -679,6 +736,11 @@ protected:
    * the BufferedRegion is set. */
   void ComputeOffsetTable();
 
+  /** Set up the padding of the rows of the buffer for pixels of
+   * pixelSize bytes, according to BufferAlignment and PadBufferRows, and
+   * compute the offset table. Called by Allocate(). */
+  void ComputeBufferRowPadding(SizeValueType pixelSize);
+
   /** Compute helper matrices used to transform Index coordinates to
    * PhysicalPoint coordinates and back. This method is virtual and will be
    * overloaded in derived classes in order to provide backward compatibility
@@ -706,6 +768,11 @@ protected:
    * \sa  ReleaseData, Initialize, SetBufferedRegion */
   virtual void InitializeBufferedRegion(void);
 
+  /** Touch the pages holding the pixels of region in a buffer laid out
+   * as the buffered region, with pixels of pixelSize bytes. Used to
+   * implement TouchBufferPages(). */
+  void TouchRegionPages(void *buffer, SizeValueType pixelSize, const RegionType & region) const;
+
 private:
   ImageBase(const Self &);      //purposely not implemented
   void operator=(const Self &); //purposely not implemented
@@ -727,6 +794,13 @@ private:
 
   OffsetValueType m_OffsetTable[VImageDimension + 1];
 
+  SizeValueType m_BufferAlignment;
+  bool          m_PadBufferRows;
+
+  /** The length of the rows of the buffer is rounded up to a multiple of
+   * this number of pixels. */
+  SizeValueType m_BufferRowLengthMultiple;
+
   RegionType m_LargestPossibleRegion;
   RegionType m_RequestedRegion;
   RegionType m_BufferedRegion;
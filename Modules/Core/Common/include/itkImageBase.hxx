@@ -45,6 +45,9 @@ ImageBase< VImageDimension >
 ::ImageBase()
 {
   memset(m_OffsetTable, 0, sizeof(m_OffsetTable));
+  m_BufferAlignment = 0;
+  m_PadBufferRows = false;
+  m_BufferRowLengthMultiple = 1;
   m_Spacing.Fill(1.0);
   m_Origin.Fill(0.0);
   m_Direction.SetIdentity();
@@ -71,8 +74,10 @@ ImageBase< VImageDimension >
   // Call the superclass which should initialize the BufferedRegion ivar.
   Superclass::Initialize();
 
-  // Clear the offset table
+  // Clear the offset table. The layout of the next buffer is set up
+  // when it is allocated.
   memset(m_OffsetTable, 0, sizeof(m_OffsetTable));
+  m_BufferRowLengthMultiple = 1;
 
   // Clear the BufferedRegion ivar
   this->InitializeBufferedRegion();
@@ -211,7 +216,15 @@ ImageBase< VImageDimension >
   m_OffsetTable[0] = num;
   for ( unsigned int i = 0; i < VImageDimension; i++ )
     {
-    num *= bufferSize[i];
+    if ( i == 0 )
+      {
+      num *= ( ( bufferSize[0] + m_BufferRowLengthMultiple - 1 ) / m_BufferRowLengthMultiple )
+             * m_BufferRowLengthMultiple;
+      }
+    else
+      {
+      num *= bufferSize[i];
+      }
     // m_OffsetTable[i+1] = (OffsetValueType)num;
     m_OffsetTable[i + 1] = num;
     }
@@ -223,6 +236,29 @@ ImageBase< VImageDimension >
   //   }
 }
 
+//----------------------------------------------------------------------------
+template< unsigned int VImageDimension >
+void
+ImageBase< VImageDimension >
+::ComputeBufferRowPadding(SizeValueType pixelSize)
+{
+  m_BufferRowLengthMultiple = 1;
+  if ( m_PadBufferRows && m_BufferAlignment > 0 && pixelSize > 0 )
+    {
+    // Smallest number of pixels spanning a multiple of the alignment
+    SizeValueType a = m_BufferAlignment;
+    SizeValueType b = pixelSize;
+    while ( b != 0 )
+      {
+      const SizeValueType r = a % b;
+      a = b;
+      b = r;
+      }
+    m_BufferRowLengthMultiple = m_BufferAlignment / a;
+    }
+  this->ComputeOffsetTable();
+}
+
 //----------------------------------------------------------------------------
 template< unsigned int VImageDimension >
 void
@@ -360,9 +396,11 @@ ImageBase< VImageDimension >
   // Copy the meta-information
   this->CopyInformation(image);
 
-  // Copy the remaining region information. Subclasses are
-  // responsible for copying the pixel container.
+  // Copy the remaining region information and the layout of the
+  // buffer. Subclasses are responsible for copying the pixel container.
+  m_BufferRowLengthMultiple = image->m_BufferRowLengthMultiple;
   this->SetBufferedRegion( image->GetBufferedRegion() );
+  this->ComputeOffsetTable();
   this->SetRequestedRegion( image->GetRequestedRegion() );
 }
 
@@ -455,6 +493,43 @@ ImageBase< VImageDimension >
   this->ComputeOffsetTable();
 }
 
+//----------------------------------------------------------------------------
+template< unsigned int VImageDimension >
+void
+ImageBase< VImageDimension >
+::TouchRegionPages(void *buffer, SizeValueType pixelSize, const RegionType & region) const
+{
+  RegionType touchedRegion = region;
+  if ( buffer == ITK_NULLPTR || !touchedRegion.Crop(m_BufferedRegion) )
+    {
+    return;
+    }
+  const SizeValueType numberOfPixels = touchedRegion.GetNumberOfPixels();
+  if ( numberOfPixels == 0 )
+    {
+    return;
+    }
+
+  // Touch each line along the first dimension, which is contiguous
+  const SizeValueType lineLength = touchedRegion.GetSize(0);
+  const SizeValueType numberOfLines = numberOfPixels / lineLength;
+  IndexType           index = touchedRegion.GetIndex();
+  char *              bytes = static_cast< char * >( buffer );
+  for ( SizeValueType line = 0; line < numberOfLines; ++line )
+    {
+    MemoryPlacement::TouchPages(bytes + this->ComputeOffset(index) * pixelSize, lineLength * pixelSize);
+    for ( unsigned int d = 1; d < VImageDimension; ++d )
+      {
+      ++index[d];
+      if ( static_cast< SizeValueType >( index[d] - touchedRegion.GetIndex(d) ) < touchedRegion.GetSize(d) )
+        {
+        break;
+        }
+      index[d] = touchedRegion.GetIndex(d);
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 template< unsigned int VImageDimension >
 void
@@ -533,6 +608,10 @@ ImageBase< VImageDimension >
   os << indent << "RequestedRegion: " << std::endl;
   this->GetRequestedRegion().PrintSelf( os, indent.GetNextIndent() );
 
+  os << indent << "BufferAlignment: " << m_BufferAlignment << std::endl;
+  os << indent << "PadBufferRows: " << ( m_PadBufferRows ? "On" : "Off" ) << std::endl;
+  os << indent << "BufferRowStride: " << this->GetBufferRowStride() << std::endl;
+
   os << indent << "Spacing: " << this->GetSpacing() << std::endl;
 
   os << indent << "Origin: " << this->GetOrigin() << std::endl; \
@@ -0,0 +1,87 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageBufferAllocator_h
+#define __itkImageBufferAllocator_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+
+namespace itk
+{
+/** \class ImageBufferAllocator
+ * \brief Abstract interface to the memory used by image buffers.
+ *
+ * ImportImageContainer, and thus Image and VectorImage, obtain the
+ * memory of their buffers from an ImageBufferAllocator when one is set,
+ * instead of using new[]. The memory is returned to the allocator,
+ * with the same number of bytes, when the buffer is released.
+ *
+ * The allocator used by the pixel containers created from now on is set
+ * with SetGlobalDefaultAllocator(). It is NULL by default.
+ *
+ * Implementations must be thread safe, since buffers are allocated and
+ * released from any thread.
+ *
+ * \sa ImageBufferPool
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ImageBufferAllocator:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ImageBufferAllocator       Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageBufferAllocator, Object);
+
+  /** Return a block of at least numberOfBytes bytes, aligned on 64
+   * bytes, or NULL when the memory is not available. Buffers requesting
+   * a larger alignment with ImportImageContainer::SetAlignment() are not
+   * obtained from the allocator. */
+  virtual void * Allocate(SizeValueType numberOfBytes) = 0;
+
+  /** Return a block obtained from Allocate() with the same number of
+   * bytes. */
+  virtual void Deallocate(void *buffer, SizeValueType numberOfBytes) = 0;
+
+  /** Set/Get the allocator used by newly created pixel containers. */
+  static void SetGlobalDefaultAllocator(Self *allocator);
+  static Pointer GetGlobalDefaultAllocator();
+
+  /** Allocate a block of numberOfBytes bytes whose address is a multiple
+   * of alignment, which must be a power of two. Returns NULL when the
+   * memory is not available. */
+  static void * AllocateAligned(SizeValueType numberOfBytes, SizeValueType alignment);
+
+  /** Release a block allocated with AllocateAligned(). */
+  static void FreeAligned(void *buffer);
+
+protected:
+  ImageBufferAllocator() {}
+  virtual ~ImageBufferAllocator() {}
+
+private:
+  ImageBufferAllocator(const Self &); //purposely not implemented
+  void operator=(const Self &);       //purposely not implemented
+};
+} // end namespace itk
+
+#endif
@@ -0,0 +1,136 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageBufferPool_h
+#define __itkImageBufferPool_h
+
+#include "itkImageBufferAllocator.h"
+#include "itkSimpleFastMutexLock.h"
+
+#include <map>
+#include <vector>
+
+namespace itk
+{
+/** \class ImageBufferPool
+ * \brief Recycle the memory of released image buffers.
+ *
+ * Iterative filters and multi-resolution registration repeatedly
+ * allocate and release buffers of the same sizes. ImageBufferPool keeps
+ * released blocks and hands them back to the next allocation of the
+ * same size bucket, instead of returning them to the system.
+ *
+ * Requested sizes are rounded up to buckets: multiples of 64 bytes up
+ * to 4KB, then four buckets between consecutive powers of two, so that
+ * at most a quarter of a block is wasted. Blocks are aligned on 64
+ * bytes.
+ *
+ * The memory kept for reuse is bounded by MaximumCachedBytes; blocks
+ * released while the pool is full are returned to the system. The pool
+ * is thread safe.
+ *
+ * Statistics are kept on the number of allocations served from the pool
+ * (hits) or from the system (misses), and on the number of bytes
+ * obtained from the system, either in use or cached, and its peak.
+ *
+ * \code
+ * itk::ImageBufferPool::Pointer pool = itk::ImageBufferPool::New();
+ * pool->SetMaximumCachedBytes(512 * 1024 * 1024);
+ * itk::ImageBufferAllocator::SetGlobalDefaultAllocator(pool);
+ * \endcode
+ *
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ImageBufferPool:public ImageBufferAllocator
+{
+public:
+  /** Standard class typedefs. */
+  typedef ImageBufferPool            Self;
+  typedef ImageBufferAllocator       Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageBufferPool, ImageBufferAllocator);
+
+  virtual void * Allocate(SizeValueType numberOfBytes) ITK_OVERRIDE;
+
+  virtual void Deallocate(void *buffer, SizeValueType numberOfBytes) ITK_OVERRIDE;
+
+  /** Set/Get the maximum number of bytes kept for reuse. Lowering it
+   * releases cached blocks. Defaults to 256MB. */
+  void SetMaximumCachedBytes(SizeValueType maximumCachedBytes);
+  SizeValueType GetMaximumCachedBytes() const;
+
+  /** Return all the cached blocks to the system. */
+  void ReleaseCachedMemory();
+
+  /** Number of allocations served from the cache. */
+  SizeValueType GetNumberOfHits() const;
+
+  /** Number of allocations served from the system. */
+  SizeValueType GetNumberOfMisses() const;
+
+  /** Number of bytes of the blocks currently in use. */
+  SizeValueType GetAllocatedBytes() const;
+
+  /** Number of bytes of the blocks currently kept for reuse. */
+  SizeValueType GetCachedBytes() const;
+
+  /** Highest number of bytes obtained from the system at any time,
+   * in use or cached. */
+  SizeValueType GetPeakBytes() const;
+
+  /** Reset the hits, misses and peak. */
+  void ResetStatistics();
+
+  /** Size of the blocks used for a request of numberOfBytes. */
+  static SizeValueType GetBucketSize(SizeValueType numberOfBytes);
+
+protected:
+  ImageBufferPool();
+  virtual ~ImageBufferPool();
+
+  virtual void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+private:
+  ImageBufferPool(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  /** Release cached blocks until no more than maximumCachedBytes are
+   * kept. Must be called with the lock held. */
+  void Trim(SizeValueType maximumCachedBytes);
+
+  typedef std::vector< void * >                 BlockListType;
+  typedef std::map< SizeValueType, BlockListType > BucketMapType;
+
+  BucketMapType               m_Buckets;
+  mutable SimpleFastMutexLock m_Lock;
+
+  SizeValueType m_MaximumCachedBytes;
+  SizeValueType m_CachedBytes;
+  SizeValueType m_AllocatedBytes;
+  SizeValueType m_PeakBytes;
+  SizeValueType m_NumberOfHits;
+  SizeValueType m_NumberOfMisses;
+};
+} // end namespace itk
+
+#endif
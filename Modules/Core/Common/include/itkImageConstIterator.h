@@ -317,6 +317,13 @@ public:
   const ImageType * GetImage() const
   { return m_Image.GetPointer(); }
 
+  /** Get the distance, in pixels, between the starts of consecutive rows
+   * of the buffer of the image. It is larger than the size of the buffered
+   * region along the first dimension when the rows are padded.
+   * \sa ImageBase::SetPadBufferRows */
+  OffsetValueType GetRowStride() const
+  { return m_Image->GetOffsetTable()[1]; }
+
   /** Get the pixel value */
   PixelType Get(void) const
   { return m_PixelAccessorFunctor.Get( *( m_Buffer + m_Offset ) ); }
@@ -0,0 +1,138 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageRegionSplitterTiled_h
+#define __itkImageRegionSplitterTiled_h
+
+#include "itkImageRegionSplitterBase.h"
+#include "itkSize.h"
+#include "itkNumericTraits.h"
+
+#include <vector>
+
+namespace itk
+{
+/** \class ImageRegionSplitterTiled
+ * \brief Divide a region into cache sized tiles.
+ *
+ * ImageRegionSplitterTiled divides a region into tiles whose cross
+ * section, in all but the slowest dimension, is small enough for the
+ * data a neighborhood operator needs to keep in cache while iterating
+ * over the tile to fit into CacheSize bytes. For an iterator visiting
+ * the tile in memory order with a neighborhood of the given Radius,
+ * that working set is
+ * \f[
+ *   (2 r_{N-1} + 1) \prod_{d<N-1} (t_d + 2 r_d) \times PixelSize
+ * \f]
+ * where \f$t_d\f$ is the extent of the tile. The fastest dimension is
+ * only reduced after all the others, so that scanlines stay as long as
+ * possible.
+ *
+ * When more pieces than cache tiles are requested, the tiles are
+ * further split along the slowest dimension. When fewer are requested,
+ * adjacent tiles are merged, starting with the slowest of the cross
+ * section dimensions, so that the number of pieces does not exceed the
+ * requested number. The best locality is therefore obtained when the
+ * splitter is asked for many pieces, for instance with
+ * ImageSource::DynamicMultiThreadingOn().
+ *
+ * The default CacheSize of 256KB corresponds to a typical L2 cache.
+ *
+ * \sa ImageSource::SetImageRegionSplitter
+ * \ingroup ITKSystemObjects
+ * \ingroup DataProcessing
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ImageRegionSplitterTiled
+  :public ImageRegionSplitterBase
+{
+public:
+  /** Standard class typedefs. */
+  typedef ImageRegionSplitterTiled     Self;
+  typedef ImageRegionSplitterBase      Superclass;
+  typedef SmartPointer< Self >         Pointer;
+  typedef SmartPointer< const Self >   ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageRegionSplitterTiled, ImageRegionSplitterBase);
+
+  /** Set/Get the number of bytes the working set of a tile should fit
+   * in. Defaults to 256KB. */
+  itkSetClampMacro(CacheSize, SizeValueType, 1, NumericTraits< SizeValueType >::max());
+  itkGetConstMacro(CacheSize, SizeValueType);
+
+  /** Set/Get the size in bytes of a pixel of the processed image.
+   * Defaults to 4. */
+  itkSetClampMacro(PixelSize, SizeValueType, 1, NumericTraits< SizeValueType >::max());
+  itkGetConstMacro(PixelSize, SizeValueType);
+
+  /** Set the radius of the neighborhood visited around each pixel,
+   * either the same in all dimensions or per dimension. Defaults to
+   * 0. */
+  void SetRadius(SizeValueType radius);
+
+  template< unsigned int VDimension >
+  void SetRadius(const Size< VDimension > & radius)
+  {
+    std::vector< SizeValueType > r( radius.m_Size, radius.m_Size + VDimension );
+    if ( r != m_Radius )
+      {
+      m_Radius = r;
+      this->Modified();
+      }
+  }
+
+  /** Get the radius of dimension \c d. */
+  SizeValueType GetRadius(unsigned int d) const;
+
+protected:
+  ImageRegionSplitterTiled();
+
+  virtual unsigned int GetNumberOfSplitsInternal(unsigned int dim,
+                                                 const IndexValueType regionIndex[],
+                                                 const SizeValueType regionSize[],
+                                                 unsigned int requestedNumber) const ITK_OVERRIDE;
+
+  virtual unsigned int GetSplitInternal(unsigned int dim,
+                                        unsigned int i,
+                                        unsigned int numberOfPieces,
+                                        IndexValueType regionIndex[],
+                                        SizeValueType regionSize[]) const ITK_OVERRIDE;
+
+  virtual void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+private:
+  ImageRegionSplitterTiled(const Self &); //purposely not implemented
+  void operator=(const Self &);           //purposely not implemented
+
+  /** Compute the number of pieces each dimension is divided into, and
+   * return the total number of pieces. */
+  unsigned int ComputeSplits(unsigned int dim,
+                             unsigned int requestedNumber,
+                             const SizeValueType regionSize[],
+                             unsigned int splits[]) const;
+
+  SizeValueType                m_CacheSize;
+  SizeValueType                m_PixelSize;
+  std::vector< SizeValueType > m_Radius;
+};
+} // end namespace itk
+
+#endif
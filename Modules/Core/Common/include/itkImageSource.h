@@ -31,6 +31,8 @@
 #include "itkProcessObject.h"
 #include "itkImage.h"
 #include "itkImageRegionSplitterBase.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkThreadTimingRecorder.h"
 
 namespace itk
 {
@@ -232,6 +234,54 @@ public:
   using Superclass::MakeOutput;
   virtual ProcessObject::DataObjectPointer MakeOutput(ProcessObject::DataObjectPointerArraySizeType idx) ITK_OVERRIDE;
 
+  /** Set the image region splitter used to divide the output
+   * requested region for multi-threading. When it is not set, or set to
+   * NULL, the global default splitter, which divides the region along
+   * its slowest dimension, is used. Subclasses which override
+   * GetImageRegionSplitter() ignore this value.
+   *
+   * \sa GetImageRegionSplitter(), ImageRegionSplitterTiled */
+  itkSetConstObjectMacro(ImageRegionSplitter, ImageRegionSplitterBase);
+
+  /** Set/Get whether the default GenerateData() uses dynamic
+   * scheduling. When on, the output requested region is split into
+   * many more pieces than there are threads (see
+   * DynamicChunksPerThread), and each thread repeatedly takes the next
+   * unprocessed piece and passes it to DynamicThreadedGenerateData()
+   * until none are left. This balances the load of filters whose cost
+   * varies across the image. Only filters which provide an
+   * implementation of DynamicThreadedGenerateData() support this mode;
+   * it is off by default. */
+  itkSetMacro(DynamicMultiThreading, bool);
+  itkGetConstMacro(DynamicMultiThreading, bool);
+  itkBooleanMacro(DynamicMultiThreading);
+
+  /** Set/Get the number of pieces, per thread, the output requested
+   * region is split into when DynamicMultiThreading is on. The default
+   * is 8. */
+  itkSetClampMacro(DynamicChunksPerThread, unsigned int, 1, NumericTraits< unsigned int >::max());
+  itkGetConstMacro(DynamicChunksPerThread, unsigned int);
+
+  /** Set/Get how the pages of the outputs allocated by
+   * AllocateOutputs() are placed on the memory nodes. With
+   * FirstTouchPlacement, the pages of the output requested region are
+   * touched, before BeforeThreadedGenerateData() is called, by the
+   * threads and with the region split that GenerateData() then uses. In
+   * dynamic mode, each thread touches a fixed share of the pieces. The
+   * default is MemoryPlacement::GetGlobalDefaultPlacement() at the time
+   * the filter is created.
+   * \sa MemoryPlacement */
+  itkSetMacro(MemoryPlacement, MemoryPlacement::PlacementType);
+  itkGetConstMacro(MemoryPlacement, MemoryPlacement::PlacementType);
+
+  /** Set/Get the recorder of the work of each thread in the executions of
+   * the default GenerateData(). When it is not set, the global recorder of
+   * ThreadTimingRecorder, if any, is used, and nothing is recorded
+   * otherwise.
+   * \sa ThreadTimingRecorder */
+  itkSetObjectMacro(ThreadTimingRecorder, ThreadTimingRecorder);
+  itkGetModifiableObjectMacro(ThreadTimingRecorder, ThreadTimingRecorder);
+
 protected:
   ImageSource();
   virtual ~ImageSource() {}
@@ -279,6 +329,17 @@ protected:
   void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                             ThreadIdType threadId);
 
+  /** The entry point used instead of ThreadedGenerateData() when
+   * DynamicMultiThreading is on. It is called with each of the pieces
+   * of the output requested region, by whichever thread is free to
+   * process it, so an implementation can not rely on a thread id to
+   * index per-thread data. The same restrictions on writing outside of
+   * the given region apply.
+   *
+   * \sa SetDynamicMultiThreading() */
+  virtual
+  void DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForChunk);
+
   /** The GenerateData method normally allocates the buffers for all of the
    * outputs of a filter. Some filters may want to override this default
    * behavior. For example, a filter may have multiple outputs with
@@ -327,8 +388,9 @@ protected:
    * separated into class so that they can be easily be reused. When
    * deriving from this class to write a filter consideration to the
    * algorithm used to divide the image should be made. If a change is
-   * desired this method should be overridden to return the
-   * appropriate object.
+   * desired, either this method should be overridden to return the
+   * appropriate object, or the object should be set with
+   * SetImageRegionSplitter().
    */
   virtual const ImageRegionSplitterBase* GetImageRegionSplitter(void) const;
 
@@ -354,15 +416,59 @@ protected:
    * control to ThreadedGenerateData(). */
   static ITK_THREAD_RETURN_TYPE ThreaderCallback(void *arg);
 
+  /** Static function used as a "callback" by the MultiThreader when
+   * DynamicMultiThreading is on. Each thread claims pieces of the
+   * output requested region until all of them have been passed to
+   * DynamicThreadedGenerateData(). */
+  static ITK_THREAD_RETURN_TYPE DynamicThreaderCallback(void *arg);
+
+  /** Static function used as a "callback" by the MultiThreader to
+   * touch the pages of the outputs with FirstTouchPlacement. */
+  static ITK_THREAD_RETURN_TYPE FirstTouchThreaderCallback(void *arg);
+
+  /** Touch the pages of the outputs holding the pixels of the given
+   * region. */
+  void TouchOutputPages(const OutputImageRegionType & region);
+
   /** Internal structure used for passing image data into the threading library
     */
   struct ThreadStruct {
-    Pointer Filter;
+    Pointer                                Filter;
+    ThreadTimingRecorder *                 Recorder;
+    ThreadTimingRecorder::ExecutionRecord *Execution;
+    ThreadStruct() : Recorder(ITK_NULLPTR), Execution(ITK_NULLPTR) {}
+  };
+
+  /** Internal structure shared by the threads during a dynamically
+   * scheduled execution. */
+  struct DynamicThreadStruct {
+    Pointer                                Filter;
+    unsigned int                           NumberOfChunks;
+    unsigned int                           NextChunk;
+    SimpleFastMutexLock                    NextChunkLock;
+    ThreadTimingRecorder *                 Recorder;
+    ThreadTimingRecorder::ExecutionRecord *Execution;
+    DynamicThreadStruct() : Recorder(ITK_NULLPTR), Execution(ITK_NULLPTR) {}
+  };
+
+  /** Internal structure used to touch the pages of the outputs. */
+  struct FirstTouchThreadStruct {
+    Pointer      Filter;
+    unsigned int NumberOfPieces;
   };
 
 private:
   ImageSource(const Self &);    //purposely not implemented
   void operator=(const Self &); //purposely not implemented
+
+  bool         m_DynamicMultiThreading;
+  unsigned int m_DynamicChunksPerThread;
+
+  ImageRegionSplitterBase::ConstPointer m_ImageRegionSplitter;
+
+  MemoryPlacement::PlacementType m_MemoryPlacement;
+
+  ThreadTimingRecorder::Pointer m_ThreadTimingRecorder;
 };
 } // end namespace itk
 
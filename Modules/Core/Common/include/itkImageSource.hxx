@@ -41,7 +41,10 @@ namespace itk
  */
 template< typename TOutputImage >
 ImageSource< TOutputImage >
-::ImageSource()
+::ImageSource() :
+  m_DynamicMultiThreading(false),
+  m_DynamicChunksPerThread(8),
+  m_MemoryPlacement( MemoryPlacement::GetGlobalDefaultPlacement() )
 {
   // Create the output. We use static_cast<> here because we know the default
   // output must be of type TOutputImage
@@ -165,6 +168,10 @@ const ImageRegionSplitterBase*
 ImageSource< TOutputImage >
 ::GetImageRegionSplitter(void) const
 {
+  if ( m_ImageRegionSplitter.IsNotNull() )
+    {
+    return m_ImageRegionSplitter;
+    }
   return this->GetGlobalDefaultSplitter();
 }
 
@@ -206,6 +213,7 @@ ImageSource< TOutputImage >
     if ( outputPtr )
       {
       outputPtr->SetBufferedRegion( outputPtr->GetRequestedRegion() );
+      outputPtr->SetMemoryPlacement(m_MemoryPlacement);
       outputPtr->Allocate();
       }
     }
@@ -221,25 +229,102 @@ ImageSource< TOutputImage >
   // memory for the filter's outputs
   this->AllocateOutputs();
 
+  // Get the output pointer
+  const OutputImageType *outputPtr = this->GetOutput();
+  const ImageRegionSplitterBase * splitter = this->GetImageRegionSplitter();
+
+  if ( m_MemoryPlacement == MemoryPlacement::FirstTouchPlacement )
+    {
+    // Place the pages of the outputs on the nodes of the threads which
+    // are going to generate them, before anything else writes to them
+    FirstTouchThreadStruct str;
+    str.Filter = this;
+    unsigned int validThreads;
+    if ( m_DynamicMultiThreading )
+      {
+      str.NumberOfPieces = splitter->GetNumberOfSplits( outputPtr->GetRequestedRegion(),
+                                                        this->GetNumberOfThreads() * m_DynamicChunksPerThread );
+      validThreads = this->GetNumberOfThreads();
+      if ( str.NumberOfPieces < validThreads )
+        {
+        validThreads = str.NumberOfPieces;
+        }
+      }
+    else
+      {
+      str.NumberOfPieces = splitter->GetNumberOfSplits( outputPtr->GetRequestedRegion(), this->GetNumberOfThreads() );
+      validThreads = str.NumberOfPieces;
+      }
+
+    this->GetMultiThreader()->SetNumberOfThreads( validThreads );
+    this->GetMultiThreader()->SetSingleMethod(this->FirstTouchThreaderCallback, &str);
+    this->GetMultiThreader()->SingleMethodExecute();
+    }
+
   // Call a method that can be overridden by a subclass to perform
   // some calculations prior to splitting the main computations into
   // separate threads
   this->BeforeThreadedGenerateData();
 
-  // Set up the multithreaded processing
-  ThreadStruct str;
-  str.Filter = this;
+  ThreadTimingRecorder *recorder = m_ThreadTimingRecorder.IsNotNull() ?
+                                   m_ThreadTimingRecorder.GetPointer() : ThreadTimingRecorder::GetGlobalRecorder();
 
-  // Get the output pointer
-  const OutputImageType *outputPtr = this->GetOutput();
-  const ImageRegionSplitterBase * splitter = this->GetImageRegionSplitter();
-  const unsigned int validThreads = splitter->GetNumberOfSplits( outputPtr->GetRequestedRegion(), this->GetNumberOfThreads() );
+  if ( m_DynamicMultiThreading )
+    {
+    // Over-decompose the requested region, and let the threads pick the
+    // pieces as they become free
+    DynamicThreadStruct str;
+    str.Filter = this;
+    str.NextChunk = 0;
+    str.NumberOfChunks = splitter->GetNumberOfSplits( outputPtr->GetRequestedRegion(),
+                                                      this->GetNumberOfThreads() * m_DynamicChunksPerThread );
+
+    unsigned int validThreads = this->GetNumberOfThreads();
+    if ( str.NumberOfChunks < validThreads )
+      {
+      validThreads = str.NumberOfChunks;
+      }
 
-  this->GetMultiThreader()->SetNumberOfThreads( validThreads );
-  this->GetMultiThreader()->SetSingleMethod(this->ThreaderCallback, &str);
+    this->GetMultiThreader()->SetNumberOfThreads( validThreads );
+    this->GetMultiThreader()->SetSingleMethod(this->DynamicThreaderCallback, &str);
+    if ( recorder )
+      {
+      str.Recorder = recorder;
+      str.Execution = recorder->StartExecution( this, this->GetMultiThreader()->GetNumberOfThreads() );
+      }
 
-  // multithread the execution
-  this->GetMultiThreader()->SingleMethodExecute();
+    // multithread the execution
+    this->GetMultiThreader()->SingleMethodExecute();
+
+    if ( recorder )
+      {
+      recorder->StopExecution( str.Execution );
+      }
+    }
+  else
+    {
+    // Set up the multithreaded processing
+    ThreadStruct str;
+    str.Filter = this;
+
+    const unsigned int validThreads = splitter->GetNumberOfSplits( outputPtr->GetRequestedRegion(), this->GetNumberOfThreads() );
+
+    this->GetMultiThreader()->SetNumberOfThreads( validThreads );
+    this->GetMultiThreader()->SetSingleMethod(this->ThreaderCallback, &str);
+    if ( recorder )
+      {
+      str.Recorder = recorder;
+      str.Execution = recorder->StartExecution( this, this->GetMultiThreader()->GetNumberOfThreads() );
+      }
+
+    // multithread the execution
+    this->GetMultiThreader()->SingleMethodExecute();
+
+    if ( recorder )
+      {
+      recorder->StopExecution( str.Execution );
+      }
+    }
 
   // Call a method that can be overridden by a subclass to perform
   // some calculations after all the threads have completed
@@ -268,6 +353,15 @@ ImageSource< TOutputImage >
   throw e_;
 }
 
+//----------------------------------------------------------------------------
+template< typename TOutputImage >
+void
+ImageSource< TOutputImage >
+::DynamicThreadedGenerateData(const OutputImageRegionType &)
+{
+  itkExceptionMacro( << "Subclass should override this method for DynamicMultiThreading to be used!" );
+}
+
 // Callback routine used by the threading library. This routine just calls
 // the ThreadedGenerateData method after setting the correct region for this
 // thread.
@@ -292,7 +386,17 @@ ImageSource< TOutputImage >
 
   if ( threadId < total )
     {
-    str->Filter->ThreadedGenerateData(splitRegion, threadId);
+    if ( str->Execution )
+      {
+      const ThreadTimingRecorder::TimeStampType startTime = str->Recorder->GetTime();
+      str->Filter->ThreadedGenerateData(splitRegion, threadId);
+      str->Recorder->RecordPiece( str->Execution, threadId, startTime, str->Recorder->GetTime(),
+                                  splitRegion.GetNumberOfPixels() );
+      }
+    else
+      {
+      str->Filter->ThreadedGenerateData(splitRegion, threadId);
+      }
     }
   // else
   //   {
@@ -303,6 +407,92 @@ ImageSource< TOutputImage >
 
   return ITK_THREAD_RETURN_VALUE;
 }
+
+// Callback routine used by the threading library when DynamicMultiThreading
+// is on. Each thread claims the next unprocessed piece of the output
+// requested region until all of them have been generated.
+template< typename TOutputImage >
+ITK_THREAD_RETURN_TYPE
+ImageSource< TOutputImage >
+::DynamicThreaderCallback(void *arg)
+{
+  const ThreadIdType threadId = ( (MultiThreader::ThreadInfoStruct *)( arg ) )->ThreadID;
+  DynamicThreadStruct *str =
+    (DynamicThreadStruct *)( ( (MultiThreader::ThreadInfoStruct *)( arg ) )->UserData );
+
+  typename TOutputImage::RegionType splitRegion;
+  while ( true )
+    {
+    str->NextChunkLock.Lock();
+    const unsigned int chunk = str->NextChunk++;
+    str->NextChunkLock.Unlock();
+
+    if ( chunk >= str->NumberOfChunks )
+      {
+      break;
+      }
+
+    if ( chunk < str->Filter->SplitRequestedRegion(chunk, str->NumberOfChunks, splitRegion) )
+      {
+      if ( str->Execution )
+        {
+        const ThreadTimingRecorder::TimeStampType startTime = str->Recorder->GetTime();
+        str->Filter->DynamicThreadedGenerateData(splitRegion);
+        str->Recorder->RecordPiece( str->Execution, threadId, startTime, str->Recorder->GetTime(),
+                                    splitRegion.GetNumberOfPixels() );
+        }
+      else
+        {
+        str->Filter->DynamicThreadedGenerateData(splitRegion);
+        }
+      }
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+// Callback routine used by the threading library to touch the pages of
+// the outputs. Each thread touches the pieces of the output requested
+// region it is going to generate.
+template< typename TOutputImage >
+ITK_THREAD_RETURN_TYPE
+ImageSource< TOutputImage >
+::FirstTouchThreaderCallback(void *arg)
+{
+  const ThreadIdType threadId = ( (MultiThreader::ThreadInfoStruct *)( arg ) )->ThreadID;
+  const ThreadIdType threadCount = ( (MultiThreader::ThreadInfoStruct *)( arg ) )->NumberOfThreads;
+
+  FirstTouchThreadStruct *str =
+    (FirstTouchThreadStruct *)( ( (MultiThreader::ThreadInfoStruct *)( arg ) )->UserData );
+
+  typename TOutputImage::RegionType splitRegion;
+  for ( unsigned int piece = threadId; piece < str->NumberOfPieces; piece += threadCount )
+    {
+    if ( piece < str->Filter->SplitRequestedRegion(piece, str->NumberOfPieces, splitRegion) )
+      {
+      str->Filter->TouchOutputPages(splitRegion);
+      }
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< typename TOutputImage >
+void
+ImageSource< TOutputImage >
+::TouchOutputPages(const OutputImageRegionType & region)
+{
+  typedef ImageBase< OutputImageDimension > ImageBaseType;
+
+  for ( OutputDataObjectIterator it(this); !it.IsAtEnd(); it++ )
+    {
+    ImageBaseType *outputPtr = dynamic_cast< ImageBaseType * >( it.GetOutput() );
+    if ( outputPtr )
+      {
+      outputPtr->TouchBufferPages(region);
+      }
+    }
+}
 } // end namespace itk
 
 #endif
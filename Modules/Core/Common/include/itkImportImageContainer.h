@@ -20,6 +20,8 @@
 
 #include "itkObject.h"
 #include "itkObjectFactory.h"
+#include "itkMemoryPlacement.h"
+#include "itkImageBufferAllocator.h"
 #include <utility>
 
 namespace itk
@@ -73,6 +75,14 @@ public:
   void SetImportPointer(TElement *ptr, TElementIdentifier num,
                         bool LetContainerManageMemory = false);
 
+  /** Set the pointer from which the image data is imported, where the
+   * memory was obtained from the given allocator rather than from
+   * ImageBufferAllocator::Allocate(). The container keeps a reference to
+   * the allocator, and returns the memory to it with Deallocate() when
+   * the buffer is released. The elements are assumed to be constructed. */
+  void SetImportPointerFromAllocator(TElement *ptr, TElementIdentifier num,
+                                     ImageBufferAllocator *allocator);
+
   /** Index operator. This version can be an lvalue. */
   TElement & operator[](const ElementIdentifier id)
   { return m_ImportPointer[id]; }
@@ -132,6 +142,37 @@ public:
   itkGetConstMacro(ContainerManageMemory, bool);
   itkBooleanMacro(ContainerManageMemory);
 
+  /** Set/Get how the pages of the memory allocated by the container
+   * are placed on the memory nodes. With FirstTouchPlacement or
+   * InterleavedPlacement, buffers of at least a page are allocated
+   * directly from the operating system and left untouched, unless the
+   * constructor of TElement writes to them. Defaults to
+   * MemoryPlacement::GetGlobalDefaultPlacement(). Only affects
+   * subsequent allocations.
+   * \sa MemoryPlacement */
+  itkSetMacro(MemoryPlacement, MemoryPlacement::PlacementType);
+  itkGetConstMacro(MemoryPlacement, MemoryPlacement::PlacementType);
+
+  /** Set/Get the allocator the memory of the container is obtained
+   * from. When NULL, the memory is allocated with new[], or according
+   * to the MemoryPlacement. Defaults to
+   * ImageBufferAllocator::GetGlobalDefaultAllocator(). Only affects
+   * subsequent allocations; the current buffer is returned to the
+   * allocator it was obtained from.
+   * \sa ImageBufferPool */
+  itkSetObjectMacro(BufferAllocator, ImageBufferAllocator);
+  itkGetObjectMacro(BufferAllocator, ImageBufferAllocator);
+
+  /** Set/Get the alignment, in bytes, of the address of the memory
+   * allocated by the container. It must be zero or a power of two. Zero,
+   * the default, keeps the alignment of new[]. Alignments up to 64 bytes
+   * are provided by the BufferAllocator, and up to the page size by
+   * FirstTouchPlacement and InterleavedPlacement; otherwise the memory
+   * is allocated by the container itself. Only affects subsequent
+   * allocations. */
+  itkSetMacro(Alignment, SizeValueType);
+  itkGetConstMacro(Alignment, SizeValueType);
+
 protected:
   ImportImageContainer();
   virtual ~ImportImageContainer();
@@ -171,10 +212,27 @@ private:
   ImportImageContainer(const Self &); //purposely not implemented
   void operator=(const Self &);       //purposely not implemented
 
+  /** How a buffer was allocated, to release it the same way. */
+  typedef enum { NewAllocation, PagesAllocation, AllocatorAllocation, AlignedAllocation } AllocationType;
+
+  /** How AllocateElements() allocates a buffer of the given number of
+   * elements. */
+  AllocationType GetAllocationType(ElementIdentifier size) const;
+
+  /** Record how the current buffer was allocated. */
+  void SetImportPointerAllocation(AllocationType allocation);
+
   TElement *         m_ImportPointer;
   TElementIdentifier m_Size;
   TElementIdentifier m_Capacity;
   bool               m_ContainerManageMemory;
+
+  MemoryPlacement::PlacementType m_MemoryPlacement;
+  ImageBufferAllocator::Pointer  m_BufferAllocator;
+  SizeValueType                  m_Alignment;
+
+  AllocationType                m_ImportPointerAllocation;
+  ImageBufferAllocator::Pointer m_ImportPointerAllocator;
 };
 } // end namespace itk
 
@@ -30,6 +30,8 @@
 
 #include "itkImportImageContainer.h"
 
+#include <new>
+
 namespace itk
 {
 template< typename TElementIdentifier, typename TElement >
@@ -40,6 +42,10 @@ ImportImageContainer< TElementIdentifier, TElement >
   m_ContainerManageMemory = true;
   m_Capacity = 0;
   m_Size = 0;
+  m_MemoryPlacement = MemoryPlacement::GetGlobalDefaultPlacement();
+  m_BufferAllocator = ImageBufferAllocator::GetGlobalDefaultAllocator();
+  m_Alignment = 0;
+  m_ImportPointerAllocation = NewAllocation;
 }
 
 template< typename TElementIdentifier, typename TElement >
@@ -65,7 +71,8 @@ ImportImageContainer< TElementIdentifier, TElement >
     {
     if ( size > m_Capacity )
       {
-      TElement *temp = this->AllocateElements(size);
+      const AllocationType allocation = this->GetAllocationType(size);
+      TElement *           temp = this->AllocateElements(size);
       // only copy the portion of the data used in the old buffer
       std::copy(m_ImportPointer,
                 m_ImportPointer+m_Size,
@@ -74,6 +81,7 @@ ImportImageContainer< TElementIdentifier, TElement >
       DeallocateManagedMemory();
 
       m_ImportPointer = temp;
+      this->SetImportPointerAllocation(allocation);
       m_ContainerManageMemory = true;
       m_Capacity = size;
       m_Size = size;
@@ -87,7 +95,9 @@ ImportImageContainer< TElementIdentifier, TElement >
     }
   else
     {
+    const AllocationType allocation = this->GetAllocationType(size);
     m_ImportPointer = this->AllocateElements(size);
+    this->SetImportPointerAllocation(allocation);
     m_Capacity = size;
     m_Size = size;
     m_ContainerManageMemory = true;
@@ -109,6 +119,7 @@ ImportImageContainer< TElementIdentifier, TElement >
     if ( m_Size < m_Capacity )
       {
       const TElementIdentifier size = m_Size;
+      const AllocationType     allocation = this->GetAllocationType(size);
       TElement *               temp = this->AllocateElements(size);
       std::copy(m_ImportPointer,
                 m_ImportPointer+m_Size,
@@ -117,6 +128,7 @@ ImportImageContainer< TElementIdentifier, TElement >
       DeallocateManagedMemory();
 
       m_ImportPointer = temp;
+      this->SetImportPointerAllocation(allocation);
       m_ContainerManageMemory = true;
       m_Capacity = size;
       m_Size = size;
@@ -161,6 +173,7 @@ ImportImageContainer< TElementIdentifier, TElement >
 {
   DeallocateManagedMemory();
   m_ImportPointer = ptr;
+  this->SetImportPointerAllocation(NewAllocation);
   m_ContainerManageMemory = LetContainerManageMemory;
   m_Capacity = num;
   m_Size = num;
@@ -168,6 +181,61 @@ ImportImageContainer< TElementIdentifier, TElement >
   this->Modified();
 }
 
+template< typename TElementIdentifier, typename TElement >
+void
+ImportImageContainer< TElementIdentifier, TElement >
+::SetImportPointerFromAllocator(TElement *ptr, TElementIdentifier num,
+                                ImageBufferAllocator *allocator)
+{
+  DeallocateManagedMemory();
+  m_ImportPointer = ptr;
+  m_ImportPointerAllocation = AllocatorAllocation;
+  m_ImportPointerAllocator = allocator;
+  m_ContainerManageMemory = true;
+  m_Capacity = num;
+  m_Size = num;
+
+  this->Modified();
+}
+
+template< typename TElementIdentifier, typename TElement >
+typename ImportImageContainer< TElementIdentifier, TElement >::AllocationType
+ImportImageContainer< TElementIdentifier, TElement >
+::GetAllocationType(ElementIdentifier size) const
+{
+  if ( m_BufferAllocator.IsNotNull() && m_Alignment <= 64 )
+    {
+    return AllocatorAllocation;
+    }
+  if ( m_MemoryPlacement != MemoryPlacement::DefaultPlacement
+       && static_cast< SizeValueType >( size ) * sizeof( TElement ) >= MemoryPlacement::GetPageSize()
+       && m_Alignment <= MemoryPlacement::GetPageSize() )
+    {
+    return PagesAllocation;
+    }
+  if ( m_Alignment > 0 )
+    {
+    return AlignedAllocation;
+    }
+  return NewAllocation;
+}
+
+template< typename TElementIdentifier, typename TElement >
+void
+ImportImageContainer< TElementIdentifier, TElement >
+::SetImportPointerAllocation(AllocationType allocation)
+{
+  m_ImportPointerAllocation = allocation;
+  if ( allocation == AllocatorAllocation )
+    {
+    m_ImportPointerAllocator = m_BufferAllocator;
+    }
+  else
+    {
+    m_ImportPointerAllocator = ITK_NULLPTR;
+    }
+}
+
 template< typename TElementIdentifier, typename TElement >
 TElement *ImportImageContainer< TElementIdentifier, TElement >
 ::AllocateElements(ElementIdentifier size) const
@@ -177,13 +245,48 @@ TElement *ImportImageContainer< TElementIdentifier, TElement >
   // does not do this by default.
   TElement *data;
 
-  try
+  const AllocationType allocation = this->GetAllocationType(size);
+  if ( allocation == NewAllocation )
     {
-    data = new TElement[size];
+    try
+      {
+      data = new TElement[size];
+      }
+    catch ( ... )
+      {
+      data = ITK_NULLPTR;
+      }
     }
-  catch ( ... )
+  else
     {
-    data = ITK_NULLPTR;
+    const SizeValueType numberOfBytes = static_cast< SizeValueType >( size ) * sizeof( TElement );
+    if ( allocation == AllocatorAllocation )
+      {
+      data = static_cast< TElement * >( m_BufferAllocator->Allocate(numberOfBytes) );
+      }
+    else if ( allocation == AlignedAllocation )
+      {
+      data = static_cast< TElement * >( ImageBufferAllocator::AllocateAligned(numberOfBytes, m_Alignment) );
+      }
+    else
+      {
+      // Fresh pages are given physical memory on the node of the thread
+      // which first touches them, unless interleaving is requested.
+      data = static_cast< TElement * >( MemoryPlacement::AllocatePages(numberOfBytes) );
+      if ( data && m_MemoryPlacement == MemoryPlacement::InterleavedPlacement )
+        {
+        MemoryPlacement::InterleavePages(data, numberOfBytes);
+        }
+      }
+
+    // Construct the elements in the raw memory
+    if ( data )
+      {
+      for ( ElementIdentifier i = 0; i < size; ++i )
+        {
+        new ( data + i ) TElement;
+        }
+      }
     }
   if ( !data )
     {
@@ -203,9 +306,33 @@ void ImportImageContainer< TElementIdentifier, TElement >
   // Encapsulate all image memory deallocation here
   if ( m_ContainerManageMemory )
     {
-    delete[] m_ImportPointer;
+    if ( m_ImportPointerAllocation == NewAllocation )
+      {
+      delete[] m_ImportPointer;
+      }
+    else if ( m_ImportPointer )
+      {
+      for ( TElementIdentifier i = 0; i < m_Capacity; ++i )
+        {
+        m_ImportPointer[i].~TElement();
+        }
+      const SizeValueType numberOfBytes = static_cast< SizeValueType >( m_Capacity ) * sizeof( TElement );
+      if ( m_ImportPointerAllocation == PagesAllocation )
+        {
+        MemoryPlacement::FreePages(m_ImportPointer, numberOfBytes);
+        }
+      else if ( m_ImportPointerAllocation == AlignedAllocation )
+        {
+        ImageBufferAllocator::FreeAligned(m_ImportPointer);
+        }
+      else
+        {
+        m_ImportPointerAllocator->Deallocate(m_ImportPointer, numberOfBytes);
+        }
+      }
     }
   m_ImportPointer = ITK_NULLPTR;
+  this->SetImportPointerAllocation(NewAllocation);
   m_Capacity = 0;
   m_Size = 0;
 }
@@ -222,6 +349,9 @@ ImportImageContainer< TElementIdentifier, TElement >
      << ( m_ContainerManageMemory ? "true" : "false" ) << std::endl;
   os << indent << "Size: " << m_Size << std::endl;
   os << indent << "Capacity: " << m_Capacity << std::endl;
+  os << indent << "MemoryPlacement: " << m_MemoryPlacement << std::endl;
+  os << indent << "BufferAllocator: " << m_BufferAllocator.GetPointer() << std::endl;
+  os << indent << "Alignment: " << m_Alignment << std::endl;
 }
 } // end namespace itk
 
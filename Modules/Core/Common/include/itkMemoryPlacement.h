@@ -0,0 +1,106 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkMemoryPlacement_h
+#define __itkMemoryPlacement_h
+
+#include "itkIntTypes.h"
+#include "ITKCommonExport.h"
+
+#include <ostream>
+
+namespace itk
+{
+/** \class MemoryPlacement
+ * \brief Control on which NUMA nodes the pages of image buffers are placed.
+ *
+ * On machines with several memory nodes (NUMA), the operating system
+ * usually places a page on the node of the thread which first writes to
+ * it. An image buffer initialized by a single thread therefore lives on a
+ * single node, and the threads running on the other nodes are limited by
+ * the bandwidth of the interconnect.
+ *
+ * Three placements are available:
+ * - DefaultPlacement: buffers are allocated with new[], as usual.
+ * - FirstTouchPlacement: buffers are allocated from fresh pages which are
+ *   left untouched. ImageSource then touches the pages of each output from
+ *   the threads which will generate them, following the same region split
+ *   as ThreadedGenerateData().
+ * - InterleavedPlacement: buffers are allocated from fresh pages which
+ *   are interleaved over all the memory nodes. This does not depend on
+ *   which thread first writes to the buffer.
+ *
+ * The placement used by default is set with SetGlobalDefaultPlacement(),
+ * or with the ITK_MEMORY_PLACEMENT environment variable set to DEFAULT,
+ * FIRSTTOUCH or INTERLEAVED. It can be overridden per filter with
+ * ImageSource::SetMemoryPlacement(), and per buffer with
+ * ImportImageContainer::SetMemoryPlacement().
+ *
+ * Interleaving is only implemented on Linux; elsewhere, and on kernels
+ * without NUMA support, InterleavedPlacement behaves as
+ * FirstTouchPlacement.
+ *
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT MemoryPlacement
+{
+public:
+  /** The available placements. */
+  typedef enum {
+    DefaultPlacement = 0,
+    FirstTouchPlacement,
+    InterleavedPlacement
+  } PlacementType;
+
+  /** Set/Get the placement used by newly created pixel containers and
+   * image sources. */
+  static void SetGlobalDefaultPlacement(PlacementType placement);
+  static PlacementType GetGlobalDefaultPlacement();
+
+  /** Get the size of a memory page. */
+  static SizeValueType GetPageSize();
+
+  /** Allocate a block of fresh, untouched pages of at least the given
+   * number of bytes directly from the operating system. Returns NULL when
+   * the allocation fails. */
+  static void * AllocatePages(SizeValueType numberOfBytes);
+
+  /** Release a block allocated with AllocatePages(). */
+  static void FreePages(void *pages, SizeValueType numberOfBytes);
+
+  /** Request the pages of the block to be interleaved over all memory
+   * nodes. This must be done before the pages are touched. Returns false
+   * when interleaving is not supported. */
+  static bool InterleavePages(void *pages, SizeValueType numberOfBytes);
+
+  /** Touch every page starting in [begin, begin + numberOfBytes), so that
+   * untouched pages are placed on the node of the calling thread. The
+   * content of the memory is not modified. */
+  static void TouchPages(void *begin, SizeValueType numberOfBytes);
+
+private:
+  MemoryPlacement();                        //purposely not implemented
+  MemoryPlacement(const MemoryPlacement &); //purposely not implemented
+  void operator=(const MemoryPlacement &);  //purposely not implemented
+};
+
+/** Print the name of a placement. */
+extern ITKCommon_EXPORT std::ostream & operator<<(std::ostream & os,
+                                                  MemoryPlacement::PlacementType placement);
+} // end namespace itk
+
+#endif
@@ -89,6 +89,22 @@ public:
 
   static ThreadIdType  GetGlobalDefaultNumberOfThreads();
 
+  /** Set/Get the value which is used to initialize UseThreadPool in the
+   * constructor. When it has not been set explicitly, it is read from the
+   * ITK_USE_THREADPOOL environment variable ("ON", "TRUE", "YES" or "1"
+   * enable the pool), and defaults to false. */
+  static void SetGlobalDefaultUseThreadPool(bool useThreadPool);
+
+  static bool GetGlobalDefaultUseThreadPool();
+
+  /** Set/Get whether SingleMethodExecute() dispatches its work onto the
+   * persistent, process-wide ThreadPool instead of creating and joining
+   * new threads on every call. The ThreadInfoStruct passed to the
+   * SingleMethod is the same in both modes. */
+  itkSetMacro(UseThreadPool, bool);
+  itkGetConstMacro(UseThreadPool, bool);
+  itkBooleanMacro(UseThreadPool);
+
   /** Execute the SingleMethod (as define by SetSingleMethod) using
    * m_NumberOfThreads threads. As a side effect the m_NumberOfThreads will be
    * checked against the current m_GlobalMaximumNumberOfThreads and clamped if
@@ -186,6 +202,11 @@ private:
    */
   static ThreadIdType m_GlobalDefaultNumberOfThreads;
 
+  /** Global variable defining whether new MultiThreader instances use the
+   * thread pool, and whether it has been initialized yet. */
+  static bool m_GlobalDefaultUseThreadPool;
+  static bool m_GlobalDefaultUseThreadPoolIsInitialized;
+
   /**  Platform specific number of threads */
   static ThreadIdType  GetGlobalDefaultNumberOfThreadsByPlatform();
 
@@ -200,6 +221,9 @@ private:
    */
   ThreadIdType m_NumberOfThreads;
 
+  /** Whether SingleMethodExecute() runs on the ThreadPool. */
+  bool m_UseThreadPool;
+
   /** Static function used as a "proxy callback" by the MultiThreader.  The
    * threading library will call this routine for each thread, which
    * will delegate the control to the prescribed SingleMethod. This
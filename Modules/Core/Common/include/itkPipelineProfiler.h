@@ -0,0 +1,183 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkPipelineProfiler_h
+#define __itkPipelineProfiler_h
+
+#include "itkProcessObject.h"
+#include "itkRealTimeClock.h"
+#include "itkMemoryUsageObserver.h"
+#include "itkSimpleFastMutexLock.h"
+#include <vector>
+
+namespace itk
+{
+/** \class PipelineProfiler
+ * \brief Measures the time and memory spent by each process object of a
+ * pipeline.
+ *
+ * The profiler observes the StartEvent, EndEvent, AbortEvent and
+ * ProgressEvent of the process objects it is attached to, either one by one
+ * with AttachToProcessObject(), or all the process objects upstream of a
+ * data object with AttachToPipeline(). For each execution of their
+ * GenerateData(), which excludes the update of their inputs, it records the
+ * wall time, the CPU time of the process, and the memory usage of the
+ * process, sampled at each event to estimate its peak.
+ *
+ * Report() prints a table of the process objects, the slowest first, and
+ * WriteChromeTrace() writes the executions in the Trace Event Format read
+ * by chrome://tracing, with a track per thread updating the pipelines.
+ *
+ * The CPU time is given by std::clock(), which adds the time of all the
+ * threads of the process on POSIX systems, and is the wall time on
+ * Windows. The memory usage is given by MemoryUsageObserver. Pipelines
+ * updated by several threads at once may be attached to the same profiler,
+ * but their CPU times and memory usages then overlap.
+ *
+ * A process object deleted while it is attached is detached, and keeps its
+ * measures until Reset().
+ *
+ * \sa TimeProbe
+ * \sa MemoryProbe
+ *
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT PipelineProfiler:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef PipelineProfiler           Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(PipelineProfiler, Object);
+
+  typedef RealTimeClock::TimeStampType            TimeStampType;
+  typedef MemoryUsageObserverBase::MemoryLoadType MemoryLoadType;
+
+  /** Attach to a process object. Attaching twice has no effect. */
+  void AttachToProcessObject(ProcessObject *processObject);
+
+  /** Attach to the source of a data object and all the process objects
+   * upstream of it. */
+  void AttachToPipeline(const DataObject *output);
+
+  /** Stop observing the process objects. Their measures are kept. */
+  void Detach();
+
+  /** Discard the measures, and the process objects which are no longer
+   * attached. */
+  void Reset();
+
+  /** Get the number of process objects measured. */
+  SizeValueType GetNumberOfProcessObjects() const;
+
+  /** Get the measures of a process object. They are 0 for a process object
+   * which is not measured. Times are in seconds, memory in kB. */
+  SizeValueType GetNumberOfExecutions(const ProcessObject *processObject) const;
+  TimeStampType GetWallTime(const ProcessObject *processObject) const;
+  TimeStampType GetCPUTime(const ProcessObject *processObject) const;
+  MemoryLoadType GetPeakMemoryUsage(const ProcessObject *processObject) const;
+
+  /** Print a table of the process objects measured, by decreasing wall
+   * time. */
+  void Report(std::ostream & os = std::cout) const;
+
+  /** Write the executions in the Trace Event Format of chrome://tracing. */
+  void WriteChromeTrace(std::ostream & os) const;
+  void WriteChromeTrace(const std::string & fileName) const;
+
+protected:
+  PipelineProfiler();
+  ~PipelineProfiler();
+  virtual void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+private:
+  PipelineProfiler(const Self &); //purposely not implemented
+  void operator=(const Self &);   //purposely not implemented
+
+  /** The measures of a process object. */
+  struct ProcessObjectRecord
+  {
+    ProcessObject *Source;
+    std::string    Name;
+    bool           Attached;
+    unsigned long  ObserverTags[5];
+
+    SizeValueType  NumberOfExecutions;
+    TimeStampType  WallTime;
+    TimeStampType  CPUTime;
+    MemoryLoadType PeakMemoryUsage;
+    ThreadIdType   NumberOfThreads;
+
+    // the execution in progress
+    bool           Running;
+    TimeStampType  StartWallTime;
+    TimeStampType  StartCPUTime;
+    MemoryLoadType StartMemoryUsage;
+    MemoryLoadType ExecutionPeakMemoryUsage;
+    unsigned int   Thread;
+  };
+
+  /** An execution, for the trace. */
+  struct ExecutionRecord
+  {
+    SizeValueType  Record;
+    TimeStampType  StartWallTime;
+    TimeStampType  WallTime;
+    TimeStampType  CPUTime;
+    MemoryLoadType StartMemoryUsage;
+    MemoryLoadType PeakMemoryUsage;
+    unsigned int   Thread;
+  };
+
+#if defined( ITK_USE_WIN32_THREADS )
+  typedef DWORD ThreadIdentifierType;
+#else
+  typedef ThreadProcessIDType ThreadIdentifierType;
+#endif
+
+  /** The DeleteEvent is invoked by a const method. */
+  void ProcessEvent(Object *caller, const EventObject & event);
+  void ProcessConstEvent(const Object *caller, const EventObject & event);
+
+  /** Index of the record of a process object, or the number of records. */
+  SizeValueType FindRecord(const ProcessObject *processObject) const;
+
+  /** Index of the calling thread, in the order the threads were seen. */
+  unsigned int GetCurrentThreadIndex();
+
+  void RemoveObservers(ProcessObjectRecord & record);
+
+  TimeStampType GetProcessCPUTime() const;
+
+  std::vector< ProcessObjectRecord >  m_Records;
+  std::vector< ExecutionRecord >      m_Executions;
+  std::vector< ThreadIdentifierType > m_Threads;
+  TimeStampType                       m_Origin;
+  RealTimeClock::Pointer              m_Clock;
+  MemoryUsageObserver                 m_MemoryObserver;
+  mutable SimpleFastMutexLock         m_Mutex;
+};
+} // end namespace itk
+
+#endif
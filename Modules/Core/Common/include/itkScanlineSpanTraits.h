@@ -0,0 +1,100 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkScanlineSpanTraits_h
+#define __itkScanlineSpanTraits_h
+
+#include "itkImage.h"
+#include "itkIsSame.h"
+
+namespace itk
+{
+/** \class ImageScanlineSpanTraits
+ * \brief Whether the scanlines of an image type are plain arrays of pixels.
+ *
+ * Value is true when the pixels of a scanline of TImage are stored one
+ * after the other as PixelType, so that a scanline can be read and
+ * written through a PixelType pointer. This holds for Image, but not for
+ * VectorImage or ImageAdaptor, whose pixels go through a pixel accessor.
+ *
+ * \sa Functor::SpanFunctorTraits
+ * \ingroup ITKCommon
+ */
+template< typename TImage >
+struct ImageScanlineSpanTraits
+{
+  static const bool Value = false;
+};
+
+template< typename TPixel, unsigned int VImageDimension >
+struct ImageScanlineSpanTraits< Image< TPixel, VImageDimension > >
+{
+  static const bool Value = true;
+};
+
+/** \cond HIDE_META_PROGRAMMING */
+/** TrueType when VSpans is true, to select at compile time between the
+ * scanline span and the pixel by pixel implementations. */
+template< bool VSpans >
+struct ScanlineSpanTag: public FalseType
+{
+};
+
+template<>
+struct ScanlineSpanTag< true >: public TrueType
+{
+};
+/** \endcond */
+
+namespace Functor
+{
+/** \class SpanFunctorTraits
+ * \brief Whether a functor processes whole spans of pixels at once.
+ *
+ * UnaryFunctorImageFilter, BinaryFunctorImageFilter and
+ * TernaryFunctorImageFilter process each scanline of images for which
+ * ImageScanlineSpanTraits holds as a plain array. By default, they call
+ * the functor on each element in a simple loop, which the compiler can
+ * vectorize once the functor is inlined.
+ *
+ * A functor with a better way to process a whole span, e.g. a branch
+ * free or vectorized implementation for some pixel types, opts in by
+ * specializing SpanFunctorTraits to derive from TrueType, and by
+ * providing, according to its number of arguments:
+ *
+ * \code
+ * void ProcessSpan(const TInput *in, TOutput *out, SizeValueType n) const;
+ * void ProcessSpan(const TInput1 *in1, const TInput2 *in2,
+ *                  TOutput *out, SizeValueType n) const;
+ * void ProcessSpan(const TInput1 *in1, const TInput2 *in2, const TInput3 *in3,
+ *                  TOutput *out, SizeValueType n) const;
+ * \endcode
+ *
+ * out may be equal to one of the inputs when the filter runs in place.
+ * When one input of a BinaryFunctorImageFilter is a constant, the
+ * default loop is used.
+ *
+ * \ingroup ITKCommon
+ */
+template< typename TFunctor >
+struct SpanFunctorTraits: public FalseType
+{
+};
+} // end namespace Functor
+} // end namespace itk
+
+#endif
@@ -233,6 +233,8 @@ public:
 
   const PixelContainer * GetPixelContainer() const { return m_Buffer.GetPointer(); }
 
+  virtual SizeValueType GetPixelSizeInBytes() const { return sizeof( TPixel ); }
+
   /** Set the container to use. Note that this does not cause the
    * DataObject to be modified. */
   void SetPixelContainer(PixelContainer *container);
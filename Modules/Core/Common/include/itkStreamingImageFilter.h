@@ -36,6 +36,15 @@ namespace itk
  * This filter will produce the entire output as one image, but the upstream
  * filters will do their processing in pieces.
  *
+ * Instead of a fixed number of pieces, a memory budget can be given with
+ * SetMemoryBudget(). The number of pieces is then the smallest one for
+ * which the estimated peak memory fits in the budget. The estimate is
+ * the size of the output plus the size of the requested regions of all
+ * the images of the upstream pipeline for the largest piece, and of the
+ * buffers of the images at its start, as given by
+ * ImageBase::GetPixelSizeInBytes(). It is conservative, since it does
+ * not account for filters running in place or releasing their data.
+ *
  * \ingroup ITKSystemObjects
  * \ingroup DataProcessing
  * \ingroup ITKCommon
@@ -86,6 +95,22 @@ public:
    * will be executed this many times. */
   itkGetConstReferenceMacro(NumberOfStreamDivisions, unsigned int);
 
+  /** Set/Get the maximum number of bytes the output and the upstream
+   * pipeline should use. When not 0, the number of pieces is computed
+   * from the budget and NumberOfStreamDivisions is ignored. 0 by
+   * default. */
+  itkSetMacro(MemoryBudget, SizeValueType);
+  itkGetConstMacro(MemoryBudget, SizeValueType);
+
+  /** Get the number of pieces the last update was divided into. */
+  itkGetConstMacro(NumberOfStreamDivisionsUsed, unsigned int);
+
+  /** Get the peak memory, in bytes, estimated for the last update: the
+   * size of the output plus the estimated memory of the upstream
+   * pipeline for the largest piece. Only computed when a memory budget is
+   * set. */
+  itkGetConstMacro(EstimatedPeakMemory, SizeValueType);
+
   /** Get/Set the helper class for dividing the input into chunks. */
   itkSetObjectMacro(RegionSplitter, SplitterType);
   itkGetModifiableObjectMacro(RegionSplitter, SplitterType);
@@ -117,6 +142,17 @@ protected:
   ~StreamingImageFilter();
   void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Estimate the memory, in bytes, used by the upstream pipeline to
+   * produce streamRegion of the input: the requested regions are
+   * propagated upstream, without updating, and the sizes of the
+   * requested regions of all the images upstream are added. */
+  virtual SizeValueType EstimateStreamMemory(const InputImageRegionType & streamRegion);
+
+  /** Number of pieces for which the estimated peak memory fits in the
+   * memory budget, or the largest number of pieces the splitter allows
+   * if none does. */
+  unsigned int ComputeNumberOfStreamDivisions(const OutputImageRegionType & outputRegion);
+
 private:
   StreamingImageFilter(const StreamingImageFilter &); //purposely not
                                                       // implemented
@@ -126,6 +162,9 @@ private:
 
   unsigned int          m_NumberOfStreamDivisions;
   RegionSplitterPointer m_RegionSplitter;
+  SizeValueType         m_MemoryBudget;
+  unsigned int          m_NumberOfStreamDivisionsUsed;
+  SizeValueType         m_EstimatedPeakMemory;
 };
 } // end namespace itk
 
@@ -21,6 +21,9 @@
 #include "itkCommand.h"
 #include "itkImageAlgorithm.h"
 #include "itkImageRegionSplitterSlowDimension.h"
+#include <algorithm>
+#include <cmath>
+#include <set>
 
 namespace itk
 {
@@ -34,6 +37,11 @@ StreamingImageFilter< TInputImage, TOutputImage >
   // default to 10 divisions
   m_NumberOfStreamDivisions = 10;
 
+  // no memory budget
+  m_MemoryBudget = 0;
+  m_NumberOfStreamDivisionsUsed = 0;
+  m_EstimatedPeakMemory = 0;
+
   // create default region splitter
   m_RegionSplitter = ImageRegionSplitterSlowDimension::New();
 }
@@ -58,6 +66,10 @@ StreamingImageFilter< TInputImage, TOutputImage >
 
   os << indent << "Number of stream divisions: " << m_NumberOfStreamDivisions
      << std::endl;
+  os << indent << "Memory budget: " << m_MemoryBudget << std::endl;
+  os << indent << "Number of stream divisions used: " << m_NumberOfStreamDivisionsUsed
+     << std::endl;
+  os << indent << "Estimated peak memory: " << m_EstimatedPeakMemory << std::endl;
   if ( m_RegionSplitter )
     {
     os << indent << "Region splitter:" << m_RegionSplitter << std::endl;
@@ -177,14 +189,22 @@ StreamingImageFilter< TInputImage, TOutputImage >
    */
   unsigned int numDivisions, numDivisionsFromSplitter;
 
-  numDivisions = m_NumberOfStreamDivisions;
-  numDivisionsFromSplitter =
-    m_RegionSplitter
-    ->GetNumberOfSplits(outputRegion, m_NumberOfStreamDivisions);
-  if ( numDivisionsFromSplitter < numDivisions )
+  if ( m_MemoryBudget > 0 )
+    {
+    numDivisions = this->ComputeNumberOfStreamDivisions(outputRegion);
+    }
+  else
     {
-    numDivisions = numDivisionsFromSplitter;
+    numDivisions = m_NumberOfStreamDivisions;
+    numDivisionsFromSplitter =
+      m_RegionSplitter
+      ->GetNumberOfSplits(outputRegion, m_NumberOfStreamDivisions);
+    if ( numDivisionsFromSplitter < numDivisions )
+      {
+      numDivisions = numDivisionsFromSplitter;
+      }
     }
+  m_NumberOfStreamDivisionsUsed = numDivisions;
 
   /**
    * Loop over the number of pieces, execute the upstream pipeline on each
@@ -243,6 +263,108 @@ StreamingImageFilter< TInputImage, TOutputImage >
   // Mark that we are no longer updating the data in this filter
   this->m_Updating = false;
 }
+
+template< typename TInputImage, typename TOutputImage >
+unsigned int
+StreamingImageFilter< TInputImage, TOutputImage >
+::ComputeNumberOfStreamDivisions(const OutputImageRegionType & outputRegion)
+{
+  const SizeValueType outputMemory = this->GetOutput(0)->GetRequestedRegionSizeInBytes();
+  const SizeValueType available = m_MemoryBudget > outputMemory ? m_MemoryBudget - outputMemory : 0;
+
+  // Largest number of pieces the splitter can produce
+  const unsigned int maximumNumberOfDivisions =
+    m_RegionSplitter->GetNumberOfSplits( outputRegion, NumericTraits< unsigned int >::max() );
+
+  // The pieces may be enlarged upstream, e.g. by the radius of
+  // neighborhood filters, so the memory is not proportional to the size
+  // of the pieces: estimate again after each guess
+  unsigned int numberOfRequestedDivisions = 1;
+  unsigned int numDivisions;
+  for (;; )
+    {
+    numDivisions = m_RegionSplitter->GetNumberOfSplits(outputRegion, numberOfRequestedDivisions);
+
+    // The first piece is the largest one for the splitters of ITK
+    InputImageRegionType streamRegion = outputRegion;
+    m_RegionSplitter->GetSplit(0, numDivisions, streamRegion);
+    const SizeValueType streamMemory = this->EstimateStreamMemory(streamRegion);
+    m_EstimatedPeakMemory = outputMemory + streamMemory;
+
+    if ( streamMemory <= available || numberOfRequestedDivisions >= maximumNumberOfDivisions )
+      {
+      break;
+      }
+
+    // The splitter may give fewer pieces than requested, so the request
+    // grows at each guess to reach the maximum in the end
+    double guess = 2.0 * numDivisions;
+    if ( available > 0 )
+      {
+      guess = std::ceil( static_cast< double >( numDivisions ) * streamMemory / available );
+      }
+    guess = std::min( guess, static_cast< double >( maximumNumberOfDivisions ) );
+    numberOfRequestedDivisions = std::max( numberOfRequestedDivisions + 1,
+                                           static_cast< unsigned int >( guess ) );
+    }
+
+  if ( m_EstimatedPeakMemory > m_MemoryBudget )
+    {
+    itkWarningMacro(<< "The estimated peak memory of " << m_EstimatedPeakMemory
+                    << " bytes with " << numDivisions << " stream divisions exceeds the memory budget of "
+                    << m_MemoryBudget << " bytes.");
+    }
+  return numDivisions;
+}
+
+template< typename TInputImage, typename TOutputImage >
+SizeValueType
+StreamingImageFilter< TInputImage, TOutputImage >
+::EstimateStreamMemory(const InputImageRegionType & streamRegion)
+{
+  InputImageType *inputPtr = const_cast< InputImageType * >( this->GetInput(0) );
+
+  inputPtr->SetRequestedRegion(streamRegion);
+  inputPtr->PropagateRequestedRegion();
+
+  // Add the requested regions of all the data objects upstream, each
+  // one once even when it is the input of several filters. Data objects
+  // without a source keep their buffer whatever the request.
+  SizeValueType                  memory = 0;
+  std::set< const DataObject * > visited;
+  std::vector< DataObject * >    toVisit(1, inputPtr);
+  while ( !toVisit.empty() )
+    {
+    DataObject *data = toVisit.back();
+    toVisit.pop_back();
+    if ( !data || !visited.insert(data).second )
+      {
+      continue;
+      }
+    ProcessObject *source = data->GetSource().GetPointer();
+    if ( !source )
+      {
+      memory += data->GetBufferedRegionSizeInBytes();
+      }
+    else
+      {
+      memory += data->GetRequestedRegionSizeInBytes();
+
+      ProcessObject::DataObjectPointerArray inputs = source->GetInputs();
+      for ( size_t i = 0; i < inputs.size(); ++i )
+        {
+        toVisit.push_back( inputs[i] );
+        }
+      // The other outputs of the source are buffered too
+      ProcessObject::DataObjectPointerArray outputs = source->GetOutputs();
+      for ( size_t i = 0; i < outputs.size(); ++i )
+        {
+        toVisit.push_back( outputs[i] );
+        }
+      }
+    }
+  return memory;
+}
 } // end namespace itk
 
 #endif
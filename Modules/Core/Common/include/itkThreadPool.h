@@ -0,0 +1,136 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkThreadPool_h
+#define __itkThreadPool_h
+
+#include "itkMultiThreader.h"
+#include "itkConditionVariable.h"
+
+#include <deque>
+#include <set>
+
+namespace itk
+{
+/** \class ThreadPool
+ * \brief A process-wide pool of persistent worker threads.
+ *
+ * The ThreadPool keeps a set of worker threads alive between calls so
+ * that repeated multithreaded executions (for example the
+ * SingleMethodExecute() of every filter in a long pipeline) do not pay the
+ * cost of creating and joining operating system threads each time.
+ *
+ * Work is submitted as a ThreadJob through AddWork(), which returns an
+ * identifier that must later be passed to WaitForJob(). A job that has
+ * not yet been picked up by a worker when WaitForJob() is called is
+ * executed directly by the waiting thread, so nested use of the pool
+ * (a threaded filter run from within another threaded filter) can not
+ * dead-lock even when all the workers are busy.
+ *
+ * The pool grows on demand, up to ITK_MAX_THREADS workers, and is shared
+ * by all the MultiThreader instances for which UseThreadPool is on.
+ *
+ * \sa MultiThreader::SetGlobalDefaultUseThreadPool
+ * \ingroup OSSystemObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ThreadPool:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ThreadPool                 Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ThreadPool, Object);
+
+  /** Return the process-wide thread pool instance, creating it on the
+   * first call. */
+  static Pointer New();
+  static Pointer GetInstance();
+
+  /** Identifier of a job submitted with AddWork(). */
+  typedef SizeValueType ThreadJobIdType;
+
+  /** \struct ThreadJob
+   * \brief The function, and its argument, executed by a worker thread.
+   * \ingroup ITKCommon
+   */
+  struct ThreadJob {
+    ThreadFunctionType m_ThreadFunction;
+    void *             m_UserData;
+  };
+
+  /** Queue a job for execution by one of the worker threads. The returned
+   * identifier must be passed to WaitForJob(). */
+  ThreadJobIdType AddWork(const ThreadJob & job);
+
+  /** Block until the given job has completed. If no worker has started the
+   * job yet, it is executed by the calling thread. */
+  void WaitForJob(ThreadJobIdType id);
+
+  /** Number of worker threads currently alive in the pool. */
+  ThreadIdType GetNumberOfThreads() const;
+
+protected:
+  ThreadPool();
+  ~ThreadPool();
+  virtual void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+private:
+  ThreadPool(const Self &);     //purposely not implemented
+  void operator=(const Self &); //purposely not implemented
+
+  struct QueuedJob {
+    ThreadJobIdType m_Id;
+    ThreadJob       m_Job;
+  };
+  typedef std::deque< QueuedJob > JobQueueType;
+
+  /** Start an additional worker thread. Must be called with m_Mutex held. */
+  void AddThread();
+
+  /** Worker thread main loop, started through SpawnThread(). */
+  static ITK_THREAD_RETURN_TYPE ThreadExecute(void *arg);
+
+  /** Run a job and record its completion. */
+  void ExecuteJob(const QueuedJob & job);
+
+  /** The threader used to spawn, and at destruction terminate, the
+   * worker threads. */
+  MultiThreader::Pointer m_Threader;
+  ThreadIdType           m_ThreadIds[ITK_MAX_THREADS];
+  ThreadIdType           m_NumberOfThreads;
+
+  /** Number of workers waiting for work. */
+  ThreadIdType m_NumberOfIdleThreads;
+
+  /** Protects all the members below, and the ones above once the workers
+   * are started. */
+  mutable SimpleMutexLock    m_Mutex;
+  ConditionVariable::Pointer m_WorkAvailable;
+  ConditionVariable::Pointer m_JobCompleted;
+
+  JobQueueType                m_JobQueue;
+  std::set< ThreadJobIdType > m_CompletedJobs;
+  ThreadJobIdType             m_NextJobId;
+  bool                        m_StopThreads;
+};
+}  // end namespace itk
+#endif
@@ -0,0 +1,160 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkThreadTimingRecorder_h
+#define __itkThreadTimingRecorder_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkRealTimeClock.h"
+#include "itkSimpleFastMutexLock.h"
+#include <deque>
+#include <vector>
+
+namespace itk
+{
+/** \class ThreadTimingRecorder
+ * \brief Records the work of each thread in the threaded executions of
+ * image sources, to measure their load imbalance.
+ *
+ * When an ImageSource has a recorder, set with
+ * ImageSource::SetThreadTimingRecorder(), or when a global recorder is set
+ * with SetGlobalRecorder(), its default GenerateData() records, for each
+ * thread, the time it started and stopped generating its pieces of the
+ * output, the time it spent generating them, and the number of pixels in
+ * them. Without a recorder, nothing is measured.
+ *
+ * GetImbalanceRatio() is the longest time a thread was busy divided by the
+ * mean over the threads, which is 1 when the load is balanced, and the
+ * number of threads when a single thread did all the work.
+ * GetPixelImbalanceRatio() is the same ratio for the numbers of pixels,
+ * which tells whether an imbalance comes from the split of the region or
+ * from pixels which are more expensive than others.
+ *
+ * Report() prints a table of the executions, and WriteChromeTrace() writes
+ * them in the Trace Event Format read by chrome://tracing, with a process
+ * per execution and a track per thread.
+ *
+ * The executions are kept until Reset(), which must not be called while
+ * filters recording to this recorder execute.
+ *
+ * \sa PipelineProfiler
+ *
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ThreadTimingRecorder:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ThreadTimingRecorder       Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ThreadTimingRecorder, Object);
+
+  /** Times are in seconds since the recorder was created or reset. */
+  typedef RealTimeClock::TimeStampType TimeStampType;
+
+  /** The work of a thread during an execution. */
+  struct ThreadRecord
+  {
+    TimeStampType StartTime;
+    TimeStampType StopTime;
+    TimeStampType BusyTime;
+    SizeValueType NumberOfPixels;
+    SizeValueType NumberOfPieces;
+  };
+
+  /** A threaded execution. */
+  struct ExecutionRecord
+  {
+    std::string                 Name;
+    TimeStampType               StartTime;
+    TimeStampType               StopTime;
+    std::vector< ThreadRecord > Threads;
+  };
+
+  /** Set/Get the recorder used by the image sources which do not have
+   * their own. It is NULL by default. It should be set while no filter
+   * executes. */
+  static void SetGlobalRecorder(Self *recorder);
+  static Self * GetGlobalRecorder();
+
+  /** Start recording an execution of a process object with the given
+   * number of threads. */
+  ExecutionRecord * StartExecution(const Object *processObject, ThreadIdType numberOfThreads);
+
+  /** Record that a thread generated a piece of the output between two
+   * times given by GetTime(). Each thread only modifies its own record,
+   * so no lock is taken. */
+  void RecordPiece(ExecutionRecord *execution, ThreadIdType threadId,
+                   TimeStampType startTime, TimeStampType stopTime,
+                   SizeValueType numberOfPixels) const;
+
+  /** Stop recording an execution. */
+  void StopExecution(ExecutionRecord *execution);
+
+  /** Get the current time. */
+  TimeStampType GetTime() const;
+
+  /** Get the executions recorded. */
+  SizeValueType GetNumberOfExecutions() const;
+  const ExecutionRecord & GetExecution(SizeValueType execution) const;
+
+  /** Get the ratio of the longest busy time of a thread to the mean busy
+   * time of the threads of an execution. */
+  double GetImbalanceRatio(SizeValueType execution) const;
+
+  /** Get the ratio of the largest number of pixels generated by a thread
+   * to the mean number of pixels of the threads of an execution. */
+  double GetPixelImbalanceRatio(SizeValueType execution) const;
+
+  /** Discard the executions. */
+  void Reset();
+
+  /** Print a table of the executions. */
+  void Report(std::ostream & os = std::cout) const;
+
+  /** Write the executions in the Trace Event Format of chrome://tracing. */
+  void WriteChromeTrace(std::ostream & os) const;
+  void WriteChromeTrace(const std::string & fileName) const;
+
+protected:
+  ThreadTimingRecorder();
+  ~ThreadTimingRecorder() {}
+  virtual void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+private:
+  ThreadTimingRecorder(const Self &); //purposely not implemented
+  void operator=(const Self &);       //purposely not implemented
+
+  /** The records do not move when executions are added. */
+  std::deque< ExecutionRecord > m_Executions;
+  TimeStampType                 m_Origin;
+  RealTimeClock::Pointer        m_Clock;
+  mutable SimpleFastMutexLock   m_Mutex;
+
+  static Pointer m_GlobalRecorder;
+};
+} // end namespace itk
+
+#endif
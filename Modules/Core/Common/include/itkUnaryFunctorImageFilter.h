@@ -20,6 +20,8 @@
 
 #include "itkInPlaceImageFilter.h"
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkScanlineSpanTraits.h"
+#include "itkProgressReporter.h"
 
 namespace itk
 {
@@ -35,6 +37,11 @@ namespace itk
  * UnaryFunctorImageFilter (like the CastImageFilter) can be used
  * to promote a 2D image to a 3D image, etc.
  *
+ * When the input and output are Images, each scanline is processed as a
+ * plain array of pixels, which lets the compiler vectorize the loop.
+ * Functors can provide their own implementation for whole scanlines;
+ * see Functor::SpanFunctorTraits.
+ *
  * \sa BinaryFunctorImageFilter TernaryFunctorImageFilter
  *
  * \ingroup   IntensityImageFilters     MultiThreaded
@@ -95,6 +102,13 @@ public:
       }
   }
 
+  /** Set/Get whether scanlines are processed as plain arrays of pixels
+   * when the image types allow it. On by default. When off, the functor
+   * is called through the iterators, one pixel at a time. */
+  itkSetMacro(UseScanlineSpans, bool);
+  itkGetConstMacro(UseScanlineSpans, bool);
+  itkBooleanMacro(UseScanlineSpans);
+
 protected:
   UnaryFunctorImageFilter();
   virtual ~UnaryFunctorImageFilter() {}
@@ -126,7 +140,37 @@ private:
   UnaryFunctorImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);          //purposely not implemented
 
+  typedef ScanlineSpanTag< ImageScanlineSpanTraits< TInputImage >::Value
+                           && ImageScanlineSpanTraits< TOutputImage >::Value > ScanlineSpansType;
+
+  /** Apply the functor to the scanlines of the regions, pixel by pixel
+   * or as spans of pixels. */
+  void ProcessScanlines(const InputImageRegionType & inputRegion,
+                        const OutputImageRegionType & outputRegion,
+                        ProgressReporter & progress, const FalseType &);
+
+  void ProcessScanlines(const InputImageRegionType & inputRegion,
+                        const OutputImageRegionType & outputRegion,
+                        ProgressReporter & progress, const TrueType &);
+
+  /** Apply the functor to a span of n pixels. */
+  void ProcessSpan(const InputImagePixelType *in, OutputImagePixelType *out,
+                   SizeValueType n, const FalseType &)
+  {
+    for ( SizeValueType i = 0; i < n; ++i )
+      {
+      out[i] = m_Functor(in[i]);
+      }
+  }
+
+  void ProcessSpan(const InputImagePixelType *in, OutputImagePixelType *out,
+                   SizeValueType n, const TrueType &)
+  {
+    m_Functor.ProcessSpan(in, out, n);
+  }
+
   FunctorType m_Functor;
+  bool        m_UseScanlineSpans;
 };
 } // end namespace itk
 
@@ -33,6 +33,7 @@ UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
 {
   this->SetNumberOfRequiredInputs(1);
   this->InPlaceOff();
+  m_UseScanlineSpans = true;
 }
 
 /**
@@ -157,8 +158,6 @@ UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
     {
     return;
     }
-  const TInputImage *inputPtr = this->GetInput();
-  TOutputImage *outputPtr = this->GetOutput(0);
 
   // Define the portion of the input to walk for this thread, using
   // the CallCopyOutputRegionToInputRegion method allows for the input
@@ -170,9 +169,26 @@ UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
   const size_t numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / regionSize[0];
   ProgressReporter progress( this, threadId, numberOfLinesToProcess );
 
+  if ( m_UseScanlineSpans && inputRegionForThread.GetSize(0) == regionSize[0] )
+    {
+    this->ProcessScanlines( inputRegionForThread, outputRegionForThread, progress, ScanlineSpansType() );
+    }
+  else
+    {
+    this->ProcessScanlines( inputRegionForThread, outputRegionForThread, progress, FalseType() );
+    }
+}
+
+template< typename TInputImage, typename TOutputImage, typename TFunction >
+void
+UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
+::ProcessScanlines(const InputImageRegionType & inputRegion,
+                   const OutputImageRegionType & outputRegion,
+                   ProgressReporter & progress, const FalseType &)
+{
   // Define the iterators
-  ImageScanlineConstIterator< TInputImage > inputIt(inputPtr, inputRegionForThread);
-  ImageScanlineIterator< TOutputImage > outputIt(outputPtr, outputRegionForThread);
+  ImageScanlineConstIterator< TInputImage > inputIt(this->GetInput(), inputRegion);
+  ImageScanlineIterator< TOutputImage > outputIt(this->GetOutput(0), outputRegion);
 
   inputIt.GoToBegin();
   outputIt.GoToBegin();
@@ -189,6 +205,30 @@ UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
     progress.CompletedPixel();  // potential exception thrown here
     }
 }
+
+template< typename TInputImage, typename TOutputImage, typename TFunction >
+void
+UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
+::ProcessScanlines(const InputImageRegionType & inputRegion,
+                   const OutputImageRegionType & outputRegion,
+                   ProgressReporter & progress, const TrueType &)
+{
+  ImageScanlineConstIterator< TInputImage > inputIt(this->GetInput(), inputRegion);
+  ImageScanlineIterator< TOutputImage > outputIt(this->GetOutput(0), outputRegion);
+
+  const SizeValueType length = outputRegion.GetSize(0);
+  typename Functor::SpanFunctorTraits< FunctorType >::Type functorSpans;
+
+  inputIt.GoToBegin();
+  outputIt.GoToBegin();
+  while ( !inputIt.IsAtEnd() )
+    {
+    this->ProcessSpan( &inputIt.Value(), &outputIt.Value(), length, functorSpans );
+    inputIt.NextLine();
+    outputIt.NextLine();
+    progress.CompletedPixel();  // potential exception thrown here
+    }
+}
 } // end namespace itk
 
 #endif
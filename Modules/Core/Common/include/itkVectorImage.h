@@ -204,6 +204,16 @@ public:
    * memory. */
   virtual void Initialize();
 
+  /** Set how the pages of the pixel container allocated by the next
+   * call to Allocate() are placed on the memory nodes.
+   * \sa MemoryPlacement */
+  virtual void SetMemoryPlacement(MemoryPlacement::PlacementType placement);
+
+  /** Touch the pages of the pixel container holding the pixels of the
+   * given region, without modifying them.
+   * \sa MemoryPlacement */
+  virtual void TouchBufferPages(const RegionType & region);
+
   /** Fill the image buffer with a value.  Be sure to call Allocate()
    * first. */
   void FillBuffer(const PixelType & value);
@@ -332,6 +342,11 @@ public:
 
   virtual void SetNumberOfComponentsPerPixel(unsigned int n);
 
+  virtual SizeValueType GetPixelSizeInBytes() const
+  {
+    return sizeof( InternalPixelType ) * m_VectorLength;
+  }
+
 protected:
   VectorImage();
   void PrintSelf(std::ostream & os, Indent indent) const;
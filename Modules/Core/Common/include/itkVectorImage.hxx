@@ -55,12 +55,29 @@ VectorImage< TPixel, VImageDimension >
     }
 
   SizeValueType num;
-  this->ComputeOffsetTable();
+  this->ComputeBufferRowPadding( sizeof( InternalPixelType ) * m_VectorLength );
   num = this->GetOffsetTable()[VImageDimension];
 
+  m_Buffer->SetAlignment( this->GetBufferAlignment() );
   m_Buffer->Reserve(num * m_VectorLength);
 }
 
+template< typename TPixel, unsigned int VImageDimension >
+void
+VectorImage< TPixel, VImageDimension >
+::SetMemoryPlacement(MemoryPlacement::PlacementType placement)
+{
+  m_Buffer->SetMemoryPlacement(placement);
+}
+
+template< typename TPixel, unsigned int VImageDimension >
+void
+VectorImage< TPixel, VImageDimension >
+::TouchBufferPages(const RegionType & region)
+{
+  this->TouchRegionPages( m_Buffer->GetBufferPointer(), sizeof( InternalPixelType ) * m_VectorLength, region );
+}
+
 template< typename TPixel, unsigned int VImageDimension >
 void
 VectorImage< TPixel, VImageDimension >
@@ -85,8 +102,9 @@ void
 VectorImage< TPixel, VImageDimension >
 ::FillBuffer(const PixelType & value)
 {
+  // Includes the padding of the rows, if any
   const SizeValueType numberOfPixels =
-    this->GetBufferedRegion().GetNumberOfPixels();
+    static_cast< SizeValueType >( this->GetOffsetTable()[VImageDimension] );
 
   SizeValueType ctr = 0;
 
@@ -0,0 +1,50 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkChromeTracePrivate.h"
+#include <iomanip>
+#include <sstream>
+
+namespace itk
+{
+namespace ChromeTrace
+{
+std::string JSONString(const std::string & s)
+{
+  std::ostringstream json;
+  json << '"';
+  for ( std::string::const_iterator c = s.begin(); c != s.end(); ++c )
+    {
+    if ( *c == '"' || *c == '\\' )
+      {
+      json << '\\' << *c;
+      }
+    else if ( static_cast< unsigned char >( *c ) < 0x20 )
+      {
+      json << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+           << static_cast< int >( *c ) << std::dec << std::setfill(' ');
+      }
+    else
+      {
+      json << *c;
+      }
+    }
+  json << '"';
+  return json.str();
+}
+} // end namespace ChromeTrace
+} // end namespace itk
@@ -0,0 +1,56 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkChromeTracePrivate_h
+#define __itkChromeTracePrivate_h
+
+#include "itkMacro.h"
+#include <fstream>
+#include <string>
+
+/*
+ * Helpers shared by the classes which write their timings as Chrome
+ * traces, PipelineProfiler and ThreadTimingRecorder.
+ */
+
+namespace itk
+{
+namespace ChromeTrace
+{
+/** Quote and escape s as a JSON string. */
+std::string JSONString(const std::string & s);
+
+/** Write the trace of recorder, with its WriteChromeTrace(std::ostream &),
+ * to the file fileName, throwing if it cannot be written. */
+template< typename TRecorder >
+void WriteFile(const TRecorder *recorder, const std::string & fileName)
+{
+  std::ofstream file( fileName.c_str() );
+  if ( !file )
+    {
+    itkGenericExceptionMacro(<< recorder->GetNameOfClass() << ": Cannot open " << fileName << " for writing");
+    }
+  recorder->WriteChromeTrace(file);
+  if ( !file )
+    {
+    itkGenericExceptionMacro(<< recorder->GetNameOfClass() << ": Cannot write " << fileName);
+    }
+}
+} // end namespace ChromeTrace
+} // end namespace itk
+
+#endif
@@ -0,0 +1,78 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageBufferAllocator.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkMutexLockHolder.h"
+
+#include <cstdlib>
+
+namespace itk
+{
+namespace
+{
+SimpleFastMutexLock           globalDefaultAllocatorLock;
+ImageBufferAllocator::Pointer globalDefaultAllocator;
+}
+
+void
+ImageBufferAllocator
+::SetGlobalDefaultAllocator(Self *allocator)
+{
+  MutexLockHolder< SimpleFastMutexLock > lock(globalDefaultAllocatorLock);
+  globalDefaultAllocator = allocator;
+}
+
+ImageBufferAllocator::Pointer
+ImageBufferAllocator
+::GetGlobalDefaultAllocator()
+{
+  MutexLockHolder< SimpleFastMutexLock > lock(globalDefaultAllocatorLock);
+  return globalDefaultAllocator;
+}
+
+void *
+ImageBufferAllocator
+::AllocateAligned(SizeValueType numberOfBytes, SizeValueType alignment)
+{
+  if ( alignment < sizeof( void * ) )
+    {
+    alignment = sizeof( void * );
+    }
+  // Over-allocate, and keep the address of the block just before the
+  // aligned address returned.
+  void *block = std::malloc(numberOfBytes + alignment + sizeof( void * ) - 1);
+  if ( block == ITK_NULLPTR )
+    {
+    return ITK_NULLPTR;
+    }
+  const uintptr_t first = reinterpret_cast< uintptr_t >( block ) + sizeof( void * );
+  void **         aligned = reinterpret_cast< void ** >( ( first + alignment - 1 ) & ~( alignment - 1 ) );
+  aligned[-1] = block;
+  return aligned;
+}
+
+void
+ImageBufferAllocator
+::FreeAligned(void *buffer)
+{
+  if ( buffer != ITK_NULLPTR )
+    {
+    std::free( static_cast< void ** >( buffer )[-1] );
+    }
+}
+} // end namespace itk
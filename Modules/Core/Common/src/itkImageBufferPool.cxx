@@ -0,0 +1,239 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageBufferPool.h"
+#include "itkMutexLockHolder.h"
+
+namespace itk
+{
+ImageBufferPool
+::ImageBufferPool() :
+  m_MaximumCachedBytes(256 * 1024 * 1024),
+  m_CachedBytes(0),
+  m_AllocatedBytes(0),
+  m_PeakBytes(0),
+  m_NumberOfHits(0),
+  m_NumberOfMisses(0)
+{
+}
+
+ImageBufferPool
+::~ImageBufferPool()
+{
+  this->Trim(0);
+}
+
+SizeValueType
+ImageBufferPool
+::GetBucketSize(SizeValueType numberOfBytes)
+{
+  SizeValueType step = 64;
+  if ( numberOfBytes > 4096 )
+    {
+    // a quarter of the largest power of two not above numberOfBytes
+    SizeValueType power = 4096;
+    while ( power <= numberOfBytes / 2 )
+      {
+      power *= 2;
+      }
+    step = power / 4;
+    }
+  return ( ( numberOfBytes + step - 1 ) / step ) * step;
+}
+
+void *
+ImageBufferPool
+::Allocate(SizeValueType numberOfBytes)
+{
+  const SizeValueType bucketSize = GetBucketSize(numberOfBytes);
+
+  m_Lock.Lock();
+  BucketMapType::iterator bucket = m_Buckets.find(bucketSize);
+  if ( bucket != m_Buckets.end() && !bucket->second.empty() )
+    {
+    void *block = bucket->second.back();
+    bucket->second.pop_back();
+    m_CachedBytes -= bucketSize;
+    m_AllocatedBytes += bucketSize;
+    ++m_NumberOfHits;
+    m_Lock.Unlock();
+    return block;
+    }
+  ++m_NumberOfMisses;
+  m_Lock.Unlock();
+
+  void *block = Superclass::AllocateAligned(bucketSize, 64);
+  if ( block == ITK_NULLPTR )
+    {
+    // The cached blocks may be what prevents the allocation
+    this->ReleaseCachedMemory();
+    block = Superclass::AllocateAligned(bucketSize, 64);
+    if ( block == ITK_NULLPTR )
+      {
+      return ITK_NULLPTR;
+      }
+    }
+
+  m_Lock.Lock();
+  m_AllocatedBytes += bucketSize;
+  if ( m_AllocatedBytes + m_CachedBytes > m_PeakBytes )
+    {
+    m_PeakBytes = m_AllocatedBytes + m_CachedBytes;
+    }
+  m_Lock.Unlock();
+
+  return block;
+}
+
+void
+ImageBufferPool
+::Deallocate(void *buffer, SizeValueType numberOfBytes)
+{
+  if ( buffer == ITK_NULLPTR )
+    {
+    return;
+    }
+  const SizeValueType bucketSize = GetBucketSize(numberOfBytes);
+
+  m_Lock.Lock();
+  m_AllocatedBytes -= bucketSize;
+  if ( m_CachedBytes + bucketSize <= m_MaximumCachedBytes )
+    {
+    m_Buckets[bucketSize].push_back(buffer);
+    m_CachedBytes += bucketSize;
+    buffer = ITK_NULLPTR;
+    }
+  m_Lock.Unlock();
+
+  if ( buffer )
+    {
+    Superclass::FreeAligned(buffer);
+    }
+}
+
+void
+ImageBufferPool
+::Trim(SizeValueType maximumCachedBytes)
+{
+  // Release the largest blocks first
+  BucketMapType::reverse_iterator bucket = m_Buckets.rbegin();
+  while ( m_CachedBytes > maximumCachedBytes && bucket != m_Buckets.rend() )
+    {
+    while ( m_CachedBytes > maximumCachedBytes && !bucket->second.empty() )
+      {
+      Superclass::FreeAligned( bucket->second.back() );
+      bucket->second.pop_back();
+      m_CachedBytes -= bucket->first;
+      }
+    ++bucket;
+    }
+}
+
+void
+ImageBufferPool
+::SetMaximumCachedBytes(SizeValueType maximumCachedBytes)
+{
+  MutexLockHolder< SimpleFastMutexLock > lock(m_Lock);
+  if ( m_MaximumCachedBytes != maximumCachedBytes )
+    {
+    m_MaximumCachedBytes = maximumCachedBytes;
+    this->Trim(m_MaximumCachedBytes);
+    this->Modified();
+    }
+}
+
+SizeValueType
+ImageBufferPool
+::GetMaximumCachedBytes() const
+{
+  MutexLockHolder< SimpleFastMutexLock > lock(m_Lock);
+  return m_MaximumCachedBytes;
+}
+
+void
+ImageBufferPool
+::ReleaseCachedMemory()
+{
+  MutexLockHolder< SimpleFastMutexLock > lock(m_Lock);
+  this->Trim(0);
+}
+
+SizeValueType
+ImageBufferPool
+::GetNumberOfHits() const
+{
+  MutexLockHolder< SimpleFastMutexLock > lock(m_Lock);
+  return m_NumberOfHits;
+}
+
+SizeValueType
+ImageBufferPool
+::GetNumberOfMisses() const
+{
+  MutexLockHolder< SimpleFastMutexLock > lock(m_Lock);
+  return m_NumberOfMisses;
+}
+
+SizeValueType
+ImageBufferPool
+::GetAllocatedBytes() const
+{
+  MutexLockHolder< SimpleFastMutexLock > lock(m_Lock);
+  return m_AllocatedBytes;
+}
+
+SizeValueType
+ImageBufferPool
+::GetCachedBytes() const
+{
+  MutexLockHolder< SimpleFastMutexLock > lock(m_Lock);
+  return m_CachedBytes;
+}
+
+SizeValueType
+ImageBufferPool
+::GetPeakBytes() const
+{
+  MutexLockHolder< SimpleFastMutexLock > lock(m_Lock);
+  return m_PeakBytes;
+}
+
+void
+ImageBufferPool
+::ResetStatistics()
+{
+  MutexLockHolder< SimpleFastMutexLock > lock(m_Lock);
+  m_NumberOfHits = 0;
+  m_NumberOfMisses = 0;
+  m_PeakBytes = m_AllocatedBytes + m_CachedBytes;
+}
+
+void
+ImageBufferPool
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  MutexLockHolder< SimpleFastMutexLock > lock(m_Lock);
+  os << indent << "MaximumCachedBytes: " << m_MaximumCachedBytes << std::endl;
+  os << indent << "CachedBytes: " << m_CachedBytes << std::endl;
+  os << indent << "AllocatedBytes: " << m_AllocatedBytes << std::endl;
+  os << indent << "PeakBytes: " << m_PeakBytes << std::endl;
+  os << indent << "NumberOfHits: " << m_NumberOfHits << std::endl;
+  os << indent << "NumberOfMisses: " << m_NumberOfMisses << std::endl;
+}
+} // end namespace itk
@@ -0,0 +1,208 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageRegionSplitterTiled.h"
+#include "itkMath.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace itk
+{
+
+ImageRegionSplitterTiled
+::ImageRegionSplitterTiled() :
+  m_CacheSize(256 * 1024),
+  m_PixelSize(4)
+{
+}
+
+void
+ImageRegionSplitterTiled
+::SetRadius(SizeValueType radius)
+{
+  // a single entry applies to all dimensions
+  std::vector< SizeValueType > r(1, radius);
+  if ( r != m_Radius )
+    {
+    m_Radius = r;
+    this->Modified();
+    }
+}
+
+SizeValueType
+ImageRegionSplitterTiled
+::GetRadius(unsigned int d) const
+{
+  if ( m_Radius.empty() )
+    {
+    return 0;
+    }
+  if ( m_Radius.size() == 1 )
+    {
+    return m_Radius[0];
+    }
+  return d < m_Radius.size() ? m_Radius[d] : 0;
+}
+
+void
+ImageRegionSplitterTiled
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "CacheSize: " << m_CacheSize << std::endl;
+  os << indent << "PixelSize: " << m_PixelSize << std::endl;
+  os << indent << "Radius: [";
+  for ( unsigned int d = 0; d < m_Radius.size(); ++d )
+    {
+    os << ( d > 0 ? ", " : "" ) << m_Radius[d];
+    }
+  os << "]" << std::endl;
+}
+
+unsigned int
+ImageRegionSplitterTiled
+::GetNumberOfSplitsInternal(unsigned int dim,
+                            const IndexValueType itkNotUsed(regionIndex)[],
+                            const SizeValueType regionSize[],
+                            unsigned int requestedNumber) const
+{
+  std::vector< unsigned int > splits(dim);
+  return this->ComputeSplits(dim, requestedNumber, regionSize, &splits[0]);
+}
+
+unsigned int
+ImageRegionSplitterTiled
+::GetSplitInternal(unsigned int dim,
+                   unsigned int splitI,
+                   unsigned int numberOfPieces,
+                   IndexValueType regionIndex[],
+                   SizeValueType regionSize[]) const
+{
+  std::vector< unsigned int > splits(dim);
+  numberOfPieces = this->ComputeSplits(dim, numberOfPieces, regionSize, &splits[0]);
+
+  // determine which piece we are in, the first dimension varying fastest
+  unsigned int offset = splitI;
+  for ( unsigned int i = 0; i < dim; ++i )
+    {
+    const unsigned int pieceIndex = offset % splits[i];
+    offset /= splits[i];
+
+    const SizeValueType  inputRegionSize = regionSize[i];
+    const IndexValueType indexOffset =
+      Math::Floor< IndexValueType >( pieceIndex * ( inputRegionSize / double(splits[i]) ) );
+
+    regionIndex[i] += indexOffset;
+    if ( pieceIndex < splits[i] - 1 )
+      {
+      regionSize[i] = Math::Floor< SizeValueType >( ( pieceIndex + 1 ) * ( inputRegionSize / double(splits[i]) ) )
+                      - indexOffset;
+      }
+    else
+      {
+      regionSize[i] = inputRegionSize - indexOffset;
+      }
+    }
+
+  return numberOfPieces;
+}
+
+unsigned int
+ImageRegionSplitterTiled
+::ComputeSplits(unsigned int dim,
+                unsigned int requestedNumber,
+                const SizeValueType regionSize[],
+                unsigned int splits[]) const
+{
+  if ( requestedNumber < 1 )
+    {
+    requestedNumber = 1;
+    }
+
+  for ( unsigned int d = 0; d < dim; ++d )
+    {
+    splits[d] = 1;
+    }
+
+  const unsigned int slowest = dim - 1;
+
+  // Extent of a tile in each of the cross section dimensions
+  std::vector< double > tile(slowest);
+  for ( unsigned int d = 0; d < slowest; ++d )
+    {
+    tile[d] = static_cast< double >( regionSize[d] );
+    }
+
+  // Shrink the cross section, keeping the fastest dimension for last,
+  // until the working set of the neighborhood fits into the cache.
+  const double planeBytes = ( 2.0 * this->GetRadius(slowest) + 1.0 ) * m_PixelSize;
+  for ( int d = static_cast< int >( slowest ) - 1; d >= 0; --d )
+    {
+    double otherBytes = planeBytes;
+    double workingSet = planeBytes;
+    for ( unsigned int e = 0; e < slowest; ++e )
+      {
+      const double extent = tile[e] + 2.0 * this->GetRadius(e);
+      workingSet *= extent;
+      if ( e != static_cast< unsigned int >( d ) )
+        {
+        otherBytes *= extent;
+        }
+      }
+    if ( workingSet <= m_CacheSize )
+      {
+      break;
+      }
+
+    const double maxExtent = std::floor( m_CacheSize / otherBytes ) - 2.0 * this->GetRadius(d);
+    tile[d] = std::max( 1.0, std::min( maxExtent, tile[d] ) );
+    }
+
+  // Number of tiles in the cross section
+  double numberOfTiles = 1.0;
+  for ( unsigned int d = 0; d < slowest; ++d )
+    {
+    if ( regionSize[d] > 0 )
+      {
+      splits[d] = static_cast< unsigned int >( std::min( std::ceil( regionSize[d] / tile[d] ),
+                                                        static_cast< double >( requestedNumber ) ) );
+      }
+    numberOfTiles *= splits[d];
+    }
+
+  // Merge tiles, starting with the slowest cross section dimension, until
+  // there are no more than requested
+  for ( int d = static_cast< int >( slowest ) - 1; d >= 0 && numberOfTiles > requestedNumber; --d )
+    {
+    const double otherTiles = numberOfTiles / splits[d];
+    splits[d] = static_cast< unsigned int >( std::max( 1.0, std::floor( requestedNumber / otherTiles ) ) );
+    numberOfTiles = otherTiles * splits[d];
+    }
+
+  // Use the remaining pieces to split along the slowest dimension
+  const unsigned int slowestSplits =
+    static_cast< unsigned int >( std::floor( requestedNumber / numberOfTiles ) );
+  splits[slowest] = std::max( 1u, static_cast< unsigned int >(
+                                std::min( static_cast< SizeValueType >( slowestSplits ), regionSize[slowest] ) ) );
+
+  return static_cast< unsigned int >( numberOfTiles ) * splits[slowest];
+}
+
+} // end namespace itk
@@ -0,0 +1,206 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMemoryPlacement.h"
+#include "itksys/SystemTools.hxx"
+
+#if defined( WIN32 ) || defined( _WIN32 )
+  #include "itkWindows.h"
+#else
+  #include <sys/mman.h>
+  #include <unistd.h>
+  #if defined( __linux__ )
+    #include <sys/syscall.h>
+    #include <errno.h>
+  #endif
+#endif
+
+namespace itk
+{
+namespace
+{
+MemoryPlacement::PlacementType globalDefaultPlacement = MemoryPlacement::DefaultPlacement;
+bool                           globalDefaultPlacementIsInitialized = false;
+}
+
+void
+MemoryPlacement
+::SetGlobalDefaultPlacement(PlacementType placement)
+{
+  globalDefaultPlacement = placement;
+  globalDefaultPlacementIsInitialized = true;
+}
+
+MemoryPlacement::PlacementType
+MemoryPlacement
+::GetGlobalDefaultPlacement()
+{
+  if ( !globalDefaultPlacementIsInitialized )
+    {
+    itksys_stl::string itkMemoryPlacementEnv;
+    if ( itksys::SystemTools::GetEnv("ITK_MEMORY_PLACEMENT", itkMemoryPlacementEnv) )
+      {
+      itkMemoryPlacementEnv = itksys::SystemTools::UpperCase(itkMemoryPlacementEnv);
+      if ( itkMemoryPlacementEnv == "FIRSTTOUCH" )
+        {
+        globalDefaultPlacement = FirstTouchPlacement;
+        }
+      else if ( itkMemoryPlacementEnv == "INTERLEAVED" )
+        {
+        globalDefaultPlacement = InterleavedPlacement;
+        }
+      }
+    globalDefaultPlacementIsInitialized = true;
+    }
+  return globalDefaultPlacement;
+}
+
+SizeValueType
+MemoryPlacement
+::GetPageSize()
+{
+  static SizeValueType pageSize = 0;
+  if ( pageSize == 0 )
+    {
+#if defined( WIN32 ) || defined( _WIN32 )
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    pageSize = static_cast< SizeValueType >( info.dwPageSize );
+#else
+    pageSize = static_cast< SizeValueType >( sysconf(_SC_PAGESIZE) );
+#endif
+    }
+  return pageSize;
+}
+
+void *
+MemoryPlacement
+::AllocatePages(SizeValueType numberOfBytes)
+{
+  if ( numberOfBytes == 0 )
+    {
+    return ITK_NULLPTR;
+    }
+#if defined( WIN32 ) || defined( _WIN32 )
+  // Committed pages are only given physical memory when first touched
+  return VirtualAlloc(ITK_NULLPTR, numberOfBytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+  void *pages = mmap(ITK_NULLPTR, numberOfBytes, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANON, -1, 0);
+  if ( pages == MAP_FAILED )
+    {
+    return ITK_NULLPTR;
+    }
+  return pages;
+#endif
+}
+
+void
+MemoryPlacement
+::FreePages(void *pages, SizeValueType numberOfBytes)
+{
+  if ( pages == ITK_NULLPTR )
+    {
+    return;
+    }
+#if defined( WIN32 ) || defined( _WIN32 )
+  (void)numberOfBytes;
+  VirtualFree(pages, 0, MEM_RELEASE);
+#else
+  munmap(pages, numberOfBytes);
+#endif
+}
+
+bool
+MemoryPlacement
+::InterleavePages(void *pages, SizeValueType numberOfBytes)
+{
+#if defined( __linux__ ) && defined( SYS_mbind )
+  // Value of MPOL_INTERLEAVE in <linux/mempolicy.h>, which is not
+  // installed everywhere.
+  const int mpolInterleave = 3;
+
+  // Request all the nodes; the kernel restricts the mask to the nodes
+  // with memory the process is allowed to use. Kernels supporting fewer
+  // nodes than the mask reject it, so retry with smaller ones.
+  unsigned long nodeMask[1024 / ( 8 * sizeof( unsigned long ) )];
+  for ( unsigned int i = 0; i < sizeof( nodeMask ) / sizeof( unsigned long ); ++i )
+    {
+    nodeMask[i] = ~0UL;
+    }
+  for ( unsigned long maxNode = 8 * sizeof( nodeMask ); maxNode >= 8 * sizeof( unsigned long ); maxNode /= 2 )
+    {
+    if ( syscall(SYS_mbind, pages, numberOfBytes, mpolInterleave, nodeMask, maxNode + 1, 0) == 0 )
+      {
+      return true;
+      }
+    if ( errno != EINVAL )
+      {
+      break;
+      }
+    }
+  return false;
+#else
+  (void)pages;
+  (void)numberOfBytes;
+  return false;
+#endif
+}
+
+void
+MemoryPlacement
+::TouchPages(void *begin, SizeValueType numberOfBytes)
+{
+  const SizeValueType pageSize = GetPageSize();
+  char *              first = static_cast< char * >( begin );
+  char *const         end = first + numberOfBytes;
+
+  // Start with the first page boundary in the range, so that concurrent
+  // calls on adjacent ranges never touch the same byte.
+  const SizeValueType misalignment = reinterpret_cast< uintptr_t >( first ) % pageSize;
+  if ( misalignment != 0 )
+    {
+    first += pageSize - misalignment;
+    }
+
+  for ( char *p = first; p < end; p += pageSize )
+    {
+    volatile char *v = p;
+    *v = *v;
+    }
+}
+
+std::ostream &
+operator<<(std::ostream & os, MemoryPlacement::PlacementType placement)
+{
+  switch ( placement )
+    {
+    case MemoryPlacement::DefaultPlacement:
+      os << "DefaultPlacement";
+      break;
+    case MemoryPlacement::FirstTouchPlacement:
+      os << "FirstTouchPlacement";
+      break;
+    case MemoryPlacement::InterleavedPlacement:
+      os << "InterleavedPlacement";
+      break;
+    default:
+      os << "Unknown placement " << static_cast< int >( placement );
+    }
+  return os;
+}
+} // end namespace itk
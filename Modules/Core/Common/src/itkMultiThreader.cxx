@@ -26,6 +26,7 @@
  *
  *=========================================================================*/
 #include "itkMultiThreader.h"
+#include "itkThreadPool.h"
 #include "itkNumericTraits.h"
 #include <iostream>
 #include <algorithm>
@@ -48,6 +49,35 @@ ThreadIdType MultiThreader:: m_GlobalMaximumNumberOfThreads = ITK_MAX_THREADS;
 // => Not initialized.
 ThreadIdType MultiThreader:: m_GlobalDefaultNumberOfThreads = 0;
 
+// Initialize static members that control the default use of the thread
+// pool. The environment is only queried on first use.
+bool MultiThreader:: m_GlobalDefaultUseThreadPool = false;
+bool MultiThreader:: m_GlobalDefaultUseThreadPoolIsInitialized = false;
+
+void MultiThreader::SetGlobalDefaultUseThreadPool(bool useThreadPool)
+{
+  m_GlobalDefaultUseThreadPool = useThreadPool;
+  m_GlobalDefaultUseThreadPoolIsInitialized = true;
+}
+
+bool MultiThreader::GetGlobalDefaultUseThreadPool()
+{
+  if ( !m_GlobalDefaultUseThreadPoolIsInitialized )
+    {
+    itksys_stl::string itkUseThreadPoolEnv;
+    if ( itksys::SystemTools::GetEnv("ITK_USE_THREADPOOL", itkUseThreadPoolEnv) )
+      {
+      itkUseThreadPoolEnv = itksys::SystemTools::UpperCase(itkUseThreadPoolEnv);
+      m_GlobalDefaultUseThreadPool = ( itkUseThreadPoolEnv == "ON"
+                                       || itkUseThreadPoolEnv == "TRUE"
+                                       || itkUseThreadPoolEnv == "YES"
+                                       || itkUseThreadPoolEnv == "1" );
+      }
+    m_GlobalDefaultUseThreadPoolIsInitialized = true;
+    }
+  return m_GlobalDefaultUseThreadPool;
+}
+
 void MultiThreader::SetGlobalMaximumNumberOfThreads(ThreadIdType val)
 {
   m_GlobalMaximumNumberOfThreads = val;
@@ -201,6 +231,7 @@ MultiThreader::MultiThreader()
   m_SingleMethod = ITK_NULLPTR;
   m_SingleData = ITK_NULLPTR;
   m_NumberOfThreads = this->GetGlobalDefaultNumberOfThreads();
+  m_UseThreadPool = this->GetGlobalDefaultUseThreadPool();
 }
 
 MultiThreader::~MultiThreader()
@@ -237,6 +268,8 @@ void MultiThreader::SingleMethodExecute()
 {
   ThreadIdType                 thread_loop = 0;
   ThreadProcessIDType process_id[ITK_MAX_THREADS];
+  ThreadPool::ThreadJobIdType  job_id[ITK_MAX_THREADS];
+  ThreadPool::Pointer          threadPool;
 
   if ( !m_SingleMethod )
     {
@@ -246,6 +279,11 @@ void MultiThreader::SingleMethodExecute()
   // obey the global maximum number of threads limit
   m_NumberOfThreads = std::min( m_GlobalMaximumNumberOfThreads, m_NumberOfThreads );
 
+  if ( m_UseThreadPool && m_NumberOfThreads > 1 )
+    {
+    threadPool = ThreadPool::GetInstance();
+    }
+
   // Spawn a set of threads through the SingleMethodProxy. Exceptions
   // thrown from a thread will be caught by the SingleMethodProxy. A
   // naive mechanism is in place for determining whether a thread
@@ -263,8 +301,18 @@ void MultiThreader::SingleMethodExecute()
       m_ThreadInfoArray[thread_loop].NumberOfThreads = m_NumberOfThreads;
       m_ThreadInfoArray[thread_loop].ThreadFunction = m_SingleMethod;
 
-      process_id[thread_loop] =
-        this->DispatchSingleMethodThread(&m_ThreadInfoArray[thread_loop]);
+      if ( threadPool )
+        {
+        ThreadPool::ThreadJob job;
+        job.m_ThreadFunction = this->SingleMethodProxy;
+        job.m_UserData = &m_ThreadInfoArray[thread_loop];
+        job_id[thread_loop] = threadPool->AddWork(job);
+        }
+      else
+        {
+        process_id[thread_loop] =
+          this->DispatchSingleMethodThread(&m_ThreadInfoArray[thread_loop]);
+        }
       }
     }
   catch ( std::exception & e )
@@ -299,7 +347,14 @@ void MultiThreader::SingleMethodExecute()
       {
       try
         {
-        this->WaitForSingleMethodThread(process_id[thread_loop]);
+        if ( threadPool )
+          {
+          threadPool->WaitForJob(job_id[thread_loop]);
+          }
+        else
+          {
+          this->WaitForSingleMethodThread(process_id[thread_loop]);
+          }
         }
       catch ( ... )
               {}
@@ -328,7 +383,14 @@ void MultiThreader::SingleMethodExecute()
     {
     try
       {
-      this->WaitForSingleMethodThread(process_id[thread_loop]);
+      if ( threadPool )
+        {
+        threadPool->WaitForJob(job_id[thread_loop]);
+        }
+      else
+        {
+        this->WaitForSingleMethodThread(process_id[thread_loop]);
+        }
       if ( m_ThreadInfoArray[thread_loop].ThreadExitCode
            != ThreadInfoStruct::SUCCESS )
         {
@@ -406,6 +468,7 @@ void MultiThreader::PrintSelf(std::ostream & os, Indent indent) const
      << m_GlobalMaximumNumberOfThreads << std::endl;
   os << indent << "Global Default Number Of Threads: "
      << m_GlobalDefaultNumberOfThreads << std::endl;
+  os << indent << "Use Thread Pool: " << m_UseThreadPool << std::endl;
 }
 
 
@@ -0,0 +1,490 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkPipelineProfiler.h"
+#include "itkCommand.h"
+#include "itkMutexLockHolder.h"
+#include "itkChromeTracePrivate.h"
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+
+namespace itk
+{
+namespace
+{
+// Order of the observer tags in a record
+enum { StartTag = 0, EndTag, AbortTag, ProgressTag, DeleteTag };
+
+// Records sorted by decreasing wall time
+struct SlowerThan
+{
+  SlowerThan(const std::vector< double > & wallTimes) : m_WallTimes(wallTimes) {}
+  bool operator()(SizeValueType a, SizeValueType b) const
+  {
+    return m_WallTimes[a] > m_WallTimes[b];
+  }
+  const std::vector< double > & m_WallTimes;
+};
+}
+
+PipelineProfiler
+::PipelineProfiler()
+{
+  m_Clock = RealTimeClock::New();
+  m_Origin = m_Clock->GetTimeInSeconds();
+}
+
+PipelineProfiler
+::~PipelineProfiler()
+{
+  this->Detach();
+}
+
+void
+PipelineProfiler
+::AttachToProcessObject(ProcessObject *processObject)
+{
+  if ( !processObject )
+    {
+    return;
+    }
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  const SizeValueType index = this->FindRecord(processObject);
+  if ( index < m_Records.size() && m_Records[index].Attached )
+    {
+    return;
+    }
+
+  typedef MemberCommand< Self > CommandType;
+  CommandType::Pointer command = CommandType::New();
+  command->SetCallbackFunction(this, &Self::ProcessEvent);
+  command->SetCallbackFunction(this, &Self::ProcessConstEvent);
+
+  ProcessObjectRecord record;
+  record.Source = processObject;
+  record.Name = processObject->GetObjectName().empty() ?
+                std::string( processObject->GetNameOfClass() ) : processObject->GetObjectName();
+  record.Attached = true;
+  record.ObserverTags[StartTag] = processObject->AddObserver(StartEvent(), command);
+  record.ObserverTags[EndTag] = processObject->AddObserver(EndEvent(), command);
+  record.ObserverTags[AbortTag] = processObject->AddObserver(AbortEvent(), command);
+  record.ObserverTags[ProgressTag] = processObject->AddObserver(ProgressEvent(), command);
+  record.ObserverTags[DeleteTag] = processObject->AddObserver(DeleteEvent(), command);
+  record.NumberOfExecutions = 0;
+  record.WallTime = 0.0;
+  record.CPUTime = 0.0;
+  record.PeakMemoryUsage = 0;
+  record.NumberOfThreads = processObject->GetNumberOfThreads();
+  record.Running = false;
+  record.StartWallTime = 0.0;
+  record.StartCPUTime = 0.0;
+  record.StartMemoryUsage = 0;
+  record.ExecutionPeakMemoryUsage = 0;
+  record.Thread = 0;
+
+  if ( index < m_Records.size() )
+    {
+    // attached again after Detach(), the measures are kept
+    record.NumberOfExecutions = m_Records[index].NumberOfExecutions;
+    record.WallTime = m_Records[index].WallTime;
+    record.CPUTime = m_Records[index].CPUTime;
+    record.PeakMemoryUsage = m_Records[index].PeakMemoryUsage;
+    m_Records[index] = record;
+    }
+  else
+    {
+    m_Records.push_back(record);
+    }
+  this->Modified();
+}
+
+void
+PipelineProfiler
+::AttachToPipeline(const DataObject *output)
+{
+  if ( !output )
+    {
+    return;
+    }
+  std::vector< ProcessObject::Pointer > sources;
+  ProcessObject::Pointer                source = output->GetSource().GetPointer();
+  if ( source.IsNotNull() )
+    {
+    sources.push_back(source);
+    }
+  while ( !sources.empty() )
+    {
+    ProcessObject::Pointer processObject = sources.back();
+    sources.pop_back();
+    {
+    MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+    const SizeValueType index = this->FindRecord(processObject);
+    if ( index < m_Records.size() && m_Records[index].Attached )
+      {
+      // already visited, along with the process objects upstream of it
+      continue;
+      }
+    }
+    this->AttachToProcessObject(processObject);
+
+    ProcessObject::DataObjectPointerArray inputs = processObject->GetInputs();
+    for ( ProcessObject::DataObjectPointerArray::const_iterator it = inputs.begin(); it != inputs.end(); ++it )
+      {
+      if ( it->IsNotNull() )
+        {
+        ProcessObject::Pointer inputSource = ( *it )->GetSource().GetPointer();
+        if ( inputSource.IsNotNull() )
+          {
+          sources.push_back(inputSource);
+          }
+        }
+      }
+    }
+}
+
+void
+PipelineProfiler
+::Detach()
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  for ( std::vector< ProcessObjectRecord >::iterator it = m_Records.begin(); it != m_Records.end(); ++it )
+    {
+    if ( it->Attached )
+      {
+      this->RemoveObservers(*it);
+      }
+    }
+}
+
+void
+PipelineProfiler
+::Reset()
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  std::vector< ProcessObjectRecord > attached;
+  for ( std::vector< ProcessObjectRecord >::iterator it = m_Records.begin(); it != m_Records.end(); ++it )
+    {
+    if ( it->Attached )
+      {
+      it->NumberOfExecutions = 0;
+      it->WallTime = 0.0;
+      it->CPUTime = 0.0;
+      it->PeakMemoryUsage = 0;
+      it->Running = false;
+      attached.push_back(*it);
+      }
+    }
+  m_Records.swap(attached);
+  m_Executions.clear();
+  m_Threads.clear();
+  m_Origin = m_Clock->GetTimeInSeconds();
+  this->Modified();
+}
+
+SizeValueType
+PipelineProfiler
+::GetNumberOfProcessObjects() const
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  return m_Records.size();
+}
+
+SizeValueType
+PipelineProfiler
+::GetNumberOfExecutions(const ProcessObject *processObject) const
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  const SizeValueType index = this->FindRecord(processObject);
+  return index < m_Records.size() ? m_Records[index].NumberOfExecutions : 0;
+}
+
+PipelineProfiler::TimeStampType
+PipelineProfiler
+::GetWallTime(const ProcessObject *processObject) const
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  const SizeValueType index = this->FindRecord(processObject);
+  return index < m_Records.size() ? m_Records[index].WallTime : 0.0;
+}
+
+PipelineProfiler::TimeStampType
+PipelineProfiler
+::GetCPUTime(const ProcessObject *processObject) const
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  const SizeValueType index = this->FindRecord(processObject);
+  return index < m_Records.size() ? m_Records[index].CPUTime : 0.0;
+}
+
+PipelineProfiler::MemoryLoadType
+PipelineProfiler
+::GetPeakMemoryUsage(const ProcessObject *processObject) const
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  const SizeValueType index = this->FindRecord(processObject);
+  return index < m_Records.size() ? m_Records[index].PeakMemoryUsage : 0;
+}
+
+void
+PipelineProfiler
+::ProcessEvent(Object *caller, const EventObject & event)
+{
+  this->ProcessConstEvent(caller, event);
+}
+
+void
+PipelineProfiler
+::ProcessConstEvent(const Object *caller, const EventObject & event)
+{
+  const ProcessObject *processObject = static_cast< const ProcessObject * >( caller );
+
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  const SizeValueType index = this->FindRecord(processObject);
+  if ( index >= m_Records.size() )
+    {
+    return;
+    }
+  ProcessObjectRecord & record = m_Records[index];
+
+  if ( DeleteEvent().CheckEvent(&event) )
+    {
+    // the observers are deleted along with the process object
+    record.Attached = false;
+    record.Running = false;
+    record.Source = ITK_NULLPTR;
+    return;
+    }
+
+  const MemoryLoadType memoryUsage = m_MemoryObserver.GetMemoryUsage();
+  if ( StartEvent().CheckEvent(&event) )
+    {
+    // an execution which threw an exception has no EndEvent, and is
+    // discarded
+    record.Running = true;
+    record.StartMemoryUsage = memoryUsage;
+    record.ExecutionPeakMemoryUsage = memoryUsage;
+    record.NumberOfThreads = processObject->GetNumberOfThreads();
+    record.Thread = this->GetCurrentThreadIndex();
+    record.StartCPUTime = this->GetProcessCPUTime();
+    record.StartWallTime = m_Clock->GetTimeInSeconds();
+    return;
+    }
+  if ( !record.Running )
+    {
+    return;
+    }
+  record.ExecutionPeakMemoryUsage = std::max(record.ExecutionPeakMemoryUsage, memoryUsage);
+  if ( ProgressEvent().CheckEvent(&event) )
+    {
+    return;
+    }
+
+  // EndEvent or AbortEvent
+  ExecutionRecord execution;
+  execution.Record = index;
+  execution.StartWallTime = record.StartWallTime - m_Origin;
+  execution.WallTime = m_Clock->GetTimeInSeconds() - record.StartWallTime;
+  execution.CPUTime = this->GetProcessCPUTime() - record.StartCPUTime;
+  execution.StartMemoryUsage = record.StartMemoryUsage;
+  execution.PeakMemoryUsage = record.ExecutionPeakMemoryUsage;
+  execution.Thread = record.Thread;
+  m_Executions.push_back(execution);
+
+  record.Running = false;
+  ++record.NumberOfExecutions;
+  record.WallTime += execution.WallTime;
+  record.CPUTime += execution.CPUTime;
+  record.PeakMemoryUsage = std::max(record.PeakMemoryUsage, execution.PeakMemoryUsage);
+}
+
+SizeValueType
+PipelineProfiler
+::FindRecord(const ProcessObject *processObject) const
+{
+  SizeValueType index = 0;
+  while ( index < m_Records.size() && m_Records[index].Source != processObject )
+    {
+    ++index;
+    }
+  return index;
+}
+
+unsigned int
+PipelineProfiler
+::GetCurrentThreadIndex()
+{
+#if defined( ITK_USE_PTHREADS )
+  const ThreadIdentifierType thread = pthread_self();
+  for ( unsigned int t = 0; t < m_Threads.size(); ++t )
+    {
+    if ( pthread_equal(m_Threads[t], thread) )
+      {
+      return t;
+      }
+    }
+#elif defined( ITK_USE_WIN32_THREADS )
+  const ThreadIdentifierType thread = GetCurrentThreadId();
+  for ( unsigned int t = 0; t < m_Threads.size(); ++t )
+    {
+    if ( m_Threads[t] == thread )
+      {
+      return t;
+      }
+    }
+#else
+  const ThreadIdentifierType thread = 0;
+  if ( !m_Threads.empty() )
+    {
+    return 0;
+    }
+#endif
+  m_Threads.push_back(thread);
+  return static_cast< unsigned int >( m_Threads.size() - 1 );
+}
+
+void
+PipelineProfiler
+::RemoveObservers(ProcessObjectRecord & record)
+{
+  for ( unsigned int t = 0; t < 5; ++t )
+    {
+    record.Source->RemoveObserver(record.ObserverTags[t]);
+    }
+  record.Attached = false;
+  record.Running = false;
+}
+
+PipelineProfiler::TimeStampType
+PipelineProfiler
+::GetProcessCPUTime() const
+{
+  return static_cast< TimeStampType >( std::clock() ) / CLOCKS_PER_SEC;
+}
+
+void
+PipelineProfiler
+::Report(std::ostream & os) const
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  if ( m_Records.empty() )
+    {
+    os << "No process objects have been measured" << std::endl;
+    return;
+    }
+
+  std::vector< double >        wallTimes(m_Records.size());
+  std::vector< SizeValueType > order(m_Records.size());
+  double                       totalWallTime = 0.0;
+  for ( SizeValueType r = 0; r < m_Records.size(); ++r )
+    {
+    wallTimes[r] = m_Records[r].WallTime;
+    order[r] = r;
+    totalWallTime += wallTimes[r];
+    }
+  std::stable_sort( order.begin(), order.end(), SlowerThan(wallTimes) );
+
+  const std::ios::fmtflags flags = os.flags();
+  os << std::left;
+  os.width(40);
+  os << " Process Object ";
+  os << std::right;
+  os.width(10);
+  os << " Runs ";
+  os.width(9);
+  os << " Threads ";
+  os.width(14);
+  os << " Wall (s) ";
+  os.width(8);
+  os << " % ";
+  os.width(14);
+  os << " CPU (s) ";
+  os.width(16);
+  os << " Peak (kB) ";
+  os << std::endl;
+
+  for ( std::vector< SizeValueType >::const_iterator it = order.begin(); it != order.end(); ++it )
+    {
+    const ProcessObjectRecord & record = m_Records[*it];
+    os << std::left;
+    os.width(40);
+    os << record.Name;
+    os << std::right << std::fixed;
+    os.width(10);
+    os << record.NumberOfExecutions;
+    os.width(9);
+    os << record.NumberOfThreads;
+    os.width(14);
+    os << std::setprecision(6) << record.WallTime;
+    os.width(8);
+    os << std::setprecision(1) << ( totalWallTime > 0.0 ? 100.0 * record.WallTime / totalWallTime : 0.0 );
+    os.width(14);
+    os << std::setprecision(6) << record.CPUTime;
+    os.width(16);
+    os << record.PeakMemoryUsage;
+    os << std::endl;
+    }
+  os.flags(flags);
+}
+
+void
+PipelineProfiler
+::WriteChromeTrace(std::ostream & os) const
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  const std::ios::fmtflags flags = os.flags();
+  os << std::fixed << std::setprecision(3);
+  os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  for ( SizeValueType e = 0; e < m_Executions.size(); ++e )
+    {
+    const ExecutionRecord &     execution = m_Executions[e];
+    const ProcessObjectRecord & record = m_Records[execution.Record];
+    // complete events, with times in microseconds
+    os << ( e == 0 ? "\n" : ",\n" )
+       << "{\"name\":" << ChromeTrace::JSONString(record.Name)
+       << ",\"cat\":\"ProcessObject\",\"ph\":\"X\",\"pid\":0"
+       << ",\"tid\":" << execution.Thread
+       << ",\"ts\":" << 1.0e6 * execution.StartWallTime
+       << ",\"dur\":" << 1.0e6 * execution.WallTime
+       << ",\"args\":{\"cpu_ms\":" << 1.0e3 * execution.CPUTime
+       << ",\"threads\":" << record.NumberOfThreads
+       << ",\"start_memory_kB\":" << execution.StartMemoryUsage
+       << ",\"peak_memory_kB\":" << execution.PeakMemoryUsage
+       << "}}";
+    }
+  os << "\n]}" << std::endl;
+  os.flags(flags);
+}
+
+void
+PipelineProfiler
+::WriteChromeTrace(const std::string & fileName) const
+{
+  ChromeTrace::WriteFile(this, fileName);
+}
+
+void
+PipelineProfiler
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  os << indent << "NumberOfProcessObjects: " << m_Records.size() << std::endl;
+  os << indent << "NumberOfExecutions: " << m_Executions.size() << std::endl;
+  os << indent << "NumberOfThreads: " << m_Threads.size() << std::endl;
+}
+} // end namespace itk
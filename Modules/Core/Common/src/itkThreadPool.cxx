@@ -0,0 +1,230 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkThreadPool.h"
+#include "itkSimpleFastMutexLock.h"
+
+namespace itk
+{
+namespace
+{
+// The process-wide instance. It is destroyed, and its workers joined, at
+// program exit.
+ThreadPool::Pointer   threadPoolInstance;
+SimpleFastMutexLock   threadPoolInstanceLock;
+}
+
+ThreadPool::Pointer
+ThreadPool
+::New()
+{
+  return Self::GetInstance();
+}
+
+ThreadPool::Pointer
+ThreadPool
+::GetInstance()
+{
+  threadPoolInstanceLock.Lock();
+  if ( threadPoolInstance.IsNull() )
+    {
+    threadPoolInstance = new ThreadPool;
+    // Remove the extra reference added by the constructor
+    threadPoolInstance->UnRegister();
+    }
+  threadPoolInstanceLock.Unlock();
+  return threadPoolInstance;
+}
+
+ThreadPool
+::ThreadPool() :
+  m_NumberOfThreads(0),
+  m_NumberOfIdleThreads(0),
+  m_NextJobId(0),
+  m_StopThreads(false)
+{
+  m_Threader = MultiThreader::New();
+  m_WorkAvailable = ConditionVariable::New();
+  m_JobCompleted = ConditionVariable::New();
+}
+
+ThreadPool
+::~ThreadPool()
+{
+  m_Mutex.Lock();
+  m_StopThreads = true;
+  m_WorkAvailable->Broadcast();
+  m_Mutex.Unlock();
+
+  for ( ThreadIdType i = 0; i < m_NumberOfThreads; ++i )
+    {
+    try
+      {
+      m_Threader->TerminateThread(m_ThreadIds[i]);
+      }
+    catch ( ... )
+      {
+      }
+    }
+}
+
+void
+ThreadPool
+::AddThread()
+{
+#if defined( ITK_USE_PTHREADS ) || defined( ITK_USE_WIN32_THREADS )
+  m_ThreadIds[m_NumberOfThreads] = m_Threader->SpawnThread(Self::ThreadExecute, this);
+  ++m_NumberOfThreads;
+#endif
+}
+
+ThreadPool::ThreadJobIdType
+ThreadPool
+::AddWork(const ThreadJob & job)
+{
+  m_Mutex.Lock();
+
+  QueuedJob queued;
+  queued.m_Id = m_NextJobId++;
+  queued.m_Job = job;
+  m_JobQueue.push_back(queued);
+
+  // Only grow the pool when no worker is available to take the job. If the
+  // pool can not grow, the job is eventually run by WaitForJob().
+  if ( m_NumberOfIdleThreads < m_JobQueue.size()
+       && m_NumberOfThreads < ITK_MAX_THREADS )
+    {
+    try
+      {
+      this->AddThread();
+      }
+    catch ( ... )
+      {
+      itkWarningMacro(<< "Unable to add a thread to the pool, "
+                      << m_NumberOfThreads << " threads are in use.");
+      }
+    }
+  m_WorkAvailable->Signal();
+  m_Mutex.Unlock();
+
+  return queued.m_Id;
+}
+
+void
+ThreadPool
+::WaitForJob(ThreadJobIdType id)
+{
+  m_Mutex.Lock();
+
+  // If the job has not been started yet, do it here.
+  for ( JobQueueType::iterator it = m_JobQueue.begin(); it != m_JobQueue.end(); ++it )
+    {
+    if ( it->m_Id == id )
+      {
+      const QueuedJob job = *it;
+      m_JobQueue.erase(it);
+      m_Mutex.Unlock();
+      this->ExecuteJob(job);
+      m_Mutex.Lock();
+      break;
+      }
+    }
+
+  while ( m_CompletedJobs.find(id) == m_CompletedJobs.end() )
+    {
+    m_JobCompleted->Wait(&m_Mutex);
+    }
+  m_CompletedJobs.erase(id);
+
+  m_Mutex.Unlock();
+}
+
+ThreadIdType
+ThreadPool
+::GetNumberOfThreads() const
+{
+  m_Mutex.Lock();
+  const ThreadIdType numberOfThreads = m_NumberOfThreads;
+  m_Mutex.Unlock();
+  return numberOfThreads;
+}
+
+void
+ThreadPool
+::ExecuteJob(const QueuedJob & job)
+{
+  // The MultiThreader submits its SingleMethodProxy, which already reports
+  // exceptions through the ThreadInfoStruct. Anything else escaping a job
+  // must not take down the worker.
+  try
+    {
+    ( *job.m_Job.m_ThreadFunction )( job.m_Job.m_UserData );
+    }
+  catch ( ... )
+    {
+    }
+
+  m_Mutex.Lock();
+  m_CompletedJobs.insert(job.m_Id);
+  m_JobCompleted->Broadcast();
+  m_Mutex.Unlock();
+}
+
+ITK_THREAD_RETURN_TYPE
+ThreadPool
+::ThreadExecute(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *threadInfo =
+    static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  ThreadPool *pool = static_cast< ThreadPool * >( threadInfo->UserData );
+
+  pool->m_Mutex.Lock();
+  while ( true )
+    {
+    while ( !pool->m_StopThreads && pool->m_JobQueue.empty() )
+      {
+      ++pool->m_NumberOfIdleThreads;
+      pool->m_WorkAvailable->Wait(&pool->m_Mutex);
+      --pool->m_NumberOfIdleThreads;
+      }
+    if ( pool->m_StopThreads )
+      {
+      break;
+      }
+
+    const QueuedJob job = pool->m_JobQueue.front();
+    pool->m_JobQueue.pop_front();
+    pool->m_Mutex.Unlock();
+
+    pool->ExecuteJob(job);
+
+    pool->m_Mutex.Lock();
+    }
+  pool->m_Mutex.Unlock();
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void
+ThreadPool
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfThreads: " << this->GetNumberOfThreads() << std::endl;
+}
+}  // end namespace itk
@@ -0,0 +1,296 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkThreadTimingRecorder.h"
+#include "itkMutexLockHolder.h"
+#include "itkChromeTracePrivate.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace itk
+{
+ThreadTimingRecorder::Pointer ThreadTimingRecorder::m_GlobalRecorder;
+
+ThreadTimingRecorder
+::ThreadTimingRecorder()
+{
+  m_Clock = RealTimeClock::New();
+  m_Origin = m_Clock->GetTimeInSeconds();
+}
+
+void
+ThreadTimingRecorder
+::SetGlobalRecorder(Self *recorder)
+{
+  m_GlobalRecorder = recorder;
+}
+
+ThreadTimingRecorder *
+ThreadTimingRecorder
+::GetGlobalRecorder()
+{
+  return m_GlobalRecorder.GetPointer();
+}
+
+ThreadTimingRecorder::ExecutionRecord *
+ThreadTimingRecorder
+::StartExecution(const Object *processObject, ThreadIdType numberOfThreads)
+{
+  ThreadRecord thread;
+  thread.StartTime = 0.0;
+  thread.StopTime = 0.0;
+  thread.BusyTime = 0.0;
+  thread.NumberOfPixels = 0;
+  thread.NumberOfPieces = 0;
+
+  ExecutionRecord execution;
+  execution.Name = processObject->GetObjectName().empty() ?
+                   std::string( processObject->GetNameOfClass() ) : processObject->GetObjectName();
+  execution.Threads.resize(numberOfThreads, thread);
+
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  execution.StartTime = this->GetTime();
+  execution.StopTime = execution.StartTime;
+  m_Executions.push_back(execution);
+  return &m_Executions.back();
+}
+
+void
+ThreadTimingRecorder
+::RecordPiece(ExecutionRecord *execution, ThreadIdType threadId,
+              TimeStampType startTime, TimeStampType stopTime,
+              SizeValueType numberOfPixels) const
+{
+  ThreadRecord & thread = execution->Threads[threadId];
+  if ( thread.NumberOfPieces == 0 )
+    {
+    thread.StartTime = startTime;
+    }
+  thread.StopTime = stopTime;
+  thread.BusyTime += stopTime - startTime;
+  thread.NumberOfPixels += numberOfPixels;
+  ++thread.NumberOfPieces;
+}
+
+void
+ThreadTimingRecorder
+::StopExecution(ExecutionRecord *execution)
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  execution->StopTime = this->GetTime();
+}
+
+ThreadTimingRecorder::TimeStampType
+ThreadTimingRecorder
+::GetTime() const
+{
+  return m_Clock->GetTimeInSeconds() - m_Origin;
+}
+
+SizeValueType
+ThreadTimingRecorder
+::GetNumberOfExecutions() const
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  return m_Executions.size();
+}
+
+const ThreadTimingRecorder::ExecutionRecord &
+ThreadTimingRecorder
+::GetExecution(SizeValueType execution) const
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  if ( execution >= m_Executions.size() )
+    {
+    itkExceptionMacro(<< "Execution " << execution << " requested out of "
+                      << m_Executions.size());
+    }
+  return m_Executions[execution];
+}
+
+double
+ThreadTimingRecorder
+::GetImbalanceRatio(SizeValueType execution) const
+{
+  const std::vector< ThreadRecord > & threads = this->GetExecution(execution).Threads;
+  TimeStampType maximum = 0.0;
+  TimeStampType sum = 0.0;
+  for ( std::vector< ThreadRecord >::const_iterator it = threads.begin(); it != threads.end(); ++it )
+    {
+    maximum = std::max(maximum, it->BusyTime);
+    sum += it->BusyTime;
+    }
+  return sum > 0.0 ? maximum * threads.size() / sum : 1.0;
+}
+
+double
+ThreadTimingRecorder
+::GetPixelImbalanceRatio(SizeValueType execution) const
+{
+  const std::vector< ThreadRecord > & threads = this->GetExecution(execution).Threads;
+  SizeValueType maximum = 0;
+  SizeValueType sum = 0;
+  for ( std::vector< ThreadRecord >::const_iterator it = threads.begin(); it != threads.end(); ++it )
+    {
+    maximum = std::max(maximum, it->NumberOfPixels);
+    sum += it->NumberOfPixels;
+    }
+  return sum > 0 ? static_cast< double >( maximum ) * threads.size() / sum : 1.0;
+}
+
+void
+ThreadTimingRecorder
+::Reset()
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  m_Executions.clear();
+  m_Origin = m_Clock->GetTimeInSeconds();
+  this->Modified();
+}
+
+void
+ThreadTimingRecorder
+::Report(std::ostream & os) const
+{
+  const SizeValueType numberOfExecutions = this->GetNumberOfExecutions();
+  if ( numberOfExecutions == 0 )
+    {
+    os << "No executions have been recorded" << std::endl;
+    return;
+    }
+
+  const std::ios::fmtflags flags = os.flags();
+  os << std::right;
+  os.width(8);
+  os << " # ";
+  os << std::left;
+  os.width(36);
+  os << " Process Object ";
+  os << std::right;
+  os.width(9);
+  os << " Threads ";
+  os.width(12);
+  os << " Wall (s) ";
+  os.width(12);
+  os << " Min (s) ";
+  os.width(12);
+  os << " Mean (s) ";
+  os.width(12);
+  os << " Max (s) ";
+  os.width(11);
+  os << " Imbalance ";
+  os.width(11);
+  os << " Pixels ";
+  os << std::endl;
+
+  for ( SizeValueType e = 0; e < numberOfExecutions; ++e )
+    {
+    const ExecutionRecord & execution = this->GetExecution(e);
+    TimeStampType minimum = 0.0;
+    TimeStampType maximum = 0.0;
+    TimeStampType sum = 0.0;
+    for ( SizeValueType t = 0; t < execution.Threads.size(); ++t )
+      {
+      const TimeStampType busyTime = execution.Threads[t].BusyTime;
+      minimum = t == 0 ? busyTime : std::min(minimum, busyTime);
+      maximum = std::max(maximum, busyTime);
+      sum += busyTime;
+      }
+    os.width(8);
+    os << e;
+    os << "  " << std::left;
+    os.width(34);
+    os << execution.Name;
+    os << std::right << std::fixed << std::setprecision(6);
+    os.width(9);
+    os << execution.Threads.size();
+    os.width(12);
+    os << execution.StopTime - execution.StartTime;
+    os.width(12);
+    os << minimum;
+    os.width(12);
+    os << ( execution.Threads.empty() ? 0.0 : sum / execution.Threads.size() );
+    os.width(12);
+    os << maximum;
+    os << std::setprecision(3);
+    os.width(11);
+    os << this->GetImbalanceRatio(e);
+    os.width(11);
+    os << this->GetPixelImbalanceRatio(e);
+    os << std::endl;
+    }
+  os.flags(flags);
+}
+
+void
+ThreadTimingRecorder
+::WriteChromeTrace(std::ostream & os) const
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  const std::ios::fmtflags flags = os.flags();
+  os << std::fixed << std::setprecision(3);
+  os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  const char *separator = "\n";
+  for ( SizeValueType e = 0; e < m_Executions.size(); ++e )
+    {
+    const ExecutionRecord & execution = m_Executions[e];
+    std::ostringstream      processName;
+    processName << e << " " << execution.Name;
+    os << separator
+       << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << e
+       << ",\"args\":{\"name\":" << ChromeTrace::JSONString( processName.str() ) << "}}";
+    separator = ",\n";
+    for ( SizeValueType t = 0; t < execution.Threads.size(); ++t )
+      {
+      const ThreadRecord & thread = execution.Threads[t];
+      if ( thread.NumberOfPieces == 0 )
+        {
+        continue;
+        }
+      // complete events, with times in microseconds
+      os << separator
+         << "{\"name\":" << ChromeTrace::JSONString(execution.Name)
+         << ",\"cat\":\"Thread\",\"ph\":\"X\",\"pid\":" << e
+         << ",\"tid\":" << t
+         << ",\"ts\":" << 1.0e6 * thread.StartTime
+         << ",\"dur\":" << 1.0e6 * ( thread.StopTime - thread.StartTime )
+         << ",\"args\":{\"busy_ms\":" << 1.0e3 * thread.BusyTime
+         << ",\"pixels\":" << thread.NumberOfPixels
+         << ",\"pieces\":" << thread.NumberOfPieces
+         << "}}";
+      }
+    }
+  os << "\n]}" << std::endl;
+  os.flags(flags);
+}
+
+void
+ThreadTimingRecorder
+::WriteChromeTrace(const std::string & fileName) const
+{
+  ChromeTrace::WriteFile(this, fileName);
+}
+
+void
+ThreadTimingRecorder
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfExecutions: " << this->GetNumberOfExecutions() << std::endl;
+}
+} // end namespace itk
@@ -0,0 +1,215 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImage.h"
+#include "itkVectorImage.h"
+#include "itkRGBPixel.h"
+#include "itkImageBufferPool.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageScanlineIterator.h"
+#include "itkConstNeighborhoodIterator.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+bool IsAligned(const void *pointer, itk::SizeValueType alignment)
+{
+  return reinterpret_cast< uintptr_t >( pointer ) % alignment == 0;
+}
+
+// Fill an image with a value computed from the index of each pixel
+template< typename TImage >
+void FillWithIndex(TImage *image)
+{
+  itk::ImageRegionIteratorWithIndex< TImage > it( image, image->GetBufferedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const typename TImage::IndexType index = it.GetIndex();
+    it.Set( static_cast< typename TImage::PixelType >( index[0] + 100 * index[1] ) );
+    }
+}
+
+// Sum of the 3x3 neighborhoods of all the pixels
+template< typename TImage >
+double SumNeighborhoods(const TImage *image)
+{
+  typename TImage::SizeType radius;
+  radius.Fill(1);
+  itk::ConstNeighborhoodIterator< TImage > it( radius, image, image->GetBufferedRegion() );
+  double                                   sum = 0.0;
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    for ( unsigned int i = 0; i < it.Size(); ++i )
+      {
+      sum += ( i + 1 ) * it.GetPixel(i);
+      }
+    }
+  return sum;
+}
+}
+
+int itkImageBufferAlignmentTest(int, char *[])
+{
+  typedef itk::Image< float, 2 > ImageType;
+
+  ImageType::SizeType   size = { { 37, 5 } };
+  ImageType::IndexType  start = { { -3, 2 } };
+  ImageType::RegionType region(start, size);
+
+  // The default layout is contiguous
+  ImageType::Pointer contiguous = ImageType::New();
+  contiguous->SetRegions(region);
+  contiguous->Allocate();
+  TEST_EXPECT_EQUAL( contiguous->GetBufferAlignment(), 0u );
+  TEST_EXPECT_TRUE( !contiguous->GetPadBufferRows() );
+  TEST_EXPECT_EQUAL( contiguous->GetBufferRowStride(), 37 );
+  TEST_EXPECT_EQUAL( contiguous->GetPixelContainer()->Size(), 37u * 5u );
+  FillWithIndex( contiguous.GetPointer() );
+
+  // Aligned, contiguous buffer
+  ImageType::Pointer aligned = ImageType::New();
+  aligned->SetBufferAlignment(64);
+  aligned->SetRegions(region);
+  aligned->Allocate();
+  TEST_EXPECT_TRUE( IsAligned(aligned->GetBufferPointer(), 64) );
+  TEST_EXPECT_EQUAL( aligned->GetBufferRowStride(), 37 );
+  TEST_EXPECT_EQUAL( aligned->GetPixelContainer()->Size(), 37u * 5u );
+
+  // Aligned buffer with padded rows: 37 floats are padded to 48
+  ImageType::Pointer padded = ImageType::New();
+  padded->SetBufferAlignment(64);
+  padded->PadBufferRowsOn();
+  padded->SetRegions(region);
+  padded->Allocate();
+  padded->FillBuffer(-1.0f);
+  TEST_EXPECT_TRUE( IsAligned(padded->GetBufferPointer(), 64) );
+  TEST_EXPECT_EQUAL( padded->GetBufferRowStride(), 48 );
+  TEST_EXPECT_EQUAL( padded->GetOffsetTable()[2], 48 * 5 );
+  TEST_EXPECT_EQUAL( padded->GetPixelContainer()->Size(), 48u * 5u );
+  FillWithIndex( padded.GetPointer() );
+
+  // Every pixel is found where GetPixel() and the iterators expect it
+  ImageType::IndexType index;
+  index[0] = 10;
+  index[1] = 4;
+  TEST_EXPECT_EQUAL( padded->GetPixel(index), 410.0f );
+  TEST_EXPECT_EQUAL( padded->ComputeIndex( padded->ComputeOffset(index) ), index );
+
+  itk::ImageRegionIterator< ImageType > regionIt( padded, region );
+  itk::ImageRegionIterator< ImageType > expectedIt( contiguous, region );
+  TEST_EXPECT_EQUAL( regionIt.GetRowStride(), 48 );
+  for ( ; !regionIt.IsAtEnd(); ++regionIt, ++expectedIt )
+    {
+    TEST_EXPECT_EQUAL( regionIt.Get(), expectedIt.Get() );
+    TEST_EXPECT_EQUAL( regionIt.GetIndex(), expectedIt.GetIndex() );
+    }
+  TEST_EXPECT_TRUE( expectedIt.IsAtEnd() );
+
+  // Each scanline starts on an aligned address
+  ImageType::RegionType subRegion = region;
+  subRegion.ShrinkByRadius(1);
+  itk::ImageScanlineIterator< ImageType > scanlineIt( padded, region );
+  TEST_EXPECT_EQUAL( scanlineIt.GetRowStride(), 48 );
+  unsigned int numberOfLines = 0;
+  while ( !scanlineIt.IsAtEnd() )
+    {
+    TEST_EXPECT_TRUE( IsAligned(&scanlineIt.Value(), 64) );
+    TEST_EXPECT_EQUAL( scanlineIt.Get(), static_cast< float >( start[0] + 100 * scanlineIt.GetIndex()[1] ) );
+    while ( !scanlineIt.IsAtEndOfLine() )
+      {
+      ++scanlineIt;
+      }
+    scanlineIt.NextLine();
+    ++numberOfLines;
+    }
+  TEST_EXPECT_EQUAL( numberOfLines, 5u );
+
+  itk::ImageScanlineIterator< ImageType > subScanlineIt( padded, subRegion );
+  itk::ImageScanlineIterator< ImageType > subExpectedIt( contiguous, subRegion );
+  while ( !subScanlineIt.IsAtEnd() )
+    {
+    while ( !subScanlineIt.IsAtEndOfLine() )
+      {
+      TEST_EXPECT_EQUAL( subScanlineIt.Get(), subExpectedIt.Get() );
+      ++subScanlineIt;
+      ++subExpectedIt;
+      }
+    subScanlineIt.NextLine();
+    subExpectedIt.NextLine();
+    }
+
+  // Neighborhood iterators wrap over the padding
+  TEST_EXPECT_EQUAL( SumNeighborhoods( padded.GetPointer() ), SumNeighborhoods( contiguous.GetPointer() ) );
+
+  // Grafting keeps the layout of the buffer
+  ImageType::Pointer grafted = ImageType::New();
+  grafted->Graft(padded);
+  TEST_EXPECT_EQUAL( grafted->GetBufferRowStride(), 48 );
+  TEST_EXPECT_EQUAL( grafted->GetPixel(index), 410.0f );
+
+  // Releasing the buffer restores the contiguous layout of the next one
+  padded->PadBufferRowsOff();
+  padded->Initialize();
+  padded->SetRegions(region);
+  padded->Allocate();
+  TEST_EXPECT_EQUAL( padded->GetBufferRowStride(), 37 );
+  TEST_EXPECT_TRUE( IsAligned(padded->GetBufferPointer(), 64) );
+
+  // Rows of 3-byte pixels are padded to a multiple of 64 pixels
+  typedef itk::Image< itk::RGBPixel< unsigned char >, 3 > RGBImageType;
+  RGBImageType::Pointer     rgbImage = RGBImageType::New();
+  RGBImageType::SizeType    rgbSize = { { 70, 3, 2 } };
+  RGBImageType::RegionType  rgbRegion(rgbSize);
+  rgbImage->SetBufferAlignment(64);
+  rgbImage->SetPadBufferRows(true);
+  rgbImage->SetRegions(rgbRegion);
+  rgbImage->Allocate();
+  TEST_EXPECT_EQUAL( rgbImage->GetBufferRowStride(), 128 );
+  TEST_EXPECT_EQUAL( rgbImage->GetOffsetTable()[3], 128 * 3 * 2 );
+
+  // Vector images pad according to the size of the whole pixel
+  typedef itk::VectorImage< float, 2 > VectorImageType;
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetVectorLength(3);
+  vectorImage->SetBufferAlignment(64);
+  vectorImage->PadBufferRowsOn();
+  vectorImage->SetRegions(region);
+  vectorImage->Allocate();
+  TEST_EXPECT_TRUE( IsAligned(vectorImage->GetBufferPointer(), 64) );
+  TEST_EXPECT_EQUAL( vectorImage->GetBufferRowStride(), 48 );
+  TEST_EXPECT_EQUAL( vectorImage->GetPixelContainer()->Size(), 48u * 5u * 3u );
+
+  // Larger alignments than the allocators provide are honored
+  itk::ImageBufferPool::Pointer pool = itk::ImageBufferPool::New();
+  ImageType::Pointer pooled = ImageType::New();
+  pooled->SetRegions(region);
+  pooled->GetPixelContainer()->SetBufferAllocator(pool);
+  pooled->Allocate();
+  TEST_EXPECT_TRUE( IsAligned(pooled->GetBufferPointer(), 64) );
+  TEST_EXPECT_EQUAL( pool->GetAllocatedBytes(), 768u );
+
+  ImageType::PixelContainerPointer container = ImageType::PixelContainer::New();
+  container->SetBufferAllocator(pool);
+  container->SetAlignment(4096);
+  container->Reserve(10);
+  TEST_EXPECT_TRUE( IsAligned(container->GetBufferPointer(), 4096) );
+  TEST_EXPECT_EQUAL( pool->GetAllocatedBytes(), 768u );
+  container->Initialize();
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,146 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageBufferPool.h"
+#include "itkImage.h"
+#include "itkVectorImage.h"
+#include "itkMultiThreader.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+ITK_THREAD_RETURN_TYPE AllocateImages(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct *info =
+    static_cast< itk::MultiThreader::ThreadInfoStruct * >( arg );
+
+  typedef itk::Image< float, 2 > ImageType;
+  ImageType::RegionType region;
+  ImageType::SizeType   size;
+  for ( unsigned int i = 0; i < 200; ++i )
+    {
+    size.Fill( 16 + ( i + info->ThreadID ) % 5 * 8 );
+    region.SetSize(size);
+    ImageType::Pointer image = ImageType::New();
+    image->SetRegions(region);
+    image->Allocate();
+    image->FillBuffer( static_cast< float >( info->ThreadID ) );
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+}
+
+int itkImageBufferPoolTest(int, char *[])
+{
+  itk::ImageBufferPool::Pointer pool = itk::ImageBufferPool::New();
+
+  EXERCISE_BASIC_OBJECT_METHODS( pool, ImageBufferPool );
+
+  TEST_EXPECT_EQUAL( itk::ImageBufferPool::GetBucketSize(1), 64u );
+  TEST_EXPECT_EQUAL( itk::ImageBufferPool::GetBucketSize(4096), 4096u );
+  TEST_EXPECT_EQUAL( itk::ImageBufferPool::GetBucketSize(4097), 5120u );
+  TEST_EXPECT_EQUAL( itk::ImageBufferPool::GetBucketSize(8192), 8192u );
+  TEST_EXPECT_EQUAL( itk::ImageBufferPool::GetBucketSize(1000000), 1048576u );
+
+  // A released block is reused by the next allocation of its bucket
+  void *block = pool->Allocate(5000);
+  TEST_EXPECT_EQUAL( pool->GetNumberOfMisses(), 1u );
+  TEST_EXPECT_EQUAL( pool->GetAllocatedBytes(), 5120u );
+  pool->Deallocate(block, 5000);
+  TEST_EXPECT_EQUAL( pool->GetAllocatedBytes(), 0u );
+  TEST_EXPECT_EQUAL( pool->GetCachedBytes(), 5120u );
+  void *reused = pool->Allocate(5100);
+  TEST_EXPECT_TRUE( reused == block );
+  TEST_EXPECT_EQUAL( pool->GetNumberOfHits(), 1u );
+  TEST_EXPECT_EQUAL( pool->GetCachedBytes(), 0u );
+  pool->Deallocate(reused, 5100);
+
+  // The cache is bounded
+  pool->SetMaximumCachedBytes(8192);
+  block = pool->Allocate(10000);
+  pool->Deallocate(block, 10000);
+  TEST_EXPECT_EQUAL( pool->GetCachedBytes(), 5120u );
+  TEST_EXPECT_EQUAL( pool->GetPeakBytes(), 5120u + 10240u );
+  pool->SetMaximumCachedBytes(1024);
+  TEST_EXPECT_EQUAL( pool->GetCachedBytes(), 0u );
+
+  pool->ResetStatistics();
+  TEST_EXPECT_EQUAL( pool->GetNumberOfHits(), 0u );
+  TEST_EXPECT_EQUAL( pool->GetNumberOfMisses(), 0u );
+  TEST_EXPECT_EQUAL( pool->GetPeakBytes(), 0u );
+
+  // Images allocated and released repeatedly use the same blocks
+  pool->SetMaximumCachedBytes(64 * 1024 * 1024);
+  itk::ImageBufferAllocator::SetGlobalDefaultAllocator(pool);
+  TEST_EXPECT_TRUE( itk::ImageBufferAllocator::GetGlobalDefaultAllocator() == pool.GetPointer() );
+
+  typedef itk::Image< short, 3 > ImageType;
+  ImageType::RegionType region;
+  ImageType::SizeType   size;
+  size.Fill(40);
+  region.SetSize(size);
+  for ( unsigned int i = 0; i < 10; ++i )
+    {
+    ImageType::Pointer image = ImageType::New();
+    TEST_EXPECT_TRUE( image->GetPixelContainer()->GetBufferAllocator() == pool.GetPointer() );
+    image->SetRegions(region);
+    image->Allocate();
+    image->FillBuffer(static_cast< short >( i ));
+    TEST_EXPECT_EQUAL( image->GetPixel( region.GetIndex() ), static_cast< short >( i ) );
+    }
+  pool->Print(std::cout);
+  TEST_EXPECT_EQUAL( pool->GetNumberOfMisses(), 1u );
+  TEST_EXPECT_EQUAL( pool->GetNumberOfHits(), 9u );
+  TEST_EXPECT_EQUAL( pool->GetAllocatedBytes(), 0u );
+
+  typedef itk::VectorImage< double, 2 > VectorImageType;
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  VectorImageType::RegionType vectorRegion;
+  VectorImageType::SizeType   vectorSize;
+  vectorSize.Fill(20);
+  vectorRegion.SetSize(vectorSize);
+  vectorImage->SetRegions(vectorRegion);
+  vectorImage->SetVectorLength(4);
+  vectorImage->Allocate();
+  TEST_EXPECT_EQUAL( pool->GetAllocatedBytes(), itk::ImageBufferPool::GetBucketSize(20 * 20 * 4 * sizeof( double ) ) );
+  vectorImage = ITK_NULLPTR;
+
+  // A buffer is returned to the allocator it was obtained from
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  image->GetPixelContainer()->SetBufferAllocator(ITK_NULLPTR);
+  image = ITK_NULLPTR;
+  TEST_EXPECT_EQUAL( pool->GetAllocatedBytes(), 0u );
+
+  // Concurrent allocations
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads(4);
+  threader->SetSingleMethod(AllocateImages, ITK_NULLPTR);
+  threader->SingleMethodExecute();
+  std::cout << "Hits: " << pool->GetNumberOfHits()
+            << " Misses: " << pool->GetNumberOfMisses()
+            << " Peak bytes: " << pool->GetPeakBytes() << std::endl;
+  TEST_EXPECT_EQUAL( pool->GetAllocatedBytes(), 0u );
+
+  itk::ImageBufferAllocator::SetGlobalDefaultAllocator(ITK_NULLPTR);
+  pool->ReleaseCachedMemory();
+  TEST_EXPECT_EQUAL( pool->GetCachedBytes(), 0u );
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,158 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageRegionSplitterTiled.h"
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkTestingMacros.h"
+#include <iostream>
+
+namespace
+{
+// Check that the pieces of the region cover every pixel exactly once.
+bool CheckCoverage( const itk::ImageRegionSplitterBase *splitter,
+                    const itk::ImageRegion<3> & region,
+                    unsigned int requestedNumber )
+{
+  typedef itk::Image< unsigned short, 3 > ImageType;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  image->FillBuffer(0);
+
+  const unsigned int numberOfPieces = splitter->GetNumberOfSplits(region, requestedNumber);
+  if ( numberOfPieces > requestedNumber )
+    {
+    std::cerr << "Got " << numberOfPieces << " pieces while "
+              << requestedNumber << " were requested" << std::endl;
+    return false;
+    }
+
+  for ( unsigned int i = 0; i < numberOfPieces; ++i )
+    {
+    itk::ImageRegion<3> piece = region;
+    splitter->GetSplit(i, numberOfPieces, piece);
+    if ( !region.IsInside(piece) )
+      {
+      std::cerr << "Piece " << i << " is outside of the region: " << piece << std::endl;
+      return false;
+      }
+    itk::ImageRegionIterator< ImageType > it(image, piece);
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      it.Set( it.Get() + 1 );
+      }
+    }
+
+  itk::ImageRegionConstIterator< ImageType > it(image, region);
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != 1 )
+      {
+      std::cerr << "Pixel " << it.GetIndex() << " is in " << it.Get()
+                << " of " << numberOfPieces << " pieces" << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkImageRegionSplitterTiledTest(int, char*[])
+{
+  itk::ImageRegionSplitterTiled::Pointer splitter = itk::ImageRegionSplitterTiled::New();
+
+  EXERCISE_BASIC_OBJECT_METHODS( splitter, ImageRegionSplitterTiled );
+
+  TEST_EXPECT_EQUAL( splitter->GetCacheSize(), 256u * 1024u );
+  TEST_EXPECT_EQUAL( splitter->GetPixelSize(), 4u );
+  TEST_EXPECT_EQUAL( splitter->GetRadius(0), 0u );
+
+  itk::ImageRegion<3> region;
+  region.SetIndex(0, 3);
+  region.SetIndex(1, -7);
+  region.SetIndex(2, 11);
+  region.SetSize(0, 20);
+  region.SetSize(1, 20);
+  region.SetSize(2, 20);
+
+  // The whole region fits in the cache: behaves as the slow dimension
+  // splitter
+  TEST_EXPECT_EQUAL( splitter->GetNumberOfSplits( region, 1 ), 1u );
+  TEST_EXPECT_EQUAL( splitter->GetNumberOfSplits( region, 4 ), 4u );
+  TEST_EXPECT_EQUAL( splitter->GetNumberOfSplits( region, 99 ), 20u );
+
+  itk::ImageRegion<3> piece = region;
+  splitter->GetSplit(1, 4, piece);
+  TEST_EXPECT_EQUAL( piece.GetIndex(2), 16 );
+  TEST_EXPECT_EQUAL( piece.GetSize(0), 20u );
+  TEST_EXPECT_EQUAL( piece.GetSize(1), 20u );
+  TEST_EXPECT_EQUAL( piece.GetSize(2), 5u );
+
+  // With a working set of 3 x 22 x 22 x 4 bytes, the second dimension
+  // is reduced to a single row first.
+  splitter->SetRadius(1);
+  splitter->SetCacheSize(1024);
+  TEST_EXPECT_EQUAL( splitter->GetRadius(2), 1u );
+  TEST_EXPECT_EQUAL( splitter->GetNumberOfSplits( region, 1000 ), 400u );
+  TEST_EXPECT_EQUAL( splitter->GetNumberOfSplits( region, 20 ), 20u );
+  TEST_EXPECT_EQUAL( splitter->GetNumberOfSplits( region, 7 ), 7u );
+
+  piece = region;
+  splitter->GetSplit(21, 400, piece);
+  TEST_EXPECT_EQUAL( piece.GetIndex(0), 3 );
+  TEST_EXPECT_EQUAL( piece.GetIndex(1), -6 );
+  TEST_EXPECT_EQUAL( piece.GetIndex(2), 12 );
+  TEST_EXPECT_EQUAL( piece.GetSize(0), 20u );
+  TEST_EXPECT_EQUAL( piece.GetSize(1), 1u );
+  TEST_EXPECT_EQUAL( piece.GetSize(2), 1u );
+
+  // Then the fastest dimension, to tiles of 5 pixels.
+  splitter->SetCacheSize(256);
+  TEST_EXPECT_EQUAL( splitter->GetNumberOfSplits( region, 80 ), 80u );
+  TEST_EXPECT_EQUAL( splitter->GetNumberOfSplits( region, 10000 ), 1600u );
+
+  piece = region;
+  splitter->GetSplit(5, 80, piece);
+  TEST_EXPECT_EQUAL( piece.GetIndex(0), 8 );
+  TEST_EXPECT_EQUAL( piece.GetIndex(1), -6 );
+  TEST_EXPECT_EQUAL( piece.GetSize(0), 5u );
+  TEST_EXPECT_EQUAL( piece.GetSize(1), 1u );
+  TEST_EXPECT_EQUAL( piece.GetSize(2), 20u );
+
+  // Anisotropic radius and pixel size
+  itk::Size<3> radius;
+  radius[0] = 0;
+  radius[1] = 2;
+  radius[2] = 3;
+  splitter->SetRadius(radius);
+  splitter->SetPixelSize(8);
+  splitter->SetCacheSize(4096);
+  TEST_EXPECT_EQUAL( splitter->GetRadius(1), 2u );
+
+  const unsigned int requested[] = { 1, 2, 3, 5, 8, 13, 64, 100, 1000, 10000 };
+  for ( unsigned int i = 0; i < sizeof(requested) / sizeof(requested[0]); ++i )
+    {
+    if ( !CheckCoverage( splitter, region, requested[i] ) )
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,135 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageSource.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkTestingMacros.h"
+
+namespace itk
+{
+/** A source incrementing every pixel of its output once, through either of
+ * the ThreadedGenerateData() entry points. */
+template< typename TOutputImage >
+class DynamicMultiThreadingTestSource:public ImageSource< TOutputImage >
+{
+public:
+  typedef DynamicMultiThreadingTestSource Self;
+  typedef ImageSource< TOutputImage >     Superclass;
+  typedef SmartPointer< Self >            Pointer;
+  typedef SmartPointer< const Self >      ConstPointer;
+
+  itkNewMacro(Self);
+  itkTypeMacro(DynamicMultiThreadingTestSource, ImageSource);
+
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
+  itkGetConstMacro(NumberOfChunks, unsigned int);
+
+protected:
+  DynamicMultiThreadingTestSource() : m_NumberOfChunks(0)
+  {
+    typename TOutputImage::RegionType region;
+    typename TOutputImage::SizeType   size;
+    size.Fill(32);
+    region.SetSize(size);
+    this->GetOutput()->SetRegions(region);
+  }
+
+  virtual void BeforeThreadedGenerateData() ITK_OVERRIDE
+  {
+    this->GetOutput()->FillBuffer(0);
+    m_NumberOfChunks = 0;
+  }
+
+  virtual void ThreadedGenerateData(const OutputImageRegionType & region, ThreadIdType) ITK_OVERRIDE
+  {
+    this->Increment(region);
+  }
+
+  virtual void DynamicThreadedGenerateData(const OutputImageRegionType & region) ITK_OVERRIDE
+  {
+    this->Increment(region);
+  }
+
+  void Increment(const OutputImageRegionType & region)
+  {
+    ImageRegionIterator< TOutputImage > it(this->GetOutput(), region);
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      it.Set( it.Get() + 1 );
+      }
+    m_Lock.Lock();
+    ++m_NumberOfChunks;
+    m_Lock.Unlock();
+  }
+
+private:
+  DynamicMultiThreadingTestSource(const Self &); //purposely not implemented
+  void operator=(const Self &);                  //purposely not implemented
+
+  SimpleFastMutexLock m_Lock;
+  unsigned int        m_NumberOfChunks;
+};
+}
+
+int itkImageSourceDynamicMultiThreadingTest(int, char *[])
+{
+  typedef itk::Image< unsigned int, 3 >                       ImageType;
+  typedef itk::DynamicMultiThreadingTestSource< ImageType > SourceType;
+
+  SourceType::Pointer source = SourceType::New();
+  source->SetNumberOfThreads(4);
+
+  TEST_EXPECT_TRUE( !source->GetDynamicMultiThreading() );
+  TEST_EXPECT_EQUAL( source->GetDynamicChunksPerThread(), 8u );
+
+  // Static splitting, at most one piece per thread
+  source->Update();
+  TEST_EXPECT_TRUE( source->GetNumberOfChunks() <= source->GetNumberOfThreads() );
+
+  // Dynamic scheduling over-decomposes the region
+  source->DynamicMultiThreadingOn();
+  source->SetDynamicChunksPerThread(4);
+  source->Modified();
+  source->Update();
+  std::cout << "Number of chunks: " << source->GetNumberOfChunks() << std::endl;
+  TEST_EXPECT_EQUAL( source->GetNumberOfChunks(), source->GetNumberOfThreads() * 4 );
+
+  // Every pixel must have been generated exactly once
+  itk::ImageRegionConstIterator< ImageType > it( source->GetOutput(), source->GetOutput()->GetBufferedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != 1 )
+      {
+      std::cerr << "Pixel " << it.GetIndex() << " was generated " << it.Get() << " times" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // The number of chunks is bounded by what the splitter can produce
+  source->SetDynamicChunksPerThread(100);
+  source->Modified();
+  source->Update();
+  TEST_EXPECT_EQUAL( source->GetNumberOfChunks(), 32u );
+
+  source->SetDynamicChunksPerThread(0);
+  TEST_EXPECT_EQUAL( source->GetDynamicChunksPerThread(), 1u );
+
+  return EXIT_SUCCESS;
+}
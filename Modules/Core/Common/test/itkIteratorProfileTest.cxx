@@ -0,0 +1,422 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImage.h"
+#include "itkVector.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageScanlineConstIterator.h"
+#include "itkConstNeighborhoodIterator.h"
+#include "itkConstShapedNeighborhoodIterator.h"
+#include "itkConstantBoundaryCondition.h"
+#include "itkPeriodicBoundaryCondition.h"
+#include "itkNeighborhoodAlgorithm.h"
+#include "itkMultiThreader.h"
+#include "itkRealTimeClock.h"
+#include "itkVersion.h"
+
+#include <cmath>
+#include <ctime>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+
+namespace
+{
+// The pixels are added to a double, to keep the compiler from skipping the
+// loops
+inline void Accumulate(double & sum, double pixel)
+{
+  sum += pixel;
+}
+
+template< typename T, unsigned int VDimension >
+inline void Accumulate(double & sum, const itk::Vector< T, VDimension > & pixel)
+{
+  for ( unsigned int c = 0; c < VDimension; ++c )
+    {
+    sum += pixel[c];
+    }
+}
+
+template< typename TPixel >
+struct PixelName
+{
+  static const char * Get();
+};
+template<> const char * PixelName< unsigned char >::Get() { return "uchar"; }
+template<> const char * PixelName< float >::Get() { return "float"; }
+template<> const char * PixelName< itk::Vector< float, 3 > >::Get() { return "vector3f"; }
+
+template< typename TImage >
+struct RegionConstIteratorBenchmark
+{
+  double operator()(const TImage *image, const typename TImage::RegionType & region) const
+  {
+    double sum = 0.0;
+    for ( itk::ImageRegionConstIterator< TImage > it(image, region); !it.IsAtEnd(); ++it )
+      {
+      Accumulate( sum, it.Get() );
+      }
+    return sum;
+  }
+};
+
+template< typename TImage >
+struct RegionIteratorBenchmark
+{
+  double operator()(TImage *image, const typename TImage::RegionType & region) const
+  {
+    // read, write and read back each pixel
+    double sum = 0.0;
+    for ( itk::ImageRegionIterator< TImage > it(image, region); !it.IsAtEnd(); ++it )
+      {
+      it.Set( it.Get() );
+      Accumulate( sum, it.Get() );
+      }
+    return sum;
+  }
+};
+
+template< typename TImage >
+struct ScanlineIteratorBenchmark
+{
+  double operator()(const TImage *image, const typename TImage::RegionType & region) const
+  {
+    double sum = 0.0;
+    itk::ImageScanlineConstIterator< TImage > it(image, region);
+    while ( !it.IsAtEnd() )
+      {
+      while ( !it.IsAtEndOfLine() )
+        {
+        Accumulate( sum, it.Get() );
+        ++it;
+        }
+      it.NextLine();
+      }
+    return sum;
+  }
+};
+
+template< typename TImage >
+struct RegionIteratorWithIndexBenchmark
+{
+  double operator()(TImage *image, const typename TImage::RegionType & region) const
+  {
+    double sum = 0.0;
+    for ( itk::ImageRegionIteratorWithIndex< TImage > it(image, region); !it.IsAtEnd(); ++it )
+      {
+      Accumulate( sum, it.Get() );
+      }
+    return sum;
+  }
+};
+
+// Sum of the 3^N neighborhood of each pixel. The boundary condition is set
+// the way the filters set it, with OverrideBoundaryCondition(). The
+// Interior benchmarks only visit the pixels whose neighborhood is inside
+// the image, where the boundary condition is never used.
+template< typename TImage, typename TBoundaryCondition >
+struct NeighborhoodIteratorBenchmark
+{
+  double operator()(const TImage *image, const typename TImage::RegionType & region) const
+  {
+    typedef itk::ConstNeighborhoodIterator< TImage > IteratorType;
+    typename IteratorType::RadiusType radius;
+    radius.Fill(1);
+    IteratorType       it(radius, image, region);
+    TBoundaryCondition boundaryCondition;
+    it.OverrideBoundaryCondition(&boundaryCondition);
+    const unsigned int size = it.Size();
+    double             sum = 0.0;
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      for ( unsigned int i = 0; i < size; ++i )
+        {
+        Accumulate( sum, it.GetPixel(i) );
+        }
+      }
+    return sum;
+  }
+};
+
+// Sum of the face connected neighbors of each pixel
+template< typename TImage, typename TBoundaryCondition >
+struct ShapedNeighborhoodIteratorBenchmark
+{
+  double operator()(const TImage *image, const typename TImage::RegionType & region) const
+  {
+    typedef itk::ConstShapedNeighborhoodIterator< TImage > IteratorType;
+    typename IteratorType::RadiusType radius;
+    radius.Fill(1);
+    IteratorType       it(radius, image, region);
+    TBoundaryCondition boundaryCondition;
+    it.OverrideBoundaryCondition(&boundaryCondition);
+    typename IteratorType::OffsetType offset;
+    offset.Fill(0);
+    it.ActivateOffset(offset);
+    for ( unsigned int j = 0; j < TImage::ImageDimension; ++j )
+      {
+      offset[j] = -1;
+      it.ActivateOffset(offset);
+      offset[j] = 1;
+      it.ActivateOffset(offset);
+      offset[j] = 0;
+      }
+    double sum = 0.0;
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      for ( typename IteratorType::ConstIterator ci = it.Begin(); !ci.IsAtEnd(); ++ci )
+        {
+        Accumulate( sum, ci.Get() );
+        }
+      }
+    return sum;
+  }
+};
+
+/** Runs each benchmark until it has taken a minimum time, like Google
+ * Benchmark, and keeps the results. */
+class BenchmarkRunner
+{
+public:
+  struct Result
+  {
+    std::string        Name;
+    itk::SizeValueType Iterations;
+    double             RealTime;
+    double             CPUTime;
+    itk::SizeValueType PixelsPerIteration;
+  };
+
+  BenchmarkRunner(double minimumTime) : m_MinimumTime(minimumTime), m_Sum(0.0)
+  {
+    m_Clock = itk::RealTimeClock::New();
+  }
+
+  template< typename TBenchmark, typename TImage >
+  double Run(const std::string & name, TImage *image, const typename TImage::RegionType & region)
+  {
+    TBenchmark benchmark;
+    // warm up the caches, and get the value the other iterations must give
+    const double value = benchmark(image, region);
+
+    itk::SizeValueType iterations = 1;
+    while ( true )
+      {
+      const std::clock_t startCPUTime = std::clock();
+      const double       startTime = m_Clock->GetTimeInSeconds();
+      for ( itk::SizeValueType i = 0; i < iterations; ++i )
+        {
+        m_Sum += benchmark(image, region);
+        }
+      const double realTime = m_Clock->GetTimeInSeconds() - startTime;
+      const double cpuTime = static_cast< double >( std::clock() - startCPUTime ) / CLOCKS_PER_SEC;
+      if ( realTime >= m_MinimumTime || iterations >= 1000000 )
+        {
+        Result result;
+        result.Name = name;
+        result.Iterations = iterations;
+        result.RealTime = realTime;
+        result.CPUTime = cpuTime;
+        result.PixelsPerIteration = region.GetNumberOfPixels();
+        m_Results.push_back(result);
+        std::cout << std::left << std::setw(60) << name << std::right << std::setw(10) << iterations
+                  << std::setw(14) << std::setprecision(4) << result.PixelsPerIteration * iterations / realTime / 1.0e6
+                  << " Mpixels/s" << std::endl;
+        break;
+        }
+      // aim slightly past the minimum time
+      const double scale = realTime > 0.0 ? 1.4 * m_MinimumTime / realTime : 10.0;
+      iterations = static_cast< itk::SizeValueType >( iterations * std::min( std::max(scale, 2.0), 10.0 ) );
+      }
+    return value;
+  }
+
+  // Write the results in the JSON format of Google Benchmark, so that its
+  // tools can compare the results of two builds.
+  bool WriteJSON(const std::string & fileName) const
+  {
+    std::ofstream file( fileName.c_str() );
+    if ( !file )
+      {
+      return false;
+      }
+    char      date[64];
+    std::time_t now = std::time(ITK_NULLPTR);
+    std::strftime( date, sizeof( date ), "%Y-%m-%d %H:%M:%S", std::localtime( &now ) );
+    file << "{\n  \"context\": {\n"
+         << "    \"date\": \"" << date << "\",\n"
+         << "    \"executable\": \"itkIteratorProfileTest\",\n"
+         << "    \"itk_version\": \"" << itk::Version::GetITKVersion() << "\",\n"
+         << "    \"num_cpus\": " << itk::MultiThreader::GetGlobalDefaultNumberOfThreads() << ",\n"
+         << "    \"library_build_type\": \"" <<
+#ifdef NDEBUG
+      "release"
+#else
+      "debug"
+#endif
+         << "\"\n  },\n  \"benchmarks\": [";
+    file << std::setprecision(10);
+    for ( std::vector< Result >::const_iterator it = m_Results.begin(); it != m_Results.end(); ++it )
+      {
+      file << ( it == m_Results.begin() ? "\n" : ",\n" )
+           << "    {\n"
+           << "      \"name\": \"" << it->Name << "\",\n"
+           << "      \"run_name\": \"" << it->Name << "\",\n"
+           << "      \"run_type\": \"iteration\",\n"
+           << "      \"iterations\": " << it->Iterations << ",\n"
+           << "      \"real_time\": " << 1.0e9 * it->RealTime / it->Iterations << ",\n"
+           << "      \"cpu_time\": " << 1.0e9 * it->CPUTime / it->Iterations << ",\n"
+           << "      \"time_unit\": \"ns\",\n"
+           << "      \"items_per_second\": " << it->PixelsPerIteration * it->Iterations / it->RealTime << "\n"
+           << "    }";
+      }
+    file << "\n  ]\n}" << std::endl;
+    return static_cast< bool >( file );
+  }
+
+  double GetSum() const { return m_Sum; }
+
+private:
+  double                      m_MinimumTime;
+  double                      m_Sum;
+  itk::RealTimeClock::Pointer m_Clock;
+  std::vector< Result >       m_Results;
+};
+
+template< typename TPixel, unsigned int VDimension >
+bool RunBenchmarks(BenchmarkRunner & runner, itk::SizeValueType numberOfPixels)
+{
+  typedef itk::Image< TPixel, VDimension > ImageType;
+  typedef typename ImageType::RegionType   RegionType;
+
+  // an image about as large as requested, whatever its dimension
+  typename ImageType::SizeType size;
+  size.Fill( static_cast< itk::SizeValueType >(
+               std::floor( std::pow( static_cast< double >( numberOfPixels ), 1.0 / VDimension ) + 0.5 ) ) );
+  typename ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+  itk::SizeValueType n = 0;
+  for ( itk::ImageRegionIterator< ImageType > it( image, image->GetBufferedRegion() ); !it.IsAtEnd(); ++it, ++n )
+    {
+    it.Set( static_cast< typename itk::NumericTraits< TPixel >::ValueType >( n % 97 ) );
+    }
+  const RegionType & region = image->GetBufferedRegion();
+
+  typedef itk::NeighborhoodAlgorithm::ImageBoundaryFacesCalculator< ImageType > FacesCalculatorType;
+  typename FacesCalculatorType::RadiusType radius;
+  radius.Fill(1);
+  FacesCalculatorType faceCalculator;
+  const RegionType    interior = faceCalculator( image, region, radius ).front();
+
+  std::ostringstream suffix;
+  suffix << "/" << PixelName< TPixel >::Get() << "/" << VDimension << "D";
+
+  typedef itk::ZeroFluxNeumannBoundaryCondition< ImageType > ZeroFluxType;
+  typedef itk::ConstantBoundaryCondition< ImageType >        ConstantType;
+  typedef itk::PeriodicBoundaryCondition< ImageType >        PeriodicType;
+
+  const double regionSum = runner.Run< RegionConstIteratorBenchmark< ImageType > >(
+    std::string( "ImageRegionConstIterator" ) + suffix.str(), image.GetPointer(), region );
+  const double sums[] = {
+    runner.Run< RegionIteratorBenchmark< ImageType > >(
+      std::string( "ImageRegionIterator" ) + suffix.str(), image.GetPointer(), region ),
+    runner.Run< ScanlineIteratorBenchmark< ImageType > >(
+      std::string( "ImageScanlineIterator" ) + suffix.str(), image.GetPointer(), region ),
+    runner.Run< RegionIteratorWithIndexBenchmark< ImageType > >(
+      std::string( "ImageRegionIteratorWithIndex" ) + suffix.str(), image.GetPointer(), region )
+  };
+
+  runner.Run< NeighborhoodIteratorBenchmark< ImageType, ZeroFluxType > >(
+    std::string( "ConstNeighborhoodIterator/ZeroFluxNeumann" ) + suffix.str(), image.GetPointer(), region );
+  runner.Run< NeighborhoodIteratorBenchmark< ImageType, ConstantType > >(
+    std::string( "ConstNeighborhoodIterator/Constant" ) + suffix.str(), image.GetPointer(), region );
+  runner.Run< NeighborhoodIteratorBenchmark< ImageType, PeriodicType > >(
+    std::string( "ConstNeighborhoodIterator/Periodic" ) + suffix.str(), image.GetPointer(), region );
+  // in the interior, the boundary condition is never needed
+  const double interiorSum = runner.Run< NeighborhoodIteratorBenchmark< ImageType, ZeroFluxType > >(
+    std::string( "ConstNeighborhoodIterator/Interior" ) + suffix.str(), image.GetPointer(), interior );
+  runner.Run< ShapedNeighborhoodIteratorBenchmark< ImageType, ZeroFluxType > >(
+    std::string( "ConstShapedNeighborhoodIterator/ZeroFluxNeumann" ) + suffix.str(), image.GetPointer(), region );
+  runner.Run< ShapedNeighborhoodIteratorBenchmark< ImageType, ZeroFluxType > >(
+    std::string( "ConstShapedNeighborhoodIterator/Interior" ) + suffix.str(), image.GetPointer(), interior );
+
+  // The iterators visiting every pixel once must agree
+  bool success = true;
+  for ( unsigned int i = 0; i < 3; ++i )
+    {
+    if ( sums[i] != regionSum )
+      {
+      std::cerr << "Iterator " << i << " gives " << sums[i] << " instead of " << regionSum << suffix.str() << std::endl;
+      success = false;
+      }
+    }
+  if ( !( interiorSum > 0.0 ) )
+    {
+    std::cerr << "The interior of the image was not visited" << suffix.str() << std::endl;
+    success = false;
+    }
+  return success;
+}
+}
+
+// Measure the pixels per second visited by the iterators of ITK, for a few
+// pixel types and dimensions, and the cost of the boundary conditions of
+// the neighborhood iterators. The results are written in the JSON format of
+// Google Benchmark to the file given as first argument, if any, to be
+// compared between builds. The minimum time of each benchmark, in seconds,
+// and the number of pixels of the images may follow.
+int itkIteratorProfileTest(int argc, char *argv[])
+{
+  double minimumTime = 0.05;
+  if ( argc > 2 )
+    {
+    minimumTime = atof( argv[2] );
+    }
+  itk::SizeValueType numberOfPixels = 1 << 18;
+  if ( argc > 3 )
+    {
+    numberOfPixels = atoi( argv[3] );
+    }
+
+  BenchmarkRunner runner( minimumTime );
+  bool            success = true;
+  success &= RunBenchmarks< unsigned char, 2 >( runner, numberOfPixels );
+  success &= RunBenchmarks< unsigned char, 3 >( runner, numberOfPixels );
+  success &= RunBenchmarks< float, 2 >( runner, numberOfPixels );
+  success &= RunBenchmarks< float, 3 >( runner, numberOfPixels );
+  success &= RunBenchmarks< itk::Vector< float, 3 >, 2 >( runner, numberOfPixels );
+  success &= RunBenchmarks< itk::Vector< float, 3 >, 3 >( runner, numberOfPixels );
+  std::cout << "Checksum: " << runner.GetSum() << std::endl;
+
+  if ( argc > 1 && !runner.WriteJSON( argv[1] ) )
+    {
+    std::cerr << "Cannot write " << argv[1] << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if ( !success )
+    {
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
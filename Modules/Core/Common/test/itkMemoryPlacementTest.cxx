@@ -0,0 +1,211 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMemoryPlacement.h"
+#include "itkImageSource.h"
+#include "itkVectorImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+namespace itk
+{
+/** A source writing the linear index of each pixel of its output. */
+template< typename TOutputImage >
+class MemoryPlacementTestSource:public ImageSource< TOutputImage >
+{
+public:
+  typedef MemoryPlacementTestSource   Self;
+  typedef ImageSource< TOutputImage > Superclass;
+  typedef SmartPointer< Self >        Pointer;
+  typedef SmartPointer< const Self >  ConstPointer;
+
+  itkNewMacro(Self);
+  itkTypeMacro(MemoryPlacementTestSource, ImageSource);
+
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
+protected:
+  MemoryPlacementTestSource()
+  {
+    typename TOutputImage::RegionType region;
+    typename TOutputImage::SizeType   size;
+    size.Fill(64);
+    region.SetSize(size);
+    this->GetOutput()->SetRegions(region);
+  }
+
+  virtual void ThreadedGenerateData(const OutputImageRegionType & region, ThreadIdType) ITK_OVERRIDE
+  {
+    this->Generate(region);
+  }
+
+  virtual void DynamicThreadedGenerateData(const OutputImageRegionType & region) ITK_OVERRIDE
+  {
+    this->Generate(region);
+  }
+
+  void Generate(const OutputImageRegionType & region)
+  {
+    TOutputImage *output = this->GetOutput();
+    ImageRegionIteratorWithIndex< TOutputImage > it(output, region);
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      it.Set( output->ComputeOffset( it.GetIndex() ) );
+      }
+  }
+
+private:
+  MemoryPlacementTestSource(const Self &); //purposely not implemented
+  void operator=(const Self &);            //purposely not implemented
+};
+}
+
+namespace
+{
+template< typename TImage >
+bool CheckLinearIndex(const TImage *image)
+{
+  itk::ImageRegionConstIteratorWithIndex< TImage > it( image, image->GetBufferedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != static_cast< typename TImage::PixelType >( image->ComputeOffset( it.GetIndex() ) ) )
+      {
+      std::cerr << "Wrong value " << it.Get() << " at " << it.GetIndex() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkMemoryPlacementTest(int, char *[])
+{
+  typedef itk::Image< unsigned int, 3 > ImageType;
+
+  std::cout << "Page size: " << itk::MemoryPlacement::GetPageSize() << std::endl;
+  std::cout << "Global default placement: " << itk::MemoryPlacement::GetGlobalDefaultPlacement() << std::endl;
+
+  // Page allocation, interleaving and touching
+  const itk::SizeValueType numberOfBytes = 5 * itk::MemoryPlacement::GetPageSize() + 3;
+  char *pages = static_cast< char * >( itk::MemoryPlacement::AllocatePages(numberOfBytes) );
+  TEST_EXPECT_TRUE( pages != ITK_NULLPTR );
+  std::cout << "Interleaving supported: "
+            << itk::MemoryPlacement::InterleavePages(pages, numberOfBytes) << std::endl;
+  for ( itk::SizeValueType i = 0; i < numberOfBytes; ++i )
+    {
+    pages[i] = static_cast< char >( i % 127 );
+    }
+  itk::MemoryPlacement::TouchPages(pages + 1, numberOfBytes - 1);
+  for ( itk::SizeValueType i = 0; i < numberOfBytes; ++i )
+    {
+    if ( pages[i] != static_cast< char >( i % 127 ) )
+      {
+      std::cerr << "TouchPages modified byte " << i << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  itk::MemoryPlacement::FreePages(pages, numberOfBytes);
+
+  // Pixel containers follow the global default
+  itk::MemoryPlacement::SetGlobalDefaultPlacement(itk::MemoryPlacement::InterleavedPlacement);
+  TEST_EXPECT_EQUAL( itk::MemoryPlacement::GetGlobalDefaultPlacement(), itk::MemoryPlacement::InterleavedPlacement );
+
+  ImageType::Pointer image = ImageType::New();
+  TEST_EXPECT_EQUAL( image->GetPixelContainer()->GetMemoryPlacement(), itk::MemoryPlacement::InterleavedPlacement );
+  ImageType::RegionType region;
+  ImageType::SizeType   size;
+  size.Fill(33);
+  region.SetSize(size);
+  image->SetRegions(region);
+  image->Allocate();
+  image->FillBuffer(7);
+  image->TouchBufferPages(region);
+  TEST_EXPECT_EQUAL( image->GetPixel( region.GetIndex() ), 7u );
+
+  // Growing and squeezing the container keeps the content
+  ImageType::PixelContainer *container = image->GetPixelContainer();
+  container->SetMemoryPlacement(itk::MemoryPlacement::FirstTouchPlacement);
+  const itk::SizeValueType numberOfPixels = region.GetNumberOfPixels();
+  container->Reserve(2 * numberOfPixels);
+  container->Reserve(numberOfPixels);
+  container->Squeeze();
+  TEST_EXPECT_EQUAL( container->Capacity(), numberOfPixels );
+  TEST_EXPECT_EQUAL( (*container)[numberOfPixels - 1], 7u );
+  container->Print(std::cout);
+  container->Initialize();
+
+  // Small buffers are allocated as usual
+  size.Fill(2);
+  region.SetSize(size);
+  image->SetRegions(region);
+  image->Allocate();
+  image->FillBuffer(3);
+  TEST_EXPECT_EQUAL( image->GetPixel( region.GetIndex() ), 3u );
+
+  // Vector images
+  typedef itk::VectorImage< float, 2 > VectorImageType;
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  VectorImageType::RegionType vectorRegion;
+  VectorImageType::SizeType   vectorSize;
+  vectorSize.Fill(100);
+  vectorRegion.SetSize(vectorSize);
+  vectorImage->SetRegions(vectorRegion);
+  vectorImage->SetVectorLength(3);
+  vectorImage->SetMemoryPlacement(itk::MemoryPlacement::FirstTouchPlacement);
+  vectorImage->Allocate();
+  VectorImageType::PixelType value(3);
+  value.Fill(2.5);
+  vectorImage->FillBuffer(value);
+  vectorImage->TouchBufferPages(vectorRegion);
+  TEST_EXPECT_EQUAL( vectorImage->GetPixel( vectorRegion.GetIndex() )[2], 2.5f );
+
+  // Image sources, in both threading modes
+  itk::MemoryPlacement::SetGlobalDefaultPlacement(itk::MemoryPlacement::DefaultPlacement);
+
+  typedef itk::MemoryPlacementTestSource< ImageType > SourceType;
+  SourceType::Pointer source = SourceType::New();
+  TEST_EXPECT_EQUAL( source->GetMemoryPlacement(), itk::MemoryPlacement::DefaultPlacement );
+  source->SetNumberOfThreads(4);
+  source->SetMemoryPlacement(itk::MemoryPlacement::FirstTouchPlacement);
+  source->Update();
+  TEST_EXPECT_EQUAL( source->GetOutput()->GetPixelContainer()->GetMemoryPlacement(),
+                     itk::MemoryPlacement::FirstTouchPlacement );
+  if ( !CheckLinearIndex( source->GetOutput() ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  source->DynamicMultiThreadingOn();
+  source->SetMemoryPlacement(itk::MemoryPlacement::InterleavedPlacement);
+  source->Update();
+  TEST_EXPECT_EQUAL( source->GetOutput()->GetPixelContainer()->GetMemoryPlacement(),
+                     itk::MemoryPlacement::InterleavedPlacement );
+  if ( !CheckLinearIndex( source->GetOutput() ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  source->SetMemoryPlacement(itk::MemoryPlacement::FirstTouchPlacement);
+  source->Update();
+  if ( !CheckLinearIndex( source->GetOutput() ) )
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
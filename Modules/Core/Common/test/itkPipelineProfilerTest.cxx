@@ -0,0 +1,122 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkPipelineProfiler.h"
+#include "itkAddImageFilter.h"
+#include "itkAbsImageFilter.h"
+#include "itkImage.h"
+#include "itkTestingMacros.h"
+#include <sstream>
+
+namespace
+{
+itk::SizeValueType CountOccurrences(const std::string & s, const std::string & pattern)
+{
+  itk::SizeValueType count = 0;
+  for ( std::string::size_type pos = s.find(pattern); pos != std::string::npos; pos = s.find(pattern, pos + 1) )
+    {
+    ++count;
+    }
+  return count;
+}
+}
+
+// Measure the process objects of a pipeline where a filter feeds two
+// others, and report them as a table and a trace.
+int itkPipelineProfilerTest(int, char* [])
+{
+  typedef itk::Image< float, 3 >                               ImageType;
+  typedef itk::AddImageFilter< ImageType, ImageType >          AddType;
+  typedef itk::AbsImageFilter< ImageType, ImageType >          AbsType;
+
+  ImageType::SizeType size = { { 64, 64, 32 } };
+  ImageType::Pointer  image = ImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+  image->FillBuffer( -1.0f );
+
+  AddType::Pointer add = AddType::New();
+  add->SetInput1( image );
+  add->SetInput2( image );
+  AbsType::Pointer abs = AbsType::New();
+  abs->SetInput( add->GetOutput() );
+  abs->SetObjectName( "Magnitude \"abs\"" );
+  AddType::Pointer sum = AddType::New();
+  sum->SetInput1( add->GetOutput() );
+  sum->SetInput2( abs->GetOutput() );
+
+  itk::PipelineProfiler::Pointer profiler = itk::PipelineProfiler::New();
+  EXERCISE_BASIC_OBJECT_METHODS( profiler, itk::PipelineProfiler );
+  profiler->Report();
+
+  profiler->AttachToPipeline( sum->GetOutput() );
+  TEST_EXPECT_EQUAL( profiler->GetNumberOfProcessObjects(), 3u );
+  profiler->AttachToProcessObject( abs );
+  TEST_EXPECT_EQUAL( profiler->GetNumberOfProcessObjects(), 3u );
+
+  TRY_EXPECT_NO_EXCEPTION( sum->Update() );
+  TEST_EXPECT_EQUAL( sum->GetOutput()->GetPixel( ImageType::IndexType() ), 0.0f );
+  TEST_EXPECT_EQUAL( profiler->GetNumberOfExecutions( add ), 1u );
+  TEST_EXPECT_EQUAL( profiler->GetNumberOfExecutions( abs ), 1u );
+  TEST_EXPECT_EQUAL( profiler->GetNumberOfExecutions( sum ), 1u );
+  TEST_EXPECT_TRUE( profiler->GetWallTime( sum ) > 0.0 );
+  TEST_EXPECT_TRUE( profiler->GetCPUTime( sum ) >= 0.0 );
+  TEST_EXPECT_TRUE( profiler->GetPeakMemoryUsage( sum ) > 0 );
+
+  // Only the filters out of date execute again
+  TRY_EXPECT_NO_EXCEPTION( sum->Update() );
+  TEST_EXPECT_EQUAL( profiler->GetNumberOfExecutions( sum ), 1u );
+  abs->Modified();
+  TRY_EXPECT_NO_EXCEPTION( sum->Update() );
+  TEST_EXPECT_EQUAL( profiler->GetNumberOfExecutions( add ), 1u );
+  TEST_EXPECT_EQUAL( profiler->GetNumberOfExecutions( abs ), 2u );
+  TEST_EXPECT_EQUAL( profiler->GetNumberOfExecutions( sum ), 2u );
+
+  std::ostringstream report;
+  profiler->Report( report );
+  std::cout << report.str();
+  TEST_EXPECT_EQUAL( CountOccurrences( report.str(), "AddImageFilter" ), 2u );
+  TEST_EXPECT_EQUAL( CountOccurrences( report.str(), "Magnitude" ), 1u );
+
+  std::ostringstream trace;
+  profiler->WriteChromeTrace( trace );
+  std::cout << trace.str();
+  TEST_EXPECT_EQUAL( CountOccurrences( trace.str(), "\"ph\":\"X\"" ), 5u );
+  TEST_EXPECT_EQUAL( CountOccurrences( trace.str(), "\"Magnitude \\\"abs\\\"\"" ), 2u );
+  TRY_EXPECT_EXCEPTION( profiler->WriteChromeTrace( "/nonexistent/directory/trace.json" ) );
+
+  // Detached filters are no longer measured
+  profiler->Detach();
+  add->Modified();
+  TRY_EXPECT_NO_EXCEPTION( sum->Update() );
+  TEST_EXPECT_EQUAL( profiler->GetNumberOfExecutions( add ), 1u );
+  profiler->Reset();
+  TEST_EXPECT_EQUAL( profiler->GetNumberOfProcessObjects(), 0u );
+
+  // A filter deleted while attached is detached
+  profiler->AttachToPipeline( sum->GetOutput() );
+  abs->Modified();
+  TRY_EXPECT_NO_EXCEPTION( sum->Update() );
+  TEST_EXPECT_EQUAL( profiler->GetNumberOfExecutions( abs ), 1u );
+  sum = ITK_NULLPTR;
+  TEST_EXPECT_EQUAL( profiler->GetNumberOfProcessObjects(), 3u );
+  profiler->Reset();
+  TEST_EXPECT_EQUAL( profiler->GetNumberOfProcessObjects(), 2u );
+
+  return EXIT_SUCCESS;
+}
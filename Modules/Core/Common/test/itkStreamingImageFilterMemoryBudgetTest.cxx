@@ -0,0 +1,151 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkStreamingImageFilter.h"
+#include "itkShrinkImageFilter.h"
+#include "itkCommand.h"
+#include "itkVectorImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+// Count the executions of a filter
+class CountExecutionsCommand: public itk::Command
+{
+public:
+  typedef CountExecutionsCommand   Self;
+  typedef itk::Command             Superclass;
+  typedef itk::SmartPointer< Self > Pointer;
+  itkNewMacro(Self);
+
+  unsigned int m_NumberOfExecutions;
+
+  virtual void Execute(itk::Object *, const itk::EventObject & event)
+  {
+    if ( itk::StartEvent().CheckEvent(&event) )
+      {
+      ++m_NumberOfExecutions;
+      }
+  }
+
+  virtual void Execute(const itk::Object *object, const itk::EventObject & event)
+  {
+    this->Execute(const_cast< itk::Object * >( object ), event);
+  }
+
+protected:
+  CountExecutionsCommand(): m_NumberOfExecutions(0) {}
+};
+}
+
+int itkStreamingImageFilterMemoryBudgetTest(int, char* [] )
+{
+  typedef itk::Image< float, 3 >                            ImageType;
+  typedef itk::ShrinkImageFilter< ImageType, ImageType >    ShrinkType;
+  typedef itk::StreamingImageFilter< ImageType, ImageType > StreamerType;
+
+  // 40 x 30 x 20 floats take 96000 bytes
+  ImageType::SizeType   size = { { 40, 30, 20 } };
+  ImageType::RegionType region( size );
+  ImageType::Pointer    image = ImageType::New();
+  image->SetRegions( region );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, region );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType & index = it.GetIndex();
+    it.Set( static_cast< float >( index[0] + 100 * index[1] + 10000 * index[2] ) );
+    }
+
+  TEST_EXPECT_EQUAL( image->GetPixelSizeInBytes(), sizeof( float ) );
+  TEST_EXPECT_EQUAL( image->GetBufferedRegionSizeInBytes(), 96000u );
+
+  typedef itk::VectorImage< short, 3 > VectorImageType;
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetVectorLength( 3 );
+  vectorImage->SetRegions( region );
+  TEST_EXPECT_EQUAL( vectorImage->GetPixelSizeInBytes(), 3 * sizeof( short ) );
+  TEST_EXPECT_EQUAL( vectorImage->GetRequestedRegionSizeInBytes(), 144000u );
+
+  // Shrinking by 1 copies the pieces of the input
+  ShrinkType::Pointer shrink = ShrinkType::New();
+  shrink->SetInput( image );
+  shrink->SetShrinkFactors( 1 );
+  CountExecutionsCommand::Pointer executions = CountExecutionsCommand::New();
+  shrink->AddObserver( itk::StartEvent(), executions );
+
+  StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( shrink->GetOutput() );
+  TEST_EXPECT_EQUAL( streamer->GetMemoryBudget(), 0u );
+
+  // Without a budget, the number of divisions is used
+  streamer->SetNumberOfStreamDivisions( 3 );
+  TRY_EXPECT_NO_EXCEPTION( streamer->Update() );
+  TEST_EXPECT_EQUAL( streamer->GetNumberOfStreamDivisionsUsed(), 3u );
+  TEST_EXPECT_EQUAL( executions->m_NumberOfExecutions, 3u );
+
+  // The output and the input image take 192000 bytes, which leaves 24000
+  // bytes, i.e. 5 slices, for the pieces of the output of the filter
+  streamer->SetMemoryBudget( 216000 );
+  streamer->Modified();
+  executions->m_NumberOfExecutions = 0;
+  TRY_EXPECT_NO_EXCEPTION( streamer->Update() );
+  std::cout << streamer;
+  TEST_EXPECT_EQUAL( streamer->GetNumberOfStreamDivisionsUsed(), 4u );
+  TEST_EXPECT_EQUAL( streamer->GetEstimatedPeakMemory(), 216000u );
+  TEST_EXPECT_EQUAL( executions->m_NumberOfExecutions, 4u );
+
+  // One byte less requires smaller pieces
+  streamer->SetMemoryBudget( 215999 );
+  streamer->Modified();
+  TRY_EXPECT_NO_EXCEPTION( streamer->Update() );
+  TEST_EXPECT_EQUAL( streamer->GetNumberOfStreamDivisionsUsed(), 5u );
+  TEST_EXPECT_EQUAL( streamer->GetEstimatedPeakMemory(), 211200u );
+
+  // A budget larger than the whole pipeline does not stream
+  streamer->SetMemoryBudget( 1000000 );
+  streamer->Modified();
+  TRY_EXPECT_NO_EXCEPTION( streamer->Update() );
+  TEST_EXPECT_EQUAL( streamer->GetNumberOfStreamDivisionsUsed(), 1u );
+  TEST_EXPECT_EQUAL( streamer->GetEstimatedPeakMemory(), 288000u );
+
+  // A budget too small for the output and the input streams as much as
+  // the splitter allows
+  streamer->SetMemoryBudget( 100000 );
+  streamer->Modified();
+  TRY_EXPECT_NO_EXCEPTION( streamer->Update() );
+  TEST_EXPECT_EQUAL( streamer->GetNumberOfStreamDivisionsUsed(), 20u );
+  TEST_EXPECT_EQUAL( streamer->GetEstimatedPeakMemory(), 96000u + 96000u + 4800u );
+
+  // The output is the same in every case
+  itk::ImageRegionConstIterator< ImageType > inputIt( image, region );
+  itk::ImageRegionConstIterator< ImageType > outputIt( streamer->GetOutput(), region );
+  for ( ; !inputIt.IsAtEnd(); ++inputIt, ++outputIt )
+    {
+    if ( inputIt.Get() != outputIt.Get() )
+      {
+      std::cerr << "Output differs from the input at " << inputIt.GetIndex() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,166 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkThreadPool.h"
+#include "itkMultiThreader.h"
+
+#include <iostream>
+#include <algorithm>
+
+namespace
+{
+struct ThreadPoolTestData
+{
+  itk::SimpleFastMutexLock m_Lock;
+  unsigned int             m_Calls[ITK_MAX_THREADS];
+  unsigned int             m_NestedCalls;
+};
+
+ITK_THREAD_RETURN_TYPE NestedThreadedMethod(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct *info =
+    static_cast< itk::MultiThreader::ThreadInfoStruct * >( arg );
+  ThreadPoolTestData *data = static_cast< ThreadPoolTestData * >( info->UserData );
+
+  data->m_Lock.Lock();
+  ++data->m_NestedCalls;
+  data->m_Lock.Unlock();
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+ITK_THREAD_RETURN_TYPE ThreadedMethod(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct *info =
+    static_cast< itk::MultiThreader::ThreadInfoStruct * >( arg );
+  ThreadPoolTestData *data = static_cast< ThreadPoolTestData * >( info->UserData );
+
+  data->m_Lock.Lock();
+  ++data->m_Calls[info->ThreadID];
+  data->m_Lock.Unlock();
+
+  // Run a multithreaded execution from within a pooled thread, as a filter
+  // updating a mini-pipeline in its ThreadedGenerateData would.
+  itk::MultiThreader::Pointer nested = itk::MultiThreader::New();
+  nested->UseThreadPoolOn();
+  nested->SetNumberOfThreads(4);
+  nested->SetSingleMethod(NestedThreadedMethod, data);
+  nested->SingleMethodExecute();
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+ITK_THREAD_RETURN_TYPE ThrowingThreadedMethod(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct *info =
+    static_cast< itk::MultiThreader::ThreadInfoStruct * >( arg );
+  if ( info->ThreadID == info->NumberOfThreads - 1 )
+    {
+    itkGenericExceptionMacro(<< "Exception thrown from a pooled thread");
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+}
+
+int itkThreadPoolTest(int, char *[])
+{
+  itk::ThreadPool::Pointer pool = itk::ThreadPool::GetInstance();
+  if ( pool != itk::ThreadPool::New() )
+    {
+    std::cerr << "ThreadPool::New() did not return the global instance" << std::endl;
+    return EXIT_FAILURE;
+    }
+  pool->Print(std::cout);
+
+  itk::MultiThreader::SetGlobalDefaultUseThreadPool(true);
+  if ( !itk::MultiThreader::GetGlobalDefaultUseThreadPool() )
+    {
+    std::cerr << "SetGlobalDefaultUseThreadPool(true) was ignored" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  if ( !threader->GetUseThreadPool() )
+    {
+    std::cerr << "New MultiThreader does not use the global default" << std::endl;
+    return EXIT_FAILURE;
+    }
+  threader->SetNumberOfThreads(8);
+  const itk::ThreadIdType numberOfThreads = threader->GetNumberOfThreads();
+
+  ThreadPoolTestData data;
+  for ( itk::ThreadIdType i = 0; i < ITK_MAX_THREADS; ++i )
+    {
+    data.m_Calls[i] = 0;
+    }
+  data.m_NestedCalls = 0;
+
+  // Repeated executions must reuse the same workers.
+  const unsigned int numberOfExecutions = 20;
+  threader->SetSingleMethod(ThreadedMethod, &data);
+  for ( unsigned int e = 0; e < numberOfExecutions; ++e )
+    {
+    threader->SingleMethodExecute();
+    }
+
+  for ( itk::ThreadIdType i = 0; i < numberOfThreads; ++i )
+    {
+    if ( data.m_Calls[i] != numberOfExecutions )
+      {
+      std::cerr << "Thread " << i << " ran " << data.m_Calls[i]
+                << " times instead of " << numberOfExecutions << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  const itk::ThreadIdType nestedThreads =
+    std::min( static_cast< itk::ThreadIdType >( 4 ), itk::MultiThreader::GetGlobalMaximumNumberOfThreads() );
+  if ( data.m_NestedCalls != numberOfExecutions * numberOfThreads * nestedThreads )
+    {
+    std::cerr << "Nested executions ran " << data.m_NestedCalls << " times instead of "
+              << numberOfExecutions * numberOfThreads * nestedThreads << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if ( pool->GetNumberOfThreads() > ITK_MAX_THREADS )
+    {
+    std::cerr << "The pool grew past ITK_MAX_THREADS" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Pool threads after execution: " << pool->GetNumberOfThreads() << std::endl;
+
+  // Exceptions in a pooled thread are reported as with spawned threads.
+  threader->SetSingleMethod(ThrowingThreadedMethod, ITK_NULLPTR);
+  bool caught = false;
+  try
+    {
+    threader->SingleMethodExecute();
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cout << "Caught expected exception: " << e.GetDescription() << std::endl;
+    caught = true;
+    }
+  if ( !caught )
+    {
+    std::cerr << "Exception in a pooled thread was not reported" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  itk::MultiThreader::SetGlobalDefaultUseThreadPool(false);
+
+  return EXIT_SUCCESS;
+}
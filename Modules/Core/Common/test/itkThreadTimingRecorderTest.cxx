@@ -0,0 +1,168 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkThreadTimingRecorder.h"
+#include "itkImageSource.h"
+#include "itkImageRegionIterator.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+#include <sstream>
+
+namespace itk
+{
+/** A source whose first slices are much slower to generate than the
+ * others. */
+template< typename TOutputImage >
+class ThreadTimingRecorderTestSource:public ImageSource< TOutputImage >
+{
+public:
+  typedef ThreadTimingRecorderTestSource Self;
+  typedef ImageSource< TOutputImage >    Superclass;
+  typedef SmartPointer< Self >           Pointer;
+  typedef SmartPointer< const Self >     ConstPointer;
+
+  itkNewMacro(Self);
+  itkTypeMacro(ThreadTimingRecorderTestSource, ImageSource);
+
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
+protected:
+  ThreadTimingRecorderTestSource()
+  {
+    typename TOutputImage::RegionType region;
+    typename TOutputImage::SizeType   size;
+    size.Fill(32);
+    region.SetSize(size);
+    this->GetOutput()->SetRegions(region);
+  }
+
+  virtual void ThreadedGenerateData(const OutputImageRegionType & region, ThreadIdType) ITK_OVERRIDE
+  {
+    this->Generate(region);
+  }
+
+  virtual void DynamicThreadedGenerateData(const OutputImageRegionType & region) ITK_OVERRIDE
+  {
+    this->Generate(region);
+  }
+
+  void Generate(const OutputImageRegionType & region)
+  {
+    for ( IndexValueType z = region.GetIndex(2); z < region.GetUpperIndex()[2] + 1; ++z )
+      {
+      if ( z < 8 )
+        {
+        itksys::SystemTools::Delay(20);
+        }
+      }
+    ImageRegionIterator< TOutputImage > it(this->GetOutput(), region);
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      it.Set(1);
+      }
+  }
+
+private:
+  ThreadTimingRecorderTestSource(const Self &); //purposely not implemented
+  void operator=(const Self &);                 //purposely not implemented
+};
+}
+
+// Record the work of the threads of a filter whose load is not balanced by
+// the static split of its region, and is balanced by dynamic scheduling.
+int itkThreadTimingRecorderTest(int, char *[])
+{
+  typedef itk::Image< unsigned char, 3 >                     ImageType;
+  typedef itk::ThreadTimingRecorderTestSource< ImageType > SourceType;
+  typedef itk::ThreadTimingRecorder                        RecorderType;
+
+  RecorderType::Pointer recorder = RecorderType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( recorder, RecorderType );
+  TEST_EXPECT_TRUE( RecorderType::GetGlobalRecorder() == ITK_NULLPTR );
+  TRY_EXPECT_EXCEPTION( recorder->GetExecution( 0 ) );
+  recorder->Report();
+
+  // Nothing is recorded without a recorder
+  SourceType::Pointer source = SourceType::New();
+  source->SetNumberOfThreads( 4 );
+  TEST_EXPECT_TRUE( source->GetThreadTimingRecorder() == ITK_NULLPTR );
+  TRY_EXPECT_NO_EXCEPTION( source->Update() );
+  TEST_EXPECT_EQUAL( recorder->GetNumberOfExecutions(), 0u );
+
+  // Static split, where the first thread gets all the slow slices
+  source->SetThreadTimingRecorder( recorder );
+  source->Modified();
+  TRY_EXPECT_NO_EXCEPTION( source->Update() );
+  TEST_EXPECT_EQUAL( recorder->GetNumberOfExecutions(), 1u );
+  const RecorderType::ExecutionRecord & execution = recorder->GetExecution( 0 );
+  TEST_EXPECT_EQUAL( execution.Name, std::string( "ThreadTimingRecorderTestSource" ) );
+  TEST_EXPECT_EQUAL( execution.Threads.size(), 4u );
+  itk::SizeValueType numberOfPixels = 0;
+  for ( unsigned int t = 0; t < execution.Threads.size(); ++t )
+    {
+    const RecorderType::ThreadRecord & thread = execution.Threads[t];
+    TEST_EXPECT_EQUAL( thread.NumberOfPieces, 1u );
+    TEST_EXPECT_TRUE( thread.StartTime >= execution.StartTime );
+    TEST_EXPECT_TRUE( thread.StopTime <= execution.StopTime );
+    TEST_EXPECT_TRUE( thread.BusyTime <= thread.StopTime - thread.StartTime + 1e-6 );
+    numberOfPixels += thread.NumberOfPixels;
+    }
+  TEST_EXPECT_EQUAL( numberOfPixels, 32u * 32u * 32u );
+  TEST_EXPECT_EQUAL( recorder->GetPixelImbalanceRatio( 0 ), 1.0 );
+  std::cout << "Static imbalance: " << recorder->GetImbalanceRatio( 0 ) << std::endl;
+  TEST_EXPECT_TRUE( recorder->GetImbalanceRatio( 0 ) > 2.0 );
+
+  // Dynamic scheduling spreads the slow slices over the threads
+  source->DynamicMultiThreadingOn();
+  source->Modified();
+  TRY_EXPECT_NO_EXCEPTION( source->Update() );
+  TEST_EXPECT_EQUAL( recorder->GetNumberOfExecutions(), 2u );
+  itk::SizeValueType numberOfPieces = 0;
+  for ( unsigned int t = 0; t < recorder->GetExecution( 1 ).Threads.size(); ++t )
+    {
+    numberOfPieces += recorder->GetExecution( 1 ).Threads[t].NumberOfPieces;
+    }
+  TEST_EXPECT_EQUAL( numberOfPieces, 32u );
+  std::cout << "Dynamic imbalance: " << recorder->GetImbalanceRatio( 1 ) << std::endl;
+  TEST_EXPECT_TRUE( recorder->GetImbalanceRatio( 1 ) < recorder->GetImbalanceRatio( 0 ) );
+
+  recorder->Report();
+  std::ostringstream trace;
+  recorder->WriteChromeTrace( trace );
+  std::cout << trace.str();
+  TEST_EXPECT_TRUE( trace.str().find( "\"ph\":\"M\",\"pid\":1" ) != std::string::npos );
+  TRY_EXPECT_EXCEPTION( recorder->WriteChromeTrace( "/nonexistent/directory/trace.json" ) );
+
+  // The global recorder is used by the filters without their own
+  RecorderType::Pointer globalRecorder = RecorderType::New();
+  RecorderType::SetGlobalRecorder( globalRecorder );
+  SourceType::Pointer other = SourceType::New();
+  other->SetObjectName( "Other" );
+  TRY_EXPECT_NO_EXCEPTION( other->Update() );
+  source->Modified();
+  TRY_EXPECT_NO_EXCEPTION( source->Update() );
+  RecorderType::SetGlobalRecorder( ITK_NULLPTR );
+  TEST_EXPECT_EQUAL( globalRecorder->GetNumberOfExecutions(), 1u );
+  TEST_EXPECT_EQUAL( globalRecorder->GetExecution( 0 ).Name, std::string( "Other" ) );
+  TEST_EXPECT_EQUAL( recorder->GetNumberOfExecutions(), 3u );
+
+  recorder->Reset();
+  TEST_EXPECT_EQUAL( recorder->GetNumberOfExecutions(), 0u );
+
+  return EXIT_SUCCESS;
+}
@@ -20,6 +20,8 @@
 
 #include "itkInPlaceImageFilter.h"
 #include "itkSimpleDataObjectDecorator.h"
+#include "itkScanlineSpanTraits.h"
+#include "itkProgressReporter.h"
 
 namespace itk
 {
@@ -36,6 +38,11 @@ namespace itk
  * the pipeline. The SetConstant() and GetConstant() methods are provided as shortcuts
  * to set or get the constant value without manipulating the decorator.
  *
+ * When the inputs and output are Images, each scanline is processed as a
+ * plain array of pixels, which lets the compiler vectorize the loop.
+ * Functors can provide their own implementation for whole scanlines;
+ * see Functor::SpanFunctorTraits.
+ *
  * \sa UnaryFunctorImageFilter TernaryFunctorImageFilter
  *
  * \ingroup IntensityImageFilters   MultiThreaded
@@ -149,6 +156,13 @@ public:
       }
   }
 
+  /** Set/Get whether scanlines are processed as plain arrays of pixels
+   * when the image types allow it. On by default. When off, the functor
+   * is called through the iterators, one pixel at a time. */
+  itkSetMacro(UseScanlineSpans, bool);
+  itkGetConstMacro(UseScanlineSpans, bool);
+  itkBooleanMacro(UseScanlineSpans);
+
   /** ImageDimension constants */
   itkStaticConstMacro(
     InputImage1Dimension, unsigned int, TInputImage1::ImageDimension);
@@ -193,7 +207,39 @@ private:
   BinaryFunctorImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);           //purposely not implemented
 
+  typedef ScanlineSpanTag< ImageScanlineSpanTraits< TInputImage1 >::Value
+                           && ImageScanlineSpanTraits< TInputImage2 >::Value
+                           && ImageScanlineSpanTraits< TOutputImage >::Value > ScanlineSpansType;
+
+  /** Apply the functor to the scanlines of the region, pixel by pixel
+   * or as spans of pixels. One of the inputs may be NULL, when it is a
+   * constant. */
+  void ProcessScanlines(const TInputImage1 *inputPtr1, const TInputImage2 *inputPtr2,
+                        const OutputImageRegionType & region,
+                        ProgressReporter & progress, const FalseType &);
+
+  void ProcessScanlines(const TInputImage1 *inputPtr1, const TInputImage2 *inputPtr2,
+                        const OutputImageRegionType & region,
+                        ProgressReporter & progress, const TrueType &);
+
+  /** Apply the functor to spans of n pixels of both inputs. */
+  void ProcessSpan(const Input1ImagePixelType *in1, const Input2ImagePixelType *in2,
+                   OutputImagePixelType *out, SizeValueType n, const FalseType &)
+  {
+    for ( SizeValueType i = 0; i < n; ++i )
+      {
+      out[i] = m_Functor(in1[i], in2[i]);
+      }
+  }
+
+  void ProcessSpan(const Input1ImagePixelType *in1, const Input2ImagePixelType *in2,
+                   OutputImagePixelType *out, SizeValueType n, const TrueType &)
+  {
+    m_Functor.ProcessSpan(in1, in2, out, n);
+  }
+
   FunctorType m_Functor;
+  bool        m_UseScanlineSpans;
 };
 } // end namespace itk
 
@@ -35,6 +35,7 @@ BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
 {
   this->SetNumberOfRequiredInputs(2);
   this->InPlaceOff();
+  m_UseScanlineSpans = true;
 }
 
 /**
@@ -213,23 +214,42 @@ BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
     dynamic_cast< const TInputImage1 * >( ProcessObject::GetInput(0) );
   const TInputImage2 *inputPtr2 =
     dynamic_cast< const TInputImage2 * >( ProcessObject::GetInput(1) );
-  TOutputImage *outputPtr = this->GetOutput(0);
   const SizeValueType size0 = outputRegionForThread.GetSize(0);
   if( size0 == 0)
     {
     return;
     }
+  if( !inputPtr1 && !inputPtr2 )
+    {
+    itkGenericExceptionMacro(<<"At most one of the inputs can be a constant.");
+    }
   const size_t numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / size0;
+  ProgressReporter progress( this, threadId, numberOfLinesToProcess );
 
-  if( inputPtr1 && inputPtr2 )
+  if ( m_UseScanlineSpans )
     {
-    ImageScanlineConstIterator< TInputImage1 > inputIt1(inputPtr1, outputRegionForThread);
-    ImageScanlineConstIterator< TInputImage2 > inputIt2(inputPtr2, outputRegionForThread);
-    ImageScanlineIterator< TOutputImage > outputIt(outputPtr, outputRegionForThread);
-
+    this->ProcessScanlines( inputPtr1, inputPtr2, outputRegionForThread, progress, ScanlineSpansType() );
+    }
+  else
+    {
+    this->ProcessScanlines( inputPtr1, inputPtr2, outputRegionForThread, progress, FalseType() );
+    }
+}
 
-    ProgressReporter progress( this, threadId, numberOfLinesToProcess );
+template< typename TInputImage1, typename TInputImage2, typename TOutputImage, typename TFunction  >
+void
+BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
+::ProcessScanlines(const TInputImage1 *inputPtr1, const TInputImage2 *inputPtr2,
+                   const OutputImageRegionType & region,
+                   ProgressReporter & progress, const FalseType &)
+{
+  TOutputImage *outputPtr = this->GetOutput(0);
 
+  if( inputPtr1 && inputPtr2 )
+    {
+    ImageScanlineConstIterator< TInputImage1 > inputIt1(inputPtr1, region);
+    ImageScanlineConstIterator< TInputImage2 > inputIt2(inputPtr2, region);
+    ImageScanlineIterator< TOutputImage > outputIt(outputPtr, region);
 
     while ( !inputIt1.IsAtEnd() )
       {
@@ -249,11 +269,10 @@ BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
     }
   else if( inputPtr1 )
     {
-    ImageScanlineConstIterator< TInputImage1 > inputIt1(inputPtr1, outputRegionForThread);
-    ImageScanlineIterator< TOutputImage > outputIt(outputPtr, outputRegionForThread);
+    ImageScanlineConstIterator< TInputImage1 > inputIt1(inputPtr1, region);
+    ImageScanlineIterator< TOutputImage > outputIt(outputPtr, region);
 
     const Input2ImagePixelType & input2Value = this->GetConstant2();
-    ProgressReporter progress( this, threadId, numberOfLinesToProcess );
 
     while ( !inputIt1.IsAtEnd() )
       {
@@ -268,14 +287,12 @@ BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
       progress.CompletedPixel(); // potential exception thrown here
       }
     }
-  else if( inputPtr2 )
+  else
     {
-    ImageScanlineConstIterator< TInputImage2 > inputIt2(inputPtr2, outputRegionForThread);
-    ImageScanlineIterator< TOutputImage > outputIt(outputPtr, outputRegionForThread);
+    ImageScanlineConstIterator< TInputImage2 > inputIt2(inputPtr2, region);
+    ImageScanlineIterator< TOutputImage > outputIt(outputPtr, region);
 
     const Input1ImagePixelType & input1Value = this->GetConstant1();
-    ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
-
 
     while ( !inputIt2.IsAtEnd() )
       {
@@ -290,9 +307,70 @@ BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
       progress.CompletedPixel(); // potential exception thrown here
       }
     }
+}
+
+template< typename TInputImage1, typename TInputImage2, typename TOutputImage, typename TFunction  >
+void
+BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
+::ProcessScanlines(const TInputImage1 *inputPtr1, const TInputImage2 *inputPtr2,
+                   const OutputImageRegionType & region,
+                   ProgressReporter & progress, const TrueType &)
+{
+  TOutputImage *      outputPtr = this->GetOutput(0);
+  const SizeValueType length = region.GetSize(0);
+
+  ImageScanlineIterator< TOutputImage > outputIt(outputPtr, region);
+
+  if( inputPtr1 && inputPtr2 )
+    {
+    ImageScanlineConstIterator< TInputImage1 > inputIt1(inputPtr1, region);
+    ImageScanlineConstIterator< TInputImage2 > inputIt2(inputPtr2, region);
+
+    typename Functor::SpanFunctorTraits< FunctorType >::Type functorSpans;
+    while ( !outputIt.IsAtEnd() )
+      {
+      this->ProcessSpan( &inputIt1.Value(), &inputIt2.Value(), &outputIt.Value(), length, functorSpans );
+      inputIt1.NextLine();
+      inputIt2.NextLine();
+      outputIt.NextLine();
+      progress.CompletedPixel(); // potential exception thrown here
+      }
+    }
+  else if( inputPtr1 )
+    {
+    ImageScanlineConstIterator< TInputImage1 > inputIt1(inputPtr1, region);
+
+    const Input2ImagePixelType input2Value = this->GetConstant2();
+    while ( !outputIt.IsAtEnd() )
+      {
+      const Input1ImagePixelType *in1 = &inputIt1.Value();
+      OutputImagePixelType *      out = &outputIt.Value();
+      for ( SizeValueType i = 0; i < length; ++i )
+        {
+        out[i] = m_Functor( in1[i], input2Value );
+        }
+      inputIt1.NextLine();
+      outputIt.NextLine();
+      progress.CompletedPixel(); // potential exception thrown here
+      }
+    }
   else
     {
-    itkGenericExceptionMacro(<<"At most one of the inputs can be a constant.");
+    ImageScanlineConstIterator< TInputImage2 > inputIt2(inputPtr2, region);
+
+    const Input1ImagePixelType input1Value = this->GetConstant1();
+    while ( !outputIt.IsAtEnd() )
+      {
+      const Input2ImagePixelType *in2 = &inputIt2.Value();
+      OutputImagePixelType *      out = &outputIt.Value();
+      for ( SizeValueType i = 0; i < length; ++i )
+        {
+        out[i] = m_Functor( input1Value, in2[i] );
+        }
+      inputIt2.NextLine();
+      outputIt.NextLine();
+      progress.CompletedPixel(); // potential exception thrown here
+      }
     }
 }
 } // end namespace itk
@@ -0,0 +1,180 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkFunctorComposition_h
+#define __itkFunctorComposition_h
+
+namespace itk
+{
+namespace Functor
+{
+/** \class ComposeUnary
+ * \brief Apply two unary functors one after the other.
+ *
+ * Computes TFunctor2( TFunctor1(x) ), the result of TFunctor1 being
+ * converted to TIntermediate first. Used with UnaryFunctorImageFilter,
+ * it gives the same output as two UnaryFunctorImageFilters in a row, the
+ * first one producing an image of TIntermediate pixels, without the
+ * intermediate image.
+ *
+ * Compositions can be nested to fuse longer chains:
+ * \code
+ * typedef itk::Functor::ComposeUnary< short, float, float,
+ *   CastFunctorType, ShiftScaleFunctorType >           CastShiftScaleType;
+ * typedef itk::Functor::ComposeUnary< short, float, unsigned char,
+ *   CastShiftScaleType, ThresholdFunctorType >         FusedFunctorType;
+ * typedef itk::UnaryFunctorImageFilter< ShortImageType, ByteImageType,
+ *   FusedFunctorType >                                 FusedFilterType;
+ * \endcode
+ *
+ * \sa ComposeBinaryUnary ComposeUnaryBinary FunctorPipelineImageFilter
+ * \ingroup ITKImageFilterBase
+ */
+template< typename TInput, typename TIntermediate, typename TOutput,
+          typename TFunctor1, typename TFunctor2 >
+class ComposeUnary
+{
+public:
+  ComposeUnary() {}
+  ComposeUnary(const TFunctor1 & functor1, const TFunctor2 & functor2):
+    m_Functor1(functor1), m_Functor2(functor2) {}
+  ~ComposeUnary() {}
+
+  TFunctor1 & GetFunctor1() { return m_Functor1; }
+  const TFunctor1 & GetFunctor1() const { return m_Functor1; }
+  TFunctor2 & GetFunctor2() { return m_Functor2; }
+  const TFunctor2 & GetFunctor2() const { return m_Functor2; }
+
+  bool operator!=(const ComposeUnary & other) const
+  {
+    return m_Functor1 != other.m_Functor1 || m_Functor2 != other.m_Functor2;
+  }
+
+  bool operator==(const ComposeUnary & other) const
+  {
+    return !( *this != other );
+  }
+
+  inline TOutput operator()(const TInput & A) const
+  {
+    const TIntermediate intermediate = m_Functor1(A);
+
+    return m_Functor2(intermediate);
+  }
+
+private:
+  TFunctor1 m_Functor1;
+  TFunctor2 m_Functor2;
+};
+
+/** \class ComposeBinaryUnary
+ * \brief Apply a unary functor to the result of a binary functor.
+ *
+ * Computes TUnaryFunctor( TBinaryFunctor(A, B) ), the result of the
+ * binary functor being converted to TIntermediate first.
+ *
+ * \sa ComposeUnary ComposeUnaryBinary
+ * \ingroup ITKImageFilterBase
+ */
+template< typename TInput1, typename TInput2, typename TIntermediate, typename TOutput,
+          typename TBinaryFunctor, typename TUnaryFunctor >
+class ComposeBinaryUnary
+{
+public:
+  ComposeBinaryUnary() {}
+  ComposeBinaryUnary(const TBinaryFunctor & binaryFunctor, const TUnaryFunctor & unaryFunctor):
+    m_BinaryFunctor(binaryFunctor), m_UnaryFunctor(unaryFunctor) {}
+  ~ComposeBinaryUnary() {}
+
+  TBinaryFunctor & GetBinaryFunctor() { return m_BinaryFunctor; }
+  const TBinaryFunctor & GetBinaryFunctor() const { return m_BinaryFunctor; }
+  TUnaryFunctor & GetUnaryFunctor() { return m_UnaryFunctor; }
+  const TUnaryFunctor & GetUnaryFunctor() const { return m_UnaryFunctor; }
+
+  bool operator!=(const ComposeBinaryUnary & other) const
+  {
+    return m_BinaryFunctor != other.m_BinaryFunctor || m_UnaryFunctor != other.m_UnaryFunctor;
+  }
+
+  bool operator==(const ComposeBinaryUnary & other) const
+  {
+    return !( *this != other );
+  }
+
+  inline TOutput operator()(const TInput1 & A, const TInput2 & B) const
+  {
+    const TIntermediate intermediate = m_BinaryFunctor(A, B);
+
+    return m_UnaryFunctor(intermediate);
+  }
+
+private:
+  TBinaryFunctor m_BinaryFunctor;
+  TUnaryFunctor  m_UnaryFunctor;
+};
+
+/** \class ComposeUnaryBinary
+ * \brief Apply a binary functor to the result of a unary functor and a
+ * second operand.
+ *
+ * Computes TBinaryFunctor( TUnaryFunctor(A), B ), the result of the
+ * unary functor being converted to TIntermediate first. This fuses, for
+ * instance, a chain of unary filters followed by a mask.
+ *
+ * \sa ComposeUnary ComposeBinaryUnary
+ * \ingroup ITKImageFilterBase
+ */
+template< typename TInput1, typename TIntermediate, typename TInput2, typename TOutput,
+          typename TUnaryFunctor, typename TBinaryFunctor >
+class ComposeUnaryBinary
+{
+public:
+  ComposeUnaryBinary() {}
+  ComposeUnaryBinary(const TUnaryFunctor & unaryFunctor, const TBinaryFunctor & binaryFunctor):
+    m_UnaryFunctor(unaryFunctor), m_BinaryFunctor(binaryFunctor) {}
+  ~ComposeUnaryBinary() {}
+
+  TUnaryFunctor & GetUnaryFunctor() { return m_UnaryFunctor; }
+  const TUnaryFunctor & GetUnaryFunctor() const { return m_UnaryFunctor; }
+  TBinaryFunctor & GetBinaryFunctor() { return m_BinaryFunctor; }
+  const TBinaryFunctor & GetBinaryFunctor() const { return m_BinaryFunctor; }
+
+  bool operator!=(const ComposeUnaryBinary & other) const
+  {
+    return m_UnaryFunctor != other.m_UnaryFunctor || m_BinaryFunctor != other.m_BinaryFunctor;
+  }
+
+  bool operator==(const ComposeUnaryBinary & other) const
+  {
+    return !( *this != other );
+  }
+
+  inline TOutput operator()(const TInput1 & A, const TInput2 & B) const
+  {
+    const TIntermediate intermediate = m_UnaryFunctor(A);
+
+    return m_BinaryFunctor(intermediate, B);
+  }
+
+private:
+  TUnaryFunctor  m_UnaryFunctor;
+  TBinaryFunctor m_BinaryFunctor;
+};
+} // end namespace Functor
+} // end namespace itk
+
+#endif
@@ -0,0 +1,344 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkFunctorPipelineImageFilter_h
+#define __itkFunctorPipelineImageFilter_h
+
+#include "itkInPlaceImageFilter.h"
+#include "itkImageScanlineIterator.h"
+#include "itkScanlineSpanTraits.h"
+#include <typeinfo>
+#include <vector>
+
+namespace itk
+{
+/** \class FunctorPipelineImageFilter
+ * \brief Apply a chain of pixel-wise functors in a single pass.
+ *
+ * A chain of pixel-wise filters, such as a cast followed by a shift and
+ * scale, a threshold and a mask, produces a full intermediate image at
+ * each step. FunctorPipelineImageFilter applies the functors of such a
+ * chain one after the other to each scanline of the input, the
+ * intermediate values being kept in scanline buffers, and only produces
+ * the final image.
+ *
+ * The functors are the ones used with UnaryFunctorImageFilter and
+ * BinaryFunctorImageFilter, and are added at run time along with the
+ * pixel types they work on:
+ *
+ * \code
+ * filter->AddUnaryFunctor< short, float >( castFunctor );
+ * filter->AddUnaryFunctor< float, float >( shiftScaleFunctor );
+ * filter->AddUnaryFunctor< float, unsigned char >( thresholdFunctor );
+ * filter->AddBinaryFunctor< unsigned char, unsigned char, unsigned char >( maskFunctor, maskImage );
+ * \endcode
+ *
+ * The input type of each functor must be the output type of the previous
+ * one, or the input pixel type for the first functor, and the output
+ * type of the last functor must be the output pixel type. Each value is
+ * converted to the output type of its functor before being passed to the
+ * next one, so that the output is the same as the one of the chain of
+ * filters with these pixel types. The second operand of a binary functor
+ * is an Image of the same dimension, which becomes an additional input of
+ * the filter.
+ *
+ * When the chain is known at compile time, the functors can also be
+ * composed with Functor::ComposeUnary, Functor::ComposeBinaryUnary and
+ * Functor::ComposeUnaryBinary and used with the functor image filters,
+ * which lets the compiler inline the whole chain.
+ *
+ * \sa UnaryFunctorImageFilter BinaryFunctorImageFilter
+ *
+ * \ingroup IntensityImageFilters   MultiThreaded
+ * \ingroup ITKImageFilterBase
+ */
+template< typename TInputImage, typename TOutputImage = TInputImage >
+class FunctorPipelineImageFilter:
+  public InPlaceImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard class typedefs. */
+  typedef FunctorPipelineImageFilter                      Self;
+  typedef InPlaceImageFilter< TInputImage, TOutputImage > Superclass;
+  typedef SmartPointer< Self >                            Pointer;
+  typedef SmartPointer< const Self >                      ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(FunctorPipelineImageFilter, InPlaceImageFilter);
+
+  /** Some convenient typedefs. */
+  typedef TInputImage                          InputImageType;
+  typedef typename InputImageType::PixelType   InputImagePixelType;
+  typedef typename InputImageType::RegionType  InputImageRegionType;
+  typedef TOutputImage                         OutputImageType;
+  typedef typename OutputImageType::PixelType  OutputImagePixelType;
+  typedef typename OutputImageType::RegionType OutputImageRegionType;
+  typedef typename OutputImageType::IndexType  OutputImageIndexType;
+
+  /** ImageDimension constants */
+  itkStaticConstMacro(InputImageDimension, unsigned int, TInputImage::ImageDimension);
+  itkStaticConstMacro(OutputImageDimension, unsigned int, TOutputImage::ImageDimension);
+
+  /** Append a unary functor computing TOutput values from TInput values
+   * to the chain. An exception is thrown if TInput is not the output
+   * type of the previous functor. */
+  template< typename TInput, typename TOutput, typename TFunctor >
+  void AddUnaryFunctor(const TFunctor & functor)
+  {
+    this->AddStage( new UnaryStage< TInput, TOutput, TFunctor >(functor) );
+  }
+
+  /** Append a binary functor to the chain. Its first argument is the
+   * output of the previous functor and its second argument the pixels of
+   * operand, which is added to the inputs of the filter. */
+  template< typename TInput1, typename TInput2, typename TOutput, typename TFunctor >
+  void AddBinaryFunctor(const TFunctor & functor,
+                        const Image< TInput2, itkGetStaticConstMacro(OutputImageDimension) > *operand)
+  {
+    if ( !operand )
+      {
+      itkExceptionMacro(<< "The operand of a binary functor must not be NULL.");
+      }
+    const unsigned int operandIndex = static_cast< unsigned int >( this->GetNumberOfIndexedInputs() );
+    this->AddStage( new BinaryStage< TInput1, TInput2, TOutput, TFunctor >(functor, operandIndex) );
+    this->SetNthInput( operandIndex, const_cast< Image< TInput2, OutputImageDimension > * >( operand ) );
+  }
+
+  /** Remove all the functors, and the operands of the binary ones. */
+  void ClearFunctors();
+
+  /** Number of functors in the chain. */
+  unsigned int GetNumberOfFunctors() const
+  {
+    return static_cast< unsigned int >( m_Stages.size() );
+  }
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  // Begin concept checking
+  itkConceptMacro( SameDimensionCheck,
+                   ( Concept::SameDimension< itkGetStaticConstMacro(InputImageDimension),
+                                             itkGetStaticConstMacro(OutputImageDimension) > ) );
+  // End concept checking
+#endif
+
+protected:
+  FunctorPipelineImageFilter();
+  virtual ~FunctorPipelineImageFilter();
+
+  /** Check that the chain ends with the output pixel type. */
+  virtual void BeforeThreadedGenerateData() ITK_OVERRIDE;
+
+  /** Apply the chain to each scanline of the region. */
+  virtual void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                    ThreadIdType threadId) ITK_OVERRIDE;
+
+  virtual void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+private:
+  FunctorPipelineImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);             //purposely not implemented
+
+  /** Buffer holding one scanline of intermediate values. */
+  class LineBufferBase
+  {
+  public:
+    virtual ~LineBufferBase() {}
+    virtual void * GetPointer() = 0;
+  };
+
+  template< typename TPixel >
+  class LineBuffer: public LineBufferBase
+  {
+  public:
+    LineBuffer(SizeValueType length): m_Pixels(length) {}
+    virtual void * GetPointer() ITK_OVERRIDE { return &m_Pixels[0]; }
+
+  private:
+    std::vector< TPixel > m_Pixels;
+  };
+
+  /** One functor of the chain, with its pixel types erased. */
+  class StageBase
+  {
+  public:
+    virtual ~StageBase() {}
+    virtual const std::type_info & GetInputType() const = 0;
+    virtual const std::type_info & GetOutputType() const = 0;
+
+    /** Index of the operand in the inputs of the filter, 0 for unary
+     * functors. */
+    virtual unsigned int GetOperandIndex() const { return 0; }
+
+    /** Pointer to the pixel at index in the operand of a binary functor */
+    virtual const void * GetOperandPixels(const DataObject *, const OutputImageIndexType &) const
+    {
+      return ITK_NULLPTR;
+    }
+
+    /** New buffer for a scanline of output values. */
+    virtual LineBufferBase * NewLineBuffer(SizeValueType length) const = 0;
+
+    /** Apply the functor to n values. */
+    virtual void Process(const void *in, const void *operand, void *out, SizeValueType n) = 0;
+  };
+
+  template< typename TInput, typename TOutput, typename TFunctor >
+  class UnaryStage: public StageBase
+  {
+  public:
+    UnaryStage(const TFunctor & functor): m_Functor(functor) {}
+
+    virtual const std::type_info & GetInputType() const ITK_OVERRIDE { return typeid( TInput ); }
+    virtual const std::type_info & GetOutputType() const ITK_OVERRIDE { return typeid( TOutput ); }
+
+    virtual LineBufferBase * NewLineBuffer(SizeValueType length) const ITK_OVERRIDE
+    {
+      return new LineBuffer< TOutput >(length);
+    }
+
+    virtual void Process(const void *in, const void *, void *out, SizeValueType n) ITK_OVERRIDE
+    {
+      typename Functor::SpanFunctorTraits< TFunctor >::Type functorSpans;
+      this->ProcessSpan( static_cast< const TInput * >( in ), static_cast< TOutput * >( out ), n, functorSpans );
+    }
+
+  private:
+    void ProcessSpan(const TInput *in, TOutput *out, SizeValueType n, const FalseType &)
+    {
+      for ( SizeValueType i = 0; i < n; ++i )
+        {
+        out[i] = m_Functor(in[i]);
+        }
+    }
+
+    void ProcessSpan(const TInput *in, TOutput *out, SizeValueType n, const TrueType &)
+    {
+      m_Functor.ProcessSpan(in, out, n);
+    }
+
+    TFunctor m_Functor;
+  };
+
+  template< typename TInput1, typename TInput2, typename TOutput, typename TFunctor >
+  class BinaryStage: public StageBase
+  {
+  public:
+    typedef Image< TInput2, OutputImageDimension > OperandImageType;
+
+    BinaryStage(const TFunctor & functor, unsigned int operandIndex):
+      m_Functor(functor), m_OperandIndex(operandIndex) {}
+
+    virtual const std::type_info & GetInputType() const ITK_OVERRIDE { return typeid( TInput1 ); }
+    virtual const std::type_info & GetOutputType() const ITK_OVERRIDE { return typeid( TOutput ); }
+    virtual unsigned int GetOperandIndex() const ITK_OVERRIDE { return m_OperandIndex; }
+
+    virtual const void * GetOperandPixels(const DataObject *operand,
+                                          const OutputImageIndexType & index) const ITK_OVERRIDE
+    {
+      const OperandImageType *image = static_cast< const OperandImageType * >( operand );
+      return image->GetBufferPointer() + image->ComputeOffset(index);
+    }
+
+    virtual LineBufferBase * NewLineBuffer(SizeValueType length) const ITK_OVERRIDE
+    {
+      return new LineBuffer< TOutput >(length);
+    }
+
+    virtual void Process(const void *in, const void *operand, void *out, SizeValueType n) ITK_OVERRIDE
+    {
+      typename Functor::SpanFunctorTraits< TFunctor >::Type functorSpans;
+      this->ProcessSpan( static_cast< const TInput1 * >( in ), static_cast< const TInput2 * >( operand ),
+                         static_cast< TOutput * >( out ), n, functorSpans );
+    }
+
+  private:
+    void ProcessSpan(const TInput1 *in1, const TInput2 *in2, TOutput *out, SizeValueType n,
+                     const FalseType &)
+    {
+      for ( SizeValueType i = 0; i < n; ++i )
+        {
+        out[i] = m_Functor(in1[i], in2[i]);
+        }
+    }
+
+    void ProcessSpan(const TInput1 *in1, const TInput2 *in2, TOutput *out, SizeValueType n,
+                     const TrueType &)
+    {
+      m_Functor.ProcessSpan(in1, in2, out, n);
+    }
+
+    TFunctor     m_Functor;
+    unsigned int m_OperandIndex;
+  };
+
+  typedef std::vector< StageBase * > StageContainerType;
+
+  /** Append a stage after checking its input type, taking its ownership */
+  void AddStage(StageBase *stage);
+
+  typedef ScanlineSpanTag< ImageScanlineSpanTraits< TInputImage >::Value >  InputSpansType;
+  typedef ScanlineSpanTag< ImageScanlineSpanTraits< TOutputImage >::Value > OutputSpansType;
+
+  /** Pointer to the pixels of the current input scanline, copied to
+   * buffer when the scanlines of the input are not plain arrays. */
+  const InputImagePixelType * GetInputLine(ImageScanlineConstIterator< TInputImage > & it,
+                                           std::vector< InputImagePixelType > & buffer,
+                                           const FalseType &);
+
+  const InputImagePixelType * GetInputLine(ImageScanlineConstIterator< TInputImage > & it,
+                                           std::vector< InputImagePixelType > &,
+                                           const TrueType &)
+  {
+    return &it.Value();
+  }
+
+  /** Pointer where the last functor writes the current output scanline,
+   * and copy of buffer to the output when it is not a plain array. */
+  OutputImagePixelType * GetOutputLine(ImageScanlineIterator< TOutputImage > &,
+                                       std::vector< OutputImagePixelType > & buffer,
+                                       const FalseType &)
+  {
+    return &buffer[0];
+  }
+
+  OutputImagePixelType * GetOutputLine(ImageScanlineIterator< TOutputImage > & it,
+                                       std::vector< OutputImagePixelType > &,
+                                       const TrueType &)
+  {
+    return &it.Value();
+  }
+
+  void SetOutputLine(ImageScanlineIterator< TOutputImage > & it,
+                     const std::vector< OutputImagePixelType > & buffer,
+                     const FalseType &);
+
+  void SetOutputLine(ImageScanlineIterator< TOutputImage > &,
+                     const std::vector< OutputImagePixelType > &,
+                     const TrueType &) {}
+
+  StageContainerType m_Stages;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkFunctorPipelineImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,242 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkFunctorPipelineImageFilter_hxx
+#define __itkFunctorPipelineImageFilter_hxx
+
+#include "itkFunctorPipelineImageFilter.h"
+#include "itkProgressReporter.h"
+
+namespace itk
+{
+template< typename TInputImage, typename TOutputImage >
+FunctorPipelineImageFilter< TInputImage, TOutputImage >
+::FunctorPipelineImageFilter()
+{
+  this->SetNumberOfRequiredInputs(1);
+  this->InPlaceOff();
+}
+
+template< typename TInputImage, typename TOutputImage >
+FunctorPipelineImageFilter< TInputImage, TOutputImage >
+::~FunctorPipelineImageFilter()
+{
+  for ( typename StageContainerType::iterator it = m_Stages.begin(); it != m_Stages.end(); ++it )
+    {
+    delete *it;
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+FunctorPipelineImageFilter< TInputImage, TOutputImage >
+::AddStage(StageBase *stage)
+{
+  const std::type_info & expectedType =
+    m_Stages.empty() ? typeid( InputImagePixelType ) : m_Stages.back()->GetOutputType();
+
+  if ( stage->GetInputType() != expectedType )
+    {
+    const std::string inputType = stage->GetInputType().name();
+    delete stage;
+    itkExceptionMacro(<< "Functor " << m_Stages.size() << " takes " << inputType
+                      << " values, but is given " << expectedType.name() << " values.");
+    }
+  m_Stages.push_back(stage);
+  this->Modified();
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+FunctorPipelineImageFilter< TInputImage, TOutputImage >
+::ClearFunctors()
+{
+  if ( m_Stages.empty() )
+    {
+    return;
+    }
+  for ( typename StageContainerType::iterator it = m_Stages.begin(); it != m_Stages.end(); ++it )
+    {
+    delete *it;
+    }
+  m_Stages.clear();
+
+  // Remove the operands of the binary functors
+  this->SetNumberOfIndexedInputs(1);
+  this->Modified();
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+FunctorPipelineImageFilter< TInputImage, TOutputImage >
+::BeforeThreadedGenerateData()
+{
+  if ( m_Stages.empty() )
+    {
+    itkExceptionMacro(<< "No functor has been added.");
+    }
+  if ( m_Stages.back()->GetOutputType() != typeid( OutputImagePixelType ) )
+    {
+    itkExceptionMacro(<< "The last functor produces " << m_Stages.back()->GetOutputType().name()
+                      << " values, but the output pixel type is "
+                      << typeid( OutputImagePixelType ).name() << ".");
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+FunctorPipelineImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  const SizeValueType length = outputRegionForThread.GetSize(0);
+
+  if ( length == 0 )
+    {
+    return;
+    }
+
+  const size_t numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / length;
+  ProgressReporter progress( this, threadId, numberOfLinesToProcess );
+
+  // Scanline buffers for the values computed by all the functors but the
+  // last one, which writes to the output, and the operands of the binary
+  // functors
+  const size_t                     numberOfStages = m_Stages.size();
+  std::vector< LineBufferBase * >  lineBuffers( numberOfStages - 1 );
+  std::vector< const DataObject * > operands( numberOfStages );
+  for ( size_t i = 0; i < numberOfStages; ++i )
+    {
+    if ( i + 1 < numberOfStages )
+      {
+      lineBuffers[i] = m_Stages[i]->NewLineBuffer(length);
+      }
+    const unsigned int operandIndex = m_Stages[i]->GetOperandIndex();
+    operands[i] = operandIndex > 0 ? this->ProcessObject::GetInput(operandIndex) : ITK_NULLPTR;
+    }
+
+  std::vector< InputImagePixelType >  inputBuffer;
+  std::vector< OutputImagePixelType > outputBuffer;
+  if ( !InputSpansType::Value )
+    {
+    inputBuffer.resize(length);
+    }
+  if ( !OutputSpansType::Value )
+    {
+    outputBuffer.resize(length);
+    }
+
+  ImageScanlineConstIterator< TInputImage > inputIt(this->GetInput(), outputRegionForThread);
+  ImageScanlineIterator< TOutputImage >     outputIt(this->GetOutput(), outputRegionForThread);
+
+  try
+    {
+    inputIt.GoToBegin();
+    outputIt.GoToBegin();
+    while ( !inputIt.IsAtEnd() )
+      {
+      const void *in = this->GetInputLine( inputIt, inputBuffer, InputSpansType() );
+      for ( size_t i = 0; i < numberOfStages; ++i )
+        {
+        const void *operand = ITK_NULLPTR;
+        if ( operands[i] )
+          {
+          operand = m_Stages[i]->GetOperandPixels( operands[i], outputIt.GetIndex() );
+          }
+        void *out;
+        if ( i + 1 < numberOfStages )
+          {
+          out = lineBuffers[i]->GetPointer();
+          }
+        else
+          {
+          out = this->GetOutputLine( outputIt, outputBuffer, OutputSpansType() );
+          }
+        m_Stages[i]->Process(in, operand, out, length);
+        in = out;
+        }
+      this->SetOutputLine( outputIt, outputBuffer, OutputSpansType() );
+
+      inputIt.NextLine();
+      outputIt.NextLine();
+      progress.CompletedPixel();  // potential exception thrown here
+      }
+    }
+  catch ( ... )
+    {
+    for ( size_t i = 0; i < lineBuffers.size(); ++i )
+      {
+      delete lineBuffers[i];
+      }
+    throw;
+    }
+
+  for ( size_t i = 0; i < lineBuffers.size(); ++i )
+    {
+    delete lineBuffers[i];
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+const typename FunctorPipelineImageFilter< TInputImage, TOutputImage >::InputImagePixelType *
+FunctorPipelineImageFilter< TInputImage, TOutputImage >
+::GetInputLine(ImageScanlineConstIterator< TInputImage > & it,
+               std::vector< InputImagePixelType > & buffer,
+               const FalseType &)
+{
+  for ( SizeValueType i = 0; !it.IsAtEndOfLine(); ++i, ++it )
+    {
+    buffer[i] = it.Get();
+    }
+  return &buffer[0];
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+FunctorPipelineImageFilter< TInputImage, TOutputImage >
+::SetOutputLine(ImageScanlineIterator< TOutputImage > & it,
+                const std::vector< OutputImagePixelType > & buffer,
+                const FalseType &)
+{
+  for ( SizeValueType i = 0; !it.IsAtEndOfLine(); ++i, ++it )
+    {
+    it.Set(buffer[i]);
+    }
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+FunctorPipelineImageFilter< TInputImage, TOutputImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfFunctors: " << m_Stages.size() << std::endl;
+  for ( size_t i = 0; i < m_Stages.size(); ++i )
+    {
+    os << indent.GetNextIndent() << i << ": " << m_Stages[i]->GetInputType().name()
+       << " -> " << m_Stages[i]->GetOutputType().name();
+    if ( m_Stages[i]->GetOperandIndex() > 0 )
+      {
+      os << " with input " << m_Stages[i]->GetOperandIndex();
+      }
+    os << std::endl;
+    }
+}
+} // end namespace itk
+
+#endif
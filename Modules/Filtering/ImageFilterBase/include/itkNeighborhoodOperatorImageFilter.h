@@ -22,6 +22,7 @@
 #include "itkNeighborhoodOperator.h"
 #include "itkImage.h"
 #include "itkZeroFluxNeumannBoundaryCondition.h"
+#include "itkImageRegionSplitterTiled.h"
 
 namespace itk
 {
@@ -35,6 +36,10 @@ namespace itk
  * with the image region.  Apply the mirror()'d operator for
  * non-symmetric NeighborhoodOperators.
  *
+ * The output is divided among the threads with an
+ * ImageRegionSplitterTiled sized after the operator radius, so that
+ * the neighborhoods visited by each thread stay in cache.
+ *
  * \ingroup ImageFilters
  *
  * \sa Image
@@ -107,6 +112,7 @@ public:
   void SetOperator(const OutputNeighborhoodType & p)
   {
     m_Operator = p;
+    m_TiledSplitter->SetRadius( p.GetRadius() );
     this->Modified();
   }
 
@@ -152,7 +158,12 @@ public:
 
 protected:
   NeighborhoodOperatorImageFilter()
-  { m_BoundsCondition = static_cast< ImageBoundaryConditionPointerType >( &m_DefaultBoundaryCondition ); }
+  {
+    m_BoundsCondition = static_cast< ImageBoundaryConditionPointerType >( &m_DefaultBoundaryCondition );
+    m_TiledSplitter = ImageRegionSplitterTiled::New();
+    m_TiledSplitter->SetPixelSize( sizeof( InputInternalPixelType ) );
+    this->SetImageRegionSplitter(m_TiledSplitter);
+  }
   virtual ~NeighborhoodOperatorImageFilter() {}
 
   /** NeighborhoodOperatorImageFilter can be implemented as a
@@ -185,6 +196,9 @@ private:
 
   /** Default boundary condition */
   DefaultBoundaryCondition m_DefaultBoundaryCondition;
+
+  /** Default splitter, following the radius of the operator. */
+  ImageRegionSplitterTiled::Pointer m_TiledSplitter;
 };
 } // end namespace itk
 
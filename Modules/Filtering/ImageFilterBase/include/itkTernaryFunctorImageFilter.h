@@ -20,6 +20,8 @@
 
 #include "itkInPlaceImageFilter.h"
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkScanlineSpanTraits.h"
+#include "itkProgressReporter.h"
 
 namespace itk
 {
@@ -30,6 +32,11 @@ namespace itk
  * and the type of the output image.  It is also parameterized by the
  * operation to be applied, using a Functor style.
  *
+ * When the inputs and output are Images, each scanline is processed as a
+ * plain array of pixels, which lets the compiler vectorize the loop.
+ * Functors can provide their own implementation for whole scanlines;
+ * see Functor::SpanFunctorTraits.
+ *
  * \sa BinaryFunctorImageFilter UnaryFunctorImageFilter
  *
  * \ingroup IntensityImageFilters MultiThreaded
@@ -111,6 +118,13 @@ public:
       }
   }
 
+  /** Set/Get whether scanlines are processed as plain arrays of pixels
+   * when the image types allow it. On by default. When off, the functor
+   * is called through the iterators, one pixel at a time. */
+  itkSetMacro(UseScanlineSpans, bool);
+  itkGetConstMacro(UseScanlineSpans, bool);
+  itkBooleanMacro(UseScanlineSpans);
+
   /** Image dimensions */
   itkStaticConstMacro(Input1ImageDimension, unsigned int,
                       TInputImage1::ImageDimension);
@@ -157,7 +171,39 @@ private:
   TernaryFunctorImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);            //purposely not implemented
 
+  typedef ScanlineSpanTag< ImageScanlineSpanTraits< TInputImage1 >::Value
+                           && ImageScanlineSpanTraits< TInputImage2 >::Value
+                           && ImageScanlineSpanTraits< TInputImage3 >::Value
+                           && ImageScanlineSpanTraits< TOutputImage >::Value > ScanlineSpansType;
+
+  /** Apply the functor to the scanlines of the region, pixel by pixel
+   * or as spans of pixels. */
+  void ProcessScanlines(const OutputImageRegionType & region,
+                        ProgressReporter & progress, const FalseType &);
+
+  void ProcessScanlines(const OutputImageRegionType & region,
+                        ProgressReporter & progress, const TrueType &);
+
+  /** Apply the functor to spans of n pixels of the three inputs. */
+  void ProcessSpan(const Input1ImagePixelType *in1, const Input2ImagePixelType *in2,
+                   const Input3ImagePixelType *in3, OutputImagePixelType *out,
+                   SizeValueType n, const FalseType &)
+  {
+    for ( SizeValueType i = 0; i < n; ++i )
+      {
+      out[i] = m_Functor(in1[i], in2[i], in3[i]);
+      }
+  }
+
+  void ProcessSpan(const Input1ImagePixelType *in1, const Input2ImagePixelType *in2,
+                   const Input3ImagePixelType *in3, OutputImagePixelType *out,
+                   SizeValueType n, const TrueType &)
+  {
+    m_Functor.ProcessSpan(in1, in2, in3, out, n);
+  }
+
   FunctorType m_Functor;
+  bool        m_UseScanlineSpans;
 };
 } // end namespace itk
 
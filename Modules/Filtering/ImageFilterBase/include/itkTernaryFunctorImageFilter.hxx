@@ -33,6 +33,7 @@ TernaryFunctorImageFilter< TInputImage1, TInputImage2, TInputImage3, TOutputImag
 ::TernaryFunctorImageFilter()
 {
   this->InPlaceOff();
+  m_UseScanlineSpans = true;
 }
 
 /**
@@ -114,6 +115,26 @@ TernaryFunctorImageFilter< TInputImage1, TInputImage2, TInputImage3, TOutputImag
     {
     return;
     }
+  const size_t numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / size0;
+  ProgressReporter progress( this, threadId, numberOfLinesToProcess );
+
+  if ( m_UseScanlineSpans )
+    {
+    this->ProcessScanlines( outputRegionForThread, progress, ScanlineSpansType() );
+    }
+  else
+    {
+    this->ProcessScanlines( outputRegionForThread, progress, FalseType() );
+    }
+}
+
+template< typename TInputImage1, typename TInputImage2,
+          typename TInputImage3, typename TOutputImage, typename TFunction  >
+void
+TernaryFunctorImageFilter< TInputImage1, TInputImage2, TInputImage3, TOutputImage, TFunction >
+::ProcessScanlines(const OutputImageRegionType & region,
+                   ProgressReporter & progress, const FalseType &)
+{
   // We use dynamic_cast since inputs are stored as DataObjects.  The
   // ImageToImageFilter::GetInput(int) always returns a pointer to a
   // TInputImage1 so it cannot be used for the second or third input.
@@ -125,14 +146,10 @@ TernaryFunctorImageFilter< TInputImage1, TInputImage2, TInputImage3, TOutputImag
     dynamic_cast< const TInputImage3 * >( ( ProcessObject::GetInput(2) ) );
   OutputImagePointer outputPtr = this->GetOutput(0);
 
-
-  ImageScanlineConstIterator< TInputImage1 > inputIt1(inputPtr1, outputRegionForThread);
-  ImageScanlineConstIterator< TInputImage2 > inputIt2(inputPtr2, outputRegionForThread);
-  ImageScanlineConstIterator< TInputImage3 > inputIt3(inputPtr3, outputRegionForThread);
-  ImageScanlineIterator< TOutputImage >      outputIt(outputPtr, outputRegionForThread);
-
-  const size_t numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / size0;
-  ProgressReporter progress( this, threadId, numberOfLinesToProcess );
+  ImageScanlineConstIterator< TInputImage1 > inputIt1(inputPtr1, region);
+  ImageScanlineConstIterator< TInputImage2 > inputIt2(inputPtr2, region);
+  ImageScanlineConstIterator< TInputImage3 > inputIt3(inputPtr3, region);
+  ImageScanlineIterator< TOutputImage >      outputIt(outputPtr, region);
 
   while ( !inputIt1.IsAtEnd() )
     {
@@ -144,10 +161,45 @@ TernaryFunctorImageFilter< TInputImage1, TInputImage2, TInputImage3, TOutputImag
       ++inputIt3;
       ++outputIt;
       }
-      inputIt1.NextLine();
-      inputIt2.NextLine();
-      inputIt3.NextLine();
-      outputIt.NextLine();
+    inputIt1.NextLine();
+    inputIt2.NextLine();
+    inputIt3.NextLine();
+    outputIt.NextLine();
+    progress.CompletedPixel(); // potential exception thrown here
+    }
+}
+
+template< typename TInputImage1, typename TInputImage2,
+          typename TInputImage3, typename TOutputImage, typename TFunction  >
+void
+TernaryFunctorImageFilter< TInputImage1, TInputImage2, TInputImage3, TOutputImage, TFunction >
+::ProcessScanlines(const OutputImageRegionType & region,
+                   ProgressReporter & progress, const TrueType &)
+{
+  Input1ImagePointer inputPtr1 =
+    dynamic_cast< const TInputImage1 * >( ( ProcessObject::GetInput(0) ) );
+  Input2ImagePointer inputPtr2 =
+    dynamic_cast< const TInputImage2 * >( ( ProcessObject::GetInput(1) ) );
+  Input3ImagePointer inputPtr3 =
+    dynamic_cast< const TInputImage3 * >( ( ProcessObject::GetInput(2) ) );
+  OutputImagePointer outputPtr = this->GetOutput(0);
+
+  ImageScanlineConstIterator< TInputImage1 > inputIt1(inputPtr1, region);
+  ImageScanlineConstIterator< TInputImage2 > inputIt2(inputPtr2, region);
+  ImageScanlineConstIterator< TInputImage3 > inputIt3(inputPtr3, region);
+  ImageScanlineIterator< TOutputImage >      outputIt(outputPtr, region);
+
+  const SizeValueType length = region.GetSize(0);
+  typename Functor::SpanFunctorTraits< FunctorType >::Type functorSpans;
+
+  while ( !inputIt1.IsAtEnd() )
+    {
+    this->ProcessSpan( &inputIt1.Value(), &inputIt2.Value(), &inputIt3.Value(),
+                       &outputIt.Value(), length, functorSpans );
+    inputIt1.NextLine();
+    inputIt2.NextLine();
+    inputIt3.NextLine();
+    outputIt.NextLine();
     progress.CompletedPixel(); // potential exception thrown here
     }
 }
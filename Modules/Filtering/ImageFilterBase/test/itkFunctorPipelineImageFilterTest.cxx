@@ -0,0 +1,175 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFunctorPipelineImageFilter.h"
+#include "itkFunctorComposition.h"
+#include "itkCastImageFilter.h"
+#include "itkRescaleIntensityImageFilter.h"
+#include "itkClampImageFilter.h"
+#include "itkMaskImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingComparisonImageFilter.h"
+#include "itkTestingMacros.h"
+
+int itkFunctorPipelineImageFilterTest(int, char *[])
+{
+  const unsigned int Dimension = 3;
+  typedef itk::Image< short, Dimension >         ShortImageType;
+  typedef itk::Image< float, Dimension >         FloatImageType;
+  typedef itk::Image< unsigned char, Dimension > ByteImageType;
+
+  ShortImageType::SizeType size = { { 31, 17, 5 } };
+  ShortImageType::RegionType region(size);
+
+  ShortImageType::Pointer input = ShortImageType::New();
+  input->SetRegions(region);
+  input->Allocate();
+  ByteImageType::Pointer mask = ByteImageType::New();
+  mask->SetRegions(region);
+  mask->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ShortImageType > inputIt( input, region );
+  itk::ImageRegionIteratorWithIndex< ByteImageType >  maskIt( mask, region );
+  for ( ; !inputIt.IsAtEnd(); ++inputIt, ++maskIt )
+    {
+    const ShortImageType::IndexType & index = inputIt.GetIndex();
+    inputIt.Set( static_cast< short >( ( index[0] * 37 + index[1] * 101 + index[2] * 503 ) % 1200 - 300 ) );
+    maskIt.Set( ( index[0] + index[1] + index[2] ) % 3 == 0 ? 0 : 1 );
+    }
+
+  // The functors of the chain
+  typedef itk::Functor::Cast< short, float >                              CastType;
+  typedef itk::Functor::IntensityLinearTransform< float, float >          ShiftScaleType;
+  typedef itk::Functor::Clamp< float, unsigned char >                     ClampType;
+  typedef itk::Functor::MaskInput< unsigned char, unsigned char >         MaskType;
+
+  ShiftScaleType shiftScale;
+  shiftScale.SetFactor( 0.37 );
+  shiftScale.SetOffset( 12.5 );
+  shiftScale.SetMinimum( -1000.0f );
+  shiftScale.SetMaximum( 1000.0f );
+  ClampType clamp;
+  clamp.SetBounds( 10, 240 );
+  MaskType maskFunctor;
+  maskFunctor.SetOutsideValue( 3 );
+
+  // Chain of separate filters
+  typedef itk::CastImageFilter< ShortImageType, FloatImageType >                          CastFilterType;
+  typedef itk::UnaryFunctorImageFilter< FloatImageType, FloatImageType, ShiftScaleType >  ShiftScaleFilterType;
+  typedef itk::ClampImageFilter< FloatImageType, ByteImageType >                          ClampFilterType;
+  typedef itk::MaskImageFilter< ByteImageType, ByteImageType, ByteImageType >             MaskFilterType;
+
+  CastFilterType::Pointer cast = CastFilterType::New();
+  cast->SetInput( input );
+  ShiftScaleFilterType::Pointer shiftScaleFilter = ShiftScaleFilterType::New();
+  shiftScaleFilter->SetInput( cast->GetOutput() );
+  shiftScaleFilter->SetFunctor( shiftScale );
+  ClampFilterType::Pointer clampFilter = ClampFilterType::New();
+  clampFilter->SetInput( shiftScaleFilter->GetOutput() );
+  clampFilter->SetBounds( 10, 240 );
+  MaskFilterType::Pointer maskFilter = MaskFilterType::New();
+  maskFilter->SetInput( clampFilter->GetOutput() );
+  maskFilter->SetMaskImage( mask );
+  maskFilter->SetOutsideValue( 3 );
+  TRY_EXPECT_NO_EXCEPTION( maskFilter->Update() );
+
+  // Runtime pipeline
+  typedef itk::FunctorPipelineImageFilter< ShortImageType, ByteImageType > PipelineFilterType;
+  PipelineFilterType::Pointer pipeline = PipelineFilterType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( pipeline, PipelineFilterType );
+
+  pipeline->SetInput( input );
+  TRY_EXPECT_EXCEPTION( pipeline->Update() );
+
+  pipeline->AddUnaryFunctor< short, float >( CastType() );
+  pipeline->AddUnaryFunctor< float, float >( shiftScale );
+  TRY_EXPECT_EXCEPTION( ( pipeline->AddUnaryFunctor< short, float >( CastType() ) ) );
+  TRY_EXPECT_EXCEPTION( pipeline->Update() );
+  pipeline->AddUnaryFunctor< float, unsigned char >( clamp );
+  pipeline->AddBinaryFunctor< unsigned char, unsigned char, unsigned char >( maskFunctor, mask.GetPointer() );
+  TEST_EXPECT_EQUAL( pipeline->GetNumberOfFunctors(), 4u );
+  TEST_EXPECT_EQUAL( pipeline->GetNumberOfIndexedInputs(), 2u );
+  std::cout << pipeline;
+
+  TRY_EXPECT_NO_EXCEPTION( pipeline->Update() );
+
+  typedef itk::Testing::ComparisonImageFilter< ByteImageType, ByteImageType > ComparisonFilterType;
+  ComparisonFilterType::Pointer comparison = ComparisonFilterType::New();
+  comparison->SetValidInput( maskFilter->GetOutput() );
+  comparison->SetTestInput( pipeline->GetOutput() );
+  TRY_EXPECT_NO_EXCEPTION( comparison->Update() );
+  TEST_EXPECT_EQUAL( comparison->GetNumberOfPixelsWithDifferences(), 0u );
+
+  // Rebuild the same pipeline
+  pipeline->ClearFunctors();
+  TEST_EXPECT_EQUAL( pipeline->GetNumberOfFunctors(), 0u );
+  TEST_EXPECT_EQUAL( pipeline->GetNumberOfIndexedInputs(), 1u );
+  pipeline->AddUnaryFunctor< short, float >( CastType() );
+  pipeline->AddUnaryFunctor< float, float >( shiftScale );
+  pipeline->AddUnaryFunctor< float, unsigned char >( clamp );
+  pipeline->AddBinaryFunctor< unsigned char, unsigned char, unsigned char >( maskFunctor, mask.GetPointer() );
+  pipeline->SetNumberOfThreads( 3 );
+  TRY_EXPECT_NO_EXCEPTION( pipeline->Update() );
+  TRY_EXPECT_NO_EXCEPTION( comparison->Update() );
+  TEST_EXPECT_EQUAL( comparison->GetNumberOfPixelsWithDifferences(), 0u );
+
+  // Pipeline composed at compile time
+  typedef itk::Functor::ComposeUnary< short, float, float, CastType, ShiftScaleType >        CastShiftScaleType;
+  typedef itk::Functor::ComposeUnary< short, float, unsigned char,
+                                      CastShiftScaleType, ClampType >                        CastClampType;
+  typedef itk::Functor::ComposeUnaryBinary< short, unsigned char, unsigned char, unsigned char,
+                                            CastClampType, MaskType >                        ComposedType;
+  typedef itk::BinaryFunctorImageFilter< ShortImageType, ByteImageType, ByteImageType,
+                                         ComposedType >                                      ComposedFilterType;
+
+  ComposedType composed( CastClampType( CastShiftScaleType( CastType(), shiftScale ), clamp ), maskFunctor );
+  TEST_EXPECT_TRUE( composed.GetUnaryFunctor().GetFunctor2() == clamp );
+
+  ComposedFilterType::Pointer composedFilter = ComposedFilterType::New();
+  composedFilter->SetInput1( input );
+  composedFilter->SetInput2( mask );
+  composedFilter->SetFunctor( composed );
+  TRY_EXPECT_NO_EXCEPTION( composedFilter->Update() );
+  comparison->SetTestInput( composedFilter->GetOutput() );
+  TRY_EXPECT_NO_EXCEPTION( comparison->Update() );
+  TEST_EXPECT_EQUAL( comparison->GetNumberOfPixelsWithDifferences(), 0u );
+
+  // A single functor running in place
+  typedef itk::FunctorPipelineImageFilter< FloatImageType > FloatPipelineFilterType;
+  FloatImageType::Pointer floatImage = cast->GetOutput();
+  floatImage->DisconnectPipeline();
+  // The expected output is kept apart from its input, which is overwritten
+  FloatImageType::Pointer shiftScaled = shiftScaleFilter->GetOutput();
+  shiftScaled->DisconnectPipeline();
+  const float *floatBuffer = floatImage->GetBufferPointer();
+  FloatPipelineFilterType::Pointer inPlace = FloatPipelineFilterType::New();
+  inPlace->SetInput( floatImage );
+  inPlace->InPlaceOn();
+  inPlace->AddUnaryFunctor< float, float >( shiftScale );
+  TRY_EXPECT_NO_EXCEPTION( inPlace->Update() );
+  TEST_EXPECT_EQUAL( inPlace->GetOutput()->GetBufferPointer(), floatBuffer );
+
+  typedef itk::Testing::ComparisonImageFilter< FloatImageType, FloatImageType > FloatComparisonFilterType;
+  FloatComparisonFilterType::Pointer floatComparison = FloatComparisonFilterType::New();
+  floatComparison->SetValidInput( shiftScaled );
+  floatComparison->SetTestInput( inPlace->GetOutput() );
+  TRY_EXPECT_NO_EXCEPTION( floatComparison->Update() );
+  TEST_EXPECT_EQUAL( floatComparison->GetNumberOfPixelsWithDifferences(), 0u );
+
+  return EXIT_SUCCESS;
+}
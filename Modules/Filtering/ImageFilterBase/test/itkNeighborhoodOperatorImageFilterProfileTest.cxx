@@ -0,0 +1,136 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkNeighborhoodOperatorImageFilter.h"
+#include "itkLaplacianOperator.h"
+#include "itkImageRegionSplitterSlowDimension.h"
+#include "itkImageRegionSplitterTiled.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkTimeProbesCollectorBase.h"
+
+#include <cstdlib>
+
+// Compare the time taken by a 3x3x3 neighborhood operator when the output is
+// split in slabs along the slowest dimension, and when it is split in cache
+// sized tiles. Pass the image size as argument, e.g. 512, to profile large
+// volumes.
+int itkNeighborhoodOperatorImageFilterProfileTest( int argc, char *argv[] )
+{
+  const unsigned int Dimension = 3;
+  typedef float                               PixelType;
+  typedef itk::Image< PixelType, Dimension >  ImageType;
+
+  typedef itk::NeighborhoodOperatorImageFilter< ImageType, ImageType > FilterType;
+
+  unsigned int imageSize = 64;
+  if ( argc > 1 )
+    {
+    imageSize = atoi( argv[1] );
+    }
+  unsigned int numberOfIterations = 3;
+  if ( argc > 2 )
+    {
+    numberOfIterations = atoi( argv[2] );
+    }
+
+  ImageType::SizeType size;
+  size.Fill( imageSize );
+  ImageType::RegionType region;
+  region.SetSize( size );
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( region );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, region );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType & index = it.GetIndex();
+    it.Set( static_cast< PixelType >( ( index[0] * 7 + index[1] * 13 + index[2] * 29 ) % 101 ) );
+    }
+
+  itk::LaplacianOperator< PixelType, Dimension > laplacian;
+  laplacian.CreateOperator();
+
+  itk::ImageRegionSplitterSlowDimension::Pointer slabSplitter =
+    itk::ImageRegionSplitterSlowDimension::New();
+  itk::ImageRegionSplitterTiled::Pointer tiledSplitter =
+    itk::ImageRegionSplitterTiled::New();
+  tiledSplitter->SetPixelSize( sizeof( PixelType ) );
+  tiledSplitter->SetRadius( laplacian.GetRadius() );
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( image );
+  filter->SetOperator( laplacian );
+
+  const unsigned int numberOfThreads = filter->GetNumberOfThreads();
+
+  // Bytes a thread goes through while visiting three consecutive slices
+  // of its piece, for the first piece of each splitting
+  ImageType::RegionType slab = region;
+  slabSplitter->GetSplit( 0, slabSplitter->GetNumberOfSplits( region, numberOfThreads ), slab );
+  ImageType::RegionType tile = region;
+  tiledSplitter->GetSplit( 0, tiledSplitter->GetNumberOfSplits( region, numberOfThreads ), tile );
+  std::cout << "Threads: " << numberOfThreads << std::endl;
+  std::cout << "Slab piece: " << slab.GetSize() << ", working set "
+            << 3 * ( slab.GetSize(0) + 2 ) * ( slab.GetSize(1) + 2 ) * sizeof( PixelType )
+            << " bytes" << std::endl;
+  std::cout << "Tiled piece: " << tile.GetSize() << ", working set "
+            << 3 * ( tile.GetSize(0) + 2 ) * ( tile.GetSize(1) + 2 ) * sizeof( PixelType )
+            << " bytes" << std::endl;
+
+  itk::TimeProbesCollectorBase chronometer;
+
+  filter->SetImageRegionSplitter( slabSplitter );
+  for ( unsigned int i = 0; i < numberOfIterations; ++i )
+    {
+    filter->Modified();
+    chronometer.Start( "Slabs" );
+    filter->Update();
+    chronometer.Stop( "Slabs" );
+    }
+  ImageType::Pointer reference = filter->GetOutput();
+  reference->DisconnectPipeline();
+
+  filter->SetImageRegionSplitter( tiledSplitter );
+  for ( unsigned int i = 0; i < numberOfIterations; ++i )
+    {
+    filter->Modified();
+    chronometer.Start( "Tiles" );
+    filter->Update();
+    chronometer.Stop( "Tiles" );
+    }
+
+  chronometer.Report( std::cout );
+
+  // The splitting must not change the output
+  itk::ImageRegionConstIterator< ImageType > rit( reference, region );
+  itk::ImageRegionConstIterator< ImageType > oit( filter->GetOutput(), region );
+  for ( rit.GoToBegin(), oit.GoToBegin(); !rit.IsAtEnd(); ++rit, ++oit )
+    {
+    if ( rit.Get() != oit.Get() )
+      {
+      std::cerr << "Output differs at " << rit.GetIndex() << ": "
+                << oit.Get() << " instead of " << rit.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
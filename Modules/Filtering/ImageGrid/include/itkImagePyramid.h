@@ -0,0 +1,142 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImagePyramid_h
+#define __itkImagePyramid_h
+
+#include "itkDataObject.h"
+#include "itkFixedArray.h"
+#include "itkNumericTraits.h"
+#include "itkObjectFactory.h"
+#include "itkSimpleFastMutexLock.h"
+#include <vector>
+
+namespace itk
+{
+/** \class ImagePyramid
+ * \brief Holds the levels of a multi-resolution pyramid of an image,
+ * computed when first requested.
+ *
+ * Level 0 is the image given to SetImage(). Each level is computed from
+ * the one before it, shrunk by the ShrinkFactors with BinShrinkImageFilter,
+ * which averages the pixels, or ShrinkImageFilter, which subsamples them,
+ * when UseAveraging is off. An axis is never shrunk to less than a pixel.
+ *
+ * The levels computed are kept until the image of level 0 is modified, or
+ * the shrink factors change, so that viewers and coarse to fine
+ * registration methods requesting the same level share it. Levels
+ * computed elsewhere, e.g. read from a file, are given with SetLevel().
+ * GetLevel() may be called by several threads at once.
+ *
+ * \sa BinShrinkImageFilter
+ * \sa ShrinkImageFilter
+ * \sa HDF5ImageIO
+ *
+ * \ingroup DataRepresentation
+ * \ingroup ITKImageGrid
+ */
+template< typename TImage >
+class ImagePyramid:public DataObject
+{
+public:
+  /** Standard class typedefs. */
+  typedef ImagePyramid               Self;
+  typedef DataObject                 Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImagePyramid, DataObject);
+
+  typedef TImage                           ImageType;
+  typedef typename ImageType::ConstPointer ImageConstPointer;
+
+  itkStaticConstMacro(ImageDimension, unsigned int, ImageType::ImageDimension);
+
+  typedef FixedArray< unsigned int, itkGetStaticConstMacro(ImageDimension) > ShrinkFactorsType;
+
+  /** Set/Get the image of level 0, the full resolution. Setting another
+   * image discards the other levels. */
+  void SetImage(const ImageType *image);
+  const ImageType * GetImage() const;
+
+  /** Set/Get the number of levels, level 0 included. The default is 1. */
+  itkSetClampMacro(NumberOfLevels, unsigned int, 1, NumericTraits< unsigned int >::max());
+  itkGetConstMacro(NumberOfLevels, unsigned int);
+
+  /** Set/Get the factors by which each level is shrunk along each axis,
+   * from the level before it. The default is 2 along every axis. */
+  void SetShrinkFactors(const ShrinkFactorsType & factors);
+  void SetShrinkFactors(unsigned int factor);
+  itkGetConstReferenceMacro(ShrinkFactors, ShrinkFactorsType);
+
+  /** Set/Get whether the levels average the pixels of the level before
+   * them, or subsample them. The default is true. */
+  void SetUseAveraging(bool useAveraging);
+  itkGetConstMacro(UseAveraging, bool);
+  itkBooleanMacro(UseAveraging);
+
+  /** Get a level, which is computed along with the levels before it when
+   * they are not available. */
+  const ImageType * GetLevel(unsigned int level) const;
+
+  /** Set a level other than 0, computed elsewhere. It is kept until the
+   * image of level 0 is modified. */
+  void SetLevel(unsigned int level, const ImageType *image);
+
+  /** Determine if a level is available without being computed. */
+  bool IsLevelAvailable(unsigned int level) const;
+
+  /** Discard the levels other than level 0. */
+  void ReleaseLevels();
+
+  /** Discard the image and all the levels. */
+  virtual void Initialize() ITK_OVERRIDE;
+
+protected:
+  ImagePyramid();
+  ~ImagePyramid() {}
+  virtual void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+private:
+  ImagePyramid(const Self &);   //purposely not implemented
+  void operator=(const Self &); //purposely not implemented
+
+  /** Computes a level from the level before it. */
+  ImageConstPointer ComputeLevel(const ImageType *image) const;
+
+  ImageConstPointer m_Image;
+  unsigned int      m_NumberOfLevels;
+  ShrinkFactorsType m_ShrinkFactors;
+  bool              m_UseAveraging;
+
+  /** The levels other than level 0, and the modified time of the image
+   * of level 0 they were computed or set for. */
+  mutable std::vector< ImageConstPointer > m_Levels;
+  mutable std::vector< ModifiedTimeType >  m_LevelImageMTimes;
+  mutable SimpleFastMutexLock              m_Mutex;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkImagePyramid.hxx"
+#endif
+
+#endif
@@ -0,0 +1,252 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImagePyramid_hxx
+#define __itkImagePyramid_hxx
+
+#include "itkImagePyramid.h"
+#include "itkBinShrinkImageFilter.h"
+#include "itkShrinkImageFilter.h"
+#include "itkMutexLockHolder.h"
+
+namespace itk
+{
+template< typename TImage >
+ImagePyramid< TImage >
+::ImagePyramid() :
+  m_NumberOfLevels(1),
+  m_UseAveraging(true)
+{
+  m_ShrinkFactors.Fill(2);
+}
+
+template< typename TImage >
+void
+ImagePyramid< TImage >
+::SetImage(const ImageType *image)
+{
+  if ( m_Image.GetPointer() != image )
+    {
+    m_Image = image;
+    this->ReleaseLevels();
+    this->Modified();
+    }
+}
+
+template< typename TImage >
+const typename ImagePyramid< TImage >::ImageType *
+ImagePyramid< TImage >
+::GetImage() const
+{
+  return m_Image.GetPointer();
+}
+
+template< typename TImage >
+void
+ImagePyramid< TImage >
+::SetShrinkFactors(const ShrinkFactorsType & factors)
+{
+  ShrinkFactorsType clampedFactors;
+  for ( unsigned int j = 0; j < ImageDimension; ++j )
+    {
+    clampedFactors[j] = std::max(factors[j], 1u);
+    }
+  if ( m_ShrinkFactors != clampedFactors )
+    {
+    m_ShrinkFactors = clampedFactors;
+    this->ReleaseLevels();
+    this->Modified();
+    }
+}
+
+template< typename TImage >
+void
+ImagePyramid< TImage >
+::SetShrinkFactors(unsigned int factor)
+{
+  ShrinkFactorsType factors;
+  factors.Fill(factor);
+  this->SetShrinkFactors(factors);
+}
+
+template< typename TImage >
+void
+ImagePyramid< TImage >
+::SetUseAveraging(bool useAveraging)
+{
+  if ( m_UseAveraging != useAveraging )
+    {
+    m_UseAveraging = useAveraging;
+    this->ReleaseLevels();
+    this->Modified();
+    }
+}
+
+template< typename TImage >
+const typename ImagePyramid< TImage >::ImageType *
+ImagePyramid< TImage >
+::GetLevel(unsigned int level) const
+{
+  if ( level >= m_NumberOfLevels )
+    {
+    itkExceptionMacro(<< "Level " << level << " requested from a pyramid of "
+                      << m_NumberOfLevels << " levels");
+    }
+  if ( m_Image.IsNull() )
+    {
+    itkExceptionMacro(<< "No image set");
+    }
+  if ( level == 0 )
+    {
+    return m_Image.GetPointer();
+    }
+
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  const ModifiedTimeType imageMTime = m_Image->GetMTime();
+  if ( m_Levels.size() < level )
+    {
+    m_Levels.resize(level);
+    m_LevelImageMTimes.resize(level, 0);
+    }
+  // m_Levels[l - 1] holds level l
+  for ( unsigned int l = 1; l <= level; ++l )
+    {
+    if ( m_Levels[l - 1].IsNull() || m_LevelImageMTimes[l - 1] != imageMTime )
+      {
+      const ImageType *previous = l == 1 ? m_Image.GetPointer() : m_Levels[l - 2].GetPointer();
+      m_Levels[l - 1] = this->ComputeLevel(previous);
+      m_LevelImageMTimes[l - 1] = imageMTime;
+      }
+    }
+  return m_Levels[level - 1].GetPointer();
+}
+
+template< typename TImage >
+void
+ImagePyramid< TImage >
+::SetLevel(unsigned int level, const ImageType *image)
+{
+  if ( level == 0 || level >= m_NumberOfLevels )
+    {
+    itkExceptionMacro(<< "Cannot set level " << level << " of a pyramid of "
+                      << m_NumberOfLevels << " levels");
+    }
+  if ( m_Image.IsNull() )
+    {
+    itkExceptionMacro(<< "The image of level 0 must be set before the other levels");
+    }
+
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  if ( m_Levels.size() < level )
+    {
+    m_Levels.resize(level);
+    m_LevelImageMTimes.resize(level, 0);
+    }
+  m_Levels[level - 1] = image;
+  m_LevelImageMTimes[level - 1] = m_Image->GetMTime();
+}
+
+template< typename TImage >
+bool
+ImagePyramid< TImage >
+::IsLevelAvailable(unsigned int level) const
+{
+  if ( level >= m_NumberOfLevels || m_Image.IsNull() )
+    {
+    return false;
+    }
+  if ( level == 0 )
+    {
+    return true;
+    }
+
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  return level <= m_Levels.size()
+         && m_Levels[level - 1].IsNotNull()
+         && m_LevelImageMTimes[level - 1] == m_Image->GetMTime();
+}
+
+template< typename TImage >
+void
+ImagePyramid< TImage >
+::ReleaseLevels()
+{
+  MutexLockHolder< SimpleFastMutexLock > holder(m_Mutex);
+  m_Levels.clear();
+  m_LevelImageMTimes.clear();
+}
+
+template< typename TImage >
+void
+ImagePyramid< TImage >
+::Initialize()
+{
+  Superclass::Initialize();
+  m_Image = ITK_NULLPTR;
+  this->ReleaseLevels();
+}
+
+template< typename TImage >
+typename ImagePyramid< TImage >::ImageConstPointer
+ImagePyramid< TImage >
+::ComputeLevel(const ImageType *image) const
+{
+  // never shrink an axis to less than a pixel
+  const typename ImageType::SizeType & size = image->GetLargestPossibleRegion().GetSize();
+  ShrinkFactorsType                    factors;
+  for ( unsigned int j = 0; j < ImageDimension; ++j )
+    {
+    factors[j] = static_cast< unsigned int >( std::min< SizeValueType >( m_ShrinkFactors[j], size[j] ) );
+    }
+
+  typename ImageType::Pointer level;
+  if ( m_UseAveraging )
+    {
+    typedef BinShrinkImageFilter< ImageType, ImageType > ShrinkerType;
+    typename ShrinkerType::Pointer shrinker = ShrinkerType::New();
+    shrinker->SetInput(image);
+    shrinker->SetShrinkFactors(factors);
+    shrinker->Update();
+    level = shrinker->GetOutput();
+    }
+  else
+    {
+    typedef ShrinkImageFilter< ImageType, ImageType > ShrinkerType;
+    typename ShrinkerType::Pointer shrinker = ShrinkerType::New();
+    shrinker->SetInput(image);
+    shrinker->SetShrinkFactors(factors);
+    shrinker->Update();
+    level = shrinker->GetOutput();
+    }
+  level->DisconnectPipeline();
+  return level.GetPointer();
+}
+
+template< typename TImage >
+void
+ImagePyramid< TImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Image: " << m_Image.GetPointer() << std::endl;
+  os << indent << "NumberOfLevels: " << m_NumberOfLevels << std::endl;
+  os << indent << "ShrinkFactors: " << m_ShrinkFactors << std::endl;
+  os << indent << "UseAveraging: " << ( m_UseAveraging ? "On" : "Off" ) << std::endl;
+}
+} // end namespace itk
+
+#endif
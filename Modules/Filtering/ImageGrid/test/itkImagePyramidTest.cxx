@@ -0,0 +1,149 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImagePyramid.h"
+#include "itkImage.h"
+#include "itkMultiThreader.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+typedef itk::Image< float, 3 >         ImageType;
+typedef itk::ImagePyramid< ImageType > PyramidType;
+
+struct GetLevelThreadStruct
+{
+  const PyramidType *Pyramid;
+  const ImageType *  Levels[4];
+};
+
+ITK_THREAD_RETURN_TYPE GetLevelThreaderCallback(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct *info = static_cast< itk::MultiThreader::ThreadInfoStruct * >( arg );
+  GetLevelThreadStruct *               str = static_cast< GetLevelThreadStruct * >( info->UserData );
+  str->Levels[info->ThreadID] = str->Pyramid->GetLevel(3);
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+bool CheckSize(const ImageType *image, itk::SizeValueType x, itk::SizeValueType y, itk::SizeValueType z)
+{
+  const ImageType::SizeType & size = image->GetLargestPossibleRegion().GetSize();
+  if ( size[0] != x || size[1] != y || size[2] != z )
+    {
+    std::cerr << "Size is " << size << " instead of [" << x << ", " << y << ", " << z << "]" << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+// Compute the levels of a pyramid when requested, keep them until the
+// image changes, and share them between threads.
+int itkImagePyramidTest(int, char* [])
+{
+  ImageType::SizeType   size = { { 37, 20, 9 } };
+  ImageType::RegionType region( size );
+  ImageType::Pointer    image = ImageType::New();
+  image->SetRegions( region );
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, region );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType & index = it.GetIndex();
+    it.Set( index[0] + 100.0f * index[1] + 10000.0f * index[2] );
+    }
+
+  PyramidType::Pointer pyramid = PyramidType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( pyramid, PyramidType );
+  TEST_EXPECT_EQUAL( pyramid->GetNumberOfLevels(), 1u );
+  TEST_EXPECT_EQUAL( pyramid->GetShrinkFactors()[0], 2u );
+  TEST_EXPECT_TRUE( pyramid->GetUseAveraging() );
+  TRY_EXPECT_EXCEPTION( pyramid->GetLevel( 0 ) );
+
+  pyramid->SetImage( image );
+  pyramid->SetNumberOfLevels( 4 );
+  TEST_EXPECT_TRUE( pyramid->GetLevel( 0 ) == image.GetPointer() );
+  TEST_EXPECT_TRUE( !pyramid->IsLevelAvailable( 2 ) );
+  TRY_EXPECT_EXCEPTION( pyramid->GetLevel( 4 ) );
+
+  // Level 2 is computed with level 1
+  const ImageType *level2 = pyramid->GetLevel( 2 );
+  TEST_EXPECT_TRUE( pyramid->IsLevelAvailable( 1 ) );
+  TEST_EXPECT_TRUE( pyramid->IsLevelAvailable( 2 ) );
+  TEST_EXPECT_TRUE( !pyramid->IsLevelAvailable( 3 ) );
+  TEST_EXPECT_TRUE( CheckSize( pyramid->GetLevel( 1 ), 18, 10, 4 ) );
+  TEST_EXPECT_TRUE( CheckSize( level2, 9, 5, 2 ) );
+  TEST_EXPECT_TRUE( pyramid->GetLevel( 2 ) == level2 );
+
+  // Averages of 2 x 2 x 2 pixels, and of 4 x 4 x 4 pixels
+  ImageType::IndexType index = { { 3, 1, 1 } };
+  TEST_EXPECT_EQUAL( pyramid->GetLevel( 1 )->GetPixel( index ), 6.5f + 250.0f + 25000.0f );
+  TEST_EXPECT_EQUAL( level2->GetPixel( index ), 13.5f + 550.0f + 55000.0f );
+
+  // An axis is not shrunk to less than a pixel
+  TEST_EXPECT_TRUE( CheckSize( pyramid->GetLevel( 3 ), 4, 2, 1 ) );
+
+  // Levels are computed once for all the threads
+  pyramid->ReleaseLevels();
+  TEST_EXPECT_TRUE( !pyramid->IsLevelAvailable( 1 ) );
+  GetLevelThreadStruct str;
+  str.Pyramid = pyramid;
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads( 4 );
+  threader->SetSingleMethod( GetLevelThreaderCallback, &str );
+  threader->SingleMethodExecute();
+  for ( itk::ThreadIdType t = 1; t < threader->GetNumberOfThreads(); ++t )
+    {
+    TEST_EXPECT_TRUE( str.Levels[t] == str.Levels[0] );
+    }
+
+  // Modifying the image discards the levels
+  image->Modified();
+  TEST_EXPECT_TRUE( !pyramid->IsLevelAvailable( 1 ) );
+
+  // Subsampling
+  pyramid->UseAveragingOff();
+  pyramid->SetShrinkFactors( 3 );
+  TEST_EXPECT_TRUE( CheckSize( pyramid->GetLevel( 1 ), 12, 6, 3 ) );
+  ImageType::PointType point;
+  ImageType::IndexType imageIndex;
+  pyramid->GetLevel( 1 )->TransformIndexToPhysicalPoint( index, point );
+  image->TransformPhysicalPointToIndex( point, imageIndex );
+  TEST_EXPECT_EQUAL( pyramid->GetLevel( 1 )->GetPixel( index ), image->GetPixel( imageIndex ) );
+
+  // A level set is used to compute the next ones
+  ImageType::SizeType   givenSize = { { 8, 8, 8 } };
+  ImageType::Pointer    given = ImageType::New();
+  given->SetRegions( givenSize );
+  given->Allocate();
+  given->FillBuffer( 5.0f );
+  pyramid->SetShrinkFactors( 2 );
+  pyramid->SetLevel( 1, given );
+  TEST_EXPECT_TRUE( pyramid->IsLevelAvailable( 1 ) );
+  TEST_EXPECT_TRUE( pyramid->GetLevel( 1 ) == given.GetPointer() );
+  TEST_EXPECT_TRUE( CheckSize( pyramid->GetLevel( 2 ), 4, 4, 4 ) );
+  TEST_EXPECT_EQUAL( pyramid->GetLevel( 2 )->GetPixel( index ), 5.0f );
+  TRY_EXPECT_EXCEPTION( pyramid->SetLevel( 0, given ) );
+
+  pyramid->Initialize();
+  TEST_EXPECT_TRUE( pyramid->GetImage() == ITK_NULLPTR );
+  TEST_EXPECT_TRUE( !pyramid->IsLevelAvailable( 0 ) );
+
+  return EXIT_SUCCESS;
+}
@@ -71,12 +71,35 @@ public:
     return result;
   }
 
+  /** Transform a span of n pixels. The parameters are read once, so that
+   * the loop can be vectorized. */
+  void ProcessSpan(const TInput *in, TOutput *out, SizeValueType n) const
+  {
+    const RealType factor = m_Factor;
+    const RealType offset = m_Offset;
+    const TOutput  maximum = m_Maximum;
+    const TOutput  minimum = m_Minimum;
+
+    for ( SizeValueType i = 0; i < n; ++i )
+      {
+      TOutput result = static_cast< TOutput >( static_cast< RealType >( in[i] ) * factor + offset );
+      result = ( result > maximum ) ? maximum : result;
+      result = ( result < minimum ) ? minimum : result;
+      out[i] = result;
+      }
+  }
+
 private:
   RealType m_Factor;
   RealType m_Offset;
   TOutput  m_Maximum;
   TOutput  m_Minimum;
 };
+
+template< typename TInput, typename TOutput >
+struct SpanFunctorTraits< IntensityLinearTransform< TInput, TOutput > >: public TrueType
+{
+};
 }  // end namespace functor
 
 /** \class RescaleIntensityImageFilter
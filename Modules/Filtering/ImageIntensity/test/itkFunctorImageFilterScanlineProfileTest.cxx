@@ -0,0 +1,167 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkAddImageFilter.h"
+#include "itkMultiplyImageFilter.h"
+#include "itkTernaryAddImageFilter.h"
+#include "itkRescaleIntensityImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTimeProbesCollectorBase.h"
+#include "itkTestingComparisonImageFilter.h"
+
+#include <cstdlib>
+
+namespace
+{
+// Run the filter pixel by pixel, then by spans, and check that both give
+// the same output
+template< typename TFilter >
+bool ProfileFilter(TFilter *filter, const char *name, unsigned int numberOfIterations,
+                   itk::TimeProbesCollectorBase & chronometer)
+{
+  typedef typename TFilter::OutputImageType OutputImageType;
+
+  const std::string pixelsName = std::string( name ) + " pixels";
+  const std::string spansName = std::string( name ) + " spans";
+
+  filter->UseScanlineSpansOff();
+  for ( unsigned int i = 0; i < numberOfIterations; ++i )
+    {
+    filter->Modified();
+    chronometer.Start( pixelsName.c_str() );
+    filter->Update();
+    chronometer.Stop( pixelsName.c_str() );
+    }
+  typename OutputImageType::Pointer reference = filter->GetOutput();
+  reference->DisconnectPipeline();
+
+  filter->UseScanlineSpansOn();
+  for ( unsigned int i = 0; i < numberOfIterations; ++i )
+    {
+    filter->Modified();
+    chronometer.Start( spansName.c_str() );
+    filter->Update();
+    chronometer.Stop( spansName.c_str() );
+    }
+
+  typedef itk::Testing::ComparisonImageFilter< OutputImageType, OutputImageType > ComparisonFilterType;
+  typename ComparisonFilterType::Pointer comparison = ComparisonFilterType::New();
+  comparison->SetValidInput( reference );
+  comparison->SetTestInput( filter->GetOutput() );
+  comparison->Update();
+  if ( comparison->GetNumberOfPixelsWithDifferences() > 0 )
+    {
+    std::cerr << name << ": " << comparison->GetNumberOfPixelsWithDifferences()
+              << " pixels differ between the pixel and span outputs" << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+// Compare the time taken by common pixel-wise filters when the functor is
+// called through the iterators and when each scanline is processed as a
+// plain array. Pass the image size as argument, e.g. 256, to profile large
+// volumes.
+int itkFunctorImageFilterScanlineProfileTest( int argc, char *argv[] )
+{
+  const unsigned int Dimension = 3;
+  typedef itk::Image< float, Dimension >         ImageType;
+  typedef itk::Image< unsigned char, Dimension > ByteImageType;
+
+  unsigned int imageSize = 64;
+  if ( argc > 1 )
+    {
+    imageSize = atoi( argv[1] );
+    }
+  unsigned int numberOfIterations = 3;
+  if ( argc > 2 )
+    {
+    numberOfIterations = atoi( argv[2] );
+    }
+
+  ImageType::SizeType size;
+  size.Fill( imageSize );
+  ImageType::RegionType region;
+  region.SetSize( size );
+
+  ImageType::Pointer image1 = ImageType::New();
+  image1->SetRegions( region );
+  image1->Allocate();
+  ImageType::Pointer image2 = ImageType::New();
+  image2->SetRegions( region );
+  image2->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ImageType > it1( image1, region );
+  itk::ImageRegionIteratorWithIndex< ImageType > it2( image2, region );
+  for ( it1.GoToBegin(), it2.GoToBegin(); !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    const ImageType::IndexType & index = it1.GetIndex();
+    it1.Set( static_cast< float >( ( index[0] * 7 + index[1] * 13 + index[2] * 29 ) % 101 ) );
+    it2.Set( static_cast< float >( ( index[0] * 3 + index[1] * 11 + index[2] * 17 ) % 37 ) * 0.5f );
+    }
+
+  itk::TimeProbesCollectorBase chronometer;
+  bool                         success = true;
+
+  typedef itk::AddImageFilter< ImageType, ImageType, ImageType > AddFilterType;
+  AddFilterType::Pointer add = AddFilterType::New();
+  add->SetInput1( image1 );
+  add->SetInput2( image2 );
+  success &= ProfileFilter( add.GetPointer(), "Add", numberOfIterations, chronometer );
+
+  AddFilterType::Pointer addConstant = AddFilterType::New();
+  addConstant->SetInput1( image1 );
+  addConstant->SetConstant2( 3.5f );
+  success &= ProfileFilter( addConstant.GetPointer(), "AddConstant", numberOfIterations, chronometer );
+
+  typedef itk::MultiplyImageFilter< ImageType, ImageType, ImageType > MultiplyFilterType;
+  MultiplyFilterType::Pointer multiply = MultiplyFilterType::New();
+  multiply->SetInput1( image1 );
+  multiply->SetInput2( image2 );
+  success &= ProfileFilter( multiply.GetPointer(), "Multiply", numberOfIterations, chronometer );
+
+  typedef itk::TernaryAddImageFilter< ImageType, ImageType, ImageType, ImageType > TernaryAddFilterType;
+  TernaryAddFilterType::Pointer ternaryAdd = TernaryAddFilterType::New();
+  ternaryAdd->SetInput1( image1 );
+  ternaryAdd->SetInput2( image2 );
+  ternaryAdd->SetInput3( image1 );
+  success &= ProfileFilter( ternaryAdd.GetPointer(), "TernaryAdd", numberOfIterations, chronometer );
+
+  // Linear transform and cast to 8 bits, with a functor processing whole
+  // spans
+  typedef itk::Functor::IntensityLinearTransform< float, unsigned char > TransformType;
+  typedef itk::UnaryFunctorImageFilter< ImageType, ByteImageType, TransformType > TransformFilterType;
+  TransformType transform;
+  transform.SetFactor( 2.5 );
+  transform.SetOffset( -10.0 );
+  transform.SetMinimum( 0 );
+  transform.SetMaximum( 200 );
+  TransformFilterType::Pointer linear = TransformFilterType::New();
+  linear->SetInput( image1 );
+  linear->SetFunctor( transform );
+  success &= ProfileFilter( linear.GetPointer(), "LinearTransform", numberOfIterations, chronometer );
+
+  chronometer.Report( std::cout );
+
+  if ( !success )
+    {
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
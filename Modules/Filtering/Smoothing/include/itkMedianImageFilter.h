@@ -20,6 +20,7 @@
 
 #include "itkBoxImageFilter.h"
 #include "itkImage.h"
+#include "itkImageRegionSplitterTiled.h"
 
 namespace itk
 {
@@ -35,6 +36,10 @@ namespace itk
  * This filter requires that the input pixel type provides an operator<()
  * (LessThan Comparable).
  *
+ * The output is divided among the threads with an
+ * ImageRegionSplitterTiled sized after the radius, so that the
+ * neighborhoods visited by each thread stay in cache.
+ *
  * \sa Image
  * \sa Neighborhood
  * \sa NeighborhoodOperator
@@ -99,6 +104,9 @@ protected:
   MedianImageFilter();
   virtual ~MedianImageFilter() {}
 
+  /** Update the splitter with the current radius. */
+  virtual void BeforeThreadedGenerateData() ITK_OVERRIDE;
+
   /** MedianImageFilter can be implemented as a multithreaded filter.
    * Therefore, this implementation provides a ThreadedGenerateData()
    * routine which is called for each processing thread. The output
@@ -115,6 +123,8 @@ protected:
 private:
   MedianImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);    //purposely not implemented
+
+  ImageRegionSplitterTiled::Pointer m_TiledSplitter;
 };
 } // end namespace itk
 
@@ -34,7 +34,19 @@ namespace itk
 template< typename TInputImage, typename TOutputImage >
 MedianImageFilter< TInputImage, TOutputImage >
 ::MedianImageFilter()
-{}
+{
+  m_TiledSplitter = ImageRegionSplitterTiled::New();
+  m_TiledSplitter->SetPixelSize( sizeof( typename InputImageType::InternalPixelType ) );
+  this->SetImageRegionSplitter(m_TiledSplitter);
+}
+
+template< typename TInputImage, typename TOutputImage >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::BeforeThreadedGenerateData()
+{
+  m_TiledSplitter->SetRadius( this->GetRadius() );
+}
 
 template< typename TInputImage, typename TOutputImage >
 void
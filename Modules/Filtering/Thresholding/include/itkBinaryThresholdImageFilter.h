@@ -111,12 +111,34 @@ public:
     return m_OutsideValue;
   }
 
+  /** Threshold a span of n pixels. The thresholds and values are read
+   * once, and the selection is branch free, so that the loop can be
+   * vectorized. */
+  void ProcessSpan(const TInput *in, TOutput *out, SizeValueType n) const
+  {
+    const TInput  lower = m_LowerThreshold;
+    const TInput  upper = m_UpperThreshold;
+    const TOutput inside = m_InsideValue;
+    const TOutput outside = m_OutsideValue;
+
+    for ( SizeValueType i = 0; i < n; ++i )
+      {
+      const TInput a = in[i];
+      out[i] = ( lower <= a ) & ( a <= upper ) ? inside : outside;
+      }
+  }
+
 private:
   TInput  m_LowerThreshold;
   TInput  m_UpperThreshold;
   TOutput m_InsideValue;
   TOutput m_OutsideValue;
 };
+
+template< typename TInput, typename TOutput >
+struct SpanFunctorTraits< BinaryThreshold< TInput, TOutput > >: public TrueType
+{
+};
 }
 
 template< typename TInputImage, typename TOutputImage >
@@ -79,6 +79,20 @@ class MetaDataDictionary;
  *                             in the MetaDataDictionary
  * re-arrangement.
  *
+ * The voxel data is stored in chunks compressed with deflate. By
+ * default each chunk is a slice of the image. SetChunkSize() sets N-D
+ * blocks instead, so that reading a small region of interest only
+ * decompresses the blocks it overlaps. The chunk cache holds a layer of
+ * chunks across the slowest moving axis, so that images streamed in
+ * slabs thinner than the chunks compress or decompress each chunk once.
+ *
+ * A file can hold the levels of a multi-resolution pyramid, level L
+ * being the image \/ITKImage\/L with its own dimensions, spacing and
+ * origin. SetLevel() selects the image read or written, so that a region
+ * of a coarse level is read without touching the finer ones. Writing
+ * level 0 creates the file, and writing any other level adds it to the
+ * file, or replaces it, also when the level is streamed. Pasting a region
+ * writes it into the image of the level in the file.
  *
  */
 
@@ -129,12 +143,64 @@ public:
    * that the IORegions has been set properly. */
   virtual void Write(const void *buffer) ITK_OVERRIDE;
 
+  /** Set/Get the size of the chunks of the voxel data written, in voxels
+   * along each axis, fastest moving first. Axes without a size are one
+   * voxel thick, and a size of zero or larger than the image takes the
+   * whole extent of the image along that axis. An empty size, the
+   * default, chunks the image in slices. Every chunk is compressed
+   * separately. */
+  typedef std::vector< SizeValueType > ChunkSizeType;
+  void SetChunkSize(const ChunkSizeType & chunkSize)
+  {
+    if ( m_ChunkSize != chunkSize )
+      {
+      m_ChunkSize = chunkSize;
+      this->Modified();
+      }
+  }
+  const ChunkSizeType & GetChunkSize() const
+  {
+    return m_ChunkSize;
+  }
+
+  /** Set/Get the deflate compression level of the chunks, from 0, which
+   * stores them uncompressed, to 9. The default is 5. */
+  itkSetClampMacro(CompressionLevel, int, 0, 9);
+  itkGetConstMacro(CompressionLevel, int);
+
+  /** Set/Get the level of the image read or written, from 0, the full
+   * resolution. A level other than 0 is written to an existing file
+   * holding the levels before it. The default is 0. Changing the level
+   * starts a new write. */
+  virtual void SetLevel(unsigned int level);
+  itkGetConstMacro(Level, unsigned int);
+
+  /** Get the number of levels of the file, after ReadImageInformation(). */
+  itkGetConstMacro(NumberOfLevels, unsigned int);
+
+  /** Reimplemented so that streaming a level other than 0 leaves the
+   * file holding the levels before it, and that pasting checks the
+   * information of the level written. */
+  virtual unsigned int GetActualNumberOfSplitsForWriting(unsigned int numberOfRequestedSplits,
+                                                         const ImageIORegion & pasteRegion,
+                                                         const ImageIORegion & largestPossibleRegion) ITK_OVERRIDE;
+
+  /** Set the file name. Changing the file name starts a new write. */
+  virtual void SetFileName(const char *fileName) ITK_OVERRIDE;
+  virtual void SetFileName(const std::string & fileName) ITK_OVERRIDE
+  {
+    this->SetFileName(fileName.c_str());
+  }
+
 protected:
   HDF5ImageIO();
   ~HDF5ImageIO();
 
   virtual SizeType GetHeaderSize(void) const ITK_OVERRIDE;
 
+  /** Create an HDF5ImageIO reading the same level. */
+  virtual StreamingImageIOBase::Pointer CreateImageIOForPasting(void) ITK_OVERRIDE;
+
   virtual void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
 
 private:
@@ -186,9 +252,26 @@ private:
                        unsigned long numElements);
   void SetupStreaming(H5::DataSpace *imageSpace,
                       H5::DataSpace *slabSpace);
+  /** Open the voxel data set with a chunk cache holding a layer of its
+   * chunks. */
+  void OpenVoxelDataSet(const std::string & name);
+  /** Close the voxel data set and the file, if open, so that the next
+   * write writes the image information again. */
+  void CloseH5File();
+  /** The group holding the image of the current level. */
+  std::string GetImageGroupName() const;
   H5::H5File  *m_H5File;
   H5::DataSet *m_VoxelDataSet;
   bool         m_ImageInformationWritten;
+  /** Whether the next write pastes into the image of the level in the
+   * file, rather than writing a new one. */
+  bool         m_PasteIntoFile;
+
+  ChunkSizeType m_ChunkSize;
+  int           m_CompressionLevel;
+
+  unsigned int m_Level;
+  unsigned int m_NumberOfLevels;
 };
 } // end namespace itk
 
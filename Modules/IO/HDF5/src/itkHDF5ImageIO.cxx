@@ -22,27 +22,97 @@
 #include "itksys/SystemTools.hxx"
 #include "itk_H5Cpp.h"
 
+#include <sstream>
+
 namespace itk
 {
 
 HDF5ImageIO::HDF5ImageIO() : m_H5File(ITK_NULLPTR),
                              m_VoxelDataSet(ITK_NULLPTR),
-                             m_ImageInformationWritten(false)
+                             m_ImageInformationWritten(false),
+                             m_PasteIntoFile(false),
+                             m_CompressionLevel(5),
+                             m_Level(0),
+                             m_NumberOfLevels(0)
 {
 }
 
 HDF5ImageIO::~HDF5ImageIO()
+{
+  this->CloseH5File();
+}
+
+void
+HDF5ImageIO
+::CloseH5File()
 {
   if(this->m_VoxelDataSet != ITK_NULLPTR)
     {
     m_VoxelDataSet->close();
     delete m_VoxelDataSet;
+    this->m_VoxelDataSet = ITK_NULLPTR;
     }
   if(this->m_H5File != ITK_NULLPTR)
     {
     this->m_H5File->close();
     delete this->m_H5File;
+    this->m_H5File = ITK_NULLPTR;
+    }
+  this->m_ImageInformationWritten = false;
+}
+
+void
+HDF5ImageIO
+::SetLevel(unsigned int level)
+{
+  if(level != this->m_Level)
+    {
+    // the file is left open after writing the previous level
+    this->CloseH5File();
+    this->m_Level = level;
+    this->Modified();
+    }
+}
+
+void
+HDF5ImageIO
+::SetFileName(const char *fileName)
+{
+  const std::string previousFileName(this->GetFileName());
+  Superclass::SetFileName(fileName);
+  if(previousFileName != this->GetFileName())
+    {
+    this->CloseH5File();
+    }
+}
+
+unsigned int
+HDF5ImageIO
+::GetActualNumberOfSplitsForWriting(unsigned int numberOfRequestedSplits,
+                                    const ImageIORegion & pasteRegion,
+                                    const ImageIORegion & largestPossibleRegion)
+{
+  const bool fileExists = itksys::SystemTools::FileExists(this->GetFileName());
+  this->m_PasteIntoFile = fileExists && pasteRegion != largestPossibleRegion;
+  if(this->m_Level > 0 && fileExists && !this->m_PasteIntoFile)
+    {
+    // the file holding the levels before this one is not removed to
+    // stream the level
+    return this->GetActualNumberOfSplitsForWritingCanStreamWrite(numberOfRequestedSplits,
+                                                                 pasteRegion);
     }
+  return StreamingImageIOBase::GetActualNumberOfSplitsForWriting(numberOfRequestedSplits,
+                                                                 pasteRegion,
+                                                                 largestPossibleRegion);
+}
+
+StreamingImageIOBase::Pointer
+HDF5ImageIO
+::CreateImageIOForPasting()
+{
+  Self::Pointer imageIO = Self::New();
+  imageIO->SetLevel(this->m_Level);
+  return imageIO.GetPointer();
 }
 
 void
@@ -52,6 +122,15 @@ HDF5ImageIO
   Superclass::PrintSelf(os, indent);
   // just prints out the pointer value.
   os << indent << "H5File: " << this->m_H5File << std::endl;
+  os << indent << "ChunkSize:";
+  for(unsigned int i = 0; i < this->m_ChunkSize.size(); i++)
+    {
+    os << " " << this->m_ChunkSize[i];
+    }
+  os << std::endl;
+  os << indent << "CompressionLevel: " << this->m_CompressionLevel << std::endl;
+  os << indent << "Level: " << this->m_Level << std::endl;
+  os << indent << "NumberOfLevels: " << this->m_NumberOfLevels << std::endl;
 }
 
 //
@@ -69,6 +148,40 @@ const std::string VoxelType("/VoxelType");
 const std::string VoxelData("/VoxelData");
 const std::string MetaDataName("/MetaData");
 
+// Create a data set access property list whose chunk cache holds a
+// layer of chunks across the slowest moving dimension, the first one.
+// Images are streamed in slabs along that dimension, and the chunks of
+// slabs thinner than them are then compressed or decompressed once
+// instead of once per slab.
+hid_t CreateChunkCacheAccessList(int numDims, const hsize_t *dims,
+                                 const hsize_t *chunkDims, size_t elementSize)
+{
+  size_t chunkBytes = elementSize;
+  size_t numberOfChunks = 1;
+  for(int i = 0; i < numDims; i++)
+    {
+    chunkBytes *= chunkDims[i];
+    if(i > 0)
+      {
+      numberOfChunks *= (dims[i] + chunkDims[i] - 1) / chunkDims[i];
+      }
+    }
+  // never less than the default cache of 521 slots and 1 MiB
+  const size_t numberOfSlots = std::max<size_t>(521, 10 * numberOfChunks + 1);
+  const size_t cacheBytes = std::max<size_t>(1024 * 1024, chunkBytes * numberOfChunks);
+  const hid_t accessList = H5Pcreate(H5P_DATASET_ACCESS);
+  // the chunks fully read or written are evicted first
+  H5Pset_chunk_cache(accessList, numberOfSlots, cacheBytes, 1.0);
+  return accessList;
+}
+
+std::string LevelName(unsigned int level)
+{
+  std::ostringstream name;
+  name << level;
+  return name.str();
+}
+
 template <typename TScalar>
 H5::PredType GetType()
 {
@@ -694,6 +807,8 @@ void
 HDF5ImageIO
 ::ReadImageInformation()
 {
+  // the data set of another level or file may be open
+  this->CloseH5File();
   try
     {
     this->m_H5File = new H5::H5File(this->GetFileName(),
@@ -704,9 +819,16 @@ HDF5ImageIO
     //std::string fileVersion = this->ReadString(ItkVersion);
     //std::string hdfVersion = this->ReadString(HDFVersion);
 
-    std::string groupName(ImageGroup);
-    //H5::Group imageGroup(this->m_H5File->openGroup(groupName));
-    groupName += "/0";
+    {
+    H5::Group imageGroup(this->m_H5File->openGroup(ImageGroup));
+    this->m_NumberOfLevels = static_cast<unsigned int>(imageGroup.getNumObjs());
+    }
+    if(this->m_Level >= this->m_NumberOfLevels)
+      {
+      itkExceptionMacro(<< "Cannot read level " << this->m_Level << " of " << this->GetFileName()
+                        << ", which has " << this->m_NumberOfLevels << " levels");
+      }
+    std::string groupName = this->GetImageGroupName();
 
     std::string DirectionsName(groupName);
     DirectionsName += Directions;
@@ -899,6 +1021,11 @@ HDF5ImageIO
       }
     imageSet.close();
     }
+  // catch failure caused by the Group operations
+  catch( H5::GroupIException & error )
+    {
+    itkExceptionMacro(<< error.getCDetailMsg());
+    }
   // catch failure caused by the H5File operations
   catch( H5::AttributeIException & error )
     {
@@ -974,13 +1101,11 @@ HDF5ImageIO
 
   // HDF5 dimensions listed slowest moving first, ITK are fastest
   // moving first.
-  std::string VoxelDataName(ImageGroup);
-  VoxelDataName += "/0";
+  std::string VoxelDataName = this->GetImageGroupName();
   VoxelDataName += VoxelData;
   if(this->m_VoxelDataSet == ITK_NULLPTR)
     {
-    this->m_VoxelDataSet = new H5::DataSet();
-    *(this->m_VoxelDataSet) = this->m_H5File->openDataSet(VoxelDataName);
+    this->OpenVoxelDataSet(VoxelDataName);
     }
   H5::DataType voxelType = this->m_VoxelDataSet->getDataType();
   H5::DataSpace imageSpace = this->m_VoxelDataSet->getSpace();
@@ -991,6 +1116,35 @@ HDF5ImageIO
   this->m_VoxelDataSet->read(buffer,voxelType,dspace,imageSpace);
 }
 
+void
+HDF5ImageIO
+::OpenVoxelDataSet(const std::string & name)
+{
+  H5::DataSet dataSet = this->m_H5File->openDataSet(name);
+  H5::DSetCreatPropList plist = dataSet.getCreatePlist();
+  if(plist.getLayout() != H5D_CHUNKED)
+    {
+    this->m_VoxelDataSet = new H5::DataSet(dataSet);
+    return;
+    }
+  H5::DataSpace space = dataSet.getSpace();
+  const int numDims = space.getSimpleExtentNdims();
+  std::vector<hsize_t> dims(numDims);
+  std::vector<hsize_t> chunkDims(numDims);
+  space.getSimpleExtentDims(&dims[0]);
+  plist.getChunk(numDims,&chunkDims[0]);
+
+  const hid_t accessList =
+    CreateChunkCacheAccessList(numDims,&dims[0],&chunkDims[0],dataSet.getDataType().getSize());
+  const hid_t dataSetId = H5Dopen2(this->m_H5File->getId(),name.c_str(),accessList);
+  H5Pclose(accessList);
+  if(dataSetId < 0)
+    {
+    itkExceptionMacro(<< "Cannot open " << name << " in " << this->GetFileName());
+    }
+  this->m_VoxelDataSet = new H5::DataSet(dataSetId);
+}
+
 template <typename TType>
 bool
 HDF5ImageIO
@@ -1042,19 +1196,54 @@ HDF5ImageIO
     {
     return;
     }
+  // a file may still be open from reading
+  this->CloseH5File();
+  const bool pasteIntoFile = this->m_PasteIntoFile;
+  this->m_PasteIntoFile = false;
 
   try
     {
-    this->m_H5File = new H5::H5File(this->GetFileName(),
-                                    H5F_ACC_TRUNC);
-    this->WriteString(ItkVersion,
-                      Version::GetITKVersion());
-
-    this->WriteString(HDFVersion,
-                                H5_VERS_INFO);
-    std::string groupName(ImageGroup);
-    this->m_H5File->createGroup(groupName);
-    groupName += "/0";
+    if(pasteIntoFile)
+      {
+      // the information of the level in the file was checked to match
+      this->m_H5File = new H5::H5File(this->GetFileName(),
+                                      H5F_ACC_RDWR);
+      std::string VoxelDataName = this->GetImageGroupName();
+      VoxelDataName += VoxelData;
+      this->OpenVoxelDataSet(VoxelDataName);
+      this->m_ImageInformationWritten = true;
+      return;
+      }
+    if(this->m_Level == 0)
+      {
+      this->m_H5File = new H5::H5File(this->GetFileName(),
+                                      H5F_ACC_TRUNC);
+      this->WriteString(ItkVersion,
+                        Version::GetITKVersion());
+
+      this->WriteString(HDFVersion,
+                                  H5_VERS_INFO);
+      this->m_H5File->createGroup(ImageGroup);
+      }
+    else
+      {
+      // add the level to the file, after the ones before it
+      this->m_H5File = new H5::H5File(this->GetFileName(),
+                                      H5F_ACC_RDWR);
+      H5::Group imageGroup(this->m_H5File->openGroup(ImageGroup));
+      const hsize_t numberOfLevels = imageGroup.getNumObjs();
+      if(this->m_Level > numberOfLevels)
+        {
+        itkExceptionMacro(<< "Cannot write level " << this->m_Level << " to " << this->GetFileName()
+                          << ", which has " << numberOfLevels << " levels");
+        }
+      const std::string levelName = LevelName(this->m_Level);
+      if(this->m_Level < numberOfLevels)
+        {
+        H5Ldelete(imageGroup.getId(),levelName.c_str(),H5P_DEFAULT);
+        }
+      }
+    std::string groupName = this->GetImageGroupName();
     this->m_H5File->createGroup(groupName);
     std::string OriginName(groupName);
     OriginName += Origin;
@@ -1213,6 +1402,11 @@ HDF5ImageIO
       }
       }
     }
+  // catch failure caused by the Group operations
+  catch( H5::GroupIException & error )
+    {
+    itkExceptionMacro(<< error.getCDetailMsg());
+    }
   // catch failure caused by the H5File operations
   catch( H5::FileIException & error )
     {
@@ -1266,25 +1460,53 @@ HDF5ImageIO
 
     H5::DataSpace imageSpace(numDims,dims);
     H5::PredType dataType = ComponentToPredType(this->GetComponentType());
-    std::string VoxelDataName(ImageGroup);
-    VoxelDataName += "/0";
+    std::string VoxelDataName = this->GetImageGroupName();
     VoxelDataName += VoxelData;
     // set up properties for chunked, compressed writes.
-    // in this case, set the chunk size to be the N-1 dimension
-    // region
+    // by default, set the chunk size to be the N-1 dimension
+    // region, and otherwise to the chunk size given, the voxel
+    // components being kept together
     H5::DSetCreatPropList plist;
-    plist.setDeflate(5);
-    dims[0] = 1;
-    plist.setChunk(numDims,dims);
+    if(this->m_CompressionLevel > 0)
+      {
+      plist.setDeflate(this->m_CompressionLevel);
+      }
+    std::vector<hsize_t> chunkDims(dims,dims + numDims);
+    if(this->m_ChunkSize.empty())
+      {
+      chunkDims[0] = 1;
+      }
+    else
+      {
+      const int numImageDims = this->GetNumberOfDimensions();
+      for(int i(0), j(numImageDims-1); i < numImageDims; i++, j--)
+        {
+        const SizeValueType chunkSize =
+          static_cast<unsigned int>(i) < this->m_ChunkSize.size() ? this->m_ChunkSize[i] : 1;
+        if(chunkSize > 0 && chunkSize < dims[j])
+          {
+          chunkDims[j] = chunkSize;
+          }
+        }
+      }
+    plist.setChunk(numDims,&chunkDims[0]);
 
     //
     // Create DataSet Once, potentially write to it many times
     if(this->m_VoxelDataSet == ITK_NULLPTR)
       {
-      this->m_VoxelDataSet = new H5::DataSet();
-      *(this->m_VoxelDataSet) = this->m_H5File->createDataSet(VoxelDataName,
-                                                              dataType,
-                                                              imageSpace,plist);
+      const hid_t accessList =
+        CreateChunkCacheAccessList(numDims,dims,&chunkDims[0],dataType.getSize());
+      const hid_t dataSetId = H5Dcreate2(this->m_H5File->getId(),VoxelDataName.c_str(),
+                                         dataType.getId(),imageSpace.getId(),
+                                         H5P_DEFAULT,plist.getId(),accessList);
+      H5Pclose(accessList);
+      if(dataSetId < 0)
+        {
+        delete[] dims;
+        itkExceptionMacro(<< "Cannot create " << VoxelDataName << " in " << this->GetFileName());
+        }
+      this->m_VoxelDataSet = new H5::DataSet(dataSetId);
       }
     H5::DataSpace dspace;
     this->SetupStreaming(&imageSpace,&dspace);
@@ -1313,6 +1535,13 @@ HDF5ImageIO
     }
 }
 
+std::string
+HDF5ImageIO
+::GetImageGroupName() const
+{
+  return ImageGroup + "/" + LevelName(this->m_Level);
+}
+
 //
 // GetHeaderSize -- return 0
 ImageIOBase::SizeType
@@ -0,0 +1,174 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkHDF5ImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkStreamingImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+#include "itk_H5Cpp.h"
+
+namespace
+{
+template< typename TImage >
+bool CheckImage(const TImage *image)
+{
+  itk::ImageRegionConstIteratorWithIndex< TImage > it( image, image->GetBufferedRegion() );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    const typename TImage::IndexType & index = it.GetIndex();
+    const float expected = index[0] + 100.0f * index[1] + 10000.0f * index[2];
+    if ( it.Get() != expected )
+      {
+      std::cerr << "Pixel " << index << " is " << it.Get() << " instead of " << expected << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+// The chunk dimensions and number of filters of the voxel data, slowest
+// moving dimension first
+bool GetChunking(const std::string & fileName, std::vector< hsize_t > & chunkDims, int & numberOfFilters)
+{
+  H5::H5File            file( fileName.c_str(), H5F_ACC_RDONLY );
+  H5::DataSet           dataSet = file.openDataSet( "/ITKImage/0/VoxelData" );
+  H5::DSetCreatPropList plist = dataSet.getCreatePlist();
+  if ( plist.getLayout() != H5D_CHUNKED )
+    {
+    return false;
+    }
+  chunkDims.resize( dataSet.getSpace().getSimpleExtentNdims() );
+  plist.getChunk( static_cast< int >( chunkDims.size() ), &chunkDims[0] );
+  numberOfFilters = plist.getNfilters();
+  return true;
+}
+}
+
+// Write N-D chunks in streamed slabs thinner than the chunks, and read
+// them back whole, streamed and as a region of interest.
+int itkHDF5ImageIOChunkTest(int argc, char* argv[])
+{
+  if( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string fileName = std::string( argv[1] ) + "/itkHDF5ImageIOChunkTest.hdf5";
+
+  typedef float                             PixelType;
+  typedef itk::Image< PixelType, 3 >        ImageType;
+  typedef itk::ImageFileReader< ImageType > ReaderType;
+  typedef itk::ImageFileWriter< ImageType > WriterType;
+
+  ImageType::SizeType   size = { { 40, 30, 20 } };
+  ImageType::RegionType region( size );
+  ImageType::Pointer    image = ImageType::New();
+  image->SetRegions( region );
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, region );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType & index = it.GetIndex();
+    it.Set( index[0] + 100.0f * index[1] + 10000.0f * index[2] );
+    }
+
+  itk::HDF5ImageIO::Pointer io = itk::HDF5ImageIO::New();
+  TEST_EXPECT_TRUE( io->GetChunkSize().empty() );
+  TEST_EXPECT_EQUAL( io->GetCompressionLevel(), 5 );
+  itk::HDF5ImageIO::ChunkSizeType chunkSize;
+  chunkSize.push_back( 16 );
+  chunkSize.push_back( 0 );
+  chunkSize.push_back( 8 );
+  io->SetChunkSize( chunkSize );
+  io->SetCompressionLevel( 12 );
+  TEST_EXPECT_EQUAL( io->GetCompressionLevel(), 9 );
+  std::cout << io;
+
+  // Slabs of 4 slices, half a chunk thick
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( image );
+  writer->SetImageIO( io );
+  writer->SetFileName( fileName );
+  writer->SetNumberOfStreamDivisions( 5 );
+  TRY_EXPECT_NO_EXCEPTION( writer->Update() );
+  writer = WriterType::Pointer();
+  io = itk::HDF5ImageIO::Pointer();
+
+  std::vector< hsize_t > chunkDims;
+  int                    numberOfFilters = 0;
+  TEST_EXPECT_TRUE( GetChunking( fileName, chunkDims, numberOfFilters ) );
+  TEST_EXPECT_EQUAL( chunkDims.size(), 3u );
+  TEST_EXPECT_EQUAL( chunkDims[0], 8u );
+  TEST_EXPECT_EQUAL( chunkDims[1], 30u );
+  TEST_EXPECT_EQUAL( chunkDims[2], 16u );
+  TEST_EXPECT_EQUAL( numberOfFilters, 1 );
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( fileName );
+  TRY_EXPECT_NO_EXCEPTION( reader->Update() );
+  TEST_EXPECT_TRUE( reader->GetOutput()->GetBufferedRegion() == region );
+  TEST_EXPECT_TRUE( CheckImage( reader->GetOutput() ) );
+
+  ReaderType::Pointer streamingReader = ReaderType::New();
+  streamingReader->SetFileName( fileName );
+  streamingReader->UseStreamingOn();
+  typedef itk::StreamingImageFilter< ImageType, ImageType > StreamerType;
+  StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( streamingReader->GetOutput() );
+  streamer->SetNumberOfStreamDivisions( 7 );
+  TRY_EXPECT_NO_EXCEPTION( streamer->Update() );
+  TEST_EXPECT_TRUE( CheckImage( streamer->GetOutput() ) );
+
+  ImageType::IndexType  roiIndex = { { 13, 5, 7 } };
+  ImageType::SizeType   roiSize = { { 9, 11, 3 } };
+  ImageType::RegionType roi( roiIndex, roiSize );
+  ReaderType::Pointer   roiReader = ReaderType::New();
+  roiReader->SetFileName( fileName );
+  roiReader->UseStreamingOn();
+  roiReader->GetOutput()->SetRequestedRegion( roi );
+  TRY_EXPECT_NO_EXCEPTION( roiReader->GetOutput()->Update() );
+  TEST_EXPECT_TRUE( roiReader->GetOutput()->GetBufferedRegion() == roi );
+  TEST_EXPECT_TRUE( CheckImage( roiReader->GetOutput() ) );
+
+  // Uncompressed slices, in another file as the readers keep theirs open
+  const std::string slicesFileName = std::string( argv[1] ) + "/itkHDF5ImageIOChunkTestSlices.hdf5";
+  io = itk::HDF5ImageIO::New();
+  io->SetCompressionLevel( 0 );
+  writer = WriterType::New();
+  writer->SetInput( image );
+  writer->SetImageIO( io );
+  writer->SetFileName( slicesFileName );
+  TRY_EXPECT_NO_EXCEPTION( writer->Update() );
+  writer = WriterType::Pointer();
+  io = itk::HDF5ImageIO::Pointer();
+
+  TEST_EXPECT_TRUE( GetChunking( slicesFileName, chunkDims, numberOfFilters ) );
+  TEST_EXPECT_EQUAL( chunkDims[0], 1u );
+  TEST_EXPECT_EQUAL( chunkDims[1], 30u );
+  TEST_EXPECT_EQUAL( chunkDims[2], 40u );
+  TEST_EXPECT_EQUAL( numberOfFilters, 0 );
+  ReaderType::Pointer slicesReader = ReaderType::New();
+  slicesReader->SetFileName( slicesFileName );
+  TRY_EXPECT_NO_EXCEPTION( slicesReader->Update() );
+  TEST_EXPECT_TRUE( CheckImage( slicesReader->GetOutput() ) );
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,245 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkHDF5ImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+typedef itk::Image< float, 3 >            ImageType;
+typedef itk::ImageFileReader< ImageType > ReaderType;
+typedef itk::ImageFileWriter< ImageType > WriterType;
+
+float ExpectedValue(const ImageType::IndexType & index, unsigned int level)
+{
+  return index[0] + 100.0f * index[1] + 10000.0f * index[2] + 1000000.0f * level;
+}
+
+// The image of a level, shrunk by 2 along each axis from the level before
+ImageType::Pointer CreateLevel(unsigned int level)
+{
+  ImageType::SizeType size = { { 40, 30, 20 } };
+  ImageType::SpacingType spacing;
+  spacing.Fill( 1.0 );
+  for ( unsigned int l = 0; l < level; ++l )
+    {
+    for ( unsigned int j = 0; j < 3; ++j )
+      {
+      size[j] /= 2;
+      spacing[j] *= 2.0;
+      }
+    }
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->SetSpacing( spacing );
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    it.Set( ExpectedValue( it.GetIndex(), level ) );
+    }
+  return image;
+}
+
+bool CheckImage(const ImageType *image, unsigned int level)
+{
+  itk::ImageRegionConstIteratorWithIndex< ImageType > it( image, image->GetBufferedRegion() );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != ExpectedValue( it.GetIndex(), level ) )
+      {
+      std::cerr << "Pixel " << it.GetIndex() << " of level " << level << " is " << it.Get() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+void WriteLevel(const std::string & fileName, unsigned int level, const ImageType *image)
+{
+  itk::HDF5ImageIO::Pointer io = itk::HDF5ImageIO::New();
+  io->SetLevel( level );
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( image );
+  writer->SetImageIO( io );
+  writer->SetFileName( fileName );
+  writer->Update();
+}
+
+// Write a level in pieces, only writing the paste region of the image
+// into the level in the file if it is not the whole image
+void StreamLevel(const std::string & fileName, unsigned int level, const ImageType *image,
+                 unsigned int numberOfStreamDivisions, const ImageType::RegionType & pasteRegion)
+{
+  itk::HDF5ImageIO::Pointer io = itk::HDF5ImageIO::New();
+  io->SetLevel( level );
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( image );
+  writer->SetImageIO( io );
+  writer->SetFileName( fileName );
+  writer->SetNumberOfStreamDivisions( numberOfStreamDivisions );
+  itk::ImageIORegion ioRegion( 3 );
+  for ( unsigned int j = 0; j < 3; ++j )
+    {
+    ioRegion.SetIndex( j, pasteRegion.GetIndex( j ) );
+    ioRegion.SetSize( j, pasteRegion.GetSize( j ) );
+    }
+  writer->SetIORegion( ioRegion );
+  writer->Update();
+}
+}
+
+// Write the levels of a pyramid to a file, and read a region of a level
+// back.
+int itkHDF5ImageIOLevelTest(int argc, char* argv[])
+{
+  if( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string fileName = std::string( argv[1] ) + "/itkHDF5ImageIOLevelTest.hdf5";
+
+  TRY_EXPECT_NO_EXCEPTION( WriteLevel( fileName, 0, CreateLevel( 0 ) ) );
+  // Levels are added after the ones before them
+  TRY_EXPECT_EXCEPTION( WriteLevel( fileName, 2, CreateLevel( 2 ) ) );
+  TRY_EXPECT_NO_EXCEPTION( WriteLevel( fileName, 1, CreateLevel( 0 ) ) );
+  TRY_EXPECT_NO_EXCEPTION( WriteLevel( fileName, 2, CreateLevel( 2 ) ) );
+  // Level 1 is replaced
+  TRY_EXPECT_NO_EXCEPTION( WriteLevel( fileName, 1, CreateLevel( 1 ) ) );
+
+  {
+  itk::HDF5ImageIO::Pointer io = itk::HDF5ImageIO::New();
+  TEST_EXPECT_EQUAL( io->GetLevel(), 0u );
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( fileName );
+  reader->SetImageIO( io );
+  TRY_EXPECT_NO_EXCEPTION( reader->Update() );
+  TEST_EXPECT_EQUAL( io->GetNumberOfLevels(), 3u );
+  TEST_EXPECT_TRUE( CheckImage( reader->GetOutput(), 0 ) );
+
+  for ( unsigned int level = 1; level < 3; ++level )
+    {
+    io->SetLevel( level );
+    reader->Modified();
+    TRY_EXPECT_NO_EXCEPTION( reader->UpdateLargestPossibleRegion() );
+    const ImageType::Pointer expected = CreateLevel( level );
+    TEST_EXPECT_TRUE( reader->GetOutput()->GetLargestPossibleRegion() == expected->GetLargestPossibleRegion() );
+    TEST_EXPECT_TRUE( reader->GetOutput()->GetSpacing() == expected->GetSpacing() );
+    TEST_EXPECT_TRUE( CheckImage( reader->GetOutput(), level ) );
+    }
+  std::cout << io;
+
+  io->SetLevel( 3 );
+  reader->Modified();
+  TRY_EXPECT_EXCEPTION( reader->UpdateLargestPossibleRegion() );
+  }
+
+  // The levels are written through the same IO
+  const std::string sameIOFileName = std::string( argv[1] ) + "/itkHDF5ImageIOLevelTestSameIO.hdf5";
+  {
+  itk::HDF5ImageIO::Pointer io = itk::HDF5ImageIO::New();
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetImageIO( io );
+  writer->SetFileName( sameIOFileName );
+  for ( unsigned int level = 0; level < 3; ++level )
+    {
+    io->SetLevel( level );
+    writer->SetInput( CreateLevel( level ) );
+    TRY_EXPECT_NO_EXCEPTION( writer->Update() );
+    }
+  }
+  {
+  itk::HDF5ImageIO::Pointer io = itk::HDF5ImageIO::New();
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( sameIOFileName );
+  reader->SetImageIO( io );
+  for ( unsigned int level = 0; level < 3; ++level )
+    {
+    io->SetLevel( level );
+    reader->Modified();
+    TRY_EXPECT_NO_EXCEPTION( reader->UpdateLargestPossibleRegion() );
+    TEST_EXPECT_EQUAL( io->GetNumberOfLevels(), 3u );
+    TEST_EXPECT_TRUE( reader->GetOutput()->GetLargestPossibleRegion() ==
+                      CreateLevel( level )->GetLargestPossibleRegion() );
+    TEST_EXPECT_TRUE( CheckImage( reader->GetOutput(), level ) );
+    }
+  }
+
+  // The levels other than 0 are streamed, or pasted into the level in the
+  // file, leaving the other levels
+  const std::string streamFileName = std::string( argv[1] ) + "/itkHDF5ImageIOLevelTestStream.hdf5";
+  TRY_EXPECT_NO_EXCEPTION( WriteLevel( streamFileName, 0, CreateLevel( 0 ) ) );
+  {
+  const ImageType::Pointer level1 = CreateLevel( 1 );
+  const ImageType::Pointer blank = CreateLevel( 1 );
+  blank->FillBuffer( -1.0f );
+  const ImageType::RegionType largestRegion = level1->GetLargestPossibleRegion();
+  TRY_EXPECT_NO_EXCEPTION( StreamLevel( streamFileName, 1, blank, 4, largestRegion ) );
+  ImageType::RegionType pasteRegion = largestRegion;
+  pasteRegion.SetSize( 2, largestRegion.GetSize( 2 ) / 2 );
+  TRY_EXPECT_NO_EXCEPTION( StreamLevel( streamFileName, 1, level1, 1, pasteRegion ) );
+  pasteRegion.SetIndex( 2, pasteRegion.GetSize( 2 ) );
+  pasteRegion.SetSize( 2, largestRegion.GetSize( 2 ) - pasteRegion.GetSize( 2 ) );
+  TRY_EXPECT_NO_EXCEPTION( StreamLevel( streamFileName, 1, level1, 2, pasteRegion ) );
+  // A level of another size cannot be pasted into
+  const ImageType::Pointer level2 = CreateLevel( 2 );
+  pasteRegion = level2->GetLargestPossibleRegion();
+  pasteRegion.SetSize( 2, 1 );
+  TRY_EXPECT_EXCEPTION( StreamLevel( streamFileName, 1, level2, 1, pasteRegion ) );
+  }
+  TRY_EXPECT_NO_EXCEPTION( StreamLevel( streamFileName, 2, CreateLevel( 2 ), 3,
+                                        CreateLevel( 2 )->GetLargestPossibleRegion() ) );
+  {
+  itk::HDF5ImageIO::Pointer io = itk::HDF5ImageIO::New();
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( streamFileName );
+  reader->SetImageIO( io );
+  for ( unsigned int level = 0; level < 3; ++level )
+    {
+    io->SetLevel( level );
+    reader->Modified();
+    TRY_EXPECT_NO_EXCEPTION( reader->UpdateLargestPossibleRegion() );
+    TEST_EXPECT_EQUAL( io->GetNumberOfLevels(), 3u );
+    TEST_EXPECT_TRUE( reader->GetOutput()->GetLargestPossibleRegion() ==
+                      CreateLevel( level )->GetLargestPossibleRegion() );
+    TEST_EXPECT_TRUE( CheckImage( reader->GetOutput(), level ) );
+    }
+  }
+
+  // Only a region of the coarse level is read
+  itk::HDF5ImageIO::Pointer io = itk::HDF5ImageIO::New();
+  io->SetLevel( 1 );
+  ImageType::IndexType  roiIndex = { { 3, 5, 2 } };
+  ImageType::SizeType   roiSize = { { 9, 7, 5 } };
+  ImageType::RegionType roi( roiIndex, roiSize );
+  ReaderType::Pointer   roiReader = ReaderType::New();
+  roiReader->SetFileName( fileName );
+  roiReader->SetImageIO( io );
+  roiReader->UseStreamingOn();
+  roiReader->GetOutput()->SetRequestedRegion( roi );
+  TRY_EXPECT_NO_EXCEPTION( roiReader->GetOutput()->Update() );
+  TEST_EXPECT_TRUE( roiReader->GetOutput()->GetBufferedRegion() == roi );
+  TEST_EXPECT_TRUE( CheckImage( roiReader->GetOutput(), 1 ) );
+
+  return EXIT_SUCCESS;
+}
@@ -25,6 +25,7 @@
 #include "itkImageRegion.h"
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkSimpleDataObjectDecorator.h"
+#include "itkMappedFileBufferAllocator.h"
 
 namespace itk
 {
@@ -154,6 +155,27 @@ public:
   itkGetConstReferenceMacro(UseStreaming, bool);
   itkBooleanMacro(UseStreaming);
 
+  /** Set/Get whether the file is mapped in memory rather than read, when
+   * the ImageIO reports with ImageIOBase::CanMapIORegion() that the
+   * pixels are stored as the output expects them, from an offset which
+   * is a multiple of the size of their components. The buffer of the
+   * output then wraps the mapping: no pixel is copied, and the pages of
+   * the file are only read when they are accessed. Files which cannot be
+   * mapped, and outputs whose rows are padded (see
+   * ImageBase::SetPadBufferRows()), are read as usual. Off by default. */
+  itkSetMacro(UseMemoryMapping, bool);
+  itkGetConstMacro(UseMemoryMapping, bool);
+  itkBooleanMacro(UseMemoryMapping);
+
+  /** Set/Get how the mapped buffer can be accessed: copy on write, the
+   * default, or read only. */
+  itkSetMacro(MemoryMappingAccess, MappedFileBufferAllocator::AccessType);
+  itkGetConstMacro(MemoryMappingAccess, MappedFileBufferAllocator::AccessType);
+
+  /** Get whether the buffer of the output was mapped from the file by
+   * the last update. */
+  itkGetConstMacro(OutputMemoryMapped, bool);
+
 protected:
   ImageFileReader();
   ~ImageFileReader();
@@ -169,6 +191,11 @@ protected:
     * will be thrown. */
   void TestFileExistanceAndReadability();
 
+  /** Map the requested region of the file as the buffer of the output.
+   * Returns false if the file cannot be mapped, or if the rows of the
+   * output are padded, with the output left unallocated. */
+  bool MapOutputBuffer();
+
   /** Does the real work. */
   virtual void GenerateData();
 
@@ -179,6 +206,10 @@ protected:
 
   bool m_UseStreaming;
 
+  bool                                  m_UseMemoryMapping;
+  MappedFileBufferAllocator::AccessType m_MemoryMappingAccess;
+  bool                                  m_OutputMemoryMapped;
+
 private:
   ImageFileReader(const Self &); //purposely not implemented
   void operator=(const Self &);  //purposely not implemented
@@ -38,6 +38,9 @@ ImageFileReader< TOutputImage, ConvertPixelTraits >
   this->SetFileName("");
   m_UserSpecifiedImageIO = false;
   m_UseStreaming = true;
+  m_UseMemoryMapping = false;
+  m_MemoryMappingAccess = MappedFileBufferAllocator::CopyOnWriteAccess;
+  m_OutputMemoryMapped = false;
 }
 
 template< typename TOutputImage, typename ConvertPixelTraits >
@@ -63,6 +66,10 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
 
   os << indent << "UserSpecifiedImageIO flag: " << m_UserSpecifiedImageIO << "\n";
   os << indent << "m_UseStreaming: " << m_UseStreaming << "\n";
+  os << indent << "UseMemoryMapping: " << m_UseMemoryMapping << "\n";
+  os << indent << "MemoryMappingAccess: "
+     << ( m_MemoryMappingAccess == MappedFileBufferAllocator::ReadOnlyAccess ? "ReadOnly" : "CopyOnWrite" ) << "\n";
+  os << indent << "OutputMemoryMapped: " << m_OutputMemoryMapped << "\n";
 }
 
 template< typename TOutputImage, typename ConvertPixelTraits >
@@ -365,6 +372,20 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
                  << "Allocating the buffer with the EnlargedRequestedRegion \n"
                  << output->GetRequestedRegion() << "\n");
 
+  // A buffer mapped by the previous update must not be reused to read
+  // the file in
+  if ( m_OutputMemoryMapped )
+    {
+    output->GetPixelContainer()->Initialize();
+    m_OutputMemoryMapped = false;
+    }
+
+  if ( m_UseMemoryMapping && this->MapOutputBuffer() )
+    {
+    m_OutputMemoryMapped = true;
+    return;
+    }
+
   // allocated the output image to the size of the enlarge requested region
   this->AllocateOutputs();
 
@@ -471,6 +492,69 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
   loadBuffer = ITK_NULLPTR;
 }
 
+template< typename TOutputImage, typename ConvertPixelTraits >
+bool
+ImageFileReader< TOutputImage, ConvertPixelTraits >
+::MapOutputBuffer()
+{
+  typedef typename TOutputImage::PixelContainer PixelContainerType;
+  typedef typename PixelContainerType::Element  ElementType;
+
+  TOutputImage *output = this->GetOutput();
+
+  // The rows of the mapping are contiguous, so they cannot be padded
+  if ( output->GetPadBufferRows() )
+    {
+    return false;
+    }
+
+  // The pixels in the file must be those of the output, without
+  // conversion
+  const ImageIOBase::IOComponentType ioType =
+    ImageIOBase::MapPixelType< typename ConvertPixelTraits::ComponentType >::CType;
+  const SizeValueType numberOfPixels = output->GetRequestedRegion().GetNumberOfPixels();
+  const SizeValueType numberOfBytes = numberOfPixels
+                                      * m_ImageIO->GetComponentSize() * m_ImageIO->GetNumberOfComponents();
+  if ( m_ImageIO->GetComponentType() != ioType
+       || m_ImageIO->GetNumberOfComponents() != ConvertPixelTraits::GetNumberOfComponents()
+       || m_ActualIORegion.GetNumberOfPixels() != numberOfPixels
+       || numberOfBytes == 0
+       || numberOfBytes % sizeof( ElementType ) != 0 )
+    {
+    return false;
+    }
+
+  m_ImageIO->SetFileName( this->GetFileName().c_str() );
+  m_ImageIO->SetIORegion(m_ActualIORegion);
+
+  // The components must be aligned in memory as in the file
+  std::string           fileName;
+  ImageIOBase::SizeType offset = 0;
+  if ( !m_ImageIO->CanMapIORegion(fileName, offset)
+       || offset % m_ImageIO->GetComponentSize() != 0 )
+    {
+    return false;
+    }
+
+  MappedFileBufferAllocator::Pointer allocator = MappedFileBufferAllocator::New();
+  void *buffer = allocator->Map(fileName, static_cast< SizeValueType >( offset ),
+                                numberOfBytes, m_MemoryMappingAccess);
+  if ( buffer == ITK_NULLPTR )
+    {
+    itkDebugMacro(<< "Cannot map " << fileName << ", reading it instead.");
+    return false;
+    }
+  itkDebugMacro(<< "Mapping " << numberOfBytes << " bytes of " << fileName << " from byte " << offset);
+
+  typename PixelContainerType::Pointer container = PixelContainerType::New();
+  container->SetImportPointerFromAllocator(static_cast< ElementType * >( buffer ),
+                                           numberOfBytes / sizeof( ElementType ),
+                                           allocator);
+  output->SetBufferedRegion( output->GetRequestedRegion() );
+  output->SetPixelContainer(container);
+  return true;
+}
+
 template< typename TOutputImage, typename ConvertPixelTraits >
 void
 ImageFileReader< TOutputImage, ConvertPixelTraits >
@@ -325,6 +325,17 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   virtual void Read(void *buffer) = 0;
 
+  /** Determine if the pixels of the IORegion are stored in a file exactly
+   * as Read() would return them: uncompressed, contiguous and in the
+   * native byte order, so that the file can be mapped in memory instead
+   * of being read. If so, returns true with the name of that file and
+   * the offset in bytes of the first pixel of the IORegion. Is called
+   * after ReadImageInformation() and SetIORegion(). Default is false. */
+  virtual bool CanMapIORegion(std::string & itkNotUsed(fileName), SizeType & itkNotUsed(offset))
+  {
+    return false;
+  }
+
   /*-------- This part of the interfaces deals with writing data ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -614,6 +625,11 @@ protected:
    * next slice. Returns m_Strides[3]. */
   SizeType GetSliceStride() const;
 
+  /** Get the offset in bytes of the first pixel of the IORegion from the
+   * first pixel of the image, for pixels stored without padding. Returns
+   * false when the pixels of the IORegion are not contiguous. */
+  bool GetContiguousIORegionOffset(SizeType & offset) const;
+
   /** \brief Opens a file for reading and random access
    *
    * \param[out] inputStream is an istream presumed to be opened for reading
@@ -24,6 +24,7 @@
 #include <string>
 #include "itkMetaDataDictionary.h"
 #include "itkImageFileReader.h"
+#include "itkSimpleFastMutexLock.h"
 
 namespace itk
 {
@@ -35,6 +36,12 @@ namespace itk
  * the files, but the image data must have the same Size for all
  * dimensions.
  *
+ * With UseParallelReading, the files are read concurrently by
+ * GetNumberOfThreads() threads. Each thread takes the next file not yet
+ * read as soon as it is done with the previous one, so the reading and
+ * decoding of the following files overlap, and the slices are decoded
+ * directly in their part of the output buffer.
+ *
  * \sa GDCMSeriesFileNames
  * \sa NumericSeriesFileNames
  * \ingroup IOFilters
@@ -154,9 +161,18 @@ public:
   itkGetConstReferenceMacro(UseStreaming, bool);
   itkBooleanMacro(UseStreaming);
 
+  /** Set/Get whether the files are read by several threads at once, the
+   * number of threads being GetNumberOfThreads(). Off by default. The
+   * ImageIO set with SetImageIO() is then only used through new
+   * instances made by CreateAnother(), one per thread, which must not
+   * need any setting. */
+  itkSetMacro(UseParallelReading, bool);
+  itkGetConstMacro(UseParallelReading, bool);
+  itkBooleanMacro(UseParallelReading);
+
 protected:
   ImageSeriesReader():m_ImageIO(ITK_NULLPTR), m_ReverseOrder(false),
-    m_UseStreaming(true), m_MetaDataDictionaryArrayUpdate(true) {}
+    m_UseStreaming(true), m_UseParallelReading(false), m_MetaDataDictionaryArrayUpdate(true) {}
   ~ImageSeriesReader();
   void PrintSelf(std::ostream & os, Indent indent) const;
 
@@ -185,6 +201,8 @@ protected:
 
   bool m_UseStreaming;
 
+  bool m_UseParallelReading;
+
 private:
   ImageSeriesReader(const Self &); //purposely not implemented
   void operator=(const Self &);    //purposely not implemented
@@ -193,6 +211,37 @@ private:
 
   int ComputeMovingDimensionIndex(ReaderType *reader);
 
+  /** Read slice i, the file it comes from being i or its reverse, in the
+   * output buffer, or only its information when it is outside of the
+   * requested region. Returns a copy of the MetaDataDictionary of the
+   * file when it is requested. */
+  DictionaryRawPointer ReadSlice(int i, ImageIOBase *imageIO, bool needToUpdateMetaDataDictionary);
+
+  /** Read the slices with a MultiThreader, filling dictionaries in the
+   * order of the slices. After a slice fails, the slices left are read
+   * one after another on the calling thread, which throws the exception
+   * of the first failing one with its own type, as the serial reading. */
+  void ReadSlicesInParallel(const std::vector< int > & slices, bool needToUpdateMetaDataDictionary,
+                            std::vector< DictionaryRawPointer > & dictionaries);
+
+  /** Static function used as a "callback" by the MultiThreader. */
+  static ITK_THREAD_RETURN_TYPE ReadSlicesThreaderCallback(void *arg);
+
+  /** Internal structure used for passing the slices to read to the
+   * threads. */
+  struct ReadSlicesThreadStruct
+  {
+    Self *                                Reader;
+    const std::vector< int > *            Slices;
+    std::vector< DictionaryRawPointer > * Dictionaries;
+    bool                                  NeedToUpdateMetaDataDictionary;
+    SimpleFastMutexLock                   Mutex;
+    size_t                                NextSlice;
+    size_t                                NumberOfSlicesRead;
+    std::vector< unsigned char >          SliceRead;
+    bool                                  Failed;
+  };
+
   /** Modified time of the MetaDataDictionaryArray */
   TimeStamp m_MetaDataDictionaryArrayMTime;
 
@@ -26,6 +26,7 @@
 #include "vnl/vnl_math.h"
 #include "itkProgressReporter.h"
 #include "itkMetaDataObject.h"
+#include "itkMultiThreader.h"
 
 namespace itk
 {
@@ -54,6 +55,7 @@ void ImageSeriesReader< TOutputImage >
 
   os << indent << "ReverseOrder: " << m_ReverseOrder << std::endl;
   os << indent << "UseStreaming: " << m_UseStreaming << std::endl;
+  os << indent << "UseParallelReading: " << m_UseParallelReading << std::endl;
 
   if ( m_ImageIO )
     {
@@ -283,33 +285,11 @@ void ImageSeriesReader< TOutputImage >
   TOutputImage *output = this->GetOutput();
 
   ImageRegionType requestedRegion = output->GetRequestedRegion();
-  ImageRegionType largestRegion = output->GetLargestPossibleRegion();
-  ImageRegionType sliceRegionToRequest = output->GetRequestedRegion();
-
-  // Each file must have the same size.
-  SizeType validSize = largestRegion.GetSize();
-
-  // If more than one file is being read, then the input dimension
-  // will be less than the output dimension.  In this case, set
-  // the last dimension that is other than 1 of validSize to 1.  However, if the
-  // input and output have the same number of dimensions, this should
-  // not be done because it will lower the dimension of the output image.
-  if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
-    {
-    validSize[this->m_NumberOfDimensionsInImage] = 1;
-    sliceRegionToRequest.SetSize(this->m_NumberOfDimensionsInImage, 1);
-    sliceRegionToRequest.SetIndex(this->m_NumberOfDimensionsInImage, 0);
-    }
 
   // Allocate the output buffer
   output->SetBufferedRegion(requestedRegion);
   output->Allocate();
 
-  // progress reported on a per slice basis
-  ProgressReporter progress(this, 0,
-                            requestedRegion.GetSize(TOutputImage::ImageDimension-1),
-                            100);
-
   // We utilize the modified time of the output information to
   // know when the meta array needs to be updated, when the output
   // information is updated so should the meta array.
@@ -319,10 +299,11 @@ void ImageSeriesReader< TOutputImage >
     this->m_OutputInformationMTime > this->m_MetaDataDictionaryArrayMTime
     && m_MetaDataDictionaryArrayUpdate;
 
-  typename  TOutputImage::InternalPixelType *outputBuffer = output->GetBufferPointer();
-  IndexType                           sliceStartIndex = requestedRegion.GetIndex();
-  const int                           numberOfFiles = static_cast< int >( m_FileNames.size() );
+  IndexType sliceStartIndex = requestedRegion.GetIndex();
+  const int numberOfFiles = static_cast< int >( m_FileNames.size() );
 
+  // the slices whose file must be read, for data or information
+  std::vector< int > slices;
   for ( int i = 0; i != numberOfFiles; ++i )
     {
     if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
@@ -330,136 +311,315 @@ void ImageSeriesReader< TOutputImage >
       sliceStartIndex[this->m_NumberOfDimensionsInImage] = i;
       }
 
-    const bool insideRequestedRegion = requestedRegion.IsInside(sliceStartIndex);
-    const int  iFileName = ( m_ReverseOrder ? numberOfFiles - i - 1 : i );
-
     // check if we need this slice
-    if ( !insideRequestedRegion && !needToUpdateMetaDataDictionaryArray )
+    if ( requestedRegion.IsInside(sliceStartIndex) || needToUpdateMetaDataDictionaryArray )
       {
-      continue;
+      slices.push_back(i);
       }
+    }
 
-    // configure reader
-    typename ReaderType::Pointer reader = ReaderType::New();
-    reader->SetFileName( m_FileNames[iFileName].c_str() );
+  std::vector< DictionaryRawPointer > dictionaries( slices.size(), ITK_NULLPTR );
+  if ( m_UseParallelReading && this->GetNumberOfThreads() > 1 && slices.size() > 1 )
+    {
+    this->ReadSlicesInParallel(slices, needToUpdateMetaDataDictionaryArray, dictionaries);
+    }
+  else
+    {
+    // progress reported on a per slice basis
+    ProgressReporter progress(this, 0,
+                              requestedRegion.GetSize(TOutputImage::ImageDimension-1),
+                              100);
 
-    TOutputImage * readerOutput = reader->GetOutput();
+    try
+      {
+      for ( size_t s = 0; s < slices.size(); ++s )
+        {
+        dictionaries[s] = this->ReadSlice(slices[s], m_ImageIO, needToUpdateMetaDataDictionaryArray);
 
-    if ( m_ImageIO )
+        if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
+          {
+          sliceStartIndex[this->m_NumberOfDimensionsInImage] = slices[s];
+          }
+        if ( requestedRegion.IsInside(sliceStartIndex) )
+          {
+          // report progress for read slices
+          progress.CompletedPixel();
+          }
+        }
+      }
+    catch ( ... )
       {
-      reader->SetImageIO(m_ImageIO);
+      for ( size_t s = 0; s < dictionaries.size(); ++s )
+        {
+        delete dictionaries[s];
+        }
+      throw;
       }
-    reader->SetUseStreaming(m_UseStreaming);
-    readerOutput->SetRequestedRegion(sliceRegionToRequest);
+    }
 
-    // update the data or info
-    if ( !insideRequestedRegion )
+  for ( size_t s = 0; s < dictionaries.size(); ++s )
+    {
+    if ( dictionaries[s] )
       {
-      reader->UpdateOutputInformation();
+      m_MetaDataDictionaryArray.push_back(dictionaries[s]);
       }
-    else
-      {
-      // read the meta data information
-      readerOutput->UpdateOutputInformation();
+    }
 
-      // propagate the requested region to determin what the region
-      // will actually be read
-      readerOutput->PropagateRequestedRegion();
+  // update the time if we modified the meta array
+  if ( needToUpdateMetaDataDictionaryArray )
+    {
+    m_MetaDataDictionaryArrayMTime.Modified();
+    }
+}
 
-      // check that the size of each slice is the same
-      if ( readerOutput->GetLargestPossibleRegion().GetSize() != validSize )
-        {
-        itkExceptionMacro( << "Size mismatch! The size of  "
-                           << m_FileNames[iFileName].c_str()
-                           << " is "
-                           << readerOutput->GetLargestPossibleRegion().GetSize()
-                           << " and does not match the required size "
-                           << validSize
-                           << " from file "
-                           << m_FileNames[m_ReverseOrder ? m_FileNames.size() - 1 : 0].c_str() );
-        }
+template< typename TOutputImage >
+typename ImageSeriesReader< TOutputImage >::DictionaryRawPointer
+ImageSeriesReader< TOutputImage >
+::ReadSlice(int i, ImageIOBase *imageIO, bool needToUpdateMetaDataDictionary)
+{
+  TOutputImage *output = this->GetOutput();
 
-      // get the size of the region to be read
-      SizeType readSize = readerOutput->GetRequestedRegion().GetSize();
+  const ImageRegionType requestedRegion = output->GetRequestedRegion();
+  const ImageRegionType largestRegion = output->GetLargestPossibleRegion();
+  ImageRegionType       sliceRegionToRequest = output->GetRequestedRegion();
 
-      if( readSize == sliceRegionToRequest.GetSize() )
-        {
-        // if the buffer of the ImageReader is going to match that of
-        // ourselves, then set the ImageReader's buffer to a section
-        // of ours
+  // Each file must have the same size.
+  SizeType validSize = largestRegion.GetSize();
+
+  // If more than one file is being read, then the input dimension
+  // will be less than the output dimension.  In this case, set
+  // the last dimension that is other than 1 of validSize to 1.  However, if the
+  // input and output have the same number of dimensions, this should
+  // not be done because it will lower the dimension of the output image.
+  IndexType sliceStartIndex = requestedRegion.GetIndex();
+  if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
+    {
+    validSize[this->m_NumberOfDimensionsInImage] = 1;
+    sliceRegionToRequest.SetSize(this->m_NumberOfDimensionsInImage, 1);
+    sliceRegionToRequest.SetIndex(this->m_NumberOfDimensionsInImage, 0);
+    sliceStartIndex[this->m_NumberOfDimensionsInImage] = i;
+    }
+
+  const bool insideRequestedRegion = requestedRegion.IsInside(sliceStartIndex);
+  const int  numberOfFiles = static_cast< int >( m_FileNames.size() );
+  const int  iFileName = ( m_ReverseOrder ? numberOfFiles - i - 1 : i );
 
-        const size_t  numberOfPixelsInSlice = sliceRegionToRequest.GetNumberOfPixels();
+  // configure reader
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( m_FileNames[iFileName].c_str() );
 
-        typedef typename TOutputImage::AccessorFunctorType AccessorFunctorType;
-        const size_t      numberOfInternalComponentsPerPixel =  AccessorFunctorType::GetVectorLength( output );
+  TOutputImage * readerOutput = reader->GetOutput();
 
+  if ( imageIO )
+    {
+    reader->SetImageIO(imageIO);
+    }
+  reader->SetUseStreaming(m_UseStreaming);
+  readerOutput->SetRequestedRegion(sliceRegionToRequest);
+
+  // update the data or info
+  if ( !insideRequestedRegion )
+    {
+    reader->UpdateOutputInformation();
+    }
+  else
+    {
+    // read the meta data information
+    readerOutput->UpdateOutputInformation();
+
+    // propagate the requested region to determin what the region
+    // will actually be read
+    readerOutput->PropagateRequestedRegion();
 
-        const ptrdiff_t   sliceOffset = ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage ) ?
-          ( i - requestedRegion.GetIndex(this->m_NumberOfDimensionsInImage)) : 0;
+    // check that the size of each slice is the same
+    if ( readerOutput->GetLargestPossibleRegion().GetSize() != validSize )
+      {
+      itkExceptionMacro( << "Size mismatch! The size of  "
+                         << m_FileNames[iFileName].c_str()
+                         << " is "
+                         << readerOutput->GetLargestPossibleRegion().GetSize()
+                         << " and does not match the required size "
+                         << validSize
+                         << " from file "
+                         << m_FileNames[m_ReverseOrder ? m_FileNames.size() - 1 : 0].c_str() );
+      }
 
-        const ptrdiff_t  numberOfPixelComponentsUpToSlice =  numberOfPixelsInSlice * numberOfInternalComponentsPerPixel * sliceOffset;
-        const bool       bufferDelete = false;
+    // get the size of the region to be read
+    SizeType readSize = readerOutput->GetRequestedRegion().GetSize();
 
-        typename  TOutputImage::InternalPixelType * outputSliceBuffer = outputBuffer + numberOfPixelComponentsUpToSlice;
+    if( readSize == sliceRegionToRequest.GetSize() )
+      {
+      // if the buffer of the ImageReader is going to match that of
+      // ourselves, then set the ImageReader's buffer to a section
+      // of ours
 
-        if ( strcmp(output->GetNameOfClass(), "VectorImage") == 0 )
-          {
-          // if the input image type is a vector image then the number
-          // of components needs to be set for the size
-          readerOutput->GetPixelContainer()->SetImportPointer( outputSliceBuffer,
-                                                               numberOfPixelsInSlice*numberOfInternalComponentsPerPixel,
-                                                               bufferDelete );
-          }
-        else
-          {
-          // otherwise the actual number of pixels needs to be passed
-          readerOutput->GetPixelContainer()->SetImportPointer( outputSliceBuffer,
-                                                               numberOfPixelsInSlice,
-                                                               bufferDelete );
-          }
-        readerOutput->UpdateOutputData();
+      const size_t  numberOfPixelsInSlice = sliceRegionToRequest.GetNumberOfPixels();
+
+      typedef typename TOutputImage::AccessorFunctorType AccessorFunctorType;
+      const size_t      numberOfInternalComponentsPerPixel =  AccessorFunctorType::GetVectorLength( output );
+
+
+      const ptrdiff_t   sliceOffset = ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage ) ?
+        ( i - requestedRegion.GetIndex(this->m_NumberOfDimensionsInImage)) : 0;
+
+      const ptrdiff_t  numberOfPixelComponentsUpToSlice =  numberOfPixelsInSlice * numberOfInternalComponentsPerPixel * sliceOffset;
+      const bool       bufferDelete = false;
+
+      typename  TOutputImage::InternalPixelType * outputSliceBuffer =
+        output->GetBufferPointer() + numberOfPixelComponentsUpToSlice;
+
+      if ( strcmp(output->GetNameOfClass(), "VectorImage") == 0 )
+        {
+        // if the input image type is a vector image then the number
+        // of components needs to be set for the size
+        readerOutput->GetPixelContainer()->SetImportPointer( outputSliceBuffer,
+                                                             numberOfPixelsInSlice*numberOfInternalComponentsPerPixel,
+                                                             bufferDelete );
         }
       else
         {
-        // the read region isn't going to match exactly what we need
-        // to update to buffer created by the reader, then copy
+        // otherwise the actual number of pixels needs to be passed
+        readerOutput->GetPixelContainer()->SetImportPointer( outputSliceBuffer,
+                                                             numberOfPixelsInSlice,
+                                                             bufferDelete );
+        }
+      readerOutput->UpdateOutputData();
+      }
+    else
+      {
+      // the read region isn't going to match exactly what we need
+      // to update to buffer created by the reader, then copy
 
-        reader->Update();
+      reader->Update();
 
-        // output of buffer copy
-        ImageRegionType outRegion = requestedRegion;
-        outRegion.SetIndex( sliceStartIndex );
+      // output of buffer copy
+      ImageRegionType outRegion = requestedRegion;
+      outRegion.SetIndex( sliceStartIndex );
 
-        // set the moving dimension to a size of 1
-        if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
-          {
-          outRegion.SetSize(this->m_NumberOfDimensionsInImage, 1);
-          }
+      // set the moving dimension to a size of 1
+      if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
+        {
+        outRegion.SetSize(this->m_NumberOfDimensionsInImage, 1);
+        }
+
+      ImageAlgorithm::Copy( readerOutput, output, sliceRegionToRequest, outRegion );
 
-        ImageAlgorithm::Copy( readerOutput, output, sliceRegionToRequest, outRegion );
+      }
+    } // end !insidedRequestedRegion
 
+  // Deep copy the MetaDataDictionary into the array
+  if ( reader->GetImageIO() && needToUpdateMetaDataDictionary )
+    {
+    DictionaryRawPointer newDictionary = new DictionaryType;
+    *newDictionary = reader->GetImageIO()->GetMetaDataDictionary();
+    return newDictionary;
+    }
+  return ITK_NULLPTR;
+}
+
+template< typename TOutputImage >
+void ImageSeriesReader< TOutputImage >
+::ReadSlicesInParallel(const std::vector< int > & slices, bool needToUpdateMetaDataDictionary,
+                       std::vector< DictionaryRawPointer > & dictionaries)
+{
+  ReadSlicesThreadStruct str;
+  str.Reader = this;
+  str.Slices = &slices;
+  str.Dictionaries = &dictionaries;
+  str.NeedToUpdateMetaDataDictionary = needToUpdateMetaDataDictionary;
+  str.NextSlice = 0;
+  str.NumberOfSlicesRead = 0;
+  str.SliceRead.assign( slices.size(), 0 );
+  str.Failed = false;
+
+  // The readers, or their ImageIO, may use the thread pool themselves
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->UseThreadPoolOff();
+  threader->SetNumberOfThreads( std::min( this->GetNumberOfThreads(), static_cast< ThreadIdType >( slices.size() ) ) );
+  threader->SetSingleMethod(Self::ReadSlicesThreaderCallback, &str);
+
+  this->UpdateProgress(0.0f);
+  threader->SingleMethodExecute();
+
+  if ( str.Failed )
+    {
+    // the exception is not copied across the threads, which would slice it
+    try
+      {
+      for ( size_t s = 0; s < slices.size(); ++s )
+        {
+        if ( !str.SliceRead[s] )
+          {
+          dictionaries[s] = this->ReadSlice(slices[s], m_ImageIO, needToUpdateMetaDataDictionary);
+          }
         }
+      }
+    catch ( ... )
+      {
+      for ( size_t s = 0; s < dictionaries.size(); ++s )
+        {
+        delete dictionaries[s];
+        dictionaries[s] = ITK_NULLPTR;
+        }
+      throw;
+      }
+    }
+  this->UpdateProgress(1.0f);
+}
 
-      // report progress for read slices
-      progress.CompletedPixel();
+template< typename TOutputImage >
+ITK_THREAD_RETURN_TYPE
+ImageSeriesReader< TOutputImage >
+::ReadSlicesThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  ReadSlicesThreadStruct *         str = static_cast< ReadSlicesThreadStruct * >( info->UserData );
+  Self *                           reader = str->Reader;
 
-     } // end !insidedRequestedRegion
+  // An ImageIO can only read one file at a time
+  ImageIOBase::Pointer imageIO;
+  if ( reader->m_ImageIO )
+    {
+    imageIO = dynamic_cast< ImageIOBase * >( reader->m_ImageIO->CreateAnother().GetPointer() );
+    }
 
-    // Deep copy the MetaDataDictionary into the array
-    if ( reader->GetImageIO() &&  needToUpdateMetaDataDictionaryArray )
+  while ( true )
+    {
+    str->Mutex.Lock();
+    const size_t s = str->NextSlice++;
+    const bool   done = str->Failed || s >= str->Slices->size();
+    str->Mutex.Unlock();
+    if ( done )
       {
-      DictionaryRawPointer newDictionary = new DictionaryType;
-      *newDictionary = reader->GetImageIO()->GetMetaDataDictionary();
-      m_MetaDataDictionaryArray.push_back(newDictionary);
+      break;
       }
 
-    } // end per slice loop
+    try
+      {
+      ( *str->Dictionaries )[s] =
+        reader->ReadSlice( ( *str->Slices )[s], imageIO, str->NeedToUpdateMetaDataDictionary );
+      }
+    catch ( ... )
+      {
+      // the slice is read again by ReadSlicesInParallel
+      str->Mutex.Lock();
+      str->Failed = true;
+      str->Mutex.Unlock();
+      break;
+      }
 
-  // update the time if we modified the meta array
-  if ( needToUpdateMetaDataDictionaryArray )
-    {
-    m_MetaDataDictionaryArrayMTime.Modified();
+    // only the first thread reports progress
+    str->Mutex.Lock();
+    str->SliceRead[s] = 1;
+    const size_t numberOfSlicesRead = ++str->NumberOfSlicesRead;
+    str->Mutex.Unlock();
+    if ( info->ThreadID == 0 )
+      {
+      reader->UpdateProgress( static_cast< float >( numberOfSlicesRead ) / str->Slices->size() );
+      }
     }
+
+  return ITK_THREAD_RETURN_VALUE;
 }
 
 template< typename TOutputImage >
@@ -0,0 +1,109 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkMappedFileBufferAllocator_h
+#define __itkMappedFileBufferAllocator_h
+
+#include "ITKIOImageBaseExport.h"
+#include "itkImageBufferAllocator.h"
+#include <string>
+
+namespace itk
+{
+/** \class MappedFileBufferAllocator
+ * \brief Provides an image buffer mapped from a range of a file.
+ *
+ * Map() maps a range of bytes of a file in memory. The pages are only
+ * read from the file when they are first accessed, and they can be
+ * dropped by the operating system under memory pressure, so mapping a
+ * large file is quick and only the parts of it which are used take
+ * physical memory.
+ *
+ * The mapping is handed to an ImportImageContainer with
+ * ImportImageContainer::SetImportPointerFromAllocator(). The container
+ * then keeps the allocator alive, and unmaps the range through
+ * Deallocate() when it releases its buffer.
+ *
+ * With CopyOnWriteAccess, the default, the buffer can be modified: the
+ * pages written to become private copies, and the file is never
+ * changed. With ReadOnlyAccess, writing to the buffer is a memory
+ * access violation, which catches filters modifying the image in place.
+ *
+ * Each allocator holds a single mapping. Allocate() always returns NULL.
+ *
+ * \sa ImageFileReader::SetUseMemoryMapping()
+ * \ingroup IOFilters
+ * \ingroup ITKIOImageBase
+ */
+class ITKIOImageBase_EXPORT MappedFileBufferAllocator:public ImageBufferAllocator
+{
+public:
+  /** Standard class typedefs. */
+  typedef MappedFileBufferAllocator  Self;
+  typedef ImageBufferAllocator       Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MappedFileBufferAllocator, ImageBufferAllocator);
+
+  /** How the mapped memory can be accessed. */
+  typedef enum { CopyOnWriteAccess = 0, ReadOnlyAccess } AccessType;
+
+  /** Map numberOfBytes bytes of the file from the given offset, and
+   * return the address of the first one, or NULL when the file cannot be
+   * mapped. The address has the alignment of the offset modulo the page
+   * size. Throws an exception if a range is already mapped. */
+  void * Map(const std::string & fileName, SizeValueType offset,
+             SizeValueType numberOfBytes, AccessType access = CopyOnWriteAccess);
+
+  /** Get the address and the size of the mapped range, NULL and 0 when
+   * none is mapped. */
+  void * GetMappedBuffer() const { return m_Buffer; }
+  SizeValueType GetNumberOfMappedBytes() const { return m_NumberOfBytes; }
+
+  /** Memory is only obtained from Map(); returns NULL. */
+  virtual void * Allocate(SizeValueType numberOfBytes) ITK_OVERRIDE;
+
+  /** Unmap the range returned by Map(). */
+  virtual void Deallocate(void *buffer, SizeValueType numberOfBytes) ITK_OVERRIDE;
+
+protected:
+  MappedFileBufferAllocator();
+  virtual ~MappedFileBufferAllocator();
+
+  virtual void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
+
+private:
+  MappedFileBufferAllocator(const Self &); //purposely not implemented
+  void operator=(const Self &);            //purposely not implemented
+
+  void Unmap();
+
+  void *        m_Buffer;
+  SizeValueType m_NumberOfBytes;
+  void *        m_View;
+  SizeValueType m_ViewSize;
+  std::string   m_FileName;
+  AccessType    m_Access;
+};
+} // end namespace itk
+
+#endif
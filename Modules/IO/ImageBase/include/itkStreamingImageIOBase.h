@@ -98,6 +98,14 @@ protected:
    */
   virtual bool RequestedToStream(void) const;
 
+  /** \brief Create the ImageIO reading the information of the file
+   * pasted into, which must match the information written.
+   *
+   * Returns CreateAnother() by default. Reimplemented by ImageIOs
+   * holding several images in a file, to read the one written.
+   */
+  virtual Pointer CreateImageIOForPasting(void);
+
   /** \brief Reimplemented from super class to get around 2GB
    * read/write limitation
    *
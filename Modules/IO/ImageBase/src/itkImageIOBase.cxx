@@ -924,6 +924,34 @@ ImageIOBase::GetSplitRegionForWriting(unsigned int ithPiece,
   return largestPossibleRegion;
 }
 
+bool
+ImageIOBase
+::GetContiguousIORegionOffset(SizeType & offset) const
+{
+  // The pixels are contiguous if the region covers whole lines, whole
+  // slices, etc. up to a dimension, and a single index beyond it.
+  SizeType stride = this->GetPixelSize();
+  bool     partial = false;
+
+  offset = 0;
+  for ( unsigned int i = 0; i < m_IORegion.GetImageDimension(); ++i )
+    {
+    const SizeType fileSize = i < m_NumberOfDimensions ? static_cast< SizeType >( m_Dimensions[i] ) : 1;
+    const SizeType size = static_cast< SizeType >( m_IORegion.GetSize(i) );
+    if ( partial && size > 1 )
+      {
+      return false;
+      }
+    if ( size != fileSize )
+      {
+      partial = true;
+      }
+    offset += static_cast< SizeType >( m_IORegion.GetIndex(i) ) * stride;
+    stride *= fileSize;
+    }
+  return true;
+}
+
 /** Given a requested region, determine what could be the region that we can
  * read from the file. This is called the streamable region, which will be
  * smaller than the LargestPossibleRegion and greater or equal to the
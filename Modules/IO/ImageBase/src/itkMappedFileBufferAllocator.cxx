@@ -0,0 +1,194 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMappedFileBufferAllocator.h"
+
+#if defined( WIN32 ) || defined( _WIN32 )
+  #include "itkWindows.h"
+#else
+  #include <sys/mman.h>
+  #include <sys/types.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+namespace itk
+{
+namespace
+{
+// Mappings must start on a multiple of this number of bytes
+SizeValueType GetMappingGranularity()
+{
+  static SizeValueType granularity = 0;
+  if ( granularity == 0 )
+    {
+#if defined( WIN32 ) || defined( _WIN32 )
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    granularity = static_cast< SizeValueType >( info.dwAllocationGranularity );
+#else
+    granularity = static_cast< SizeValueType >( sysconf(_SC_PAGESIZE) );
+#endif
+    }
+  return granularity;
+}
+}
+
+MappedFileBufferAllocator
+::MappedFileBufferAllocator():
+  m_Buffer(ITK_NULLPTR),
+  m_NumberOfBytes(0),
+  m_View(ITK_NULLPTR),
+  m_ViewSize(0),
+  m_Access(CopyOnWriteAccess)
+{}
+
+MappedFileBufferAllocator
+::~MappedFileBufferAllocator()
+{
+  this->Unmap();
+}
+
+void *
+MappedFileBufferAllocator
+::Map(const std::string & fileName, SizeValueType offset,
+      SizeValueType numberOfBytes, AccessType access)
+{
+  if ( m_View != ITK_NULLPTR )
+    {
+    itkExceptionMacro(<< "A range of " << m_FileName << " is already mapped.");
+    }
+  if ( numberOfBytes == 0 )
+    {
+    return ITK_NULLPTR;
+    }
+
+  const SizeValueType viewOffset = offset - offset % GetMappingGranularity();
+  const SizeValueType viewSize = numberOfBytes + ( offset - viewOffset );
+  if ( static_cast< SizeValueType >( static_cast< size_t >( viewSize ) ) != viewSize )
+    {
+    return ITK_NULLPTR;
+    }
+
+  void *view = ITK_NULLPTR;
+#if defined( WIN32 ) || defined( _WIN32 )
+  HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, ITK_NULLPTR,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, ITK_NULLPTR);
+  if ( file == INVALID_HANDLE_VALUE )
+    {
+    return ITK_NULLPTR;
+    }
+  const unsigned __int64 end = static_cast< unsigned __int64 >( viewOffset ) + viewSize;
+  HANDLE mapping = CreateFileMappingA(file, ITK_NULLPTR,
+                                      access == ReadOnlyAccess ? PAGE_READONLY : PAGE_WRITECOPY,
+                                      static_cast< DWORD >( end >> 32 ),
+                                      static_cast< DWORD >( end & 0xFFFFFFFF ), ITK_NULLPTR);
+  if ( mapping != ITK_NULLPTR )
+    {
+    const unsigned __int64 start = static_cast< unsigned __int64 >( viewOffset );
+    view = MapViewOfFile(mapping, access == ReadOnlyAccess ? FILE_MAP_READ : FILE_MAP_COPY,
+                         static_cast< DWORD >( start >> 32 ),
+                         static_cast< DWORD >( start & 0xFFFFFFFF ),
+                         static_cast< SIZE_T >( viewSize ));
+    // The view keeps the mapping and the file open
+    CloseHandle(mapping);
+    }
+  CloseHandle(file);
+#else
+  const int file = open(fileName.c_str(), O_RDONLY);
+  if ( file < 0 )
+    {
+    return ITK_NULLPTR;
+    }
+  // The mapping must not extend past the end of the file, where accesses
+  // would fault
+  const off_t fileSize = lseek(file, 0, SEEK_END);
+  if ( fileSize >= 0 && static_cast< SizeValueType >( fileSize ) >= viewOffset + viewSize )
+    {
+    // Private mappings are copy on write
+    view = mmap(ITK_NULLPTR, static_cast< size_t >( viewSize ),
+                access == ReadOnlyAccess ? PROT_READ : PROT_READ | PROT_WRITE,
+                MAP_PRIVATE, file, static_cast< off_t >( viewOffset ));
+    if ( view == MAP_FAILED )
+      {
+      view = ITK_NULLPTR;
+      }
+    }
+  // The mapping keeps the file open
+  close(file);
+#endif
+  if ( view == ITK_NULLPTR )
+    {
+    return ITK_NULLPTR;
+    }
+
+  m_View = view;
+  m_ViewSize = viewSize;
+  m_Buffer = static_cast< char * >( view ) + ( offset - viewOffset );
+  m_NumberOfBytes = numberOfBytes;
+  m_FileName = fileName;
+  m_Access = access;
+  return m_Buffer;
+}
+
+void *
+MappedFileBufferAllocator
+::Allocate(SizeValueType)
+{
+  return ITK_NULLPTR;
+}
+
+void
+MappedFileBufferAllocator
+::Deallocate(void *buffer, SizeValueType)
+{
+  if ( buffer != ITK_NULLPTR && buffer == m_Buffer )
+    {
+    this->Unmap();
+    }
+}
+
+void
+MappedFileBufferAllocator
+::Unmap()
+{
+  if ( m_View == ITK_NULLPTR )
+    {
+    return;
+    }
+#if defined( WIN32 ) || defined( _WIN32 )
+  UnmapViewOfFile(m_View);
+#else
+  munmap(m_View, static_cast< size_t >( m_ViewSize ));
+#endif
+  m_View = ITK_NULLPTR;
+  m_ViewSize = 0;
+  m_Buffer = ITK_NULLPTR;
+  m_NumberOfBytes = 0;
+}
+
+void
+MappedFileBufferAllocator
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << m_FileName << std::endl;
+  os << indent << "Access: " << ( m_Access == ReadOnlyAccess ? "ReadOnly" : "CopyOnWrite" ) << std::endl;
+  os << indent << "MappedBuffer: " << m_Buffer << std::endl;
+  os << indent << "NumberOfMappedBytes: " << m_NumberOfBytes << std::endl;
+}
+} // end namespace itk
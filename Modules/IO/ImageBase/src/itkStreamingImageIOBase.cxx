@@ -242,6 +242,11 @@ bool StreamingImageIOBase::StreamWriteBufferAsBinary(std::ostream & file, const
   return true;
 }
 
+StreamingImageIOBase::Pointer StreamingImageIOBase::CreateImageIOForPasting(void)
+{
+  return dynamic_cast< StreamingImageIOBase * >( this->CreateAnother().GetPointer() );
+}
+
 bool StreamingImageIOBase::CanStreamRead(void)
 {
   return true;
@@ -275,7 +280,7 @@ StreamingImageIOBase::GetActualNumberOfSplitsForWriting(unsigned int numberOfReq
 
     // need to check to see if the file is compatible
     std::string errorMessage;
-    Pointer     headerImageIOReader = dynamic_cast< StreamingImageIOBase * >( this->CreateAnother().GetPointer() );
+    Pointer     headerImageIOReader = this->CreateImageIOForPasting();
 
     try
       {
@@ -0,0 +1,157 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkStreamingImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkCastImageFilter.h"
+#include "itkTestingComparisonImageFilter.h"
+#include "itkTestingMacros.h"
+
+int itkImageFileReaderMemoryMappingTest(int argc, char* argv[])
+{
+  if( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " image" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef float                                       PixelType;
+  typedef itk::Image< PixelType, 3 >                  ImageType;
+  typedef itk::ImageFileReader< ImageType >           ReaderType;
+  typedef itk::ImageFileWriter< ImageType >           WriterType;
+  typedef itk::MappedFileBufferAllocator              AllocatorType;
+  typedef itk::Testing::ComparisonImageFilter< ImageType, ImageType > ComparisonFilterType;
+
+  ImageType::SizeType   size = { { 40, 30, 20 } };
+  ImageType::RegionType region( size );
+  ImageType::Pointer    image = ImageType::New();
+  image->SetRegions( region );
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, region );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType & index = it.GetIndex();
+    it.Set( static_cast< PixelType >( index[0] + 100 * index[1] + 10000 * index[2] ) );
+    }
+
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( image );
+  writer->SetFileName( argv[1] );
+  TRY_EXPECT_NO_EXCEPTION( writer->Update() );
+
+  // The allocator maps ranges of files
+  AllocatorType::Pointer allocator = AllocatorType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( allocator, AllocatorType );
+  TEST_EXPECT_EQUAL( allocator->Allocate( 100 ), static_cast< void * >( ITK_NULLPTR ) );
+  TEST_EXPECT_EQUAL( allocator->Map( std::string( argv[1] ) + ".missing", 0, 100 ),
+                     static_cast< void * >( ITK_NULLPTR ) );
+  const char *mapped = static_cast< const char * >( allocator->Map( argv[1], 3, 100 ) );
+  TEST_EXPECT_TRUE( mapped != ITK_NULLPTR );
+  TEST_EXPECT_EQUAL( allocator->GetNumberOfMappedBytes(), 100u );
+  TRY_EXPECT_EXCEPTION( allocator->Map( argv[1], 0, 100 ) );
+  std::ifstream file( argv[1], std::ios::binary );
+  char          bytes[103];
+  file.read( bytes, 103 );
+  TEST_EXPECT_TRUE( std::equal( bytes + 3, bytes + 103, mapped ) );
+  allocator->Deallocate( const_cast< char * >( mapped ), 100 );
+  TEST_EXPECT_EQUAL( allocator->GetMappedBuffer(), static_cast< void * >( ITK_NULLPTR ) );
+
+  // Map the whole image
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+  TEST_EXPECT_TRUE( !reader->GetUseMemoryMapping() );
+  reader->UseMemoryMappingOn();
+  TRY_EXPECT_NO_EXCEPTION( reader->Update() );
+  std::cout << reader;
+  TEST_EXPECT_TRUE( reader->GetOutputMemoryMapped() );
+  ComparisonFilterType::Pointer comparison = ComparisonFilterType::New();
+  comparison->SetValidInput( image );
+  comparison->SetTestInput( reader->GetOutput() );
+  TRY_EXPECT_NO_EXCEPTION( comparison->Update() );
+  TEST_EXPECT_EQUAL( comparison->GetNumberOfPixelsWithDifferences(), 0u );
+
+  // Writing to a copy on write mapping leaves the file unchanged
+  ImageType::IndexType index = { { 3, 4, 5 } };
+  reader->GetOutput()->SetPixel( index, -1.0f );
+  ReaderType::Pointer plainReader = ReaderType::New();
+  plainReader->SetFileName( argv[1] );
+  TRY_EXPECT_NO_EXCEPTION( plainReader->Update() );
+  TEST_EXPECT_TRUE( !plainReader->GetOutputMemoryMapped() );
+  comparison->SetTestInput( plainReader->GetOutput() );
+  TRY_EXPECT_NO_EXCEPTION( comparison->Update() );
+  TEST_EXPECT_EQUAL( comparison->GetNumberOfPixelsWithDifferences(), 0u );
+
+  // Updating again without mapping reads in a new buffer
+  reader->UseMemoryMappingOff();
+  reader->Modified();
+  TRY_EXPECT_NO_EXCEPTION( reader->Update() );
+  TEST_EXPECT_TRUE( !reader->GetOutputMemoryMapped() );
+  comparison->SetTestInput( reader->GetOutput() );
+  TRY_EXPECT_NO_EXCEPTION( comparison->Update() );
+  TEST_EXPECT_EQUAL( comparison->GetNumberOfPixelsWithDifferences(), 0u );
+
+  // Outputs with padded rows are read, here with rows which need no
+  // padding, as the pixels are read contiguously
+  ReaderType::Pointer paddedReader = ReaderType::New();
+  paddedReader->SetFileName( argv[1] );
+  paddedReader->UseMemoryMappingOn();
+  paddedReader->GetOutput()->SetBufferAlignment( 32 );
+  paddedReader->GetOutput()->PadBufferRowsOn();
+  TRY_EXPECT_NO_EXCEPTION( paddedReader->Update() );
+  TEST_EXPECT_TRUE( !paddedReader->GetOutputMemoryMapped() );
+  comparison->SetTestInput( paddedReader->GetOutput() );
+  TRY_EXPECT_NO_EXCEPTION( comparison->Update() );
+  TEST_EXPECT_EQUAL( comparison->GetNumberOfPixelsWithDifferences(), 0u );
+
+  // Read only mappings of streamed pieces
+  ReaderType::Pointer streamingReader = ReaderType::New();
+  streamingReader->SetFileName( argv[1] );
+  streamingReader->UseMemoryMappingOn();
+  streamingReader->SetMemoryMappingAccess( AllocatorType::ReadOnlyAccess );
+  typedef itk::StreamingImageFilter< ImageType, ImageType > StreamerType;
+  StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( streamingReader->GetOutput() );
+  streamer->SetNumberOfStreamDivisions( 4 );
+  TRY_EXPECT_NO_EXCEPTION( streamer->Update() );
+  TEST_EXPECT_TRUE( streamingReader->GetOutputMemoryMapped() );
+  TEST_EXPECT_EQUAL( streamingReader->GetOutput()->GetBufferedRegion().GetSize( 2 ), 5u );
+  comparison->SetTestInput( streamer->GetOutput() );
+  TRY_EXPECT_NO_EXCEPTION( comparison->Update() );
+  TEST_EXPECT_EQUAL( comparison->GetNumberOfPixelsWithDifferences(), 0u );
+
+  // Pixels which must be converted are read
+  typedef itk::Image< double, 3 > DoubleImageType;
+  typedef itk::ImageFileReader< DoubleImageType > DoubleReaderType;
+  DoubleReaderType::Pointer doubleReader = DoubleReaderType::New();
+  doubleReader->SetFileName( argv[1] );
+  doubleReader->UseMemoryMappingOn();
+  TRY_EXPECT_NO_EXCEPTION( doubleReader->Update() );
+  TEST_EXPECT_TRUE( !doubleReader->GetOutputMemoryMapped() );
+  typedef itk::CastImageFilter< ImageType, DoubleImageType > CastFilterType;
+  CastFilterType::Pointer cast = CastFilterType::New();
+  cast->SetInput( image );
+  typedef itk::Testing::ComparisonImageFilter< DoubleImageType, DoubleImageType > DoubleComparisonFilterType;
+  DoubleComparisonFilterType::Pointer doubleComparison = DoubleComparisonFilterType::New();
+  doubleComparison->SetValidInput( cast->GetOutput() );
+  doubleComparison->SetTestInput( doubleReader->GetOutput() );
+  TRY_EXPECT_NO_EXCEPTION( doubleComparison->Update() );
+  TEST_EXPECT_EQUAL( doubleComparison->GetNumberOfPixelsWithDifferences(), 0u );
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,163 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkShiftScaleImageFilter.h"
+#include "itkPipelineMonitorImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+// Read, filter and write a volume larger than a memory limit, with the
+// reader and the writer both streaming, then paste a region in the
+// written file.
+int itkImageFileReaderWriterStreamingTest(int argc, char* argv[])
+{
+  if( argc < 3 )
+    {
+    std::cerr << "Usage: " << argv[0] << " input output" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef short                                      PixelType;
+  typedef itk::Image< PixelType, 3 >                 ImageType;
+  typedef itk::ImageFileReader< ImageType >          ReaderType;
+  typedef itk::ImageFileWriter< ImageType >          WriterType;
+  typedef itk::PipelineMonitorImageFilter< ImageType > MonitorType;
+  typedef itk::ShiftScaleImageFilter< ImageType, ImageType > ShiftScaleType;
+
+  // 64 x 48 x 40 shorts take 245760 bytes, more than six times the memory
+  // allowed for the pieces read
+  const itk::SizeValueType memoryLimit = 40000;
+
+  ImageType::SizeType    size = { { 64, 48, 40 } };
+  ImageType::RegionType  region( size );
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.5;
+  spacing[1] = 0.75;
+  spacing[2] = 2.0;
+  ImageType::PointType origin;
+  origin[0] = -16.0;
+  origin[1] = 8.0;
+  origin[2] = 32.0;
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( region );
+  image->SetSpacing( spacing );
+  image->SetOrigin( origin );
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, region );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType & index = it.GetIndex();
+    it.Set( static_cast< PixelType >( index[0] + 64 * index[1] - 100 * index[2] ) );
+    }
+
+  WriterType::Pointer inputWriter = WriterType::New();
+  inputWriter->SetInput( image );
+  inputWriter->SetFileName( argv[1] );
+  TRY_EXPECT_NO_EXCEPTION( inputWriter->Update() );
+
+  // Stream the input through the filter to the output
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+  reader->UseStreamingOn();
+
+  MonitorType::Pointer monitor = MonitorType::New();
+  monitor->SetInput( reader->GetOutput() );
+
+  ShiftScaleType::Pointer shiftScale = ShiftScaleType::New();
+  shiftScale->SetInput( monitor->GetOutput() );
+  shiftScale->SetShift( 10 );
+  shiftScale->SetScale( 2 );
+
+  const unsigned int numberOfDivisions =
+    static_cast< unsigned int >( ( image->GetBufferedRegionSizeInBytes() + memoryLimit - 1 ) / memoryLimit );
+  TEST_EXPECT_EQUAL( numberOfDivisions, 7u );
+
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( shiftScale->GetOutput() );
+  writer->SetFileName( argv[2] );
+  writer->SetNumberOfStreamDivisions( numberOfDivisions );
+  TRY_EXPECT_NO_EXCEPTION( writer->Update() );
+
+  // Each piece read fits in the memory limit
+  if ( !monitor->VerifyAllInputCanStream( numberOfDivisions ) )
+    {
+    std::cerr << monitor;
+    return EXIT_FAILURE;
+    }
+  const MonitorType::RegionVectorType pieces = monitor->GetUpdatedBufferedRegions();
+  for ( size_t i = 0; i < pieces.size(); ++i )
+    {
+    const itk::SizeValueType pieceSize = pieces[i].GetNumberOfPixels() * sizeof( PixelType );
+    if ( pieceSize > memoryLimit )
+      {
+      std::cerr << "Piece " << i << " takes " << pieceSize << " bytes, more than the "
+                << memoryLimit << " bytes allowed" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Paste some slices of the input in the output, read from the file as
+  // a writer given a whole image writes all of it
+  ImageType::RegionType pasteRegion = region;
+  pasteRegion.SetIndex( 2, 10 );
+  pasteRegion.SetSize( 2, 5 );
+  itk::ImageIORegion ioRegion( 3 );
+  itk::ImageIORegionAdaptor< 3 >::Convert( pasteRegion, ioRegion, region.GetIndex() );
+
+  ReaderType::Pointer pasteReader = ReaderType::New();
+  pasteReader->SetFileName( argv[1] );
+  pasteReader->UseStreamingOn();
+
+  WriterType::Pointer pasteWriter = WriterType::New();
+  pasteWriter->SetInput( pasteReader->GetOutput() );
+  pasteWriter->SetFileName( argv[2] );
+  pasteWriter->SetIORegion( ioRegion );
+  TRY_EXPECT_NO_EXCEPTION( pasteWriter->Update() );
+
+  // Check the whole output
+  ReaderType::Pointer outputReader = ReaderType::New();
+  outputReader->SetFileName( argv[2] );
+  TRY_EXPECT_NO_EXCEPTION( outputReader->Update() );
+  ImageType::ConstPointer output = outputReader->GetOutput();
+
+  TEST_EXPECT_TRUE( output->GetLargestPossibleRegion() == region );
+  TEST_EXPECT_TRUE( output->GetSpacing() == spacing );
+  TEST_EXPECT_TRUE( output->GetOrigin() == origin );
+
+  itk::ImageRegionConstIteratorWithIndex< ImageType > outputIt( output, region );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it, ++outputIt )
+    {
+    PixelType expected = it.Get();
+    if ( !pasteRegion.IsInside( it.GetIndex() ) )
+      {
+      expected = static_cast< PixelType >( 2 * ( expected + 10 ) );
+      }
+    if ( outputIt.Get() != expected )
+      {
+      std::cerr << "Output is " << outputIt.Get() << " instead of " << expected
+                << " at " << it.GetIndex() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
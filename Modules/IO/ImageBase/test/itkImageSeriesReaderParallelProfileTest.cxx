@@ -0,0 +1,125 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageSeriesReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkTimeProbesCollectorBase.h"
+
+#include <cstdlib>
+#include <sstream>
+
+// Compare the time taken to read a series of slices one after the other
+// and with all the default threads. Pass the output directory, the number
+// of slices, e.g. 2000, and the file extension, e.g. png, to profile
+// large series.
+int itkImageSeriesReaderParallelProfileTest( int argc, char *argv[] )
+{
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory [numberOfSlices] [extension] [iterations]" << std::endl;
+    return EXIT_FAILURE;
+    }
+  unsigned int numberOfSlices = 64;
+  if ( argc > 2 )
+    {
+    numberOfSlices = atoi( argv[2] );
+    }
+  std::string extension = "mha";
+  if ( argc > 3 )
+    {
+    extension = argv[3];
+    }
+  unsigned int numberOfIterations = 3;
+  if ( argc > 4 )
+    {
+    numberOfIterations = atoi( argv[4] );
+    }
+
+  typedef unsigned char                       PixelType;
+  typedef itk::Image< PixelType, 2 >          SliceType;
+  typedef itk::Image< PixelType, 3 >          ImageType;
+  typedef itk::ImageFileWriter< SliceType >   WriterType;
+  typedef itk::ImageSeriesReader< ImageType > SeriesReaderType;
+
+  itk::TimeProbesCollectorBase chronometer;
+
+  SliceType::SizeType                  size = { { 512, 512 } };
+  SliceType::RegionType                region( size );
+  SeriesReaderType::FileNamesContainer fileNames;
+  chronometer.Start( "Write" );
+  for ( unsigned int i = 0; i < numberOfSlices; ++i )
+    {
+    SliceType::Pointer slice = SliceType::New();
+    slice->SetRegions( region );
+    slice->Allocate();
+    itk::ImageRegionIteratorWithIndex< SliceType > it( slice, region );
+    for ( ; !it.IsAtEnd(); ++it )
+      {
+      const SliceType::IndexType & index = it.GetIndex();
+      it.Set( static_cast< PixelType >( ( index[0] * 7 + index[1] * 13 + i * 29 ) % 101 ) );
+      }
+
+    std::ostringstream fileName;
+    fileName << argv[1] << "/itkImageSeriesReaderParallelProfileTest" << i << "." << extension;
+    fileNames.push_back( fileName.str() );
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetInput( slice );
+    writer->SetFileName( fileNames.back() );
+    writer->UseCompressionOn();
+    writer->Update();
+    }
+  chronometer.Stop( "Write" );
+
+  SeriesReaderType::Pointer reader = SeriesReaderType::New();
+  reader->SetFileNames( fileNames );
+  for ( unsigned int i = 0; i < numberOfIterations; ++i )
+    {
+    reader->Modified();
+    chronometer.Start( "Read, 1 thread" );
+    reader->Update();
+    chronometer.Stop( "Read, 1 thread" );
+    }
+  ImageType::Pointer reference = reader->GetOutput();
+  reference->DisconnectPipeline();
+
+  reader->UseParallelReadingOn();
+  for ( unsigned int i = 0; i < numberOfIterations; ++i )
+    {
+    reader->Modified();
+    chronometer.Start( "Read, all threads" );
+    reader->Update();
+    chronometer.Stop( "Read, all threads" );
+    }
+
+  chronometer.Report( std::cout );
+
+  itk::ImageRegionConstIterator< ImageType > rit( reference, reference->GetBufferedRegion() );
+  itk::ImageRegionConstIterator< ImageType > it( reader->GetOutput(), reference->GetBufferedRegion() );
+  for ( ; !rit.IsAtEnd(); ++rit, ++it )
+    {
+    if ( rit.Get() != it.Get() )
+      {
+      std::cerr << "Output differs at " << rit.GetIndex() << ": "
+                << it.Get() << " instead of " << rit.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  return EXIT_SUCCESS;
+}
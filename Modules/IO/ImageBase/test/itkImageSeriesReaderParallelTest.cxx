@@ -0,0 +1,144 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageSeriesReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageIOFactory.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+#include <sstream>
+
+namespace
+{
+// Check the slices read, slice i of the output coming from file
+// numberOfSlices - i - 1 when the order is reversed
+template< typename TImage >
+bool CheckSlices(const TImage *image, unsigned int numberOfSlices, bool reverseOrder)
+{
+  itk::ImageRegionConstIteratorWithIndex< TImage > it( image, image->GetBufferedRegion() );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    const typename TImage::IndexType & index = it.GetIndex();
+    const unsigned int file = reverseOrder ? numberOfSlices - index[2] - 1 : index[2];
+    const short        expected = static_cast< short >( index[0] + 10 * index[1] + 1000 * file );
+    if ( it.Get() != expected )
+      {
+      std::cerr << "Pixel " << index << " is " << it.Get() << " instead of " << expected << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+// Read a series of slices with several threads, and check that the output
+// and the dictionaries are the ones read by a single thread.
+int itkImageSeriesReaderParallelTest(int argc, char* argv[])
+{
+  if( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef short                               PixelType;
+  typedef itk::Image< PixelType, 2 >          SliceType;
+  typedef itk::Image< PixelType, 3 >          ImageType;
+  typedef itk::ImageFileWriter< SliceType >   WriterType;
+  typedef itk::ImageSeriesReader< ImageType > SeriesReaderType;
+
+  const unsigned int                   numberOfSlices = 23;
+  SliceType::SizeType                  size = { { 32, 24 } };
+  SliceType::RegionType                region( size );
+  SeriesReaderType::FileNamesContainer fileNames;
+  for ( unsigned int i = 0; i < numberOfSlices; ++i )
+    {
+    SliceType::Pointer slice = SliceType::New();
+    slice->SetRegions( region );
+    slice->Allocate();
+    itk::ImageRegionIteratorWithIndex< SliceType > it( slice, region );
+    for ( ; !it.IsAtEnd(); ++it )
+      {
+      const SliceType::IndexType & index = it.GetIndex();
+      it.Set( static_cast< PixelType >( index[0] + 10 * index[1] + 1000 * i ) );
+      }
+
+    std::ostringstream fileName;
+    fileName << argv[1] << "/itkImageSeriesReaderParallelTest" << i << ".mha";
+    fileNames.push_back( fileName.str() );
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetInput( slice );
+    writer->SetFileName( fileNames.back() );
+    TRY_EXPECT_NO_EXCEPTION( writer->Update() );
+    }
+
+  SeriesReaderType::Pointer reader = SeriesReaderType::New();
+  EXERCISE_BASIC_OBJECT_METHODS( reader, SeriesReaderType );
+  TEST_EXPECT_TRUE( !reader->GetUseParallelReading() );
+  reader->SetFileNames( fileNames );
+  reader->UseParallelReadingOn();
+  reader->SetNumberOfThreads( 4 );
+  TRY_EXPECT_NO_EXCEPTION( reader->Update() );
+  TEST_EXPECT_EQUAL( reader->GetOutput()->GetBufferedRegion().GetSize( 2 ), numberOfSlices );
+  TEST_EXPECT_TRUE( CheckSlices( reader->GetOutput(), numberOfSlices, false ) );
+
+  // The dictionaries are in the order of the slices
+  const SeriesReaderType::DictionaryArrayType *dictionaries = reader->GetMetaDataDictionaryArray();
+  TEST_EXPECT_EQUAL( dictionaries->size(), numberOfSlices );
+
+  // In reverse order, with a given ImageIO
+  reader->ReverseOrderOn();
+  reader->SetImageIO( itk::ImageIOFactory::CreateImageIO( fileNames[0].c_str(), itk::ImageIOFactory::ReadMode ) );
+  TRY_EXPECT_NO_EXCEPTION( reader->Update() );
+  TEST_EXPECT_TRUE( CheckSlices( reader->GetOutput(), numberOfSlices, true ) );
+
+  // Only the requested slices are read
+  ImageType::IndexType      index = { { 4, 3, 5 } };
+  ImageType::SizeType       requestedSize = { { 20, 15, 11 } };
+  ImageType::RegionType     requestedRegion( index, requestedSize );
+  SeriesReaderType::Pointer streamingReader = SeriesReaderType::New();
+  streamingReader->SetFileNames( fileNames );
+  streamingReader->UseParallelReadingOn();
+  streamingReader->MetaDataDictionaryArrayUpdateOff();
+  streamingReader->GetOutput()->SetRequestedRegion( requestedRegion );
+  TRY_EXPECT_NO_EXCEPTION( streamingReader->GetOutput()->Update() );
+  TEST_EXPECT_TRUE( streamingReader->GetOutput()->GetBufferedRegion() == requestedRegion );
+  TEST_EXPECT_TRUE( CheckSlices( streamingReader->GetOutput(), numberOfSlices, false ) );
+
+  // A missing file fails the whole read, with the exception type of the
+  // serial reading
+  fileNames[numberOfSlices / 2] += ".missing";
+  reader->SetFileNames( fileNames );
+  reader->ReverseOrderOff();
+  reader->SetImageIO( ITK_NULLPTR );
+  reader->SetNumberOfThreads( 3 );
+  bool caught = false;
+  try
+    {
+    reader->Update();
+    }
+  catch ( itk::ImageFileReaderException & e )
+    {
+    std::cout << e << std::endl;
+    caught = true;
+    }
+  TEST_EXPECT_TRUE( caught );
+
+  return EXIT_SUCCESS;
+}
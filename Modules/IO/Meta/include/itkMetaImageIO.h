@@ -118,11 +118,12 @@ public:
                            const ImageIORegion & largestPossibleRegion) ITK_OVERRIDE;
 
   /** Determine if the ImageIO can stream reading from this
-   *  file. Only time cannot stream read/write is if compression is used.
+   *  file. Only time cannot stream read/write is if compression is used,
+   *  unless the data is compressed in blocks.
    *  CanRead must be called prior to this function. */
   virtual bool CanStreamRead() ITK_OVERRIDE
   {
-    if ( m_MetaImage.CompressedData() )
+    if ( m_MetaImage.CompressedData() && m_FileCompressionBlockSize == 0 )
       {
       return false;
       }
@@ -143,12 +144,28 @@ public:
     return true;
   }
 
+  /** Uncompressed binary data in the native byte order, in the header
+   * file or in a single data file, can be mapped. */
+  virtual bool CanMapIORegion(std::string & fileName, SizeType & offset) ITK_OVERRIDE;
+
   /** Determing the subsampling factor in case
    *  we want a coarse version of the image/
    * \warning this is only used when streaming is on. */
   itkSetMacro(SubSamplingFactor, unsigned int);
   itkGetConstMacro(SubSamplingFactor, unsigned int);
 
+  /** Set/Get the number of uncompressed bytes in the blocks compressed
+   * data is split in. When it is not 0 and compression is used, the
+   * blocks are deflated independently and in parallel, and an index of
+   * the blocks follows the data. Reading such a file decompresses the
+   * blocks in parallel and supports streaming: only the blocks holding
+   * the requested region are decompressed. The blocks form a single
+   * zlib stream, so other MetaImage readers read the file as usual.
+   * Blocks are at most 1 GiB. The default, 0, compresses the data as a
+   * single stream. */
+  itkSetMacro(CompressionBlockSize, SizeValueType);
+  itkGetConstMacro(CompressionBlockSize, SizeValueType);
+
 protected:
   MetaImageIO();
   ~MetaImageIO();
@@ -156,12 +173,48 @@ protected:
 
 private:
 
-  MetaImage m_MetaImage;
+  /** MetaImage writing the header of data MetaImageIO compresses in
+   * blocks, which it does not compress itself. */
+  class BlockCompressedMetaImage:public MetaImage
+  {
+  public:
+    BlockCompressedMetaImage();
+
+    /** When the block size is not 0, the header written describes
+     * compressed data of the given size made of blocks of this size,
+     * whatever CompressedData() is. */
+    void SetBlockCompression(SizeValueType blockSize, SizeValueType compressedDataSize);
+
+  protected:
+    virtual void M_SetupWriteFields(void) ITK_OVERRIDE;
+
+  private:
+    SizeValueType m_BlockSize;
+    SizeValueType m_BlockCompressedDataSize;
+  };
+
+  /** Find the file holding the element data, and the position of the
+   * data in it. dataSize is the size of the data in the file. Returns
+   * false when the data is split over several files. */
+  bool GetElementDataPosition(std::string & fileName, SizeType & position, SizeType dataSize);
+
+  /** Compress the data in blocks and write it with its header. Returns
+   * false when the data cannot be written in blocks. */
+  bool WriteCompressedBlocks(const void *buffer);
+
+  /** Decompress the blocks of the data holding the region. Returns false
+   * when the data cannot be read in blocks. */
+  bool ReadCompressedBlocks(void *buffer, const ImageIORegion & region);
+
+  BlockCompressedMetaImage m_MetaImage;
 
   MetaImageIO(const Self &);    //purposely not implemented
   void operator=(const Self &); //purposely not implemented
 
   unsigned int m_SubSamplingFactor;
+
+  SizeValueType m_CompressionBlockSize;
+  SizeValueType m_FileCompressionBlockSize;
 };
 } // end namespace itk
 
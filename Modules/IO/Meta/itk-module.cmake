@@ -8,6 +8,7 @@ itk_module(ITKIOMeta
   DEPENDS
     ITKMetaIO
     ITKIOImageBase
+    ITKZLIB
   TEST_DEPENDS
     ITKTestKernel
     ITKSmoothing
@@ -20,14 +20,247 @@
 #include "itkSpatialOrientationAdapter.h"
 #include "itkMetaDataObject.h"
 #include "itkIOCommon.h"
+#include "itkMultiThreader.h"
 #include "itksys/SystemTools.hxx"
+#include "itk_zlib.h"
+#include <algorithm>
 
 namespace itk
 {
+namespace
+{
+// Header field holding the size of the blocks of block compressed data
+const char *const CompressedDataBlockSizeField = "CompressedDataBlockSize";
+
+// Blocks must fit in the 32 bit sizes of zlib
+const SizeValueType MaximumCompressionBlockSize = 1UL << 30;
+
+// Data compressed in blocks is a zlib stream made of raw deflate streams
+// ending on a byte boundary, one for each block, followed by the sizes of
+// the compressed blocks and their number, as 64 bit little endian
+// integers.
+const unsigned int ZlibHeaderSize = 2;
+const unsigned int ZlibTrailerSize = 4;
+const unsigned int BlockIndexEntrySize = 8;
+
+void EncodeBlockIndexEntry(uint64_t value, unsigned char *bytes)
+{
+  for ( unsigned int i = 0; i < BlockIndexEntrySize; ++i )
+    {
+    bytes[i] = static_cast< unsigned char >( ( value >> ( 8 * i ) ) & 0xFF );
+    }
+}
+
+uint64_t DecodeBlockIndexEntry(const unsigned char *bytes)
+{
+  uint64_t value = 0;
+  for ( unsigned int i = 0; i < BlockIndexEntrySize; ++i )
+    {
+    value |= static_cast< uint64_t >( bytes[i] ) << ( 8 * i );
+    }
+  return value;
+}
+
+struct CompressBlocksStruct
+{
+  const unsigned char *                         Data;
+  SizeValueType                                 DataSize;
+  SizeValueType                                 BlockSize;
+  std::vector< std::vector< unsigned char > > * Blocks;
+  std::vector< uLong > *                        Checksums;
+};
+
+// Each thread deflates every NumberOfThreads-th block. A block left empty
+// could not be compressed.
+ITK_THREAD_RETURN_TYPE CompressBlocksThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  CompressBlocksStruct *           str = static_cast< CompressBlocksStruct * >( info->UserData );
+
+  z_stream stream;
+  stream.zalloc = Z_NULL;
+  stream.zfree = Z_NULL;
+  stream.opaque = Z_NULL;
+  if ( deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK )
+    {
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
+  const SizeValueType numberOfBlocks = static_cast< SizeValueType >( str->Blocks->size() );
+  for ( SizeValueType k = info->ThreadID; k < numberOfBlocks; k += info->NumberOfThreads )
+    {
+    const SizeValueType        begin = k * str->BlockSize;
+    const SizeValueType        size = std::min(str->BlockSize, str->DataSize - begin);
+    const bool                 last = ( k + 1 == numberOfBlocks );
+    std::vector< unsigned char > & block = ( *str->Blocks )[k];
+
+    // The last block ends the stream, the others end on a byte boundary
+    // for the next block to follow them
+    const int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+    block.resize( deflateBound( &stream, static_cast< uLong >( size ) ) + 16 );
+    stream.next_in = const_cast< Bytef * >( str->Data + begin );
+    stream.avail_in = static_cast< uInt >( size );
+    stream.next_out = &block[0];
+    stream.avail_out = static_cast< uInt >( block.size() );
+    bool compressed = false;
+    for (;; )
+      {
+      const int result = deflate(&stream, flush);
+      if ( result == Z_STREAM_ERROR )
+        {
+        break;
+        }
+      if ( last ? result == Z_STREAM_END : stream.avail_out > 0 )
+        {
+        compressed = true;
+        break;
+        }
+      const SizeValueType written = static_cast< SizeValueType >( block.size() ) - stream.avail_out;
+      block.resize( 2 * block.size() );
+      stream.next_out = &block[written];
+      stream.avail_out = static_cast< uInt >( block.size() - written );
+      }
+    if ( compressed )
+      {
+      block.resize(stream.total_out);
+      ( *str->Checksums )[k] = adler32(adler32(0L, Z_NULL, 0), str->Data + begin, static_cast< uInt >( size ));
+      }
+    else
+      {
+      block.clear();
+      }
+    deflateReset(&stream);
+    }
+
+  deflateEnd(&stream);
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+struct DecompressBlocksStruct
+{
+  std::string                                  FileName;
+  SizeValueType                                DataSize;
+  SizeValueType                                BlockSize;
+  const std::vector< ImageIOBase::SizeType > * BlockPositions;
+  const std::vector< SizeValueType > *         Blocks;
+  const std::vector< SizeValueType > *         LineOffsets;
+  SizeValueType                                LineSize;
+  char *                                       Buffer;
+  std::vector< char > *                        Decompressed;
+};
+
+// Each thread inflates every NumberOfThreads-th block of the list, and
+// copies the parts of the lines of the region it holds to the buffer.
+ITK_THREAD_RETURN_TYPE DecompressBlocksThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  DecompressBlocksStruct *         str = static_cast< DecompressBlocksStruct * >( info->UserData );
+
+  std::ifstream file(str->FileName.c_str(), std::ios::in | std::ios::binary);
+  z_stream      stream;
+  stream.zalloc = Z_NULL;
+  stream.zfree = Z_NULL;
+  stream.opaque = Z_NULL;
+  stream.next_in = Z_NULL;
+  stream.avail_in = 0;
+  if ( !file.is_open() || inflateInit2(&stream, -MAX_WBITS) != Z_OK )
+    {
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
+  const std::vector< SizeValueType > & lineOffsets = *str->LineOffsets;
+  std::vector< unsigned char >         compressed;
+  std::vector< char >                  block( str->BlockSize );
+  for ( SizeValueType b = info->ThreadID; b < str->Blocks->size(); b += info->NumberOfThreads )
+    {
+    const SizeValueType k = ( *str->Blocks )[b];
+    const SizeValueType begin = k * str->BlockSize;
+    const SizeValueType size = std::min(str->BlockSize, str->DataSize - begin);
+
+    compressed.resize( static_cast< size_t >( ( *str->BlockPositions )[k + 1] - ( *str->BlockPositions )[k] ) );
+    file.seekg( ( *str->BlockPositions )[k] );
+    file.read( reinterpret_cast< char * >( &compressed[0] ), compressed.size() );
+    if ( !file )
+      {
+      break;
+      }
+    inflateReset(&stream);
+    stream.next_in = &compressed[0];
+    stream.avail_in = static_cast< uInt >( compressed.size() );
+    stream.next_out = reinterpret_cast< Bytef * >( &block[0] );
+    stream.avail_out = static_cast< uInt >( size );
+    const int result = inflate(&stream, Z_SYNC_FLUSH);
+    if ( ( result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR )
+         || stream.total_out != size )
+      {
+      break;
+      }
+
+    // Lines are in increasing order of offset
+    SizeValueType line = static_cast< SizeValueType >(
+      std::upper_bound(lineOffsets.begin(), lineOffsets.end(), begin) - lineOffsets.begin() );
+    if ( line > 0 )
+      {
+      --line;
+      }
+    for (; line < lineOffsets.size() && lineOffsets[line] < begin + size; ++line )
+      {
+      const SizeValueType first = std::max(lineOffsets[line], begin);
+      const SizeValueType end = std::min(lineOffsets[line] + str->LineSize, begin + size);
+      if ( first < end )
+        {
+        std::copy( &block[first - begin], &block[first - begin] + ( end - first ),
+                   str->Buffer + line * str->LineSize + ( first - lineOffsets[line] ) );
+        }
+      }
+    ( *str->Decompressed )[b] = 1;
+    }
+
+  inflateEnd(&stream);
+  return ITK_THREAD_RETURN_VALUE;
+}
+}
+
+MetaImageIO::BlockCompressedMetaImage::BlockCompressedMetaImage():
+  m_BlockSize(0),
+  m_BlockCompressedDataSize(0)
+{}
+
+void MetaImageIO::BlockCompressedMetaImage::SetBlockCompression(SizeValueType blockSize,
+                                                                SizeValueType compressedDataSize)
+{
+  m_BlockSize = blockSize;
+  m_BlockCompressedDataSize = compressedDataSize;
+}
+
+void MetaImageIO::BlockCompressedMetaImage::M_SetupWriteFields(void)
+{
+  if ( m_BlockSize == 0 )
+    {
+    MetaImage::M_SetupWriteFields();
+    return;
+    }
+
+  // Describe the compressed data, which MetaImage does not write
+  const bool compressedData = m_CompressedData;
+  m_CompressedData = true;
+  m_CompressedDataSize = static_cast< METAIO_STL::streamoff >( m_BlockCompressedDataSize );
+  MetaImage::M_SetupWriteFields();
+  m_CompressedData = compressedData;
+  m_CompressedDataSize = 0;
+
+  // ElementDataFile must remain the last field
+  MET_FieldRecordType *field = new MET_FieldRecordType;
+  MET_InitWriteField( field, CompressedDataBlockSizeField, MET_UINT, static_cast< double >( m_BlockSize ) );
+  m_Fields.insert(m_Fields.end() - 1, field);
+}
+
 MetaImageIO::MetaImageIO()
 {
   m_FileType = Binary;
   m_SubSamplingFactor = 1;
+  m_CompressionBlockSize = 0;
+  m_FileCompressionBlockSize = 0;
   if ( MET_SystemByteOrderMSB() )
     {
     m_ByteOrder = BigEndian;
@@ -52,6 +285,7 @@ void MetaImageIO::PrintSelf(std::ostream & os, Indent indent) const
   Superclass::PrintSelf(os, indent);
   m_MetaImage.PrintInfo();
   os << indent << "SubSamplingFactor: " << m_SubSamplingFactor << "\n";
+  os << indent << "CompressionBlockSize: " << m_CompressionBlockSize << "\n";
 }
 
 void MetaImageIO::SetDataFileName(const char *filename)
@@ -391,11 +625,22 @@ void MetaImageIO::ReadImageInformation()
   //
   // save the metadatadictionary in the MetaImage header.
   // NOTE: The MetaIO library only supports typeless strings as metadata
+  m_FileCompressionBlockSize = 0;
   int dictFields = m_MetaImage.GetNumberOfAdditionalReadFields();
   for ( int f = 0; f < dictFields; f++ )
     {
     std::string key( m_MetaImage.GetAdditionalReadFieldName(f) );
     std::string value ( m_MetaImage.GetAdditionalReadFieldValue(f) );
+    if ( key == CompressedDataBlockSizeField )
+      {
+      // The layout of the data is not meta data
+      if ( m_MetaImage.CompressedData() && m_MetaImage.BinaryData() )
+        {
+        std::istringstream blockSize(value);
+        blockSize >> m_FileCompressionBlockSize;
+        }
+      continue;
+      }
     EncapsulateMetaData< std::string >( thisMetaDict,key,value );
     }
 
@@ -434,6 +679,12 @@ void MetaImageIO::Read(void *buffer)
     largestRegion.SetSize( i, this->GetDimensions(i) );
     }
 
+  if ( m_FileCompressionBlockSize > 0
+       && this->ReadCompressedBlocks(buffer, largestRegion != m_IORegion ? m_IORegion : largestRegion) )
+    {
+    return;
+    }
+
   if ( largestRegion != m_IORegion )
     {
     int *indexMin = new int[nDims];
@@ -487,6 +738,361 @@ void MetaImageIO::Read(void *buffer)
     }
 }
 
+bool MetaImageIO::CanMapIORegion(std::string & fileName, SizeType & offset)
+{
+  int elementSize = 0;
+  MET_SizeOfType(m_MetaImage.ElementType(), &elementSize);
+
+  SizeType regionOffset;
+  SizeType dataPosition;
+  if ( !m_MetaImage.BinaryData()
+       || m_MetaImage.CompressedData()
+       || m_SubSamplingFactor != 1
+       || static_cast< unsigned int >( elementSize ) != this->GetComponentSize()
+       || ( elementSize > 1 && m_MetaImage.BinaryDataByteOrderMSB() != MET_SystemByteOrderMSB() )
+       || !this->GetContiguousIORegionOffset(regionOffset)
+       || !this->GetElementDataPosition( fileName, dataPosition, this->GetImageSizeInBytes() ) )
+    {
+    return false;
+    }
+
+  offset = dataPosition + regionOffset;
+  return true;
+}
+
+bool MetaImageIO::GetElementDataPosition(std::string & fileName, SizeType & position, SizeType dataSize)
+{
+  // Data split over several files has no single position
+  const std::string dataFileName = m_MetaImage.ElementDataFileName();
+  const bool        local = itksys::SystemTools::UpperCase(dataFileName) == "LOCAL";
+  if ( !local && ( dataFileName.compare(0, 4, "LIST") == 0
+                   || dataFileName.find('%') != std::string::npos ) )
+    {
+    return false;
+    }
+  if ( local )
+    {
+    fileName = m_FileName;
+    }
+  else
+    {
+    fileName = dataFileName;
+    const std::string path = itksys::SystemTools::GetFilenamePath(m_FileName);
+    if ( !path.empty() && !itksys::SystemTools::FileIsFullPath( dataFileName.c_str() ) )
+      {
+      fileName = path + "/" + dataFileName;
+      }
+    }
+
+  // Find where the data starts as MetaImage does
+  position = 0;
+  if ( m_MetaImage.HeaderSize() > 0 )
+    {
+    position = m_MetaImage.HeaderSize();
+    }
+  else if ( m_MetaImage.HeaderSize() == -1 )
+    {
+    const SizeType fileLength = static_cast< SizeType >( itksys::SystemTools::FileLength( fileName.c_str() ) );
+    if ( fileLength < dataSize )
+      {
+      return false;
+      }
+    position = fileLength - dataSize;
+    }
+  else if ( local )
+    {
+    // The data follows the header
+    std::ifstream headerStream;
+    this->OpenFileForReading(headerStream, m_FileName);
+    MetaImage header;
+    if ( !header.ReadStream(0, &headerStream, false) )
+      {
+      return false;
+      }
+    const std::streampos headerEnd = headerStream.tellg();
+    if ( headerEnd < 0 )
+      {
+      return false;
+      }
+    position = static_cast< SizeType >( headerEnd );
+    }
+  return true;
+}
+
+bool MetaImageIO::ReadCompressedBlocks(void *buffer, const ImageIORegion & region)
+{
+  // The data position of headers sized from the end of the file is only
+  // known from the size of the compressed data, which may not be exact
+  int elementSize = 0;
+  MET_SizeOfType(m_MetaImage.ElementType(), &elementSize);
+  const SizeValueType pixelSize = static_cast< SizeValueType >( elementSize )
+                                  * m_MetaImage.ElementNumberOfChannels();
+  std::string         fileName;
+  SizeType            dataPosition;
+  if ( m_SubSamplingFactor != 1
+       || m_MetaImage.HeaderSize() == -1
+       || pixelSize == 0
+       || !this->GetElementDataPosition(fileName, dataPosition, 0) )
+    {
+    return false;
+    }
+
+  const unsigned int nDims = this->GetNumberOfDimensions();
+  SizeValueType      dataSize = pixelSize;
+  for ( unsigned int i = 0; i < nDims; ++i )
+    {
+    dataSize *= this->GetDimensions(i);
+    }
+  const SizeValueType blockSize = m_FileCompressionBlockSize;
+  const SizeValueType numberOfBlocks = std::max( ( dataSize + blockSize - 1 ) / blockSize,
+                                                 static_cast< SizeValueType >( 1 ) );
+
+  // Read the index of the blocks at the end of the file
+  std::ifstream file;
+  this->OpenFileForReading(file, fileName);
+  file.seekg(0, std::ios::end);
+  const SizeType             fileLength = static_cast< SizeType >( file.tellg() );
+  unsigned char              entry[BlockIndexEntrySize];
+  std::vector< unsigned char > index;
+  const SizeType             indexSize = BlockIndexEntrySize * ( numberOfBlocks + 1 );
+  if ( fileLength >= indexSize )
+    {
+    file.seekg(fileLength - BlockIndexEntrySize);
+    file.read(reinterpret_cast< char * >( entry ), BlockIndexEntrySize);
+    }
+  if ( fileLength < indexSize || !file || DecodeBlockIndexEntry(entry) != numberOfBlocks )
+    {
+    itkExceptionMacro( "Invalid index of compressed blocks in " << fileName );
+    }
+  index.resize(indexSize - BlockIndexEntrySize);
+  file.seekg(fileLength - indexSize);
+  file.read(reinterpret_cast< char * >( &index[0] ), index.size());
+
+  std::vector< SizeType > blockPositions(numberOfBlocks + 1);
+  blockPositions[0] = dataPosition + ZlibHeaderSize;
+  for ( SizeValueType k = 0; k < numberOfBlocks; ++k )
+    {
+    blockPositions[k + 1] = blockPositions[k] + DecodeBlockIndexEntry(&index[k * BlockIndexEntrySize]);
+    }
+  if ( !file || blockPositions[numberOfBlocks] + ZlibTrailerSize + indexSize != fileLength )
+    {
+    itkExceptionMacro( "Invalid index of compressed blocks in " << fileName );
+    }
+  file.close();
+  if ( region.GetNumberOfPixels() == 0 )
+    {
+    return true;
+    }
+
+  // Offsets of the lines of the region in the uncompressed data, and the
+  // blocks holding them
+  SizeValueType numberOfLines = 1;
+  for ( unsigned int i = 1; i < region.GetImageDimension(); ++i )
+    {
+    numberOfLines *= region.GetSize(i);
+    }
+  const SizeValueType lineSize = pixelSize * ( region.GetImageDimension() > 0 ? region.GetSize(0) : 1 );
+  std::vector< SizeValueType > lineOffsets(numberOfLines);
+  std::vector< SizeValueType > position(nDims, 0);
+  std::vector< char >          touched(numberOfBlocks, 0);
+  for ( SizeValueType line = 0; line < numberOfLines; ++line )
+    {
+    SizeValueType offset = 0;
+    SizeValueType stride = pixelSize;
+    for ( unsigned int i = 0; i < nDims; ++i )
+      {
+      const SizeValueType regionIndex = i < region.GetImageDimension() ? region.GetIndex(i) : 0;
+      offset += ( regionIndex + position[i] ) * stride;
+      stride *= this->GetDimensions(i);
+      }
+    lineOffsets[line] = offset;
+    for ( SizeValueType k = offset / blockSize; k <= ( offset + lineSize - 1 ) / blockSize; ++k )
+      {
+      touched[k] = 1;
+      }
+    for ( unsigned int i = 1; i < region.GetImageDimension(); ++i )
+      {
+      if ( ++position[i] < region.GetSize(i) )
+        {
+        break;
+        }
+      position[i] = 0;
+      }
+    }
+  std::vector< SizeValueType > blocks;
+  for ( SizeValueType k = 0; k < numberOfBlocks; ++k )
+    {
+    if ( touched[k] )
+      {
+      blocks.push_back(k);
+      }
+    }
+
+  std::vector< char >    decompressed(blocks.size(), 0);
+  DecompressBlocksStruct str;
+  str.FileName = fileName;
+  str.DataSize = dataSize;
+  str.BlockSize = blockSize;
+  str.BlockPositions = &blockPositions;
+  str.Blocks = &blocks;
+  str.LineOffsets = &lineOffsets;
+  str.LineSize = lineSize;
+  str.Buffer = static_cast< char * >( buffer );
+  str.Decompressed = &decompressed;
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads( static_cast< ThreadIdType >(
+    std::min( static_cast< SizeValueType >( threader->GetNumberOfThreads() ),
+              std::max( static_cast< SizeValueType >( blocks.size() ), static_cast< SizeValueType >( 1 ) ) ) ) );
+  threader->SetSingleMethod(DecompressBlocksThreaderCallback, &str);
+  threader->SingleMethodExecute();
+
+  if ( std::find(decompressed.begin(), decompressed.end(), 0) != decompressed.end() )
+    {
+    itkExceptionMacro( "Compressed blocks cannot be read from " << fileName );
+    }
+
+  m_MetaImage.ElementData(buffer, false);
+  m_MetaImage.ElementByteOrderFix( region.GetNumberOfPixels() );
+  return true;
+}
+
+bool MetaImageIO::WriteCompressedBlocks(const void *buffer)
+{
+  // The data is written in a single file, the header file unless another
+  // data file is given
+  std::string dataFileName = m_MetaImage.ElementDataFileName();
+  std::string dataName;
+  if ( dataFileName.empty() )
+    {
+    if ( itksys::SystemTools::GetFilenameLastExtension(m_FileName) == ".mha" )
+      {
+      dataName = "LOCAL";
+      }
+    else
+      {
+      // next to the header, which names it without its directory
+      dataName = itksys::SystemTools::GetFilenameWithoutLastExtension(m_FileName) + ".zraw";
+      }
+    dataFileName = dataName;
+    }
+  const bool local = itksys::SystemTools::UpperCase(dataFileName) == "LOCAL";
+  if ( !local && ( dataFileName.compare(0, 4, "LIST") == 0
+                   || dataFileName.find('%') != std::string::npos ) )
+    {
+    return false;
+    }
+
+  const unsigned char *data = static_cast< const unsigned char * >( buffer );
+  const SizeValueType  dataSize = static_cast< SizeValueType >( this->GetImageSizeInBytes() );
+  const SizeValueType  blockSize = std::min(m_CompressionBlockSize, MaximumCompressionBlockSize);
+  const SizeValueType  numberOfBlocks = std::max( ( dataSize + blockSize - 1 ) / blockSize,
+                                                  static_cast< SizeValueType >( 1 ) );
+
+  std::vector< std::vector< unsigned char > > blocks(numberOfBlocks);
+  std::vector< uLong >                        checksums(numberOfBlocks);
+  CompressBlocksStruct                        str;
+  str.Data = data;
+  str.DataSize = dataSize;
+  str.BlockSize = blockSize;
+  str.Blocks = &blocks;
+  str.Checksums = &checksums;
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads( static_cast< ThreadIdType >(
+    std::min( static_cast< SizeValueType >( threader->GetNumberOfThreads() ), numberOfBlocks ) ) );
+  threader->SetSingleMethod(CompressBlocksThreaderCallback, &str);
+  threader->SingleMethodExecute();
+
+  SizeValueType compressedDataSize = ZlibHeaderSize + ZlibTrailerSize;
+  uLong         checksum = adler32(0L, Z_NULL, 0);
+  for ( SizeValueType k = 0; k < numberOfBlocks; ++k )
+    {
+    if ( blocks[k].empty() )
+      {
+      itkExceptionMacro( "Data cannot be compressed for " << m_FileName );
+      }
+    compressedDataSize += blocks[k].size();
+    const SizeValueType begin = k * blockSize;
+    checksum = adler32_combine( checksum, checksums[k],
+                                static_cast< z_off_t >( std::min(blockSize, dataSize - begin) ) );
+    }
+
+  // Write the header, then the data after it or in the data file
+  m_MetaImage.CompressedData(false);
+  m_MetaImage.SetBlockCompression(blockSize, compressedDataSize);
+  const bool headerWritten =
+    m_MetaImage.Write( m_FileName.c_str(), dataName.empty() ? ITK_NULLPTR : dataName.c_str(), false );
+  m_MetaImage.SetBlockCompression(0, 0);
+  m_MetaImage.CompressedData(true);
+  if ( !headerWritten )
+    {
+    itkExceptionMacro( "File cannot be written: "
+                       << this->GetFileName()
+                       << std::endl
+                       << "Reason: "
+                       << itksys::SystemTools::GetLastSystemError() );
+    }
+
+  std::string fileName;
+  if ( local )
+    {
+    fileName = m_MetaImage.FileName();
+    }
+  else
+    {
+    fileName = dataFileName;
+    const std::string path = itksys::SystemTools::GetFilenamePath(m_FileName);
+    if ( !path.empty() && !itksys::SystemTools::FileIsFullPath( dataFileName.c_str() ) )
+      {
+      fileName = path + "/" + dataFileName;
+      }
+    }
+  std::ofstream file;
+  file.open( fileName.c_str(), local ? std::ios::out | std::ios::binary | std::ios::app
+                                     : std::ios::out | std::ios::binary | std::ios::trunc );
+  if ( !file.is_open() )
+    {
+    itkExceptionMacro( "File cannot be written: " << fileName
+                       << std::endl
+                       << "Reason: "
+                       << itksys::SystemTools::GetLastSystemError() );
+    }
+
+  // zlib header of the default compression level
+  const unsigned char header[ZlibHeaderSize] = { 0x78, 0x9C };
+  file.write(reinterpret_cast< const char * >( header ), ZlibHeaderSize);
+  for ( SizeValueType k = 0; k < numberOfBlocks; ++k )
+    {
+    file.write(reinterpret_cast< const char * >( &blocks[k][0] ), blocks[k].size());
+    }
+  const unsigned char trailer[ZlibTrailerSize] = {
+    static_cast< unsigned char >( ( checksum >> 24 ) & 0xFF ),
+    static_cast< unsigned char >( ( checksum >> 16 ) & 0xFF ),
+    static_cast< unsigned char >( ( checksum >> 8 ) & 0xFF ),
+    static_cast< unsigned char >( checksum & 0xFF )
+    };
+  file.write(reinterpret_cast< const char * >( trailer ), ZlibTrailerSize);
+
+  unsigned char entry[BlockIndexEntrySize];
+  for ( SizeValueType k = 0; k < numberOfBlocks; ++k )
+    {
+    EncodeBlockIndexEntry(blocks[k].size(), entry);
+    file.write(reinterpret_cast< const char * >( entry ), BlockIndexEntrySize);
+    }
+  EncodeBlockIndexEntry(numberOfBlocks, entry);
+  file.write(reinterpret_cast< const char * >( entry ), BlockIndexEntrySize);
+
+  if ( !file )
+    {
+    itkExceptionMacro( "File cannot be written: " << fileName
+                       << std::endl
+                       << "Reason: "
+                       << itksys::SystemTools::GetLastSystemError() );
+    }
+  return true;
+}
+
 MetaImage * MetaImageIO::GetMetaImagePointer(void)
 {
   return &m_MetaImage;
@@ -1076,6 +1682,11 @@ MetaImageIO
     delete[] indexMin;
     delete[] indexMax;
     }
+  else if ( m_UseCompression && binaryData && m_CompressionBlockSize > 0
+            && this->WriteCompressedBlocks(buffer) )
+    {
+    // The data was compressed in blocks
+    }
   else
     {
     if ( !m_MetaImage.Write( m_FileName.c_str() ) )
@@ -0,0 +1,168 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMetaImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkStreamingImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkTestingComparisonImageFilter.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+
+// Write compressed blocks, and read them back whole, in streamed pieces
+// and as a single zlib stream, and write them to a relative path.
+int itkMetaImageIOCompressionBlockTest(int argc, char* argv[])
+{
+  if( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " image" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef short                             PixelType;
+  typedef itk::Image< PixelType, 3 >        ImageType;
+  typedef itk::ImageFileReader< ImageType > ReaderType;
+  typedef itk::ImageFileWriter< ImageType > WriterType;
+  typedef itk::Testing::ComparisonImageFilter< ImageType, ImageType > ComparisonFilterType;
+
+  // 64 x 48 x 20 shorts take 122880 bytes, which make 13 blocks
+  ImageType::SizeType   size = { { 64, 48, 20 } };
+  ImageType::RegionType region( size );
+  ImageType::Pointer    image = ImageType::New();
+  image->SetRegions( region );
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, region );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType & index = it.GetIndex();
+    it.Set( static_cast< PixelType >( ( index[0] * index[1] ) % 17 - 100 * index[2] ) );
+    }
+
+  itk::MetaImageIO::Pointer io = itk::MetaImageIO::New();
+  TEST_EXPECT_EQUAL( io->GetCompressionBlockSize(), 0u );
+  io->SetCompressionBlockSize( 10000 );
+
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( image );
+  writer->SetFileName( argv[1] );
+  writer->SetImageIO( io );
+  writer->UseCompressionOn();
+  TRY_EXPECT_NO_EXCEPTION( writer->Update() );
+  std::cout << io;
+
+  // The block size does not appear in the meta data, and streaming is
+  // supported
+  itk::MetaImageIO::Pointer readerIO = itk::MetaImageIO::New();
+  readerIO->SetFileName( argv[1] );
+  TRY_EXPECT_NO_EXCEPTION( readerIO->ReadImageInformation() );
+  TEST_EXPECT_TRUE( !readerIO->GetMetaDataDictionary().HasKey( "CompressedDataBlockSize" ) );
+  TEST_EXPECT_TRUE( readerIO->CanStreamRead() );
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( argv[1] );
+  TRY_EXPECT_NO_EXCEPTION( reader->Update() );
+  ComparisonFilterType::Pointer comparison = ComparisonFilterType::New();
+  comparison->SetValidInput( image );
+  comparison->SetTestInput( reader->GetOutput() );
+  TRY_EXPECT_NO_EXCEPTION( comparison->Update() );
+  TEST_EXPECT_EQUAL( comparison->GetNumberOfPixelsWithDifferences(), 0u );
+
+  // Streamed pieces only decompress the blocks they overlap
+  ReaderType::Pointer streamingReader = ReaderType::New();
+  streamingReader->SetFileName( argv[1] );
+  streamingReader->UseStreamingOn();
+  typedef itk::StreamingImageFilter< ImageType, ImageType > StreamerType;
+  StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( streamingReader->GetOutput() );
+  streamer->SetNumberOfStreamDivisions( 3 );
+  TRY_EXPECT_NO_EXCEPTION( streamer->Update() );
+  TEST_EXPECT_EQUAL( streamingReader->GetOutput()->GetBufferedRegion().GetSize( 2 ), 6u );
+  comparison->SetTestInput( streamer->GetOutput() );
+  TRY_EXPECT_NO_EXCEPTION( comparison->Update() );
+  TEST_EXPECT_EQUAL( comparison->GetNumberOfPixelsWithDifferences(), 0u );
+
+  // A region not made of whole lines
+  ImageType::IndexType  roiIndex = { { 5, 7, 3 } };
+  ImageType::SizeType   roiSize = { { 31, 22, 9 } };
+  ImageType::RegionType roi( roiIndex, roiSize );
+  ReaderType::Pointer   roiReader = ReaderType::New();
+  roiReader->SetFileName( argv[1] );
+  roiReader->UseStreamingOn();
+  roiReader->GetOutput()->SetRequestedRegion( roi );
+  TRY_EXPECT_NO_EXCEPTION( roiReader->GetOutput()->Update() );
+  TEST_EXPECT_TRUE( roiReader->GetOutput()->GetBufferedRegion() == roi );
+  itk::ImageRegionConstIterator< ImageType > roiIt( roiReader->GetOutput(), roi );
+  for ( ; !roiIt.IsAtEnd(); ++roiIt )
+    {
+    if ( roiIt.Get() != image->GetPixel( roiIt.GetIndex() ) )
+      {
+      std::cerr << "Region pixel " << roiIt.GetIndex() << " is " << roiIt.Get() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // The blocks form the zlib stream MetaImage reads
+  MetaImage metaImage;
+  TEST_EXPECT_TRUE( metaImage.Read( argv[1] ) );
+  TEST_EXPECT_TRUE( metaImage.CompressedData() );
+  const PixelType *elementData = static_cast< const PixelType * >( metaImage.ElementData() );
+  TEST_EXPECT_TRUE( std::equal( image->GetBufferPointer(),
+                                image->GetBufferPointer() + region.GetNumberOfPixels(), elementData ) );
+
+  // Without a block size, the data is a single stream again
+  io->SetCompressionBlockSize( 0 );
+  writer->Modified();
+  TRY_EXPECT_NO_EXCEPTION( writer->Update() );
+  TRY_EXPECT_NO_EXCEPTION( readerIO->ReadImageInformation() );
+  TEST_EXPECT_TRUE( !readerIO->CanStreamRead() );
+  reader->Modified();
+  TRY_EXPECT_NO_EXCEPTION( reader->Update() );
+  comparison->SetTestInput( reader->GetOutput() );
+  TRY_EXPECT_NO_EXCEPTION( comparison->Update() );
+  TEST_EXPECT_EQUAL( comparison->GetNumberOfPixelsWithDifferences(), 0u );
+
+  // A path relative to the working directory, in a subdirectory
+  const std::string workingDirectory = itksys::SystemTools::GetCurrentWorkingDirectory();
+  const std::string outputDirectory = itksys::SystemTools::GetFilenamePath( argv[1] );
+  const std::string extension = itksys::SystemTools::GetFilenameLastExtension( argv[1] );
+  if( !outputDirectory.empty() )
+    {
+    TEST_EXPECT_EQUAL( itksys::SystemTools::ChangeDirectory( outputDirectory.c_str() ), 0 );
+    }
+  const std::string relativeDirectory = "MetaImageIOCompressionBlockTest_" + extension.substr( 1 );
+  const std::string relativeFileName = relativeDirectory + "/relative" + extension;
+  TEST_EXPECT_TRUE( itksys::SystemTools::MakeDirectory( relativeDirectory.c_str() ) );
+  io->SetCompressionBlockSize( 10000 );
+  writer->SetFileName( relativeFileName );
+  TRY_EXPECT_NO_EXCEPTION( writer->Update() );
+  if( extension == ".mhd" )
+    {
+    TEST_EXPECT_TRUE( itksys::SystemTools::FileExists( ( relativeDirectory + "/relative.zraw" ).c_str() ) );
+    }
+  ReaderType::Pointer relativeReader = ReaderType::New();
+  relativeReader->SetFileName( relativeFileName );
+  TRY_EXPECT_NO_EXCEPTION( relativeReader->Update() );
+  comparison->SetTestInput( relativeReader->GetOutput() );
+  TRY_EXPECT_NO_EXCEPTION( comparison->Update() );
+  TEST_EXPECT_EQUAL( comparison->GetNumberOfPixelsWithDifferences(), 0u );
+  itksys::SystemTools::ChangeDirectory( workingDirectory.c_str() );
+
+  return EXIT_SUCCESS;
+}
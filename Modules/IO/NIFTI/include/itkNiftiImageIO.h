@@ -21,7 +21,7 @@
 
 
 #include <fstream>
-#include "itkImageIOBase.h"
+#include "itkStreamingImageIOBase.h"
 #include <nifti1_io.h>
 
 namespace itk
@@ -35,15 +35,26 @@ namespace itk
  * The specification for this file format is taken from the
  * web site http://analyzedirect.com/support/10.0Documents/Analyze_Resource_01.pdf
  *
+ * Regions of a file can be read, which lets ImageFileReader stream any
+ * file. Pieces of uncompressed files in the native byte order are read
+ * straight from the file, and pieces of uncompressed images with
+ * scalar, complex, RGB or RGBA pixels can be written, which lets
+ * ImageFileWriter stream them.
+ *
+ * Whole gzip compressed images are decompressed while other threads
+ * byte swap and rescale the data already decompressed. Files made of
+ * several gzip members carrying their size, as written with
+ * UseBlockCompression or by BGZF tools, are decompressed in parallel.
+ *
  * \ingroup IOFilters
  * \ingroup ITKIONIFTI
  */
-class NiftiImageIO:public ImageIOBase
+class NiftiImageIO:public StreamingImageIOBase
 {
 public:
   /** Standard class typedefs. */
   typedef NiftiImageIO         Self;
-  typedef ImageIOBase          Superclass;
+  typedef StreamingImageIOBase Superclass;
   typedef SmartPointer< Self > Pointer;
 
   /** Method for creation through the object factory. */
@@ -89,10 +100,14 @@ public:
    * that the IORegions has been set properly. */
   virtual void Write(const void *buffer) ITK_OVERRIDE;
 
-  /** Calculate the region of the image that can be efficiently read
-   *  in response to a given requested region. */
-  virtual ImageIORegion
-  GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const ITK_OVERRIDE;
+  /** Pieces can be written in uncompressed binary files, when the
+   * components of a pixel are next to each other in the file. */
+  virtual bool CanStreamWrite() ITK_OVERRIDE;
+
+  /** Uncompressed binary files in the native byte order can be mapped,
+   * unless the pixels are rescaled or their components are not next to
+   * each other in the file. */
+  virtual bool CanMapIORegion(std::string & fileName, SizeType & offset) ITK_OVERRIDE;
 
   /** A mode to allow the Nifti filter to read and write to the LegacyAnalyze75 format as interpreted by
     * the nifti library maintainers.  This format does not properly respect the file orientation fields.
@@ -102,6 +117,14 @@ public:
   itkSetMacro(LegacyAnalyze75Mode, bool);
   itkGetConstMacro(LegacyAnalyze75Mode, bool);
 
+  /** Set/Get whether compressed files are written as a series of gzip
+   * members of at most 64 KiB, in the BGZF layout, which are compressed
+   * in parallel and can be decompressed in parallel. Any gzip reader
+   * reads such files as usual. Off by default. */
+  itkSetMacro(UseBlockCompression, bool);
+  itkGetConstMacro(UseBlockCompression, bool);
+  itkBooleanMacro(UseBlockCompression);
+
 protected:
   NiftiImageIO();
   ~NiftiImageIO();
@@ -109,6 +132,9 @@ protected:
 
   virtual bool GetUseLegacyModeForTwoFileWriting(void) const { return false; }
 
+  /** Offset of the data in the image file. */
+  virtual SizeType GetHeaderSize() const ITK_OVERRIDE;
+
 private:
   bool  MustRescale();
 
@@ -120,6 +146,16 @@ private:
 
   void  SetImageIOMetadataFromNIfTI();
 
+  void  RescaleBuffer(void *buffer, size_t numberOfValues);
+
+  /** Decompress the whole data of a gzip compressed image, and byte swap
+   * it. The scalar values are also rescaled when rescale is true. */
+  void  ReadGzippedData(void *data, bool rescale);
+
+  /** Write the data after the header as gzip members compressed in
+   * parallel. */
+  void  WriteGzipMembers(const void *data);
+
   nifti_image *m_NiftiImage;
 
   double m_RescaleSlope;
@@ -129,6 +165,8 @@ private:
 
   bool m_LegacyAnalyze75Mode;
 
+  bool m_UseBlockCompression;
+
   NiftiImageIO(const Self &);   //purposely not implemented
   void operator=(const Self &); //purposely not implemented
 };
@@ -5,6 +5,7 @@ itk_module(ITKIONIFTI
   DEPENDS
     ITKNIFTI
     ITKIOImageBase
+    ITKZLIB
   TEST_DEPENDS
     ITKTestKernel
     ITKTransform
@@ -19,6 +19,12 @@
 #include "itkIOCommon.h"
 #include "itkMetaDataObject.h"
 #include "itkSpatialOrientationAdapter.h"
+#include "itkMultiThreader.h"
+#include "itkConditionVariable.h"
+#include "itksys/SystemTools.hxx"
+#include "itk_zlib.h"
+#include "vnl/vnl_math.h"
+#include <deque>
 
 namespace itk
 {
@@ -340,19 +346,13 @@ int SymMatDim(int count)
   return dim;
 }
 
-ImageIORegion
-NiftiImageIO
-::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const
-{
-  return requestedRegion;
-}
-
 NiftiImageIO::NiftiImageIO():
   m_NiftiImage(ITK_NULLPTR),
   m_RescaleSlope(1.0),
   m_RescaleIntercept(0.0),
   m_OnDiskComponentType(UNKNOWNCOMPONENTTYPE),
-  m_LegacyAnalyze75Mode(true)
+  m_LegacyAnalyze75Mode(true),
+  m_UseBlockCompression(false)
 {
   this->SetNumberOfDimensions(3);
   nifti_set_debug_level(0); // suppress error messages
@@ -383,6 +383,7 @@ NiftiImageIO
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "LegacyAnalyze75Mode: " << this->m_LegacyAnalyze75Mode << std::endl;
+  os << indent << "UseBlockCompression: " << this->m_UseBlockCompression << std::endl;
 }
 
 bool
@@ -429,6 +430,483 @@ CastCopy(float *to, void *from, size_t pixelcount)
     }
 }
 
+namespace
+{
+// Rescale the values of a buffer of the given component type; returns
+// false for the types which cannot be rescaled
+bool RescaleValues(ImageIOBase::IOComponentType componentType, void *buffer,
+                   double slope, double intercept, size_t numberOfValues)
+{
+  switch ( componentType )
+    {
+    case ImageIOBase::CHAR:
+      RescaleFunction(static_cast< char * >( buffer ), slope, intercept, numberOfValues);
+      break;
+    case ImageIOBase::UCHAR:
+      RescaleFunction(static_cast< unsigned char * >( buffer ), slope, intercept, numberOfValues);
+      break;
+    case ImageIOBase::SHORT:
+      RescaleFunction(static_cast< short * >( buffer ), slope, intercept, numberOfValues);
+      break;
+    case ImageIOBase::USHORT:
+      RescaleFunction(static_cast< unsigned short * >( buffer ), slope, intercept, numberOfValues);
+      break;
+    case ImageIOBase::INT:
+      RescaleFunction(static_cast< int * >( buffer ), slope, intercept, numberOfValues);
+      break;
+    case ImageIOBase::UINT:
+      RescaleFunction(static_cast< unsigned int * >( buffer ), slope, intercept, numberOfValues);
+      break;
+    case ImageIOBase::LONG:
+      RescaleFunction(static_cast< long * >( buffer ), slope, intercept, numberOfValues);
+      break;
+    case ImageIOBase::ULONG:
+      RescaleFunction(static_cast< unsigned long * >( buffer ), slope, intercept, numberOfValues);
+      break;
+    case ImageIOBase::FLOAT:
+      RescaleFunction(static_cast< float * >( buffer ), slope, intercept, numberOfValues);
+      break;
+    case ImageIOBase::DOUBLE:
+      RescaleFunction(static_cast< double * >( buffer ), slope, intercept, numberOfValues);
+      break;
+    default:
+      return false;
+    }
+  return true;
+}
+
+// Gzip members in the BGZF layout hold at most this number of bytes,
+// which always fit in 64 KiB once compressed
+const size_t GzipMemberDataSize = 0xff00;
+const size_t GzipMemberHeaderSize = 18;
+const size_t GzipMemberTrailerSize = 8;
+
+// Bytes of the uncompressed data a thread inflates before handing them
+// to the other threads
+const size_t GzipChunkSize = 1 << 20;
+
+inline unsigned long GetLittleEndian(const unsigned char *bytes, unsigned int numberOfBytes)
+{
+  unsigned long value = 0;
+  for ( unsigned int i = 0; i < numberOfBytes; ++i )
+    {
+    value |= static_cast< unsigned long >( bytes[i] ) << ( 8 * i );
+    }
+  return value;
+}
+
+inline void SetLittleEndian(unsigned long value, unsigned char *bytes, unsigned int numberOfBytes)
+{
+  for ( unsigned int i = 0; i < numberOfBytes; ++i )
+    {
+    bytes[i] = static_cast< unsigned char >( ( value >> ( 8 * i ) ) & 0xFF );
+    }
+}
+
+inline bool IsGzipMember(const unsigned char *bytes, size_t size)
+{
+  return size >= GzipMemberHeaderSize - 8 && bytes[0] == 0x1f && bytes[1] == 0x8b && bytes[2] == Z_DEFLATED;
+}
+
+// Size of a gzip member recorded in the BC extra field of its header,
+// or 0 when the header does not record it
+size_t GetGzipMemberSize(const unsigned char *bytes, size_t size)
+{
+  const unsigned char FEXTRA = 4;
+  if ( !IsGzipMember(bytes, size) || !( bytes[3] & FEXTRA ) || size < 12 )
+    {
+    return 0;
+    }
+  const size_t extraEnd = 12 + GetLittleEndian(bytes + 10, 2);
+  for ( size_t field = 12; field + 4 <= extraEnd && field + 4 <= size; )
+    {
+    const size_t fieldSize = GetLittleEndian(bytes + field + 2, 2);
+    if ( bytes[field] == 'B' && bytes[field + 1] == 'C' && fieldSize == 2 && field + 6 <= size )
+      {
+      const size_t memberSize = GetLittleEndian(bytes + field + 4, 2) + 1;
+      return memberSize <= size ? memberSize : 0;
+      }
+    field += 4 + fieldSize;
+    }
+  return 0;
+}
+
+// A member to inflate when CompressedSize is not 0, otherwise a range of
+// the data to process
+struct GzipWorkItem
+{
+  size_t CompressedBegin;
+  size_t CompressedSize;
+  size_t Begin;
+  size_t Size;
+};
+
+struct GzipReadStruct
+{
+  const unsigned char *Compressed;
+  size_t               CompressedSize;
+
+  // Where the data is in the uncompressed stream, and where it goes
+  char * Data;
+  size_t DataBegin;
+  size_t DataSize;
+
+  // Processing of the data decompressed
+  size_t                        ElementSize;
+  int                           SwapSize;
+  int                           DataType;
+  bool                          Rescale;
+  ImageIOBase::IOComponentType  ComponentType;
+  double                        Slope;
+  double                        Intercept;
+
+  // Work shared by the threads
+  SimpleMutexLock              Mutex;
+  ConditionVariable::Pointer   Condition;
+  std::deque< GzipWorkItem >   Work;
+  bool                         Scanned;
+  bool                         Failed;
+
+  // Starts of the members in the uncompressed stream
+  std::vector< size_t > MemberBegins;
+};
+
+template< typename T >
+void ZeroNonFinite(T *values, size_t numberOfValues)
+{
+  for ( size_t i = 0; i < numberOfValues; ++i )
+    {
+    if ( !vnl_math_isfinite(values[i]) )
+      {
+      values[i] = 0;
+      }
+    }
+}
+
+// Byte swap, clean and rescale the data in [begin, end), a range of whole
+// elements, as nifti_image_load and NiftiImageIO::Read do
+void ProcessGzippedData(GzipReadStruct *str, size_t begin, size_t end)
+{
+  char *data = str->Data + begin;
+  if ( str->SwapSize > 1 )
+    {
+    nifti_swap_Nbytes(static_cast< int >( ( end - begin ) / str->SwapSize ), str->SwapSize, data);
+    }
+  switch ( str->DataType )
+    {
+    case NIFTI_TYPE_FLOAT32:
+    case NIFTI_TYPE_COMPLEX64:
+      ZeroNonFinite(reinterpret_cast< float * >( data ), ( end - begin ) / sizeof( float ));
+      break;
+    case NIFTI_TYPE_FLOAT64:
+    case NIFTI_TYPE_COMPLEX128:
+      ZeroNonFinite(reinterpret_cast< double * >( data ), ( end - begin ) / sizeof( double ));
+      break;
+    default:
+      break;
+    }
+  if ( str->Rescale )
+    {
+    RescaleValues(str->ComponentType, data, str->Slope, str->Intercept, ( end - begin ) / str->ElementSize);
+    }
+}
+
+void PushGzipWork(GzipReadStruct *str, const GzipWorkItem & item)
+{
+  str->Mutex.Lock();
+  str->Work.push_back(item);
+  str->Condition->Signal();
+  str->Mutex.Unlock();
+}
+
+// Hand the whole elements of the data in [begin, end) of the uncompressed
+// stream to the threads
+void PushGzipProcessing(GzipReadStruct *str, size_t begin, size_t end)
+{
+  begin = std::max(begin, str->DataBegin) - str->DataBegin;
+  end = std::min(end, str->DataBegin + str->DataSize);
+  end = end > str->DataBegin ? end - str->DataBegin : 0;
+  begin = ( begin + str->ElementSize - 1 ) / str->ElementSize * str->ElementSize;
+  end = end / str->ElementSize * str->ElementSize;
+  if ( begin < end )
+    {
+    GzipWorkItem item = { 0, 0, begin, end - begin };
+    PushGzipWork(str, item);
+    }
+}
+
+// Inflate the gzip member starting at position, whose size is not known,
+// while the other threads process the data already inflated. position
+// and streamOffset are moved to the end of the member.
+bool InflateGzipMember(GzipReadStruct *str, size_t & position, size_t & streamOffset)
+{
+  z_stream stream;
+  stream.zalloc = Z_NULL;
+  stream.zfree = Z_NULL;
+  stream.opaque = Z_NULL;
+  stream.next_in = Z_NULL;
+  stream.avail_in = 0;
+  if ( inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK )
+    {
+    return false;
+    }
+
+  const size_t        dataEnd = str->DataBegin + str->DataSize;
+  std::vector< char > scratch(GzipChunkSize);
+  size_t              inputPosition = position;
+  size_t              processed = streamOffset;
+  int                 result = Z_OK;
+  while ( result != Z_STREAM_END && streamOffset < dataEnd )
+    {
+    if ( stream.avail_in == 0 )
+      {
+      const size_t available = std::min(str->CompressedSize - inputPosition, static_cast< size_t >( 1 ) << 30);
+      if ( available == 0 )
+        {
+        break;
+        }
+      stream.next_in = const_cast< Bytef * >( str->Compressed + inputPosition );
+      stream.avail_in = static_cast< uInt >( available );
+      inputPosition += available;
+      }
+
+    // Inflate the data in place, and the rest of the stream aside
+    size_t outputSize = GzipChunkSize;
+    if ( streamOffset >= str->DataBegin )
+      {
+      outputSize = std::min(outputSize, dataEnd - streamOffset);
+      stream.next_out = reinterpret_cast< Bytef * >( str->Data + ( streamOffset - str->DataBegin ) );
+      }
+    else
+      {
+      outputSize = std::min(outputSize, str->DataBegin - streamOffset);
+      stream.next_out = reinterpret_cast< Bytef * >( &scratch[0] );
+      }
+    stream.avail_out = static_cast< uInt >( outputSize );
+    result = inflate(&stream, Z_NO_FLUSH);
+    if ( result != Z_OK && result != Z_STREAM_END )
+      {
+      break;
+      }
+    streamOffset += outputSize - stream.avail_out;
+    if ( streamOffset - processed >= GzipChunkSize || result == Z_STREAM_END || streamOffset == dataEnd )
+      {
+      PushGzipProcessing(str, processed, streamOffset);
+      if ( streamOffset > str->DataBegin )
+        {
+        const size_t end = std::min(streamOffset, dataEnd) - str->DataBegin;
+        processed = std::max(processed, str->DataBegin + end / str->ElementSize * str->ElementSize);
+        }
+      }
+    }
+  PushGzipProcessing(str, processed, streamOffset);
+  position = inputPosition - stream.avail_in;
+  inflateEnd(&stream);
+  return result == Z_STREAM_END || streamOffset >= dataEnd;
+}
+
+// Inflate a member whose size is known, and process its data
+bool InflateGzipMember(GzipReadStruct *str, const GzipWorkItem & item, std::vector< char > & scratch)
+{
+  z_stream stream;
+  stream.zalloc = Z_NULL;
+  stream.zfree = Z_NULL;
+  stream.opaque = Z_NULL;
+  stream.next_in = const_cast< Bytef * >( str->Compressed + item.CompressedBegin );
+  stream.avail_in = static_cast< uInt >( item.CompressedSize );
+  if ( inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK )
+    {
+    return false;
+    }
+
+  const size_t dataEnd = str->DataBegin + str->DataSize;
+  const bool   inPlace = item.Begin >= str->DataBegin && item.Begin + item.Size <= dataEnd;
+  if ( inPlace )
+    {
+    stream.next_out = reinterpret_cast< Bytef * >( str->Data + ( item.Begin - str->DataBegin ) );
+    }
+  else
+    {
+    scratch.resize( std::max(item.Size, static_cast< size_t >( 1 )) );
+    stream.next_out = reinterpret_cast< Bytef * >( &scratch[0] );
+    }
+  stream.avail_out = static_cast< uInt >( item.Size );
+  const int result = inflate(&stream, Z_FINISH);
+  const bool inflated = result == Z_STREAM_END && stream.total_out == item.Size;
+  inflateEnd(&stream);
+  if ( !inflated )
+    {
+    return false;
+    }
+
+  // Copy the part of the data the member holds
+  if ( !inPlace )
+    {
+    const size_t begin = std::max(item.Begin, str->DataBegin);
+    const size_t end = std::min(item.Begin + item.Size, dataEnd);
+    if ( begin < end )
+      {
+      std::copy(&scratch[begin - item.Begin], &scratch[begin - item.Begin] + ( end - begin ),
+                str->Data + ( begin - str->DataBegin ));
+      }
+    }
+
+  // Elements across the ends of the member are processed once all the
+  // members are inflated
+  size_t begin = std::max(item.Begin, str->DataBegin) - str->DataBegin;
+  size_t end = std::min(item.Begin + item.Size, dataEnd);
+  end = end > str->DataBegin ? end - str->DataBegin : 0;
+  begin = ( begin + str->ElementSize - 1 ) / str->ElementSize * str->ElementSize;
+  end = end / str->ElementSize * str->ElementSize;
+  if ( begin < end )
+    {
+    ProcessGzippedData(str, begin, end);
+    }
+  return true;
+}
+
+// Thread 0 goes through the members, inflating the ones of unknown size
+// and handing the others to the threads, then works with the threads.
+ITK_THREAD_RETURN_TYPE ReadGzippedDataThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  GzipReadStruct *                 str = static_cast< GzipReadStruct * >( info->UserData );
+
+  bool succeeded = true;
+  if ( info->ThreadID == 0 )
+    {
+    size_t       position = 0;
+    size_t       streamOffset = 0;
+    const size_t dataEnd = str->DataBegin + str->DataSize;
+    while ( streamOffset < dataEnd
+            && IsGzipMember(str->Compressed + position, str->CompressedSize - position) )
+      {
+      str->MemberBegins.push_back(streamOffset);
+      const size_t memberSize = GetGzipMemberSize(str->Compressed + position, str->CompressedSize - position);
+      if ( memberSize > GzipMemberHeaderSize + GzipMemberTrailerSize )
+        {
+        const size_t       uncompressedSize =
+          GetLittleEndian(str->Compressed + position + memberSize - 4, 4);
+        if ( uncompressedSize > 0 )
+          {
+          const GzipWorkItem item = { position, memberSize, streamOffset, uncompressedSize };
+          PushGzipWork(str, item);
+          }
+        position += memberSize;
+        streamOffset += uncompressedSize;
+        }
+      else if ( !InflateGzipMember(str, position, streamOffset) )
+        {
+        break;
+        }
+      }
+    succeeded = streamOffset >= dataEnd;
+
+    str->Mutex.Lock();
+    str->Scanned = true;
+    str->Condition->Broadcast();
+    str->Mutex.Unlock();
+    }
+
+  std::vector< char > scratch;
+  for (;; )
+    {
+    str->Mutex.Lock();
+    while ( str->Work.empty() && !str->Scanned )
+      {
+      str->Condition->Wait(&str->Mutex);
+      }
+    if ( str->Work.empty() )
+      {
+      str->Mutex.Unlock();
+      break;
+      }
+    const GzipWorkItem item = str->Work.front();
+    str->Work.pop_front();
+    str->Mutex.Unlock();
+
+    if ( item.CompressedSize == 0 )
+      {
+      ProcessGzippedData(str, item.Begin, item.Begin + item.Size);
+      }
+    else if ( !InflateGzipMember(str, item, scratch) )
+      {
+      succeeded = false;
+      }
+    }
+
+  if ( !succeeded )
+    {
+    str->Mutex.Lock();
+    str->Failed = true;
+    str->Mutex.Unlock();
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+struct GzipWriteStruct
+{
+  const unsigned char *                         Data;
+  size_t                                        DataSize;
+  size_t                                        FirstMember;
+  std::vector< std::vector< unsigned char > > * Members;
+};
+
+// Each thread compresses every NumberOfThreads-th member. A member left
+// empty could not be compressed.
+ITK_THREAD_RETURN_TYPE WriteGzipMembersThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  GzipWriteStruct *                str = static_cast< GzipWriteStruct * >( info->UserData );
+
+  z_stream stream;
+  stream.zalloc = Z_NULL;
+  stream.zfree = Z_NULL;
+  stream.opaque = Z_NULL;
+  if ( deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK )
+    {
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
+  for ( size_t m = info->ThreadID; m < str->Members->size(); m += info->NumberOfThreads )
+    {
+    const size_t                 begin = ( str->FirstMember + m ) * GzipMemberDataSize;
+    const size_t                 size = std::min(GzipMemberDataSize, str->DataSize - begin);
+    std::vector< unsigned char > & member = ( *str->Members )[m];
+    member.resize( GzipMemberHeaderSize + deflateBound( &stream, static_cast< uLong >( size ) )
+                   + GzipMemberTrailerSize );
+
+    stream.next_in = const_cast< Bytef * >( str->Data + begin );
+    stream.avail_in = static_cast< uInt >( size );
+    stream.next_out = &member[GzipMemberHeaderSize];
+    stream.avail_out = static_cast< uInt >( member.size() - GzipMemberHeaderSize - GzipMemberTrailerSize );
+    const int result = deflate(&stream, Z_FINISH);
+    const size_t compressedSize = stream.total_out;
+    deflateReset(&stream);
+    if ( result != Z_STREAM_END )
+      {
+      member.clear();
+      continue;
+      }
+
+    // Header with the BC extra field holding the size of the member
+    const size_t memberSize = GzipMemberHeaderSize + compressedSize + GzipMemberTrailerSize;
+    const unsigned char header[GzipMemberHeaderSize] = {
+      0x1f, 0x8b, Z_DEFLATED, 4, 0, 0, 0, 0, 0, 0xff, 6, 0, 'B', 'C', 2, 0, 0, 0
+      };
+    std::copy(header, header + GzipMemberHeaderSize, member.begin());
+    SetLittleEndian(memberSize - 1, &member[16], 2);
+    SetLittleEndian(crc32(crc32(0L, Z_NULL, 0), str->Data + begin, static_cast< uInt >( size )),
+                    &member[GzipMemberHeaderSize + compressedSize], 4);
+    SetLittleEndian(size, &member[GzipMemberHeaderSize + compressedSize + 4], 4);
+    member.resize(memberSize);
+    }
+
+  deflateEnd(&stream);
+  return ITK_THREAD_RETURN_VALUE;
+}
+}
+
 void NiftiImageIO::Read(void *buffer)
 {
   void *data = ITK_NULLPTR;
@@ -480,6 +958,34 @@ void NiftiImageIO::Read(void *buffer)
                        << this->GetFileName() );
     }
 
+  //
+  // pieces of uncompressed binary files in the native byte order, with
+  // the same layout in the file and in memory, are read straight from
+  // the file
+  if ( this->RequestedToStream()
+       && this->m_NiftiImage->nifti_type != NIFTI_FTYPE_ASCII
+       && !nifti_is_gzfile(this->m_NiftiImage->iname)
+       && this->m_NiftiImage->byteorder == nifti_short_order()
+       && this->m_ComponentType == this->m_OnDiskComponentType
+       && ( numComponents == 1
+            || this->GetPixelType() == COMPLEX
+            || this->GetPixelType() == RGB
+            || this->GetPixelType() == RGBA ) )
+    {
+    std::ifstream file;
+    this->OpenFileForReading(file, this->m_NiftiImage->iname);
+    if ( !this->StreamReadBufferAsBinary(file, buffer) )
+      {
+      itkExceptionMacro( << "Reading a region failed for file: "
+                         << this->m_NiftiImage->iname );
+      }
+    if ( this->MustRescale() )
+      {
+      this->RescaleBuffer(buffer, numElts);
+      }
+    return;
+    }
+
   //
   // decide whether to read whole region or subregion, by stepping
   // thru dims and comparing them to requested sizes
@@ -494,7 +1000,34 @@ void NiftiImageIO::Read(void *buffer)
   // all data as a block
   if ( i == this->GetNumberOfDimensions() )
     {
-    if ( nifti_image_load(this->m_NiftiImage) == -1 )
+    if ( this->m_NiftiImage->nifti_type != NIFTI_FTYPE_ASCII
+         && nifti_is_gzfile(this->m_NiftiImage->iname) )
+      {
+      // decompress straight to the buffer when the layout of the data in
+      // memory is the layout in the file
+      if ( this->m_ComponentType == this->m_OnDiskComponentType
+           && ( numComponents == 1
+                || this->GetPixelType() == COMPLEX
+                || this->GetPixelType() == RGB
+                || this->GetPixelType() == RGBA ) )
+        {
+        const bool rescale = this->MustRescale() && numComponents == 1;
+        this->ReadGzippedData(buffer, rescale);
+        if ( this->MustRescale() && !rescale )
+          {
+          this->RescaleBuffer(buffer, numElts);
+          }
+        return;
+        }
+      this->m_NiftiImage->data = malloc( nifti_get_volsize(this->m_NiftiImage) );
+      if ( this->m_NiftiImage->data == ITK_NULLPTR )
+        {
+        itkExceptionMacro( << "Cannot allocate the data of file: "
+                           << this->GetFileName() );
+        }
+      this->ReadGzippedData(this->m_NiftiImage->data, false);
+      }
+    else if ( nifti_image_load(this->m_NiftiImage) == -1 )
       {
       itkExceptionMacro( << "nifti_image_load failed for file: "
                          << this->GetFileName() );
@@ -527,9 +1060,10 @@ void NiftiImageIO::Read(void *buffer)
       static_cast< unsigned int >( this->GetNumberOfComponents() )
       * static_cast< unsigned int >( sizeof( float ) );
 
-    // Deal with correct management of 64bits platforms
+    // Deal with correct management of 64bits platforms, the region
+    // read may be smaller than the image
     const size_t imageSizeInComponents =
-      static_cast< size_t >( this->GetImageSizeInComponents() );
+      static_cast< size_t >( numElts ) * numComponents;
 
     //
     // allocate new buffer for floats. Malloc instead of new to
@@ -602,12 +1136,13 @@ void NiftiImageIO::Read(void *buffer)
     {
     // otherwise nifti is x y z t vec l m 0, itk is
     // vec x y z t l m o
+    // with the size of the region read
     const char *       niftibuf = (const char *)data;
     char *             itkbuf = (char *)buffer;
-    const size_t rowdist = this->m_NiftiImage->dim[1];
-    const size_t slicedist = rowdist * this->m_NiftiImage->dim[2];
-    const size_t volumedist = slicedist * this->m_NiftiImage->dim[3];
-    const size_t seriesdist = volumedist * this->m_NiftiImage->dim[4];
+    const size_t rowdist = _size[0];
+    const size_t slicedist = rowdist * _size[1];
+    const size_t volumedist = slicedist * _size[2];
+    const size_t seriesdist = volumedist * _size[3];
     //
     // as per ITK bug 0007485
     // NIfTI is lower triangular, ITK is upper triangular.
@@ -626,13 +1161,13 @@ void NiftiImageIO::Read(void *buffer)
         vecOrder[i] = i;
         }
       }
-    for ( int t = 0; t < this->m_NiftiImage->dim[4]; t++ )
+    for ( int t = 0; t < _size[3]; t++ )
       {
-      for ( int z = 0; z < this->m_NiftiImage->dim[3]; z++ )
+      for ( int z = 0; z < _size[2]; z++ )
         {
-        for ( int y = 0; y < this->m_NiftiImage->dim[2]; y++ )
+        for ( int y = 0; y < _size[1]; y++ )
           {
-          for ( int x = 0; x < this->m_NiftiImage->dim[1]; x++ )
+          for ( int x = 0; x < _size[0]; x++ )
             {
             for ( unsigned int c = 0; c < numComponents; c++ )
               {
@@ -666,69 +1201,142 @@ void NiftiImageIO::Read(void *buffer)
   // Complete description of can be found in nifti1.h under "DATA SCALING"
   if ( this->MustRescale() )
     {
-    switch ( this->m_ComponentType )
+    this->RescaleBuffer(buffer, numElts);
+    }
+}
+
+void
+NiftiImageIO
+::RescaleBuffer(void *buffer, size_t numberOfValues)
+{
+  if ( !RescaleValues(this->m_ComponentType, buffer,
+                      this->m_RescaleSlope, this->m_RescaleIntercept, numberOfValues)
+       && this->GetPixelType() == SCALAR )
+    {
+    itkExceptionMacro(<< "Datatype: "
+                      << this->GetComponentTypeAsString(this->m_ComponentType)
+                      << " not supported");
+    }
+}
+
+void
+NiftiImageIO
+::ReadGzippedData(void *data, bool rescale)
+{
+  const char *fileName = this->m_NiftiImage->iname;
+  std::ifstream file;
+  this->OpenFileForReading(file, fileName);
+  file.seekg(0, std::ios::end);
+  const std::streampos fileSize = file.tellg();
+  file.seekg(0, std::ios::beg);
+  std::vector< unsigned char > compressed( fileSize > 0 ? static_cast< size_t >( fileSize ) : 0 );
+  if ( !compressed.empty() )
+    {
+    file.read( reinterpret_cast< char * >( &compressed[0] ), compressed.size() );
+    }
+  if ( compressed.empty() || !file )
+    {
+    itkExceptionMacro( << "Reading failed for file: " << fileName );
+    }
+  file.close();
+
+  GzipReadStruct str;
+  str.Compressed = &compressed[0];
+  str.CompressedSize = compressed.size();
+  str.Data = static_cast< char * >( data );
+  str.DataBegin = this->m_NiftiImage->iname_offset > 0 ? this->m_NiftiImage->iname_offset : 0;
+  str.DataSize = nifti_get_volsize(this->m_NiftiImage);
+  str.ElementSize = this->m_NiftiImage->nbyper;
+  str.SwapSize = ( this->m_NiftiImage->swapsize > 1 && this->m_NiftiImage->byteorder != nifti_short_order() )
+                 ? this->m_NiftiImage->swapsize : 0;
+  str.DataType = this->m_NiftiImage->datatype;
+  str.Rescale = rescale;
+  str.ComponentType = this->m_ComponentType;
+  str.Slope = this->m_RescaleSlope;
+  str.Intercept = this->m_RescaleIntercept;
+  str.Condition = ConditionVariable::New();
+  str.Scanned = false;
+  str.Failed = false;
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetSingleMethod(ReadGzippedDataThreaderCallback, &str);
+  threader->SingleMethodExecute();
+  if ( str.Failed )
+    {
+    itkExceptionMacro( << "Decompressing failed for file: " << fileName );
+    }
+
+  // Process the elements across the members
+  size_t previous = str.DataSize;
+  for ( size_t m = 0; m < str.MemberBegins.size(); ++m )
+    {
+    const size_t begin = str.MemberBegins[m];
+    if ( begin <= str.DataBegin || begin >= str.DataBegin + str.DataSize
+         || ( begin - str.DataBegin ) % str.ElementSize == 0 )
       {
-      case CHAR:
-        RescaleFunction(static_cast< char * >( buffer ),
-                        this->m_RescaleSlope,
-                        this->m_RescaleIntercept, numElts);
-        break;
-      case UCHAR:
-        RescaleFunction(static_cast< unsigned char * >( buffer ),
-                        this->m_RescaleSlope,
-                        this->m_RescaleIntercept, numElts);
-        break;
-      case SHORT:
-        RescaleFunction(static_cast< short * >( buffer ),
-                        this->m_RescaleSlope,
-                        this->m_RescaleIntercept, numElts);
-        break;
-      case USHORT:
-        RescaleFunction(static_cast< unsigned short * >( buffer ),
-                        this->m_RescaleSlope,
-                        this->m_RescaleIntercept, numElts);
-        break;
-      case INT:
-        RescaleFunction(static_cast< int * >( buffer ),
-                        this->m_RescaleSlope,
-                        this->m_RescaleIntercept, numElts);
-        break;
-      case UINT:
-        RescaleFunction(static_cast< unsigned int * >( buffer ),
-                        this->m_RescaleSlope,
-                        this->m_RescaleIntercept, numElts);
-        break;
-      case LONG:
-        RescaleFunction(static_cast< long * >( buffer ),
-                        this->m_RescaleSlope,
-                        this->m_RescaleIntercept, numElts);
-        break;
-      case ULONG:
-        RescaleFunction(static_cast< unsigned long * >( buffer ),
-                        this->m_RescaleSlope,
-                        this->m_RescaleIntercept, numElts);
-        break;
-      case FLOAT:
-        RescaleFunction(static_cast< float * >( buffer ),
-                        this->m_RescaleSlope,
-                        this->m_RescaleIntercept, numElts);
-        break;
-      case DOUBLE:
-        RescaleFunction(static_cast< double * >( buffer ),
-                        this->m_RescaleSlope,
-                        this->m_RescaleIntercept, numElts);
-        break;
-      default:
-        if ( this->GetPixelType() == SCALAR )
-          {
-          itkExceptionMacro(<< "Datatype: "
-                            << this->GetComponentTypeAsString(this->m_ComponentType)
-                            << " not supported");
-          }
+      continue;
+      }
+    const size_t element = ( begin - str.DataBegin ) / str.ElementSize * str.ElementSize;
+    if ( element != previous )
+      {
+      ProcessGzippedData(&str, element, element + str.ElementSize);
+      previous = element;
       }
     }
 }
 
+void
+NiftiImageIO
+::WriteGzipMembers(const void *data)
+{
+  // The header, padded to the data, is written as a first member
+  znzFile file = nifti_image_write_hdr_img(this->m_NiftiImage, 2, "wb");
+  if ( znz_isnull(file) )
+    {
+    itkExceptionMacro( << "Writing the header failed for file: "
+                       << this->m_NiftiImage->fname );
+    }
+  znzclose(file);
+
+  std::ofstream dataFile;
+  dataFile.open( this->m_NiftiImage->iname, std::ios::out | std::ios::binary | std::ios::app );
+  if ( !dataFile.is_open() )
+    {
+    itkExceptionMacro( << "Cannot open file for writing: " << this->m_NiftiImage->iname );
+    }
+
+  // Compress and write batches of members
+  const size_t               dataSize = nifti_get_volsize(this->m_NiftiImage);
+  const size_t               numberOfMembers = ( dataSize + GzipMemberDataSize - 1 ) / GzipMemberDataSize;
+  MultiThreader::Pointer     threader = MultiThreader::New();
+  const size_t               batchSize = 64 * static_cast< size_t >( threader->GetNumberOfThreads() );
+  std::vector< std::vector< unsigned char > > members;
+  GzipWriteStruct            str;
+  str.Data = static_cast< const unsigned char * >( data );
+  str.DataSize = dataSize;
+  str.Members = &members;
+  threader->SetSingleMethod(WriteGzipMembersThreaderCallback, &str);
+  for ( size_t first = 0; first < numberOfMembers; first += batchSize )
+    {
+    members.clear();
+    members.resize( std::min(batchSize, numberOfMembers - first) );
+    str.FirstMember = first;
+    threader->SingleMethodExecute();
+    for ( size_t m = 0; m < members.size(); ++m )
+      {
+      if ( members[m].empty() )
+        {
+        itkExceptionMacro( << "Compressing failed for file: " << this->m_NiftiImage->iname );
+        }
+      dataFile.write( reinterpret_cast< const char * >( &members[m][0] ), members[m].size() );
+      }
+    }
+  if ( !dataFile )
+    {
+    itkExceptionMacro( << "Writing failed for file: " << this->m_NiftiImage->iname );
+    }
+}
+
 // This method will only test if the header looks like an
 // Nifti Header.  Some code is redundant with ReadImageInformation
 // a StateMachine could provide a better implementation
@@ -1352,6 +1960,9 @@ NiftiImageIO
     {
     itkExceptionMacro(<< "Bad Nifti file name: " << FName);
     }
+  // the names of a previous call, for an earlier piece of the image
+  free(this->m_NiftiImage->fname);
+  free(this->m_NiftiImage->iname);
   this->m_NiftiImage->fname = nifti_makehdrname(BaseName.c_str(), this->m_NiftiImage->nifti_type, false, IsCompressed);
   this->m_NiftiImage->iname = nifti_makeimgname(BaseName.c_str(), this->m_NiftiImage->nifti_type, false, IsCompressed);
   //     FIELD         NOTES
@@ -1836,6 +2447,67 @@ NiftiImageIO::SetNIfTIOrientationFromImageIO(unsigned short int origdims, unsign
   //  this->m_NiftiImage->sform_code = 0;
 }
 
+bool
+NiftiImageIO
+::CanStreamWrite()
+{
+  // pieces are written straight to the data file, which cannot be
+  // compressed, and must hold the components of a pixel next to each
+  // other
+  const std::string fileName = this->GetFileName();
+  const char *      extension = nifti_find_file_extension( fileName.c_str() );
+  const unsigned int numComponents = this->GetNumberOfComponents();
+
+  return extension != ITK_NULLPTR
+         && std::string(extension) != ".nia"
+         && !nifti_is_gzfile( fileName.c_str() )
+         && ( numComponents == 1
+              || ( numComponents == 2 && this->GetPixelType() == COMPLEX )
+              || ( numComponents == 3 && this->GetPixelType() == RGB )
+              || ( numComponents == 4 && this->GetPixelType() == RGBA ) );
+}
+
+bool
+NiftiImageIO
+::CanMapIORegion(std::string & fileName, SizeType & offset)
+{
+  const unsigned int numComponents = this->GetNumberOfComponents();
+  SizeType           regionOffset;
+  if ( this->MustRescale()
+       || this->m_ComponentType != this->m_OnDiskComponentType
+       || ( numComponents > 1
+            && this->GetPixelType() != COMPLEX
+            && this->GetPixelType() != RGB
+            && this->GetPixelType() != RGBA )
+       || !this->GetContiguousIORegionOffset(regionOffset) )
+    {
+    return false;
+    }
+
+  nifti_image *header = nifti_image_read(this->GetFileName(), false);
+  if ( header == ITK_NULLPTR )
+    {
+    return false;
+    }
+  const bool mappable = header->nifti_type != NIFTI_FTYPE_ASCII
+                        && !nifti_is_gzfile(header->iname)
+                        && header->byteorder == nifti_short_order();
+  if ( mappable )
+    {
+    fileName = header->iname;
+    offset = header->iname_offset + regionOffset;
+    }
+  nifti_image_free(header);
+  return mappable;
+}
+
+NiftiImageIO::SizeType
+NiftiImageIO
+::GetHeaderSize() const
+{
+  return this->m_NiftiImage != ITK_NULLPTR ? this->m_NiftiImage->iname_offset : 0;
+}
+
 void
 NiftiImageIO
 ::Write(const void *buffer)
@@ -1843,6 +2515,61 @@ NiftiImageIO
   // Write the image Information before writing data
   this->WriteImageInformation();
   unsigned int numComponents = this->GetNumberOfComponents();
+
+  //
+  // pieces of the image are written straight to the data file: we
+  // assume that GetActualNumberOfSplitsForWriting is called before this
+  // method and removes the header if a new one needs to be written
+  if ( this->RequestedToStream() )
+    {
+    std::ofstream file;
+    if ( !itksys::SystemTools::FileExists(this->m_NiftiImage->fname) )
+      {
+      // write the header alone; the file is closed as it is not left open
+      nifti_image_write_hdr_img(this->m_NiftiImage, 0, "wb");
+      if ( !itksys::SystemTools::FileExists(this->m_NiftiImage->fname) )
+        {
+        itkExceptionMacro( << "Writing the header failed for file: "
+                           << this->m_NiftiImage->fname );
+        }
+
+      // write one byte at the end of the data to allocate it (which does
+      // not write the entire size of the data if the system supports
+      // sparse files)
+      this->OpenFileForWriting( file, this->m_NiftiImage->iname,
+                                this->m_NiftiImage->nifti_type != NIFTI_FTYPE_NIFTI1_1 );
+      std::streampos seekPos = this->GetHeaderSize() + this->GetImageSizeInBytes() - 1;
+      file.seekp(seekPos, std::ios::beg);
+      file.write("\0", 1);
+      }
+    else
+      {
+      // the data starts where the header on disk says
+      nifti_image *header = nifti_image_read(this->m_NiftiImage->fname, false);
+      if ( header == ITK_NULLPTR )
+        {
+        itkExceptionMacro( << "nifti_image_read (just header) failed for file: "
+                           << this->m_NiftiImage->fname );
+        }
+      const bool nativeByteOrder = header->byteorder == nifti_short_order();
+      this->m_NiftiImage->iname_offset = header->iname_offset;
+      nifti_image_free(header);
+      if ( !nativeByteOrder )
+        {
+        itkExceptionMacro( << "Cannot paste into a file in another byte order: "
+                           << this->m_NiftiImage->fname );
+        }
+      this->OpenFileForWriting(file, this->m_NiftiImage->iname, false);
+      }
+
+    if ( !this->StreamWriteBufferAsBinary(file, buffer) )
+      {
+      itkExceptionMacro( << "Writing a region failed for file: "
+                         << this->m_NiftiImage->iname );
+      }
+    return;
+    }
+
   if ( numComponents == 1
        || ( numComponents == 2 && this->GetPixelType() == COMPLEX )
        || ( numComponents == 3 && this->GetPixelType() == RGB )
@@ -1851,7 +2578,16 @@ NiftiImageIO
     // Need a const cast here so that we don't have to copy the memory
     // for writing.
     this->m_NiftiImage->data = const_cast< void * >( buffer );
-    nifti_image_write(this->m_NiftiImage);
+    if ( this->m_UseBlockCompression
+         && this->m_NiftiImage->nifti_type != NIFTI_FTYPE_ASCII
+         && nifti_is_gzfile(this->m_NiftiImage->iname) )
+      {
+      this->WriteGzipMembers(buffer);
+      }
+    else
+      {
+      nifti_image_write(this->m_NiftiImage);
+      }
     this->m_NiftiImage->data = ITK_NULLPTR; // if left pointing to data buffer
     // nifti_image_free will try and free this memory
     }
@@ -1937,7 +2673,16 @@ NiftiImageIO
     //Need a const cast here so that we don't have to copy the memory for
     //writing.
     this->m_NiftiImage->data = (void *)nifti_buf;
-    nifti_image_write(this->m_NiftiImage);
+    if ( this->m_UseBlockCompression
+         && this->m_NiftiImage->nifti_type != NIFTI_FTYPE_ASCII
+         && nifti_is_gzfile(this->m_NiftiImage->iname) )
+      {
+      this->WriteGzipMembers(nifti_buf);
+      }
+    else
+      {
+      nifti_image_write(this->m_NiftiImage);
+      }
     this->m_NiftiImage->data = ITK_NULLPTR; // if left pointing to data buffer
     delete[] nifti_buf;
     }
@@ -0,0 +1,136 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkNiftiImageIOTest.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMultiThreader.h"
+#include "itkTestingComparisonImageFilter.h"
+#include "itkTimeProbesCollectorBase.h"
+
+#include <cstdlib>
+
+namespace
+{
+typedef itk::Image< float, 3 > ImageType;
+
+// Read the file with the given number of threads, and check that the
+// image read is the one written
+bool ProfileRead(const std::string & fileName, const std::string & name, itk::ThreadIdType numberOfThreads,
+                 unsigned int numberOfIterations, const ImageType *reference,
+                 itk::TimeProbesCollectorBase & chronometer)
+{
+  itk::MultiThreader::SetGlobalDefaultNumberOfThreads( numberOfThreads );
+  typedef itk::ImageFileReader< ImageType > ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( fileName );
+  for ( unsigned int i = 0; i < numberOfIterations; ++i )
+    {
+    reader->Modified();
+    chronometer.Start( name.c_str() );
+    reader->Update();
+    chronometer.Stop( name.c_str() );
+    }
+
+  typedef itk::Testing::ComparisonImageFilter< ImageType, ImageType > ComparisonFilterType;
+  ComparisonFilterType::Pointer comparison = ComparisonFilterType::New();
+  comparison->SetValidInput( reference );
+  comparison->SetTestInput( reader->GetOutput() );
+  comparison->Update();
+  if ( comparison->GetNumberOfPixelsWithDifferences() != 0 )
+    {
+    std::cerr << name << ": " << comparison->GetNumberOfPixelsWithDifferences()
+              << " pixels differ from the image written" << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+// Compare the time taken to read a .nii.gz file made of a single gzip
+// member, and one made of BGZF members, with one thread and with all the
+// default threads. Pass the output directory and the data size in
+// megabytes, e.g. 1024, to profile large volumes.
+int itkNiftiImageIOGzipProfileTest( int argc, char *argv[] )
+{
+  if ( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory [megabytes] [iterations]" << std::endl;
+    return EXIT_FAILURE;
+    }
+  itksys::SystemTools::ChangeDirectory( argv[1] );
+  unsigned int megabytes = 16;
+  if ( argc > 2 )
+    {
+    megabytes = atoi( argv[2] );
+    }
+  unsigned int numberOfIterations = 3;
+  if ( argc > 3 )
+    {
+    numberOfIterations = atoi( argv[3] );
+    }
+
+  // 256 x 256 slices of floats take 256 KiB each
+  ImageType::SizeType size = { { 256, 256, 4 * megabytes } };
+  ImageType::RegionType region( size );
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( region );
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, region );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType & index = it.GetIndex();
+    it.Set( static_cast< float >( ( index[0] * 7 + index[1] * 13 + index[2] * 29 ) % 101 ) );
+    }
+
+  itk::TimeProbesCollectorBase chronometer;
+
+  typedef itk::ImageFileWriter< ImageType > WriterType;
+  itk::NiftiImageIO::Pointer io = itk::NiftiImageIO::New();
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( image );
+  writer->SetImageIO( io );
+  writer->SetFileName( "gzipProfileSingle.nii.gz" );
+  chronometer.Start( "Write single member" );
+  writer->Update();
+  chronometer.Stop( "Write single member" );
+  io->UseBlockCompressionOn();
+  writer->SetFileName( "gzipProfileMembers.nii.gz" );
+  chronometer.Start( "Write BGZF members" );
+  writer->Update();
+  chronometer.Stop( "Write BGZF members" );
+
+  const itk::ThreadIdType numberOfThreads = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+  bool                    success = true;
+  success &= ProfileRead( "gzipProfileSingle.nii.gz", "Read single member, 1 thread", 1,
+                          numberOfIterations, image, chronometer );
+  success &= ProfileRead( "gzipProfileSingle.nii.gz", "Read single member, all threads", numberOfThreads,
+                          numberOfIterations, image, chronometer );
+  success &= ProfileRead( "gzipProfileMembers.nii.gz", "Read BGZF members, 1 thread", 1,
+                          numberOfIterations, image, chronometer );
+  success &= ProfileRead( "gzipProfileMembers.nii.gz", "Read BGZF members, all threads", numberOfThreads,
+                          numberOfIterations, image, chronometer );
+  itk::MultiThreader::SetGlobalDefaultNumberOfThreads( numberOfThreads );
+
+  chronometer.Report( std::cout );
+
+  if ( !success )
+    {
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,209 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkNiftiImageIOTest.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingComparisonImageFilter.h"
+#include "itkTestingMacros.h"
+#include "itksys/SystemTools.hxx"
+#include "itk_zlib.h"
+
+namespace
+{
+std::string ReadFile(const std::string & fileName)
+{
+  std::ifstream file( fileName.c_str(), std::ios::binary );
+  return std::string( std::istreambuf_iterator< char >( file ), std::istreambuf_iterator< char >() );
+}
+
+// Decompress all the members of a gzip file, as any gzip tool would
+std::string ReadGzipFile(const std::string & fileName)
+{
+  std::string data;
+  gzFile      file = gzopen( fileName.c_str(), "rb" );
+  if ( file == ITK_NULLPTR )
+    {
+    return data;
+    }
+  char buffer[4096];
+  int  count;
+  while ( ( count = gzread( file, buffer, sizeof( buffer ) ) ) > 0 )
+    {
+    data.append( buffer, count );
+    }
+  gzclose( file );
+  return data;
+}
+
+void PutLittleEndian(unsigned char *bytes, unsigned long value, unsigned int size)
+{
+  for ( unsigned int i = 0; i < size; ++i )
+    {
+    bytes[i] = static_cast< unsigned char >( ( value >> ( 8 * i ) ) & 0xff );
+    }
+}
+
+// Write data as BGZF members of memberSize bytes, which need not be a
+// multiple of the pixel size
+bool WriteGzipMembers(const std::string & fileName, const std::string & data, unsigned int memberSize)
+{
+  std::ofstream file( fileName.c_str(), std::ios::binary );
+  std::vector< unsigned char > member( memberSize + 1024 );
+  for ( size_t begin = 0; begin < data.size(); begin += memberSize )
+    {
+    const unsigned int size = static_cast< unsigned int >( std::min< size_t >( memberSize, data.size() - begin ) );
+    const unsigned char header[18] = { 0x1f, 0x8b, 8, 4, 0, 0, 0, 0, 0, 0xff, 6, 0, 'B', 'C', 2, 0, 0, 0 };
+    std::copy( header, header + 18, member.begin() );
+
+    z_stream stream;
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    if ( deflateInit2( &stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY ) != Z_OK )
+      {
+      return false;
+      }
+    stream.next_in = reinterpret_cast< Bytef * >( const_cast< char * >( data.data() + begin ) );
+    stream.avail_in = size;
+    stream.next_out = &member[18];
+    stream.avail_out = static_cast< uInt >( member.size() - 26 );
+    const int status = deflate( &stream, Z_FINISH );
+    const unsigned long compressedSize = stream.total_out;
+    deflateEnd( &stream );
+    if ( status != Z_STREAM_END )
+      {
+      return false;
+      }
+
+    const unsigned long crc = crc32( crc32( 0L, Z_NULL, 0 ),
+                                     reinterpret_cast< const Bytef * >( data.data() + begin ), size );
+    PutLittleEndian( &member[16], 18 + compressedSize + 8 - 1, 2 );
+    PutLittleEndian( &member[18 + compressedSize], crc, 4 );
+    PutLittleEndian( &member[22 + compressedSize], size, 4 );
+    file.write( reinterpret_cast< const char * >( &member[0] ), 18 + compressedSize + 8 );
+    }
+  return file.good();
+}
+}
+
+// Read NIfTI files whose data is a single gzip member, or BGZF members
+// which are decompressed in parallel, and write BGZF members.
+int itkNiftiImageIOGzipTest(int argc, char* argv[])
+{
+  if( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  itksys::SystemTools::ChangeDirectory( argv[1] );
+
+  typedef float                             PixelType;
+  typedef itk::Image< PixelType, 3 >        ImageType;
+  typedef itk::ImageFileReader< ImageType > ReaderType;
+  typedef itk::ImageFileWriter< ImageType > WriterType;
+
+  // 70 x 50 x 30 floats take 420000 bytes, which make 7 members
+  ImageType::SizeType   size = { { 70, 50, 30 } };
+  ImageType::RegionType region( size );
+  ImageType::Pointer    image = ImageType::New();
+  image->SetRegions( region );
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, region );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType & index = it.GetIndex();
+    it.Set( static_cast< PixelType >( index[0] * index[1] % 23 ) - 0.25f * index[2] );
+    }
+
+  itk::NiftiImageIO::Pointer io = itk::NiftiImageIO::New();
+  TEST_EXPECT_TRUE( !io->GetUseBlockCompression() );
+
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( image );
+  writer->SetImageIO( io );
+  writer->SetFileName( "gzipPlain.nii" );
+  TRY_EXPECT_NO_EXCEPTION( writer->Update() );
+  writer->SetFileName( "gzipSingle.nii.gz" );
+  TRY_EXPECT_NO_EXCEPTION( writer->Update() );
+  io->UseBlockCompressionOn();
+  writer->SetFileName( "gzipMembers.nii.gz" );
+  TRY_EXPECT_NO_EXCEPTION( writer->Update() );
+  std::cout << io;
+
+  // The members decompress to the uncompressed file
+  const std::string plain = ReadFile( "gzipPlain.nii" );
+  TEST_EXPECT_TRUE( ReadGzipFile( "gzipMembers.nii.gz" ) == plain );
+  TEST_EXPECT_TRUE( ReadGzipFile( "gzipSingle.nii.gz" ) == plain );
+
+  typedef itk::Testing::ComparisonImageFilter< ImageType, ImageType > ComparisonFilterType;
+  ComparisonFilterType::Pointer comparison = ComparisonFilterType::New();
+  comparison->SetValidInput( image );
+  const char *fileNames[] = { "gzipSingle.nii.gz", "gzipMembers.nii.gz" };
+  for ( unsigned int i = 0; i < 2; ++i )
+    {
+    ReaderType::Pointer reader = ReaderType::New();
+    reader->SetFileName( fileNames[i] );
+    comparison->SetTestInput( reader->GetOutput() );
+    TRY_EXPECT_NO_EXCEPTION( comparison->Update() );
+    TEST_EXPECT_EQUAL( comparison->GetNumberOfPixelsWithDifferences(), 0u );
+    }
+
+  // Big endian data in members which split pixels is swapped
+  typedef itk::Image< double, 3 > DoubleImageType;
+  if ( WriteNiftiTestFiles( "gzip" ) != EXIT_SUCCESS )
+    {
+    return EXIT_FAILURE;
+    }
+  DoubleImageType::Pointer big;
+  TRY_EXPECT_NO_EXCEPTION( big = itk::IOTestHelper::ReadImage< DoubleImageType >( "gzipNiftiBigEndian.hdr", false ) );
+  const std::string bigData = ReadFile( "gzipNiftiBigEndian.img" );
+  itksys::SystemTools::RemoveFile( "gzipNiftiBigEndian.img" );
+
+  TEST_EXPECT_TRUE( WriteGzipMembers( "gzipNiftiBigEndian.img.gz", bigData, 101 ) );
+  DoubleImageType::Pointer bigMembers;
+  TRY_EXPECT_NO_EXCEPTION( bigMembers =
+                             itk::IOTestHelper::ReadImage< DoubleImageType >( "gzipNiftiBigEndian.hdr", false ) );
+  typedef itk::Testing::ComparisonImageFilter< DoubleImageType, DoubleImageType > DoubleComparisonFilterType;
+  DoubleComparisonFilterType::Pointer doubleComparison = DoubleComparisonFilterType::New();
+  doubleComparison->SetValidInput( big );
+  doubleComparison->SetTestInput( bigMembers );
+  TRY_EXPECT_NO_EXCEPTION( doubleComparison->Update() );
+  TEST_EXPECT_EQUAL( doubleComparison->GetNumberOfPixelsWithDifferences(), 0u );
+
+  gzFile gzipFile = gzopen( "gzipNiftiBigEndian.img.gz", "wb" );
+  TEST_EXPECT_TRUE( gzipFile != ITK_NULLPTR );
+  gzwrite( gzipFile, bigData.data(), static_cast< unsigned int >( bigData.size() ) );
+  gzclose( gzipFile );
+  DoubleImageType::Pointer bigSingle;
+  TRY_EXPECT_NO_EXCEPTION( bigSingle =
+                             itk::IOTestHelper::ReadImage< DoubleImageType >( "gzipNiftiBigEndian.hdr", false ) );
+  doubleComparison->SetTestInput( bigSingle );
+  TRY_EXPECT_NO_EXCEPTION( doubleComparison->Update() );
+  TEST_EXPECT_EQUAL( doubleComparison->GetNumberOfPixelsWithDifferences(), 0u );
+
+  // A truncated member is an error
+  const std::string members = ReadFile( "gzipMembers.nii.gz" );
+  std::ofstream truncated( "gzipTruncated.nii.gz", std::ios::binary );
+  truncated.write( members.data(), members.size() - 1000 );
+  truncated.close();
+  ReaderType::Pointer truncatedReader = ReaderType::New();
+  truncatedReader->SetFileName( "gzipTruncated.nii.gz" );
+  TRY_EXPECT_EXCEPTION( truncatedReader->Update() );
+
+  return EXIT_SUCCESS;
+}
@@ -19,7 +19,7 @@
 #define __itkNrrdImageIO_h
 
 
-#include "itkImageIOBase.h"
+#include "itkStreamingImageIOBase.h"
 #include <fstream>
 
 namespace itk
@@ -30,22 +30,27 @@ namespace itk
  * The Nrrd format was developed as part of the Teem package
  * (teem.sourceforge.net).
  *
+ * Raw data in the native byte order, attached to the header or in a
+ * single detached data file, can be read and written in pieces, which
+ * lets ImageFileReader and ImageFileWriter stream such files. Other
+ * encodings are always read and written whole.
+ *
  *  \ingroup IOFilters
  * \ingroup ITKIONRRD
  */
-class NrrdImageIO:public ImageIOBase
+class NrrdImageIO:public StreamingImageIOBase
 {
 public:
   /** Standard class typedefs. */
   typedef NrrdImageIO          Self;
-  typedef ImageIOBase          Superclass;
+  typedef StreamingImageIOBase Superclass;
   typedef SmartPointer< Self > Pointer;
 
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
 
   /** Run-time type information (and related methods). */
-  itkTypeMacro(NrrdImageIO, ImageIOBase);
+  itkTypeMacro(NrrdImageIO, StreamingImageIOBase);
 
   /** The different types of ImageIO's can support data of varying
    * dimensionality. For example, some file formats are strictly 2D
@@ -75,6 +80,18 @@ public:
    * that the IORegions has been set properly. */
   virtual void Write(const void *buffer) ITK_OVERRIDE;
 
+  /** The data can be read in pieces when it is raw data in the native
+   * byte order, in a single file. Valid after ReadImageInformation(). */
+  virtual bool CanStreamRead() ITK_OVERRIDE;
+
+  /** Pieces can be written when neither compression nor ASCII encoding
+   * is requested, and the byte order is the native one. */
+  virtual bool CanStreamWrite() ITK_OVERRIDE;
+
+  /** Raw data in the native byte order, in a single file, can be
+   * mapped. */
+  virtual bool CanMapIORegion(std::string & fileName, SizeType & offset) ITK_OVERRIDE;
+
 protected:
   NrrdImageIO();
   ~NrrdImageIO();
@@ -86,7 +103,19 @@ protected:
 
   ImageIOBase::IOComponentType NrrdToITKComponentType(const int) const;
 
+  /** Offset of the data in the data file. */
+  virtual SizeType GetHeaderSize() const ITK_OVERRIDE;
+
 private:
+  /** Write one piece of the image in the data file, which is created
+   * along with the header for the first piece. */
+  void WritePiece(const void *buffer, bool createDataFile);
+
+  /** File holding the raw data and where it starts in that file, empty
+   * when the data cannot be read in pieces. */
+  std::string m_StreamedDataFileName;
+  SizeType    m_StreamedDataOffset;
+
   NrrdImageIO(const Self &);    //purposely not implemented
   void operator=(const Self &); //purposely not implemented
 };
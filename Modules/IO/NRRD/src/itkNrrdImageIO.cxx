@@ -22,12 +22,53 @@
 #include "itkMetaDataObject.h"
 #include "itkIOCommon.h"
 #include "itkFloatingPointExceptions.h"
+#include "itkByteSwapper.h"
+#include "itksys/SystemTools.hxx"
 
 namespace itk
 {
 #define KEY_PREFIX "NRRD_"
 
-NrrdImageIO::NrrdImageIO()
+namespace
+{
+// Name of the file holding all the data of a nrrd, built the way
+// nrrdIoStateDataFileIterNext() does: the header file itself when the
+// data is attached, or the detached data file, relative to the header.
+// Empty when the data is split in several files.
+std::string NrrdDataFileName(const NrrdIoState *nio, const std::string & headerFileName)
+{
+  if ( nio->dataFNFormat || nio->dataFNArr->len > 1 )
+    {
+    return std::string();
+    }
+  if ( nio->dataFNArr->len == 0 )
+    {
+    return headerFileName;
+    }
+  std::string dataFileName = nio->dataFN[0];
+  if ( !itksys::SystemTools::FileIsFullPath( dataFileName.c_str() ) && airStrlen(nio->path) )
+    {
+    dataFileName = std::string(nio->path) + "/" + dataFileName;
+    }
+  return dataFileName;
+}
+
+template< typename T >
+void SwapRangeFromFileByteOrder(void *buffer, SizeValueType numberOfComponents, bool bigEndian)
+{
+  if ( bigEndian )
+    {
+    ByteSwapper< T >::SwapRangeFromSystemToBigEndian(static_cast< T * >( buffer ), numberOfComponents);
+    }
+  else
+    {
+    ByteSwapper< T >::SwapRangeFromSystemToLittleEndian(static_cast< T * >( buffer ), numberOfComponents);
+    }
+}
+}
+
+NrrdImageIO::NrrdImageIO():
+  m_StreamedDataOffset(0)
 {
   this->SetNumberOfDimensions(3);
   this->AddSupportedWriteExtension(".nrrd");
@@ -242,6 +283,8 @@ void NrrdImageIO::ReadImageInformation()
     // this is the mechanism by which we tell nrrdLoad to read
     // just the header, and none of the data
     nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+    // and to keep the data file open, to know where the data starts
+    nrrdIoStateSet(nio, nrrdIoStateKeepNrrdDataFileOpen, 1);
     if ( nrrdLoad(nrrd, this->GetFileName(), nio) != 0 )
       {
       char *err = biffGetDone(NRRD);
@@ -258,6 +301,20 @@ void NrrdImageIO::ReadImageInformation()
     // restore state
     FloatingPointExceptions::SetEnabled(saveFPEState);
 
+    // Raw data in a single file can be read in pieces, straight from
+    // where it starts
+    m_StreamedDataFileName = "";
+    m_StreamedDataOffset = 0;
+    if ( nio->dataFile )
+      {
+      if ( nio->encoding == nrrdEncodingRaw )
+        {
+        m_StreamedDataFileName = NrrdDataFileName( nio, this->GetFileName() );
+        m_StreamedDataOffset = static_cast< SizeType >( ftell(nio->dataFile) );
+        }
+      nio->dataFile = airFclose(nio->dataFile);
+      }
+
     if ( nrrdTypeBlock == nrrd->type )
       {
       itkExceptionMacro("ReadImageInformation: Cannot currently "
@@ -321,6 +378,12 @@ void NrrdImageIO::ReadImageInformation()
       this->SetNumberOfDimensions(nrrd->dim - 1);
       unsigned int kind = nrrd->axis[rangeAxisIdx[0]].kind;
       unsigned int size = nrrd->axis[rangeAxisIdx[0]].size;
+      // the components of a pixel must be next to each other in the file,
+      // and all of them read, to read the data in pieces
+      if ( 0 != rangeAxisIdx[0] || nrrdKind3DMaskedSymMatrix == kind )
+        {
+        m_StreamedDataFileName = "";
+        }
       // NOTE: it is the NRRD readers responsibility to make sure that
       // the size (#of components) associated with a specific kind is
       // matches the actual size of the axis.
@@ -696,6 +759,40 @@ void NrrdImageIO::ReadImageInformation()
 
 void NrrdImageIO::Read(void *buffer)
 {
+  if ( this->RequestedToStream() )
+    {
+    itkAssertOrThrowMacro(this->CanStreamRead(), "Can only stream raw data in a single file");
+
+    // read the piece straight from the data file
+    std::ifstream file;
+    this->OpenFileForReading(file, m_StreamedDataFileName);
+    if ( !this->StreamReadBufferAsBinary(file, buffer) )
+      {
+      itkExceptionMacro("Read: Error reading " << m_StreamedDataFileName);
+      }
+
+    const bool bigEndian = this->GetByteOrder() == BigEndian;
+    const SizeValueType numberOfComponents =
+      m_IORegion.GetNumberOfPixels() * this->GetNumberOfComponents();
+    switch ( this->GetComponentSize() )
+      {
+      case 1:
+        break;
+      case 2:
+        SwapRangeFromFileByteOrder< uint16_t >(buffer, numberOfComponents, bigEndian);
+        break;
+      case 4:
+        SwapRangeFromFileByteOrder< uint32_t >(buffer, numberOfComponents, bigEndian);
+        break;
+      case 8:
+        SwapRangeFromFileByteOrder< uint64_t >(buffer, numberOfComponents, bigEndian);
+        break;
+      default:
+        itkExceptionMacro(<< "Unknown component size" << this->GetComponentSize());
+      }
+    return;
+    }
+
   Nrrd *       nrrd = nrrdNew();
   bool         nrrdAllocated;
 
@@ -859,8 +956,93 @@ void NrrdImageIO::WriteImageInformation(void)
   // Nothing needs doing here.
 }
 
+bool NrrdImageIO::CanStreamRead()
+{
+  return !m_StreamedDataFileName.empty();
+}
+
+bool NrrdImageIO::CanStreamWrite()
+{
+  const ByteOrder nativeByteOrder =
+    ByteSwapper< uint16_t >::SystemIsBigEndian() ? BigEndian : LittleEndian;
+
+  return !this->GetUseCompression()
+         && this->GetFileType() != ASCII
+         && ( this->GetByteOrder() == OrderNotApplicable || this->GetByteOrder() == nativeByteOrder );
+}
+
+bool NrrdImageIO::CanMapIORegion(std::string & fileName, SizeType & offset)
+{
+  const ByteOrder nativeByteOrder =
+    ByteSwapper< uint16_t >::SystemIsBigEndian() ? BigEndian : LittleEndian;
+
+  SizeType regionOffset;
+  if ( m_StreamedDataFileName.empty()
+       || ( this->GetByteOrder() != OrderNotApplicable && this->GetByteOrder() != nativeByteOrder )
+       || !this->GetContiguousIORegionOffset(regionOffset) )
+    {
+    return false;
+    }
+  fileName = m_StreamedDataFileName;
+  offset = m_StreamedDataOffset + regionOffset;
+  return true;
+}
+
+NrrdImageIO::SizeType NrrdImageIO::GetHeaderSize() const
+{
+  return m_StreamedDataOffset;
+}
+
+void NrrdImageIO::WritePiece(const void *buffer, bool createDataFile)
+{
+  // find the data file and where the data starts in it from the header
+  Self::Pointer headerImageIO = Self::New();
+  headerImageIO->SetFileName( this->GetFileName() );
+  headerImageIO->ReadImageInformation();
+
+  const ByteOrder nativeByteOrder =
+    ByteSwapper< uint16_t >::SystemIsBigEndian() ? BigEndian : LittleEndian;
+  if ( headerImageIO->m_StreamedDataFileName.empty()
+       || ( this->GetComponentSize() > 1 && headerImageIO->GetByteOrder() != nativeByteOrder ) )
+    {
+    itkExceptionMacro("Write: Cannot paste into " << this->GetFileName()
+                      << ", its data is not raw data in the native byte order in a single file");
+    }
+  m_StreamedDataFileName = headerImageIO->m_StreamedDataFileName;
+  m_StreamedDataOffset = headerImageIO->m_StreamedDataOffset;
+
+  std::ofstream file;
+  this->OpenFileForWriting(file, m_StreamedDataFileName, false);
+
+  if ( createDataFile )
+    {
+    // write the last byte of the data to allocate it (which does not
+    // write the entire size of the data if the system supports sparse
+    // files)
+    std::streampos seekPos = m_StreamedDataOffset + this->GetImageSizeInBytes() - 1;
+    file.seekp(seekPos, std::ios::beg);
+    file.write("\0", 1);
+    }
+
+  if ( !this->StreamWriteBufferAsBinary(file, buffer) )
+    {
+    itkExceptionMacro("Write: Error writing " << m_StreamedDataFileName);
+    }
+}
+
 void NrrdImageIO::Write(const void *buffer)
 {
+  // When writing a piece of the image in an existing file, the header
+  // is already there: we assume that GetActualNumberOfSplitsForWriting
+  // is called before this method and removes the file if a new header
+  // needs to be written
+  const bool writePiece = this->RequestedToStream();
+  if ( writePiece && itksys::SystemTools::FileExists( this->GetFileName() ) )
+    {
+    this->WritePiece(buffer, false);
+    return;
+    }
+
   Nrrd *       nrrd = nrrdNew();
   NrrdIoState *nio = nrrdIoStateNew();
   int          kind[NRRD_DIM_MAX];
@@ -1110,6 +1292,12 @@ void NrrdImageIO::Write(const void *buffer)
       break;
     }
 
+  // the pieces of the data are written after the header
+  if ( writePiece )
+    {
+    nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+    }
+
   // Write the nrrd to file.
   if ( nrrdSave(this->GetFileName(), nrrd, nio) )
     {
@@ -1118,9 +1306,22 @@ void NrrdImageIO::Write(const void *buffer)
                       << this->GetFileName() << ":\n" << err);
     }
 
+  const std::string dataFileName = NrrdDataFileName( nio, this->GetFileName() );
+
   // Free the nrrd struct but don't touch nrrd->data
   nrrdNix(nrrd);
   nrrdIoStateNix(nio);
+
+  if ( writePiece )
+    {
+    if ( dataFileName != this->GetFileName() )
+      {
+      // create the detached data file, which the header refers to
+      std::ofstream file;
+      this->OpenFileForWriting(file, dataFileName, true);
+      }
+    this->WritePiece(buffer, true);
+    }
 }
 
 } // end namespace itk
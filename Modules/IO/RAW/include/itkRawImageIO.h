@@ -106,6 +106,9 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   virtual void Read(void *buffer) ITK_OVERRIDE;
 
+  /** Binary data in the native byte order can be mapped. */
+  virtual bool CanMapIORegion(std::string & fileName, SizeType & offset) ITK_OVERRIDE;
+
   /** Set/Get the Data mask. */
   itkGetConstReferenceMacro(ImageMask, unsigned short);
   void SetImageMask(unsigned long val)
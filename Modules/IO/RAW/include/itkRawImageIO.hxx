@@ -175,6 +175,26 @@ void RawImageIO< TPixel, VImageDimension >
   else if itkReadRawBytesAfterSwappingMacro(double, DOUBLE)
 }
 
+template< typename TPixel, unsigned int VImageDimension >
+bool RawImageIO< TPixel, VImageDimension >
+::CanMapIORegion(std::string & fileName, SizeType & offset)
+{
+  const ByteOrder nativeByteOrder =
+    ByteSwapperType::SystemIsBigEndian() ? BigEndian : LittleEndian;
+
+  SizeType regionOffset;
+  if ( m_FileType != Binary
+       || ( this->GetComponentSize() > 1
+            && m_ByteOrder != OrderNotApplicable && m_ByteOrder != nativeByteOrder )
+       || !this->GetContiguousIORegionOffset(regionOffset) )
+    {
+    return false;
+    }
+  fileName = m_FileName;
+  offset = static_cast< SizeType >( this->GetHeaderSize() ) + regionOffset;
+  return true;
+}
+
 template< typename TPixel, unsigned int VImageDimension >
 bool RawImageIO< TPixel, VImageDimension >
 ::CanWriteFile(const char *fname)
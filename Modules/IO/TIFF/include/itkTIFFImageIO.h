@@ -19,6 +19,7 @@
 #define __itkTIFFImageIO_h
 
 #include "itkImageIOBase.h"
+#include "itkThreadSupport.h"
 #include <fstream>
 
 namespace itk
@@ -31,6 +32,12 @@ class TIFFReaderInternal;
  *
  * \brief ImageIO object for reading and writing TIFF images
  *
+ * A tiled TIFF file of a single image is read as a 2D image, of which only
+ * the tiles intersecting the requested region are decoded, in parallel.
+ * The reader can stream such files, so that a small region of a very large
+ * image can be read without decoding the rest of it. Images are written in
+ * strips, unless TileWidth and TileHeight are set.
+ *
  * \ingroup IOFilters
  *
  * \ingroup ITKIOTIFF
@@ -68,9 +75,18 @@ public:
   /** Reads 3D data from multi-pages tiff. */
   virtual void ReadVolume(void *buffer);
 
-  /** Reads 3D data from tiled tiff. */
+  /** Reads the tiles of a tiled tiff which intersect the IORegion, in
+   * parallel. */
   virtual void ReadTiles(void *buffer);
 
+  /** Determine if the ImageIO can stream reading from the file read by
+   * ReadImageInformation(): true if it is a single tiled image. */
+  virtual bool CanStreamRead() ITK_OVERRIDE;
+
+  /** Returns the requested region if streamed reading is enabled and the
+   * file can be streamed, the whole image otherwise. */
+  virtual ImageIORegion GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requested) const ITK_OVERRIDE;
+
   /*-------- This part of the interfaces deals with writing data. ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -130,6 +146,13 @@ public:
   itkSetClampMacro(JPEGQuality, int, 1, 100);
   itkGetConstMacro(JPEGQuality, int);
 
+  /** Set/Get the size in pixels of the tiles of the images written. Both
+   * must be multiples of 16. The default 0 writes strips instead. */
+  itkSetMacro(TileWidth, unsigned int);
+  itkGetConstMacro(TileWidth, unsigned int);
+  itkSetMacro(TileHeight, unsigned int);
+  itkGetConstMacro(TileHeight, unsigned int);
+
 protected:
   TIFFImageIO();
   ~TIFFImageIO();
@@ -166,10 +189,20 @@ protected:
   int m_Compression;
   int m_JPEGQuality;
 
+  unsigned int m_TileWidth;
+  unsigned int m_TileHeight;
+
 private:
   TIFFImageIO(const Self &);    //purposely not implemented
   void operator=(const Self &); //purposely not implemented
 
+  /** Copies the part of the decoded tile at (x, y) in the file which is
+   * inside the IORegion to the buffer. */
+  void CopyTile(const unsigned char *tile, unsigned int x, unsigned int y, void *buffer);
+
+  struct ReadTilesThreadStruct;
+  static ITK_THREAD_RETURN_TYPE ReadTilesThreaderCallback(void *arg);
+
   unsigned short *m_ColorRed;
   unsigned short *m_ColorGreen;
   unsigned short *m_ColorBlue;
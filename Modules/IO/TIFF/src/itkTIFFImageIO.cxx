@@ -17,9 +17,14 @@
  *=========================================================================*/
 
 #include "itkTIFFImageIO.h"
+#include "itkMultiThreader.h"
+#include "itkSimpleFastMutexLock.h"
 #include "itksys/SystemTools.hxx"
 
 #include <sys/stat.h>
+#include <algorithm>
+#include <sstream>
+#include <vector>
 
 #include "itk_tiff.h"
 
@@ -181,24 +186,6 @@ int TIFFReaderInternal::Initialize()
         }
       }
 
-    // If the number of pages is still zero we look if the image is tiled
-    if ( this->m_NumberOfPages == 0 && TIFFIsTiled(this->m_Image) )
-      {
-      this->m_NumberOfTiles = TIFFNumberOfTiles(this->m_Image);
-
-      if ( !TIFFGetField(this->m_Image, TIFFTAG_TILEWIDTH, &this->m_TileWidth)
-           || !TIFFGetField(this->m_Image, TIFFTAG_TILELENGTH, &this->m_TileHeight) )
-        {
-        itkGenericExceptionMacro(
-          << "Cannot read tile width and tile length from file");
-        }
-      else
-        {
-        this->m_TileRows = this->m_Height / this->m_TileHeight;
-        this->m_TileColumns = this->m_Width / this->m_TileWidth;
-        }
-      }
-
     // Checking if the TIFF contains subfiles
     if ( this->m_NumberOfPages > 1 )
       {
@@ -229,6 +216,25 @@ int TIFFReaderInternal::Initialize()
       TIFFSetDirectory(this->m_Image, 0);
       }
 
+    // Check if the first image is tiled
+    if ( TIFFIsTiled(this->m_Image) )
+      {
+      this->m_NumberOfTiles = TIFFNumberOfTiles(this->m_Image);
+
+      if ( !TIFFGetField(this->m_Image, TIFFTAG_TILEWIDTH, &this->m_TileWidth)
+           || !TIFFGetField(this->m_Image, TIFFTAG_TILELENGTH, &this->m_TileHeight) )
+        {
+        itkGenericExceptionMacro(
+          << "Cannot read tile width and tile length from file");
+        }
+      else
+        {
+        // The tiles of the last row and column may go past the image
+        this->m_TileRows = ( this->m_Height + this->m_TileHeight - 1 ) / this->m_TileHeight;
+        this->m_TileColumns = ( this->m_Width + this->m_TileWidth - 1 ) / this->m_TileWidth;
+        }
+      }
+
     TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_ORIENTATION,
                           &this->m_Orientation);
     TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_SAMPLESPERPIXEL,
@@ -1072,37 +1078,161 @@ unsigned int TIFFImageIO::GetFormat()
   return m_ImageFormat;
 }
 
-/** Read a tiled tiff */
+struct TIFFImageIO::ReadTilesThreadStruct
+{
+  TIFFImageIO *                               IO;
+  void *                                      Buffer;
+  std::vector< std::pair< uint32, uint32 > >  Tiles;
+  SimpleFastMutexLock                         Mutex;
+  size_t                                      NextTile;
+  bool                                        Failed;
+  std::string                                 ErrorMessage;
+};
+
+/** Read the tiles of a tiled tiff which intersect the IORegion */
 void TIFFImageIO::ReadTiles(void *buffer)
 {
-  unsigned char *volume = reinterpret_cast< unsigned char * >( buffer );
+  const uint32 width = m_InternalImage->m_Width;
+  const uint32 height = m_InternalImage->m_Height;
+  const uint32 tileWidth = m_InternalImage->m_TileWidth;
+  const uint32 tileHeight = m_InternalImage->m_TileHeight;
+
+  // The rows of the IORegion in the file, which are upside down unless
+  // the orientation is top left
+  const uint32 xBegin = static_cast< uint32 >( m_IORegion.GetIndex(0) );
+  const uint32 xEnd = xBegin + static_cast< uint32 >( m_IORegion.GetSize(0) );
+  uint32       yBegin = static_cast< uint32 >( m_IORegion.GetIndex(1) );
+  uint32       yEnd = yBegin + static_cast< uint32 >( m_IORegion.GetSize(1) );
+  if ( m_InternalImage->m_Orientation != ORIENTATION_TOPLEFT )
+    {
+    const uint32 imageYBegin = yBegin;
+    yBegin = height - yEnd;
+    yEnd = height - imageYBegin;
+    }
+  if ( xEnd > width || yEnd > height )
+    {
+    itkExceptionMacro(<< "The region to read is outside of the image");
+    }
 
-  for ( unsigned int col = 0; col < m_InternalImage->m_Width; col += m_InternalImage->m_TileWidth )
+  ReadTilesThreadStruct str;
+  str.IO = this;
+  str.Buffer = buffer;
+  str.NextTile = 0;
+  str.Failed = false;
+  for ( uint32 y = yBegin - yBegin % tileHeight; y < yEnd; y += tileHeight )
     {
-    for ( unsigned int row = 0; row < m_InternalImage->m_Height; row += m_InternalImage->m_TileHeight )
+    for ( uint32 x = xBegin - xBegin % tileWidth; x < xEnd; x += tileWidth )
       {
-      unsigned char *tempImage;
-      tempImage =
-        new unsigned char[m_InternalImage->m_TileWidth * m_InternalImage->m_TileHeight
-                          * m_InternalImage->m_SamplesPerPixel];
+      str.Tiles.push_back( std::make_pair(x, y) );
+      }
+    }
+  if ( str.Tiles.empty() )
+    {
+    return;
+    }
 
-      if ( TIFFReadTile(m_InternalImage->m_Image, tempImage, col, row, 0, 0) < 0 )
-        {
-        itkExceptionMacro(<< "Cannot read tile : " << row << "," << col << " from file");
-        }
+  // The format and the colormap are read before the threads use them
+  this->InitializeColors();
+  this->GetFormat();
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads( std::min( threader->GetNumberOfThreads(),
+                                          static_cast< ThreadIdType >( str.Tiles.size() ) ) );
+  threader->SetSingleMethod(Self::ReadTilesThreaderCallback, &str);
+  threader->SingleMethodExecute();
 
-      unsigned int xx, yy;
-      for ( yy = 0; yy < m_InternalImage->m_TileHeight; yy++ )
+  if ( str.Failed )
+    {
+    itkExceptionMacro(<< str.ErrorMessage);
+    }
+}
+
+ITK_THREAD_RETURN_TYPE TIFFImageIO::ReadTilesThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  ReadTilesThreadStruct *          str = static_cast< ReadTilesThreadStruct * >( info->UserData );
+
+  // A TIFF handle can only be used by one thread at a time
+  TIFF *tif = TIFFOpen(str->IO->m_FileName.c_str(), "r");
+  if ( !tif )
+    {
+    str->Mutex.Lock();
+    if ( !str->Failed )
+      {
+      str->Failed = true;
+      str->ErrorMessage = "Cannot open file " + str->IO->m_FileName;
+      }
+    str->Mutex.Unlock();
+    return ITK_THREAD_RETURN_VALUE;
+    }
+
+  std::vector< unsigned char > tile( TIFFTileSize(tif) );
+  while ( true )
+    {
+    str->Mutex.Lock();
+    const size_t t = str->NextTile++;
+    const bool   done = str->Failed || t >= str->Tiles.size();
+    str->Mutex.Unlock();
+    if ( done )
+      {
+      break;
+      }
+
+    const uint32 x = str->Tiles[t].first;
+    const uint32 y = str->Tiles[t].second;
+    if ( TIFFReadTile(tif, &tile[0], x, y, 0, 0) < 0 )
+      {
+      std::ostringstream message;
+      message << "Cannot read tile : " << y << "," << x << " from file";
+      str->Mutex.Lock();
+      if ( !str->Failed )
         {
-        for ( xx = 0; xx <  m_InternalImage->m_TileWidth; xx++ )
-          {
-          for ( unsigned int i = 0; i < m_InternalImage->m_SamplesPerPixel; i++ )
-            {
-            *volume = *( tempImage++ );
-            volume++;
-            }
-          }
+        str->Failed = true;
+        str->ErrorMessage = message.str();
         }
+      str->Mutex.Unlock();
+      break;
+      }
+    str->IO->CopyTile(&tile[0], x, y, str->Buffer);
+    }
+
+  TIFFClose(tif);
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void TIFFImageIO::CopyTile(const unsigned char *tile, unsigned int x, unsigned int y, void *buffer)
+{
+  const uint32 height = m_InternalImage->m_Height;
+  const uint32 tileWidth = m_InternalImage->m_TileWidth;
+  const uint32 tileHeight = m_InternalImage->m_TileHeight;
+  const bool   topLeft = m_InternalImage->m_Orientation == ORIENTATION_TOPLEFT;
+
+  const size_t inPixelSize = m_InternalImage->m_SamplesPerPixel * ( m_InternalImage->m_BitsPerSample / 8 );
+  const size_t outPixelSize = this->GetNumberOfComponents() * this->GetComponentSize();
+
+  const uint32 regionX = static_cast< uint32 >( m_IORegion.GetIndex(0) );
+  const uint32 regionY = static_cast< uint32 >( m_IORegion.GetIndex(1) );
+  const uint32 regionWidth = static_cast< uint32 >( m_IORegion.GetSize(0) );
+  const uint32 regionHeight = static_cast< uint32 >( m_IORegion.GetSize(1) );
+
+  const uint32 xBegin = std::max(x, regionX);
+  const uint32 xEnd = std::min(x + tileWidth, regionX + regionWidth);
+  for ( uint32 row = y; row < y + tileHeight && row < height; ++row )
+    {
+    const uint32 imageRow = topLeft ? row : height - row - 1;
+    if ( imageRow < regionY || imageRow >= regionY + regionHeight )
+      {
+      continue;
+      }
+    const unsigned char *in = tile + ( static_cast< size_t >( row - y ) * tileWidth + ( xBegin - x ) ) * inPixelSize;
+    unsigned char *      out = static_cast< unsigned char * >( buffer )
+                               + ( static_cast< size_t >( imageRow - regionY ) * regionWidth + ( xBegin - regionX ) )
+                               * outPixelSize;
+    for ( uint32 col = xBegin; col < xEnd; ++col )
+      {
+      this->EvaluateImageAt( out, const_cast< unsigned char * >( in ) );
+      in += inPixelSize;
+      out += outPixelSize;
       }
     }
 }
@@ -1373,18 +1503,28 @@ void TIFFImageIO::Read(void *buffer)
     itkExceptionMacro(<< "This reader cannot read old JPEG compression");
     }
 
-  // The IO region should be of dimensions 3 otherwise we read only the first
-  // page
-  if ( m_InternalImage->m_NumberOfPages > 0 && this->GetIORegion().GetImageDimension() > 2 )
+  // A single tiled image is read one tile at a time, as libtiff cannot
+  // read its scanlines
+  if ( this->CanStreamRead() )
     {
-    this->ReadVolume(buffer);
+    try
+      {
+      this->ReadTiles(buffer);
+      }
+    catch ( ... )
+      {
+      m_InternalImage->Clean();
+      throw;
+      }
     m_InternalImage->Clean();
     return;
     }
 
-  if ( m_InternalImage->m_NumberOfTiles > 0 && this->GetIORegion().GetImageDimension() > 2 )
+  // The IO region should be of dimensions 3 otherwise we read only the first
+  // page
+  if ( m_InternalImage->m_NumberOfPages > 0 && this->GetIORegion().GetImageDimension() > 2 )
     {
-    this->ReadTiles(buffer);
+    this->ReadVolume(buffer);
     m_InternalImage->Clean();
     return;
     }
@@ -1474,6 +1614,9 @@ TIFFImageIO::TIFFImageIO()
   m_Compression = TIFFImageIO::PackBits;
   m_JPEGQuality = 75;
 
+  m_TileWidth = 0;
+  m_TileHeight = 0;
+
   this->AddSupportedWriteExtension(".tif");
   this->AddSupportedWriteExtension(".TIF");
   this->AddSupportedWriteExtension(".tiff");
@@ -1496,6 +1639,27 @@ void TIFFImageIO::PrintSelf(std::ostream & os, Indent indent) const
   Superclass::PrintSelf(os, indent);
   os << indent << "Compression: " << m_Compression << "\n";
   os << indent << "JPEGQuality: " << m_JPEGQuality << "\n";
+  os << indent << "TileWidth: " << m_TileWidth << "\n";
+  os << indent << "TileHeight: " << m_TileHeight << "\n";
+}
+
+bool TIFFImageIO::CanStreamRead()
+{
+  // Zeiss images, which have 2 samples per pixel, are read as RGB images
+  return m_InternalImage->m_NumberOfTiles > 0
+         && m_NumberOfDimensions == 2
+         && m_InternalImage->CanRead()
+         && m_InternalImage->m_SamplesPerPixel != 2;
+}
+
+ImageIORegion
+TIFFImageIO::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requested) const
+{
+  if ( !m_UseStreamedReading || !const_cast< TIFFImageIO * >( this )->CanStreamRead() )
+    {
+    return Superclass::GenerateStreamableReadRegionFromRequestedRegion(requested);
+    }
+  return requested;
 }
 
 void TIFFImageIO::InitializeColors()
@@ -1629,17 +1793,6 @@ void TIFFImageIO::ReadImageInformation()
     m_Spacing[2] = 1.0;
     m_Origin[2] = 0.0;
     }
-
-  // if the tiff is tiled
-  if ( m_InternalImage->m_NumberOfTiles > 1 )
-    {
-    this->SetNumberOfDimensions(3);
-    m_Dimensions[0] = m_InternalImage->m_TileWidth;
-    m_Dimensions[1] = m_InternalImage->m_TileHeight;
-    m_Dimensions[2] = m_InternalImage->m_NumberOfTiles;
-    m_Spacing[2] = 1.0;
-    m_Origin[2] = 0.0;
-    }
 }
 
 bool TIFFImageIO::CanWriteFile(const char *name)
@@ -1741,6 +1894,13 @@ void TIFFImageIO::InternalWrite(const void *buffer)
         << "TIFF supports unsigned/signed char, unsigned/signed short, and float");
     }
 
+  const bool tiled = m_TileWidth > 0 || m_TileHeight > 0;
+  if ( tiled && ( m_TileWidth == 0 || m_TileHeight == 0 || m_TileWidth % 16 || m_TileHeight % 16 ) )
+    {
+    itkExceptionMacro(<< "TileWidth and TileHeight must be multiples of 16, not "
+                      << m_TileWidth << " and " << m_TileHeight);
+    }
+
   uint16_t predictor;
 
   const char *mode = "w";
@@ -1881,24 +2041,32 @@ void TIFFImageIO::InternalWrite(const void *buffer)
     // Using 1 MB per strip leads to 256 rows per strip, which takes only 4 seconds to write over sshfs.
     // Rather than change that value in the third party libtiff library, we instead compute the
     // rowsperstrip here to lead to this same value.
-#ifdef TIFF_INT64_T // detect if libtiff4
-    uint64_t scanlinesize=TIFFScanlineSize64(tif);
-#else
-    tsize_t scanlinesize=TIFFScanlineSize(tif);
-#endif
-    if (scanlinesize == 0)
+    if ( tiled )
       {
-      itkExceptionMacro("TIFFScanlineSize returned 0");
+      TIFFSetField(tif, TIFFTAG_TILEWIDTH, m_TileWidth);
+      TIFFSetField(tif, TIFFTAG_TILELENGTH, m_TileHeight);
       }
-    rowsperstrip = (uint32_t)(1024*1024 / scanlinesize );
-    if ( rowsperstrip < 1 )
+    else
       {
-      rowsperstrip = 1;
-      }
+#ifdef TIFF_INT64_T // detect if libtiff4
+      uint64_t scanlinesize=TIFFScanlineSize64(tif);
+#else
+      tsize_t scanlinesize=TIFFScanlineSize(tif);
+#endif
+      if (scanlinesize == 0)
+        {
+        itkExceptionMacro("TIFFScanlineSize returned 0");
+        }
+      rowsperstrip = (uint32_t)(1024*1024 / scanlinesize );
+      if ( rowsperstrip < 1 )
+        {
+        rowsperstrip = 1;
+        }
 
-    TIFFSetField( tif,
-                  TIFFTAG_ROWSPERSTRIP,
-                  TIFFDefaultStripSize(tif, rowsperstrip) );
+      TIFFSetField( tif,
+                    TIFFTAG_ROWSPERSTRIP,
+                    TIFFDefaultStripSize(tif, rowsperstrip) );
+      }
 
     if ( resolution_x > 0 && resolution_y > 0 )
       {
@@ -1941,15 +2109,46 @@ void TIFFImageIO::InternalWrite(const void *buffer)
     rowLength *= this->GetNumberOfComponents();
     rowLength *= width;
 
-    int row = 0;
-    for ( unsigned int idx2 = 0; idx2 < height; idx2++ )
+    if ( tiled )
       {
-      if ( TIFFWriteScanline(tif, const_cast< char * >( outPtr ), row, 0) < 0 )
+      // The tiles of the last row and column are padded with zeros
+      const size_t        pixelSize = rowLength / width;
+      std::vector< char > tile( static_cast< size_t >( m_TileWidth ) * m_TileHeight * pixelSize );
+      for ( uint32 y = 0; y < h; y += m_TileHeight )
         {
-        itkExceptionMacro(<< "TIFFImageIO: error out of disk space");
+        for ( uint32 x = 0; x < w; x += m_TileWidth )
+          {
+          const uint32 tileWidth = std::min(m_TileWidth, w - x);
+          const uint32 tileHeight = std::min(m_TileHeight, h - y);
+          if ( tileWidth < m_TileWidth || tileHeight < m_TileHeight )
+            {
+            std::fill(tile.begin(), tile.end(), 0);
+            }
+          for ( uint32 row = 0; row < tileHeight; ++row )
+            {
+            const char *in = outPtr + ( static_cast< size_t >( y + row ) * w + x ) * pixelSize;
+            std::copy( in, in + tileWidth * pixelSize, &tile[0] + row * m_TileWidth * pixelSize );
+            }
+          if ( TIFFWriteTile(tif, &tile[0], x, y, 0, 0) < 0 )
+            {
+            itkExceptionMacro(<< "TIFFImageIO: error out of disk space");
+            }
+          }
+        }
+      outPtr += rowLength * height;
+      }
+    else
+      {
+      int row = 0;
+      for ( unsigned int idx2 = 0; idx2 < height; idx2++ )
+        {
+        if ( TIFFWriteScanline(tif, const_cast< char * >( outPtr ), row, 0) < 0 )
+          {
+          itkExceptionMacro(<< "TIFFImageIO: error out of disk space");
+          }
+        outPtr += rowLength;
+        ++row;
         }
-      outPtr += rowLength;
-      ++row;
       }
 
     if ( m_NumberOfDimensions == 3 )
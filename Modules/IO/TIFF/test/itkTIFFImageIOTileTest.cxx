@@ -0,0 +1,206 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTIFFImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkStreamingImageFilter.h"
+#include "itkRGBPixel.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+#include "itk_tiff.h"
+
+namespace
+{
+unsigned short ExpectedValue(const itk::Index< 2 > & index, unsigned int component)
+{
+  return static_cast< unsigned short >( index[0] + 300 * index[1] + 7 * component );
+}
+
+void SetPixel(unsigned short & pixel, const itk::Index< 2 > & index)
+{
+  pixel = ExpectedValue(index, 0);
+}
+
+void SetPixel(itk::RGBPixel< unsigned char > & pixel, const itk::Index< 2 > & index)
+{
+  for ( unsigned int c = 0; c < 3; ++c )
+    {
+    pixel[c] = static_cast< unsigned char >( ExpectedValue(index, c) );
+    }
+}
+
+bool CheckPixel(unsigned short pixel, const itk::Index< 2 > & index)
+{
+  return pixel == ExpectedValue(index, 0);
+}
+
+bool CheckPixel(const itk::RGBPixel< unsigned char > & pixel, const itk::Index< 2 > & index)
+{
+  for ( unsigned int c = 0; c < 3; ++c )
+    {
+    if ( pixel[c] != static_cast< unsigned char >( ExpectedValue(index, c) ) )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+template< typename TImage >
+bool CheckImage(const TImage *image)
+{
+  itk::ImageRegionConstIteratorWithIndex< TImage > it( image, image->GetBufferedRegion() );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    if ( !CheckPixel( it.Get(), it.GetIndex() ) )
+      {
+      std::cerr << "Pixel " << it.GetIndex() << " is " << it.Get() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+bool GetTileSize(const std::string & fileName, uint32 & tileWidth, uint32 & tileHeight)
+{
+  TIFF *tif = TIFFOpen(fileName.c_str(), "r");
+  if ( !tif )
+    {
+    return false;
+    }
+  const bool tiled = TIFFIsTiled(tif)
+                     && TIFFGetField(tif, TIFFTAG_TILEWIDTH, &tileWidth)
+                     && TIFFGetField(tif, TIFFTAG_TILELENGTH, &tileHeight);
+  TIFFClose(tif);
+  return tiled;
+}
+
+// Write the image in tiles which do not fit its size, and read it back
+// whole, streamed and as a region of interest.
+template< typename TImage >
+int TestTiles(const std::string & fileName, unsigned int tileWidth, unsigned int tileHeight, int compression)
+{
+  typedef itk::ImageFileReader< TImage > ReaderType;
+  typedef itk::ImageFileWriter< TImage > WriterType;
+
+  typename TImage::SizeType   size = { { 300, 200 } };
+  typename TImage::RegionType region( size );
+  typename TImage::Pointer    image = TImage::New();
+  image->SetRegions( region );
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< TImage > it( image, region );
+  for ( ; !it.IsAtEnd(); ++it )
+    {
+    SetPixel( it.Value(), it.GetIndex() );
+    }
+
+  itk::TIFFImageIO::Pointer io = itk::TIFFImageIO::New();
+  io->SetCompression( compression );
+  io->SetTileWidth( tileWidth );
+  io->SetTileHeight( tileHeight );
+  typename WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( image );
+  writer->SetImageIO( io );
+  writer->SetFileName( fileName );
+  TRY_EXPECT_NO_EXCEPTION( writer->Update() );
+
+  uint32 fileTileWidth = 0;
+  uint32 fileTileHeight = 0;
+  TEST_EXPECT_TRUE( GetTileSize( fileName, fileTileWidth, fileTileHeight ) );
+  TEST_EXPECT_EQUAL( fileTileWidth, tileWidth );
+  TEST_EXPECT_EQUAL( fileTileHeight, tileHeight );
+
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( fileName );
+  TRY_EXPECT_NO_EXCEPTION( reader->Update() );
+  TEST_EXPECT_TRUE( reader->GetOutput()->GetLargestPossibleRegion() == region );
+  TEST_EXPECT_TRUE( reader->GetOutput()->GetBufferedRegion() == region );
+  TEST_EXPECT_TRUE( CheckImage( reader->GetOutput() ) );
+
+  typename ReaderType::Pointer streamingReader = ReaderType::New();
+  streamingReader->SetFileName( fileName );
+  streamingReader->UseStreamingOn();
+  typedef itk::StreamingImageFilter< TImage, TImage > StreamerType;
+  typename StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( streamingReader->GetOutput() );
+  streamer->SetNumberOfStreamDivisions( 7 );
+  TRY_EXPECT_NO_EXCEPTION( streamer->Update() );
+  TEST_EXPECT_TRUE( streamer->GetOutput()->GetBufferedRegion() == region );
+  TEST_EXPECT_TRUE( CheckImage( streamer->GetOutput() ) );
+
+  // Only the region of interest is read
+  typename TImage::IndexType  roiIndex = { { 70, 45 } };
+  typename TImage::SizeType   roiSize = { { 131, 97 } };
+  typename TImage::RegionType roi( roiIndex, roiSize );
+  typename ReaderType::Pointer roiReader = ReaderType::New();
+  roiReader->SetFileName( fileName );
+  roiReader->UseStreamingOn();
+  roiReader->GetOutput()->SetRequestedRegion( roi );
+  TRY_EXPECT_NO_EXCEPTION( roiReader->GetOutput()->Update() );
+  TEST_EXPECT_TRUE( roiReader->GetOutput()->GetBufferedRegion() == roi );
+  TEST_EXPECT_TRUE( CheckImage( roiReader->GetOutput() ) );
+
+  return EXIT_SUCCESS;
+}
+}
+
+int itkTIFFImageIOTileTest(int argc, char* argv[])
+{
+  if( argc < 2 )
+    {
+    std::cerr << "Usage: " << argv[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string directory = argv[1];
+
+  itk::TIFFImageIO::Pointer io = itk::TIFFImageIO::New();
+  EXERCISE_BASIC_OBJECT_METHODS( io, itk::TIFFImageIO );
+  TEST_EXPECT_EQUAL( io->GetTileWidth(), 0u );
+  TEST_EXPECT_EQUAL( io->GetTileHeight(), 0u );
+
+  typedef itk::Image< unsigned short, 2 >                 ShortImageType;
+  typedef itk::Image< itk::RGBPixel< unsigned char >, 2 > RGBImageType;
+  if ( TestTiles< ShortImageType >( directory + "/itkTIFFImageIOTileTestShort.tif",
+                                    64, 48, itk::TIFFImageIO::Deflate ) != EXIT_SUCCESS
+       || TestTiles< ShortImageType >( directory + "/itkTIFFImageIOTileTestOne.tif",
+                                       304, 208, itk::TIFFImageIO::NoCompression ) != EXIT_SUCCESS
+       || TestTiles< RGBImageType >( directory + "/itkTIFFImageIOTileTestRGB.tif",
+                                     32, 16, itk::TIFFImageIO::PackBits ) != EXIT_SUCCESS )
+    {
+    return EXIT_FAILURE;
+    }
+
+  // Tile sizes must be multiples of 16
+  ShortImageType::SizeType size = { { 40, 40 } };
+  ShortImageType::Pointer  image = ShortImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+  image->FillBuffer( 0 );
+  io->SetTileWidth( 40 );
+  io->SetTileHeight( 32 );
+  typedef itk::ImageFileWriter< ShortImageType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( image );
+  writer->SetImageIO( io );
+  writer->SetFileName( directory + "/itkTIFFImageIOTileTestInvalid.tif" );
+  TRY_EXPECT_EXCEPTION( writer->Update() );
+
+  return EXIT_SUCCESS;
+}
@@ -120,6 +120,9 @@ protected:
 
   virtual void PrintSelf( std::ostream & os, Indent indent ) const;
 
+  /** Copy the line search settings. */
+  virtual typename LightObject::Pointer InternalClone() const ITK_OVERRIDE;
+
   TInternalComputationValueType GoldenSectionSearch( TInternalComputationValueType a, TInternalComputationValueType b, TInternalComputationValueType c );
 
   TInternalComputationValueType m_LowerLimit;
@@ -49,6 +49,27 @@ GradientDescentLineSearchOptimizerv4Template<TInternalComputationValueType>
 {}
 
 
+/**
+*InternalClone
+*/
+template<typename TInternalComputationValueType>
+typename LightObject::Pointer
+GradientDescentLineSearchOptimizerv4Template<TInternalComputationValueType>
+::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  typename Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro( << "downcast to type " << this->GetNameOfClass() << " failed." );
+    }
+  rval->SetEpsilon( this->m_Epsilon );
+  rval->SetLowerLimit( this->m_LowerLimit );
+  rval->SetUpperLimit( this->m_UpperLimit );
+  rval->SetMaximumLineSearchIterations( this->m_MaximumLineSearchIterations );
+  return loPtr;
+}
+
 /**
 *PrintSelf
 */
@@ -165,6 +165,9 @@ protected:
   DerivativeType     m_Gradient;
   virtual void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Copy the number of iterations. */
+  virtual typename LightObject::Pointer InternalClone() const ITK_OVERRIDE;
+
 private:
   GradientDescentOptimizerBasev4Template( const Self & ); //purposely not implemented
   void operator=( const Self& ); //purposely not implemented
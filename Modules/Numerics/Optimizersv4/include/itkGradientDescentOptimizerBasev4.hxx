@@ -53,6 +53,22 @@ GradientDescentOptimizerBasev4Template<TInternalComputationValueType>
 ::~GradientDescentOptimizerBasev4Template()
 {}
 
+//-------------------------------------------------------------------
+template<typename TInternalComputationValueType>
+typename LightObject::Pointer
+GradientDescentOptimizerBasev4Template<TInternalComputationValueType>
+::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  typename Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro( << "downcast to type " << this->GetNameOfClass() << " failed." );
+    }
+  rval->SetNumberOfIterations( this->m_NumberOfIterations );
+  return loPtr;
+}
+
 //-------------------------------------------------------------------
 template<typename TInternalComputationValueType>
 void
@@ -225,6 +225,9 @@ protected:
 
   virtual void PrintSelf( std::ostream & os, Indent indent ) const;
 
+  /** Copy the learning rate and convergence settings. */
+  virtual typename LightObject::Pointer InternalClone() const ITK_OVERRIDE;
+
   /** Minimum convergence value for convergence checking.
    *  The convergence checker calculates convergence value by fitting to
    *  a window of the energy profile. When the convergence value reaches
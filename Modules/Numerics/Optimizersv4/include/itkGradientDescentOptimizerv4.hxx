@@ -56,6 +56,30 @@ GradientDescentOptimizerv4Template<TInternalComputationValueType>
 {}
 
 
+/**
+*InternalClone
+*/
+template<typename TInternalComputationValueType>
+typename LightObject::Pointer
+GradientDescentOptimizerv4Template<TInternalComputationValueType>
+::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  typename Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro( << "downcast to type " << this->GetNameOfClass() << " failed." );
+    }
+  rval->SetLearningRate( this->m_LearningRate );
+  rval->SetMaximumStepSizeInPhysicalUnits( this->m_MaximumStepSizeInPhysicalUnits );
+  rval->SetDoEstimateLearningRateAtEachIteration( this->m_DoEstimateLearningRateAtEachIteration );
+  rval->SetDoEstimateLearningRateOnce( this->m_DoEstimateLearningRateOnce );
+  rval->SetMinimumConvergenceValue( this->m_MinimumConvergenceValue );
+  rval->SetConvergenceWindowSize( this->m_ConvergenceWindowSize );
+  rval->SetReturnBestParametersAndValue( this->m_ReturnBestParametersAndValue );
+  return loPtr;
+}
+
 /**
 *PrintSelf
 */
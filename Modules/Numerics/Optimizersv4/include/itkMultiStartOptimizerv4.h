@@ -20,6 +20,8 @@
 
 #include "itkObjectToObjectOptimizerBase.h"
 #include "itkGradientDescentOptimizerv4.h"
+#include "itkMultiThreader.h"
+#include "itkSimpleFastMutexLock.h"
 
 namespace itk
 {
@@ -34,6 +36,9 @@ namespace itk
    *   focus modifying the parameter sample space.  This is why we place the burden on the user to provide
    *   the parameter samples over which to optimize.
    *
+   *   The starting points can be optimized concurrently, see
+   *   SetMaximumNumberOfConcurrentStarts().
+   *
    * \ingroup ITKOptimizersv4
    */
 template<typename TInternalComputationValueType>
@@ -92,6 +97,9 @@ public:
   typedef typename Superclass::MeasureType          MeasureType;
   typedef std::vector< MeasureType >                MetricValuesListType;
 
+  /** Scales estimator type */
+  typedef typename Superclass::ScalesEstimatorType  ScalesEstimatorType;
+
   /** Get stop condition enum */
   itkGetConstReferenceMacro(StopCondition, StopConditionType);
 
@@ -139,6 +147,21 @@ public:
 
   inline ParameterListSizeType GetBestParametersIndex( ) { return this->m_BestParametersIndex; }
 
+  /** Set/Get the maximum number of starting points optimized concurrently.
+   * Each concurrent start is optimized by a copy of the local optimizer with
+   * a copy of the metric, both made with Clone(), and the threads of this
+   * optimizer are split between the concurrent starts.  This requires a
+   * metric and a local optimizer whose Clone() copies their settings, such as
+   * the image to image metrics and the gradient descent optimizers.  The
+   * starts are optimized one after another, with a warning, when the local
+   * optimizer has a scales estimator that CloneForMetric() cannot copy.  The
+   * results are those of the optimization of the starts one after another,
+   * up to the rounding of the threaded sums of the metric, but the observers
+   * of the local optimizer are not invoked.  Default is 1, i.e. the starts
+   * are optimized one after another. */
+  itkSetClampMacro(MaximumNumberOfConcurrentStarts, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(MaximumNumberOfConcurrentStarts, ThreadIdType);
+
 protected:
   /** Default constructor */
   MultiStartOptimizerv4Template();
@@ -146,6 +169,13 @@ protected:
 
   virtual void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Optimize the remaining starts concurrently, storing the optimized
+   * parameters in the parameters list, and their metric values in
+   * m_StartMetricValues where m_StartIsValid is set.  Returns false,
+   * without optimizing any start, when the scales estimator of the local
+   * optimizer cannot be copied. */
+  virtual bool OptimizeStartsConcurrently();
+
   /* Common variables for optimization control and reporting */
   bool                          m_Stop;
   StopConditionType             m_StopCondition;
@@ -158,11 +188,26 @@ protected:
   MeasureType                   m_MaximumMetricValue;
   ParameterListSizeType         m_BestParametersIndex;
   OptimizerPointer              m_LocalOptimizer;
+  ThreadIdType                  m_MaximumNumberOfConcurrentStarts;
+  MetricValuesListType          m_StartMetricValues;
+  std::vector< unsigned char >  m_StartIsValid;
 
 private:
   MultiStartOptimizerv4Template( const Self & ); //purposely not implemented
   void operator=( const Self& ); //purposely not implemented
 
+  /** The local optimizers of the concurrent starts, which take the next start
+   * to optimize from a shared counter. */
+  struct ConcurrentStartsThreadStruct
+    {
+    Self *                          Optimizer;
+    std::vector< OptimizerPointer > LocalOptimizers;
+    SizeValueType                   NextStart;
+    SimpleFastMutexLock             NextStartLock;
+    };
+
+  static ITK_THREAD_RETURN_TYPE ConcurrentStartsThreaderCallback( void *arg );
+
 };
 
 /** This helps to meet backward compatibility */
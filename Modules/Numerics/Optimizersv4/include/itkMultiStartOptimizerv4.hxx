@@ -38,6 +38,7 @@ MultiStartOptimizerv4Template<TInternalComputationValueType>
   this->m_MaximumMetricValue=NumericTraits<MeasureType>::max();
   this->m_MinimumMetricValue = this->m_MaximumMetricValue;
   m_LocalOptimizer = ITK_NULLPTR;
+  this->m_MaximumNumberOfConcurrentStarts = 1;
 }
 
 //-------------------------------------------------------------------
@@ -57,6 +58,7 @@ MultiStartOptimizerv4Template<TInternalComputationValueType>
   os << indent << "Current iteration: " << this->m_CurrentIteration << std::endl;
   os << indent << "Stop condition:"<< this->m_StopCondition << std::endl;
   os << indent << "Stop condition description: " << this->m_StopConditionDescription.str()  << std::endl;
+  os << indent << "Maximum number of concurrent starts: " << this->m_MaximumNumberOfConcurrentStarts << std::endl;
 }
 
 //-------------------------------------------------------------------
@@ -181,22 +183,50 @@ MultiStartOptimizerv4Template<TInternalComputationValueType>
   this->InvokeEvent( StartEvent() );
 
   this->m_Stop = false;
+
+  /* Optimize the starts concurrently, and then go through their results as
+   * if they had been optimized one after another. */
+  const bool concurrentStarts = this->m_LocalOptimizer
+    && this->m_MaximumNumberOfConcurrentStarts > 1
+    && this->m_CurrentIteration + 1 < this->m_NumberOfIterations
+    && this->OptimizeStartsConcurrently();
+
   while( ! this->m_Stop )
     {
     /* Compute metric value */
-    try
+    bool validStart = true;
+    if( concurrentStarts )
+      {
+      validStart = ( this->m_StartIsValid[ this->m_CurrentIteration ] != 0 );
+      if( validStart )
+        {
+        this->m_Metric->SetParameters( this->m_ParametersList[ this->m_CurrentIteration ] );
+        this->m_CurrentMetricValue = this->m_StartMetricValues[ this->m_CurrentIteration ];
+        }
+      }
+    else
       {
-      this->m_Metric->SetParameters( this->m_ParametersList[ this->m_CurrentIteration ] );
-      if (  this->m_LocalOptimizer )
+      try
+        {
+        this->m_Metric->SetParameters( this->m_ParametersList[ this->m_CurrentIteration ] );
+        if (  this->m_LocalOptimizer )
+          {
+          this->m_LocalOptimizer->SetMetric( this->m_Metric );
+          this->m_LocalOptimizer->StartOptimization();
+          this->m_ParametersList[this->m_CurrentIteration] = this->m_Metric->GetParameters();
+          }
+        this->m_CurrentMetricValue = this->m_Metric->GetValue();
+        }
+      catch ( ExceptionObject & )
         {
-        this->m_LocalOptimizer->SetMetric( this->m_Metric );
-        this->m_LocalOptimizer->StartOptimization();
-        this->m_ParametersList[this->m_CurrentIteration] = this->m_Metric->GetParameters();
+        validStart = false;
         }
-      this->m_CurrentMetricValue = this->m_Metric->GetValue();
+      }
+    if( validStart )
+      {
       this->m_MetricValuesList.push_back(this->m_CurrentMetricValue);
       }
-    catch ( ExceptionObject & )
+    else
       {
       /** We simply ignore this exception because it may just be a bad starting point.
        *  We hope that other start points are better.
@@ -233,6 +263,100 @@ MultiStartOptimizerv4Template<TInternalComputationValueType>
     } //while (!m_Stop)
 }
 
+/**
+* Optimize the remaining starts concurrently.
+*/
+template<typename TInternalComputationValueType>
+bool
+MultiStartOptimizerv4Template<TInternalComputationValueType>
+::OptimizeStartsConcurrently()
+{
+  const SizeValueType numberOfStarts = this->m_NumberOfIterations - this->m_CurrentIteration;
+  const ThreadIdType numberOfConcurrentStarts = static_cast<ThreadIdType>(
+    std::min( static_cast<SizeValueType>( this->m_MaximumNumberOfConcurrentStarts ), numberOfStarts ) );
+  const ThreadIdType numberOfThreadsPerStart =
+    std::max( this->m_NumberOfThreads / numberOfConcurrentStarts, static_cast<ThreadIdType>( 1 ) );
+
+  /* Copy the metric and the local optimizer for each concurrent start.  The
+   * copies of the metric share the images and interpolators of the metric,
+   * so they are initialized here, one after another. */
+  ConcurrentStartsThreadStruct str;
+  str.Optimizer = this;
+  str.NextStart = this->m_CurrentIteration;
+  str.LocalOptimizers.resize( numberOfConcurrentStarts );
+  ScalesEstimatorType * scalesEstimator = this->m_LocalOptimizer->GetModifiableScalesEstimator();
+  for( ThreadIdType c = 0; c < numberOfConcurrentStarts; ++c )
+    {
+    MetricTypePointer metric = dynamic_cast<MetricType *>( this->m_Metric->Clone().GetPointer() );
+    OptimizerPointer optimizer = dynamic_cast<OptimizerType *>( this->m_LocalOptimizer->Clone().GetPointer() );
+    if( metric.IsNull() || optimizer.IsNull() )
+      {
+      itkExceptionMacro( "The metric and the local optimizer could not be copied to optimize the starts concurrently." );
+      }
+    metric->SetMaximumNumberOfThreads( numberOfThreadsPerStart );
+    metric->Initialize();
+    optimizer->SetMetric( metric );
+    optimizer->SetNumberOfThreads( numberOfThreadsPerStart );
+    if( scalesEstimator )
+      {
+      typename ScalesEstimatorType::Pointer scalesEstimatorCopy = scalesEstimator->CloneForMetric( metric );
+      if( scalesEstimatorCopy.IsNull() )
+        {
+        itkWarningMacro( "The scales estimator of the local optimizer cannot be copied, the starts are optimized one after another." );
+        return false;
+        }
+      optimizer->SetScalesEstimator( scalesEstimatorCopy );
+      }
+    str.LocalOptimizers[c] = optimizer;
+    }
+
+  this->m_StartMetricValues.resize( this->m_NumberOfIterations );
+  this->m_StartIsValid.assign( this->m_NumberOfIterations, 0 );
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads( numberOfConcurrentStarts );
+  threader->SetSingleMethod( this->ConcurrentStartsThreaderCallback, &str );
+  threader->SingleMethodExecute();
+  return true;
+}
+
+template<typename TInternalComputationValueType>
+ITK_THREAD_RETURN_TYPE
+MultiStartOptimizerv4Template<TInternalComputationValueType>
+::ConcurrentStartsThreaderCallback( void *arg )
+{
+  const ThreadIdType threadId = ( (MultiThreader::ThreadInfoStruct *)( arg ) )->ThreadID;
+  ConcurrentStartsThreadStruct *str =
+    (ConcurrentStartsThreadStruct *)( ( (MultiThreader::ThreadInfoStruct *)( arg ) )->UserData );
+
+  Self * self = str->Optimizer;
+  OptimizerType * optimizer = str->LocalOptimizers[threadId];
+  MetricType * metric = optimizer->GetModifiableMetric();
+  while( true )
+    {
+    str->NextStartLock.Lock();
+    const SizeValueType start = str->NextStart++;
+    str->NextStartLock.Unlock();
+    if( start >= self->m_NumberOfIterations )
+      {
+      break;
+      }
+    try
+      {
+      metric->SetParameters( self->m_ParametersList[start] );
+      optimizer->StartOptimization();
+      self->m_ParametersList[start] = metric->GetParameters();
+      self->m_StartMetricValues[start] = metric->GetValue();
+      self->m_StartIsValid[start] = 1;
+      }
+    catch ( ExceptionObject & )
+      {
+      /* Reported by ResumeOptimization */
+      }
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
 } //namespace itk
 
 #endif
@@ -284,6 +284,11 @@ protected:
 
   void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Copy the transforms and the virtual domain set by the user.  The moving
+   * transform is cloned, to be optimized independently, and the fixed
+   * transform is shared. */
+  virtual typename LightObject::Pointer InternalClone() const ITK_OVERRIDE;
+
   /** Verify that virtual domain and displacement field are the same size
    * and in the same physical space. */
   virtual void VerifyDisplacementFieldSizeAndPhysicalSpace();
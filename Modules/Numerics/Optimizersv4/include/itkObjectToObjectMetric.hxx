@@ -508,6 +508,29 @@ ObjectToObjectMetric<TFixedDimension, TMovingDimension, TVirtualImage, TInternal
   return true;
 }
 
+template<unsigned int TFixedDimension, unsigned int TMovingDimension, typename TVirtualImage, typename TInternalComputationValueType>
+typename LightObject::Pointer
+ObjectToObjectMetric<TFixedDimension, TMovingDimension, TVirtualImage, TInternalComputationValueType>
+::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  typename Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro( << "downcast to type " << this->GetNameOfClass() << " failed." );
+    }
+  rval->SetFixedTransform( this->m_FixedTransform );
+  if( this->m_MovingTransform.IsNotNull() )
+    {
+    rval->SetMovingTransform( this->m_MovingTransform->Clone() );
+    }
+  if( this->m_UserHasSetVirtualDomain )
+    {
+    rval->SetVirtualDomainFromImage( this->m_VirtualImage );
+    }
+  return loPtr;
+}
+
 template<unsigned int TFixedDimension, unsigned int TMovingDimension, typename TVirtualImage, typename TInternalComputationValueType>
 void
 ObjectToObjectMetric<TFixedDimension, TMovingDimension, TVirtualImage, TInternalComputationValueType>
@@ -159,12 +159,21 @@ public:
    * metric value and store it in m_Value. */
   MeasureType GetCurrentValue() const;
 
+  /** Set the maximum number of threads used to evaluate the metric, for
+   * the metrics whose evaluations are threaded.  Does nothing by default. */
+  virtual void SetMaximumNumberOfThreads( const ThreadIdType ) {}
+
 protected:
   ObjectToObjectMetricBaseTemplate();
   virtual ~ObjectToObjectMetricBaseTemplate();
 
   void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Copy the settings of the metric, so that Clone() makes a metric that
+   * can be initialized and evaluated independently of this one.  Derived
+   * classes copy their own settings after calling the superclass. */
+  virtual typename LightObject::Pointer InternalClone() const ITK_OVERRIDE;
+
   GradientSourceType              m_GradientSource;
 
   /** Metric value, stored after evaluating */
@@ -66,6 +66,22 @@ ObjectToObjectMetricBaseTemplate<TInternalComputationValueType>
   return m_Value;
 }
 
+//-------------------------------------------------------------------
+template<typename TInternalComputationValueType>
+typename LightObject::Pointer
+ObjectToObjectMetricBaseTemplate<TInternalComputationValueType>
+::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  typename Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro( << "downcast to type " << this->GetNameOfClass() << " failed." );
+    }
+  rval->SetGradientSource( this->m_GradientSource );
+  return loPtr;
+}
+
 //-------------------------------------------------------------------
 template<typename TInternalComputationValueType>
 void
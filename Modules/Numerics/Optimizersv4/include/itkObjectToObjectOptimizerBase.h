@@ -163,6 +163,9 @@ public:
    */
   itkSetObjectMacro(ScalesEstimator, ScalesEstimatorType);
 
+  /** Get the scales estimator. */
+  itkGetModifiableObjectMacro(ScalesEstimator, ScalesEstimatorType);
+
   /** Option to use ScalesEstimator for scales estimation.
    * The estimation is performed once at begin of
    * optimization, and overrides any scales set using SetScales().
@@ -232,6 +235,12 @@ protected:
 
   virtual void PrintSelf(std::ostream & os, Indent indent) const ITK_OVERRIDE;
 
+  /** Copy the settings of the optimizer, so that Clone() makes an optimizer
+   * that can be run independently of this one once given its own metric.
+   * The metric and the scales estimator are shared with the copy.  Derived
+   * classes copy their own settings after calling the superclass. */
+  virtual typename LightObject::Pointer InternalClone() const ITK_OVERRIDE;
+
 private:
 
   //purposely not implemented
@@ -45,6 +45,27 @@ ObjectToObjectOptimizerBaseTemplate<TInternalComputationValueType>
 ::~ObjectToObjectOptimizerBaseTemplate()
 {}
 
+//-------------------------------------------------------------------
+template<typename TInternalComputationValueType>
+typename LightObject::Pointer
+ObjectToObjectOptimizerBaseTemplate<TInternalComputationValueType>
+::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  typename Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro( << "downcast to type " << this->GetNameOfClass() << " failed." );
+    }
+  rval->SetMetric( this->m_Metric );
+  rval->SetNumberOfThreads( this->m_NumberOfThreads );
+  rval->SetScales( this->m_Scales );
+  rval->SetWeights( this->m_Weights );
+  rval->SetScalesEstimator( this->m_ScalesEstimator );
+  rval->SetDoEstimateScales( this->m_DoEstimateScales );
+  return loPtr;
+}
+
 //-------------------------------------------------------------------
 template<typename TInternalComputationValueType>
 void
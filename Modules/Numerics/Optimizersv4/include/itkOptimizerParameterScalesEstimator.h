@@ -25,6 +25,9 @@
 namespace itk
 {
 
+template< typename TInternalComputationValueType >
+class ObjectToObjectMetricBaseTemplate;
+
 /** \class OptimizerParameterScalesEstimatorTemplate
  *  \brief OptimizerParameterScalesEstimatorTemplate is the base class offering a
  * empty method of estimating the parameter scales for optimizers.
@@ -68,6 +71,15 @@ public:
   /** Estimate the maximum size for steps. */
   virtual FloatType EstimateMaximumStepSize() = 0;
 
+  /** Create an estimator with the settings of this one, which uses
+   * \c metric instead of the metric of this one.  It lets an optimizer
+   * working on a copy of its metric estimate the scales with the copy.
+   * Returns null by default, for the estimators that cannot be copied. */
+  virtual Pointer CloneForMetric( ObjectToObjectMetricBaseTemplate<TInternalComputationValueType> * itkNotUsed(metric) ) const
+    {
+    return ITK_NULLPTR;
+    }
+
 protected:
   OptimizerParameterScalesEstimatorTemplate(){};
   ~OptimizerParameterScalesEstimatorTemplate(){};
@@ -191,6 +191,9 @@ protected:
 
   virtual void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Copy the Newton step settings. */
+  virtual typename LightObject::Pointer InternalClone() const ITK_OVERRIDE;
+
 private:
   QuasiNewtonOptimizerv4Template(const Self &); //purposely not implemented
   void operator=(const Self &);                 //purposely not implemented
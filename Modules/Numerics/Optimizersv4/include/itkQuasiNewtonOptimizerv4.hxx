@@ -53,6 +53,22 @@ QuasiNewtonOptimizerv4Template<TInternalComputationValueType>
 {
 }
 
+template<typename TInternalComputationValueType>
+typename LightObject::Pointer
+QuasiNewtonOptimizerv4Template<TInternalComputationValueType>
+::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  typename Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro( << "downcast to type " << this->GetNameOfClass() << " failed." );
+    }
+  rval->SetMaximumIterationsWithoutProgress( this->m_MaximumIterationsWithoutProgress );
+  rval->SetMaximumNewtonStepSizeInPhysicalUnits( this->m_MaximumNewtonStepSizeInPhysicalUnits );
+  return loPtr;
+}
+
 template<typename TInternalComputationValueType>
 void
 QuasiNewtonOptimizerv4Template<TInternalComputationValueType>
@@ -25,6 +25,7 @@
 #include "itkRigid3DPerspectiveTransform.h"
 
 #include "itkOptimizerParameterScalesEstimator.h"
+#include "itkObjectToObjectMetricBase.h"
 #include "itkImageRandomConstIteratorWithIndex.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
 
@@ -150,12 +151,20 @@ public:
   /** Set the sampling strategy automatically for step scale estimation. */
   virtual void SetStepScaleSamplingStrategy();
 
+  /** Create an estimator with the settings of this one, which uses
+   * \c metric instead.  \c metric must be of type \c MetricType. */
+  virtual typename Superclass::Pointer
+  CloneForMetric( ObjectToObjectMetricBaseTemplate<typename TMetric::ParametersValueType> * metric ) const ITK_OVERRIDE;
+
 protected:
   RegistrationParameterScalesEstimator();
   ~RegistrationParameterScalesEstimator(){};
 
   virtual void PrintSelf(std::ostream &os, Indent indent) const;
 
+  /** Copy the sampling settings and the metric. */
+  virtual typename LightObject::Pointer InternalClone() const ITK_OVERRIDE;
+
   /** Check the metric and the transforms. */
   bool CheckAndSetInputs();
 
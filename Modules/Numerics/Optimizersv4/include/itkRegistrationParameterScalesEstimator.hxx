@@ -713,6 +713,41 @@ RegistrationParameterScalesEstimator< TMetric >
   this->SampleVirtualDomainWithRegion(region);
 }
 
+template< typename TMetric >
+typename LightObject::Pointer
+RegistrationParameterScalesEstimator< TMetric >
+::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  typename Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro( << "downcast to type " << this->GetNameOfClass() << " failed." );
+    }
+  rval->SetMetric( this->m_Metric );
+  rval->SetTransformForward( this->m_TransformForward );
+  rval->SetVirtualDomainPointSet( this->m_VirtualDomainPointSet );
+  rval->SetCentralRegionRadius( this->m_CentralRegionRadius );
+  rval->SetNumberOfRandomSamples( this->m_NumberOfRandomSamples );
+  return loPtr;
+}
+
+template< typename TMetric >
+typename RegistrationParameterScalesEstimator< TMetric >::Superclass::Pointer
+RegistrationParameterScalesEstimator< TMetric >
+::CloneForMetric( ObjectToObjectMetricBaseTemplate<typename TMetric::ParametersValueType> * metric ) const
+{
+  MetricType * typedMetric = dynamic_cast<MetricType *>( metric );
+  if( typedMetric == ITK_NULLPTR )
+    {
+    itkExceptionMacro( << "The metric is not of type " << typeid( MetricType ).name() );
+    }
+  LightObject::Pointer loPtr = this->Clone();
+  typename Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  rval->SetMetric( typedMetric );
+  return rval.GetPointer();
+}
+
 /**
  * Print the information about this class.
  */
@@ -88,6 +88,9 @@ protected:
 
   virtual void PrintSelf(std::ostream &os, Indent indent) const;
 
+  /** Copy the small parameter variation. */
+  virtual typename LightObject::Pointer InternalClone() const ITK_OVERRIDE;
+
   /** Compute the shift in voxels when deltaParameters is applied onto the
    * current parameters. */
   virtual FloatType ComputeMaximumVoxelShift(const ParametersType &deltaParameters);
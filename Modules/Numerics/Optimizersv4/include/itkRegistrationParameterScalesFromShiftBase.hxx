@@ -221,6 +221,21 @@ RegistrationParameterScalesFromShiftBase< TMetric >
   return maxShift;
 }
 
+template< typename TMetric >
+typename LightObject::Pointer
+RegistrationParameterScalesFromShiftBase< TMetric >
+::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  typename Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro( << "downcast to type " << this->GetNameOfClass() << " failed." );
+    }
+  rval->SetSmallParameterVariation( this->m_SmallParameterVariation );
+  return loPtr;
+}
+
 /** Print the information about this class */
 template< typename TMetric >
 void
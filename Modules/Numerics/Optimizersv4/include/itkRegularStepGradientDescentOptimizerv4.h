@@ -148,6 +148,9 @@ protected:
 
   virtual void PrintSelf( std::ostream & os, Indent indent ) const;
 
+  /** Copy the step settings. */
+  virtual typename LightObject::Pointer InternalClone() const ITK_OVERRIDE;
+
   /** Minimum gradient step value for convergence checking */
   TInternalComputationValueType  m_MinimumStepLength;
 
@@ -41,6 +41,25 @@ RegularStepGradientDescentOptimizerv4<TInternalComputationValueType>
 ::~RegularStepGradientDescentOptimizerv4()
 {}
 
+template<typename TInternalComputationValueType>
+typename LightObject::Pointer
+RegularStepGradientDescentOptimizerv4<TInternalComputationValueType>
+::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  typename Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro( << "downcast to type " << this->GetNameOfClass() << " failed." );
+    }
+  rval->SetLearningRate( this->m_LearningRate );
+  rval->SetMinimumStepLength( this->m_MinimumStepLength );
+  rval->SetRelaxationFactor( this->m_RelaxationFactor );
+  rval->SetGradientMagnitudeTolerance( this->m_GradientMagnitudeTolerance );
+  rval->SetReturnBestParametersAndValue( this->m_ReturnBestParametersAndValue );
+  return loPtr;
+}
+
 template<typename TInternalComputationValueType>
 void
 RegularStepGradientDescentOptimizerv4<TInternalComputationValueType>
@@ -16,6 +16,7 @@
  *
  *=========================================================================*/
 #include "itkMultiStartOptimizerv4.h"
+#include "itkTestingMacros.h"
 
 /**
  *  \class MultiStartOptimizerv4TestMetric for test
@@ -134,11 +135,61 @@ public:
     return m_Parameters;
   }
 
+protected:
+
+  virtual itk::LightObject::Pointer InternalClone() const ITK_OVERRIDE
+  {
+    itk::LightObject::Pointer loPtr = Superclass::InternalClone();
+    Self * rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+    rval->m_Parameters = m_Parameters;
+    return loPtr;
+  }
+
 private:
 
   ParametersType m_Parameters;
 };
 
+/**
+ *  \class MultiStartOptimizerv4TestScalesEstimator for test
+ *
+ *  Unit scales, from an estimator which cannot be copied for another metric.
+ */
+class MultiStartOptimizerv4TestScalesEstimator
+  : public itk::OptimizerParameterScalesEstimator
+{
+public:
+
+  typedef MultiStartOptimizerv4TestScalesEstimator Self;
+  typedef itk::OptimizerParameterScalesEstimator   Superclass;
+  typedef itk::SmartPointer<Self>                  Pointer;
+  typedef itk::SmartPointer<const Self>            ConstPointer;
+  itkNewMacro( Self );
+  itkTypeMacro( MultiStartOptimizerv4TestScalesEstimator, OptimizerParameterScalesEstimator );
+
+  virtual void EstimateScales( ScalesType & scales ) ITK_OVERRIDE
+  {
+    scales.SetSize( MultiStartOptimizerv4TestMetric::SpaceDimension );
+    scales.Fill( 1.0 );
+  }
+
+  virtual FloatType EstimateStepScale( const ParametersType & ) ITK_OVERRIDE
+  {
+    return 1.0;
+  }
+
+  virtual void EstimateLocalStepScales( const ParametersType & step, ScalesType & localStepScales ) ITK_OVERRIDE
+  {
+    localStepScales.SetSize( step.Size() );
+    localStepScales.Fill( 1.0 );
+  }
+
+  virtual FloatType EstimateMaximumStepSize() ITK_OVERRIDE
+  {
+    return 1.0;
+  }
+};
+
 ///////////////////////////////////////////////////////////
 int MultiStartOptimizerv4RunTest(
   itk::MultiStartOptimizerv4::Pointer & itkOptimizer )
@@ -287,6 +338,75 @@ int itkMultiStartOptimizerv4Test(int, char* [] )
     return EXIT_FAILURE;
     }
   std::cout << "Test 3 passed." << std::endl;
+
+  /*
+   * Test 4
+   */
+  std::cout << "Test optimization 4: with concurrent starts" << std::endl;
+  TEST_EXPECT_EQUAL( itkOptimizer->GetMaximumNumberOfConcurrentStarts(), 1u );
+  parametersList.clear();
+  for (  int i = -3; i < 3; i++ )
+    {
+    for (  int j = -30; j < 30; j+=20 )
+      {
+      ParametersType  testPosition( spaceDimension );
+      testPosition[0]=(double)i;
+      testPosition[1]=(double)j;
+      parametersList.push_back( testPosition );
+      }
+    }
+  OptimizerType::ParametersListType serialParametersList = parametersList;
+  metric->SetParameters( parametersList[0] );
+  itkOptimizer->SetParametersList( serialParametersList );
+  if( MultiStartOptimizerv4RunTest( itkOptimizer ) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+  const OptimizerType::MetricValuesListType serialValues = itkOptimizer->GetMetricValuesList();
+  const OptimizerType::ParameterListSizeType serialBestIndex = itkOptimizer->GetBestParametersIndex();
+  serialParametersList = itkOptimizer->GetParametersList();
+
+  itkOptimizer->SetMaximumNumberOfConcurrentStarts( 4 );
+  TEST_EXPECT_EQUAL( itkOptimizer->GetMaximumNumberOfConcurrentStarts(), 4u );
+  itkOptimizer->Print( std::cout );
+  metric->SetParameters( parametersList[0] );
+  itkOptimizer->SetParametersList( parametersList );
+  if( MultiStartOptimizerv4RunTest( itkOptimizer ) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+  // The starts are optimized as they are one after another
+  TEST_EXPECT_EQUAL( itkOptimizer->GetBestParametersIndex(), serialBestIndex );
+  TEST_EXPECT_EQUAL( itkOptimizer->GetMetricValuesList().size(), serialValues.size() );
+  TEST_EXPECT_EQUAL( itkOptimizer->GetCurrentIteration(), parametersList.size() );
+  for( itk::SizeValueType s = 0; s < serialValues.size(); s++ )
+    {
+    TEST_EXPECT_EQUAL( itkOptimizer->GetMetricValuesList()[s], serialValues[s] );
+    TEST_EXPECT_TRUE( itkOptimizer->GetParametersList()[s] == serialParametersList[s] );
+    }
+  TEST_EXPECT_TRUE( itkOptimizer->GetMetric()->GetParameters() == serialParametersList[serialBestIndex] );
+  std::cout << "Test 4 passed." << std::endl;
+
+  /*
+   * Test 5
+   */
+  std::cout << "Test optimization 5: with a scales estimator which cannot be copied" << std::endl;
+  optimizer->SetScalesEstimator( MultiStartOptimizerv4TestScalesEstimator::New() );
+  optimizer->SetDoEstimateLearningRateOnce( false );
+  metric->SetParameters( parametersList[0] );
+  itkOptimizer->SetParametersList( parametersList );
+  // The starts are optimized one after another
+  if( MultiStartOptimizerv4RunTest( itkOptimizer ) == EXIT_FAILURE )
+    {
+    return EXIT_FAILURE;
+    }
+  TEST_EXPECT_EQUAL( itkOptimizer->GetBestParametersIndex(), serialBestIndex );
+  TEST_EXPECT_EQUAL( itkOptimizer->GetMetricValuesList().size(), serialValues.size() );
+  for( itk::SizeValueType s = 0; s < serialValues.size(); s++ )
+    {
+    TEST_EXPECT_EQUAL( itkOptimizer->GetMetricValuesList()[s], serialValues[s] );
+    }
+  std::cout << "Test 5 passed." << std::endl;
   return EXIT_SUCCESS;
 
 }
@@ -184,6 +184,9 @@ protected:
 
   virtual void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Copy the neighborhood radius. */
+  virtual typename LightObject::Pointer InternalClone() const ITK_OVERRIDE;
+
 private:
   ANTSNeighborhoodCorrelationImageToImageMetricv4( const Self & ); //purposely not implemented
   void operator=(const Self &); //purposely not implemented
@@ -181,13 +181,13 @@ CorrelationImageToImageMetricv4GetValueAndDerivativeThreader<TDomainPartitioner,
    * then we otherwise get when exceptions are caught in MultiThreader. */
   try
     {
-    pointIsValid = this->m_CorrelationAssociate->TransformAndEvaluateFixedPoint( virtualPoint, mappedFixedPoint, mappedFixedPixelValue );
-    if( pointIsValid &&
-        this->m_CorrelationAssociate->GetComputeDerivative() &&
-        this->m_CorrelationAssociate->GetGradientSourceIncludesFixed() )
-      {
-      this->m_CorrelationAssociate->ComputeFixedImageGradientAtPoint( mappedFixedPoint, mappedFixedImageGradient );
-      }
+    pointIsValid = this->m_CorrelationAssociate->TransformAndEvaluateFixedSample(
+                                   this->m_GetValueAndDerivativePerThreadVariables[threadId].Sample,
+                                   virtualPoint,
+                                   this->m_CorrelationAssociate->GetComputeDerivative() &&
+                                   this->m_CorrelationAssociate->GetGradientSourceIncludesFixed(),
+                                   mappedFixedPoint, mappedFixedPixelValue,
+                                   mappedFixedImageGradient );
     }
   catch( ExceptionObject & exc )
     {
@@ -107,6 +107,7 @@ TImageToImageMetric, TCorrelationMetric>
 {
   FixedImagePointType         mappedFixedPoint;
   FixedImagePixelType         mappedFixedPixelValue;
+  FixedImageGradientType      mappedFixedImageGradient;
   MovingImagePointType        mappedMovingPoint;
   MovingImagePixelType        mappedMovingPixelValue;
   bool                        pointIsValid = false;
@@ -117,7 +118,11 @@ TImageToImageMetric, TCorrelationMetric>
    * then we otherwise get when exceptions are caught in MultiThreader. */
   try
     {
-    pointIsValid = this->m_CorrelationAssociate->TransformAndEvaluateFixedPoint( virtualPoint, mappedFixedPoint, mappedFixedPixelValue );
+    pointIsValid = this->m_CorrelationAssociate->TransformAndEvaluateFixedSample(
+                                   this->m_GetValueAndDerivativePerThreadVariables[threadID].Sample,
+                                   virtualPoint, false,
+                                   mappedFixedPoint, mappedFixedPixelValue,
+                                   mappedFixedImageGradient );
     }
   catch( ExceptionObject & exc )
     {
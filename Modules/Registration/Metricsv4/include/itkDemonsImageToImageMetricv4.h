@@ -130,6 +130,9 @@ protected:
 
   void PrintSelf(std::ostream& os, Indent indent) const;
 
+  /** Copy the intensity difference threshold. */
+  virtual typename LightObject::Pointer InternalClone() const ITK_OVERRIDE;
+
 private:
 
   /** Threshold below which the denominator term is considered zero.
@@ -397,9 +397,30 @@ public:
   itkGetConstReferenceMacro(UseFixedSampledPointSet, bool);
   itkBooleanMacro(UseFixedSampledPointSet);
 
+  /** Set/Get flag to cache the fixed image samples of the domain.
+   * When on, the mapped fixed point, fixed value and fixed gradient of each
+   * sample are computed once, during the first evaluation, and read back
+   * during the following ones, as the fixed side does not change while the
+   * moving transform is optimized. The cache is cleared when the metric,
+   * the fixed image, the fixed transform, the fixed interpolator, the fixed
+   * mask or the virtual domain is modified.
+   * It holds a point, a value and a gradient per sample of the domain,
+   * i.e. per pixel of the virtual domain with dense sampling.
+   * Off by default. */
+  itkSetMacro(UseFixedSampleCache, bool);
+  itkGetConstReferenceMacro(UseFixedSampleCache, bool);
+  itkBooleanMacro(UseFixedSampleCache);
+
   /** Get the virtual domain sampling point set */
   itkGetModifiableObjectMacro(VirtualSampledPointSet, VirtualPointSetType);
 
+  /** Map the fixed domain sampling point set to the virtual domain again.
+   * Initialize() does the mapping once, so this is to be called after a
+   * different point set, or new points, have been assigned to an already
+   * initialized metric, e.g. to draw new samples at each iteration of a
+   * stochastic optimization. Only the sampled point sets are updated. */
+  void UpdateVirtualSampledPointSet();
+
   /** Set/Get the gradient filter */
   itkSetObjectMacro( FixedImageGradientFilter, FixedImageGradientFilterType );
   itkGetModifiableObjectMacro(FixedImageGradientFilter, FixedImageGradientFilterType );
@@ -431,7 +452,7 @@ public:
   /** Set number of threads to use. This the maximum number of threads to use
    * when multithreaded.  The actual number of threads used (may be less than
    * this value) can be obtained with \c GetNumberOfThreadsUsed. */
-  virtual void SetMaximumNumberOfThreads( const ThreadIdType threads );
+  virtual void SetMaximumNumberOfThreads( const ThreadIdType threads ) ITK_OVERRIDE;
   virtual ThreadIdType GetMaximumNumberOfThreads() const;
 
   /** Get Fixed Gradient Image. */
@@ -545,6 +566,25 @@ protected:
                          FixedImagePointType & mappedFixedPoint,
                          FixedImagePixelType & mappedFixedPixelValue ) const;
 
+  /**
+   * Transform and evaluate a sample of the domain, as in
+   * TransformAndEvaluateFixedPoint, and compute its fixed image gradient
+   * if \c computeGradient is true. The sample is the offset of the virtual
+   * index in the virtual region with dense sampling, and the index of the
+   * point in the virtual sampled point set with sparse sampling.
+   * When the fixed sample cache is used, the results are read from the
+   * cache, or computed and stored in it if the sample has not been cached
+   * yet. Samples outside of the domain are never cached.
+   * Different threads must process different samples.
+   */
+  bool TransformAndEvaluateFixedSample(
+                         const SizeValueType sample,
+                         const VirtualPointType & virtualPoint,
+                         const bool computeGradient,
+                         FixedImagePointType & mappedFixedPoint,
+                         FixedImagePixelType & mappedFixedPixelValue,
+                         FixedImageGradientType & mappedFixedImageGradient ) const;
+
   /** Transform and evaluate a point from VirtualImage domain to MovingImage domain. */
   bool TransformAndEvaluateMovingPoint(
                          const VirtualPointType & virtualPoint,
@@ -647,6 +687,12 @@ protected:
 
   void PrintSelf(std::ostream& os, Indent indent) const;
 
+  /** Copy the images, masks, sampling and gradient settings.  The
+   * interpolators, and the gradient filters and calculators set by the user,
+   * are shared with the copy, which must then be initialized before this
+   * metric and the copy are evaluated concurrently. */
+  virtual typename LightObject::Pointer InternalClone() const ITK_OVERRIDE;
+
 private:
   /** Map the fixed point set samples to the virtual domain */
   void MapFixedSampledPointSetToVirtual( void );
@@ -693,6 +739,21 @@ private:
       mappedFixedPoint.CastFrom(localMappedFixedPoint);
     }
 
+  /** Clear the fixed sample cache if the fixed side was modified since it
+   * was filled, and size it to the domain. */
+  void UpdateFixedSampleCache() const;
+
+  /** Fixed sample cache, as a structure of arrays indexed by sample.
+   * The state of a sample is FixedSampleNotCached, FixedSampleInvalid or
+   * FixedSampleValid. */
+  enum { FixedSampleNotCached = 0, FixedSampleInvalid, FixedSampleValid };
+  bool                                          m_UseFixedSampleCache;
+  mutable std::vector< FixedImagePointType >    m_FixedSampleCachePoints;
+  mutable std::vector< FixedImagePixelType >    m_FixedSampleCacheValues;
+  mutable std::vector< FixedImageGradientType > m_FixedSampleCacheGradients;
+  mutable std::vector< unsigned char >          m_FixedSampleCacheStates;
+  mutable TimeStamp                             m_FixedSampleCacheTime;
+
   /** Flag for warning about use of GetValue. Will be removed when
    *  GetValue implementation is improved. */
   mutable bool m_HaveMadeGetValueWarning;
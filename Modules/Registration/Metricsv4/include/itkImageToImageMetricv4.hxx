@@ -66,6 +66,7 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   this->m_UseFixedImageGradientFilter  = true;
   this->m_UseMovingImageGradientFilter = true;
   this->m_UseFixedSampledPointSet      = false;
+  this->m_UseFixedSampleCache          = false;
 
   this->m_FloatingPointCorrectionResolution = 1e6;
   this->m_UseFloatingPointCorrection = false;
@@ -280,6 +281,72 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
     /* Clear derivative final result. */
     this->m_DerivativeResult->Fill( NumericTraits< DerivativeValueType >::Zero );
     }
+
+  this->UpdateFixedSampleCache();
+}
+
+template<typename TFixedImage,typename TMovingImage,typename TVirtualImage, typename TInternalComputationValueType, typename TMetricTraits>
+void
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>
+::UpdateFixedSampleCache() const
+{
+  if( ! this->m_UseFixedSampleCache )
+    {
+    if( ! this->m_FixedSampleCacheStates.empty() )
+      {
+      /* Release the memory */
+      std::vector< FixedImagePointType >().swap( this->m_FixedSampleCachePoints );
+      std::vector< FixedImagePixelType >().swap( this->m_FixedSampleCacheValues );
+      std::vector< FixedImageGradientType >().swap( this->m_FixedSampleCacheGradients );
+      std::vector< unsigned char >().swap( this->m_FixedSampleCacheStates );
+      }
+    return;
+    }
+
+  /* Everything the fixed samples depend on. The metric itself is modified
+   * by the setting of the images, masks, virtual domain and options. */
+  ModifiedTimeType mtime = this->GetMTime();
+  mtime = std::max( mtime, this->m_FixedImage->GetMTime() );
+  mtime = std::max( mtime, this->m_FixedTransform->GetMTime() );
+  mtime = std::max( mtime, this->m_FixedInterpolator->GetMTime() );
+  mtime = std::max( mtime, this->m_VirtualImage->GetMTime() );
+  if( this->m_FixedImageMask )
+    {
+    mtime = std::max( mtime, this->m_FixedImageMask->GetMTime() );
+    }
+  if( this->m_UseFixedSampledPointSet )
+    {
+    mtime = std::max( mtime, this->m_VirtualSampledPointSet->GetMTime() );
+    }
+  if( this->GetGradientSourceIncludesFixed() )
+    {
+    if( this->m_FixedImageGradientImage )
+      {
+      mtime = std::max( mtime, this->m_FixedImageGradientImage->GetMTime() );
+      }
+    else
+      {
+      mtime = std::max( mtime, this->m_FixedImageGradientCalculator->GetMTime() );
+      }
+    }
+
+  const SizeValueType numberOfSamples = this->GetNumberOfDomainPoints();
+  if( mtime > this->m_FixedSampleCacheTime.GetMTime() ||
+      this->m_FixedSampleCacheStates.size() != numberOfSamples )
+    {
+    this->m_FixedSampleCachePoints.resize( numberOfSamples );
+    this->m_FixedSampleCacheValues.resize( numberOfSamples );
+    if( this->GetGradientSourceIncludesFixed() )
+      {
+      this->m_FixedSampleCacheGradients.resize( numberOfSamples );
+      }
+    else
+      {
+      this->m_FixedSampleCacheGradients.clear();
+      }
+    this->m_FixedSampleCacheStates.assign( numberOfSamples, FixedSampleNotCached );
+    this->m_FixedSampleCacheTime.Modified();
+    }
 }
 
 template<typename TFixedImage,typename TMovingImage,typename TVirtualImage, typename TInternalComputationValueType, typename TMetricTraits>
@@ -320,6 +387,60 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   return pointIsValid;
 }
 
+template<typename TFixedImage,typename TMovingImage,typename TVirtualImage, typename TInternalComputationValueType, typename TMetricTraits>
+bool
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>
+::TransformAndEvaluateFixedSample(
+                         const SizeValueType sample,
+                         const VirtualPointType & virtualPoint,
+                         const bool computeGradient,
+                         FixedImagePointType & mappedFixedPoint,
+                         FixedImagePixelType & mappedFixedPixelValue,
+                         FixedImageGradientType & mappedFixedImageGradient ) const
+{
+  if( sample >= this->m_FixedSampleCacheStates.size() )
+    {
+    const bool pointIsValid = this->TransformAndEvaluateFixedPoint( virtualPoint, mappedFixedPoint, mappedFixedPixelValue );
+    if( pointIsValid && computeGradient )
+      {
+      this->ComputeFixedImageGradientAtPoint( mappedFixedPoint, mappedFixedImageGradient );
+      }
+    return pointIsValid;
+    }
+
+  unsigned char & state = this->m_FixedSampleCacheStates[sample];
+  if( state == FixedSampleNotCached )
+    {
+    /* Cache the gradient whenever it may be needed, so that the
+     * evaluations of the value only fill the cache as well. */
+    FixedImagePointType & cachedPoint = this->m_FixedSampleCachePoints[sample];
+    if( this->TransformAndEvaluateFixedPoint( virtualPoint, cachedPoint, this->m_FixedSampleCacheValues[sample] ) )
+      {
+      if( this->GetGradientSourceIncludesFixed() )
+        {
+        this->ComputeFixedImageGradientAtPoint( cachedPoint, this->m_FixedSampleCacheGradients[sample] );
+        }
+      state = FixedSampleValid;
+      }
+    else
+      {
+      state = FixedSampleInvalid;
+      }
+    }
+
+  mappedFixedPoint = this->m_FixedSampleCachePoints[sample];
+  mappedFixedPixelValue = this->m_FixedSampleCacheValues[sample];
+  if( state == FixedSampleInvalid )
+    {
+    return false;
+    }
+  if( computeGradient )
+    {
+    mappedFixedImageGradient = this->m_FixedSampleCacheGradients[sample];
+    }
+  return true;
+}
+
 template<typename TFixedImage,typename TMovingImage,typename TVirtualImage, typename TInternalComputationValueType, typename TMetricTraits>
 bool
 ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>
@@ -501,6 +622,54 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   return  this->m_DenseGetValueAndDerivativeThreader->GetMaximumNumberOfThreads();
 }
 
+template<typename TFixedImage,typename TMovingImage,typename TVirtualImage, typename TInternalComputationValueType, typename TMetricTraits>
+typename LightObject::Pointer
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>
+::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  typename Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro( << "downcast to type " << this->GetNameOfClass() << " failed." );
+    }
+  rval->SetFixedImage( this->m_FixedImage );
+  rval->SetMovingImage( this->m_MovingImage );
+  rval->SetFixedInterpolator( this->m_FixedInterpolator );
+  rval->SetMovingInterpolator( this->m_MovingInterpolator );
+  rval->SetFixedImageMask( this->m_FixedImageMask );
+  rval->SetMovingImageMask( this->m_MovingImageMask );
+  rval->SetFixedSampledPointSet( this->m_FixedSampledPointSet );
+  rval->SetUseFixedSampledPointSet( this->m_UseFixedSampledPointSet );
+  rval->SetUseFixedSampleCache( this->m_UseFixedSampleCache );
+
+  // The copy keeps its own default gradient filters and calculators, which
+  // are updated by its initialization.
+  rval->SetUseFixedImageGradientFilter( this->m_UseFixedImageGradientFilter );
+  rval->SetUseMovingImageGradientFilter( this->m_UseMovingImageGradientFilter );
+  if( this->m_FixedImageGradientFilter != this->m_DefaultFixedImageGradientFilter.GetPointer() )
+    {
+    rval->SetFixedImageGradientFilter( this->m_FixedImageGradientFilter );
+    }
+  if( this->m_MovingImageGradientFilter != this->m_DefaultMovingImageGradientFilter.GetPointer() )
+    {
+    rval->SetMovingImageGradientFilter( this->m_MovingImageGradientFilter );
+    }
+  if( this->m_FixedImageGradientCalculator != this->m_DefaultFixedImageGradientCalculator.GetPointer() )
+    {
+    rval->SetFixedImageGradientCalculator( this->m_FixedImageGradientCalculator );
+    }
+  if( this->m_MovingImageGradientCalculator != this->m_DefaultMovingImageGradientCalculator.GetPointer() )
+    {
+    rval->SetMovingImageGradientCalculator( this->m_MovingImageGradientCalculator );
+    }
+
+  rval->SetUseFloatingPointCorrection( this->m_UseFloatingPointCorrection );
+  rval->SetFloatingPointCorrectionResolution( this->m_FloatingPointCorrectionResolution );
+  rval->SetMaximumNumberOfThreads( this->GetMaximumNumberOfThreads() );
+  return loPtr;
+}
+
 template<typename TFixedImage,typename TMovingImage,typename TVirtualImage, typename TInternalComputationValueType, typename TMetricTraits>
 ThreadIdType
 ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>
@@ -516,6 +685,22 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
     }
 }
 
+template<typename TFixedImage,typename TMovingImage,typename TVirtualImage, typename TInternalComputationValueType, typename TMetricTraits>
+void
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>
+::UpdateVirtualSampledPointSet()
+{
+  if( ! this->m_UseFixedSampledPointSet )
+    {
+    itkExceptionMacro("UseFixedSampledPointSet is off, there is no sampled point set to update.");
+    }
+  if( this->m_FixedSampledPointSet.IsNull() || this->m_FixedTransform.IsNull() )
+    {
+    itkExceptionMacro("The fixed sampled point set and the fixed transform must be set.");
+    }
+  this->MapFixedSampledPointSetToVirtual();
+}
+
 template<typename TFixedImage,typename TMovingImage,typename TVirtualImage, typename TInternalComputationValueType, typename TMetricTraits>
 void
 ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>
@@ -597,7 +782,8 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
      << indent << "GetUseFixedImageGradientFilter: " << this->GetUseFixedImageGradientFilter() << std::endl
      << indent << "GetUseMovingImageGradientFilter: " << this->GetUseMovingImageGradientFilter() << std::endl
      << indent << "UseFloatingPointCorrection: " << this->GetUseFloatingPointCorrection() << std::endl
-     << indent << "FloatingPointCorrectionResolution: " << this->GetFloatingPointCorrectionResolution() << std::endl;
+     << indent << "FloatingPointCorrectionResolution: " << this->GetFloatingPointCorrectionResolution() << std::endl
+     << indent << "UseFixedSampleCache: " << this->GetUseFixedSampleCache() << std::endl;
 
   if( this->GetFixedImage() != ITK_NULLPTR )
     {
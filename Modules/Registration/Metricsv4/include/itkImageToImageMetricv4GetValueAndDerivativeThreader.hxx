@@ -33,10 +33,16 @@ ImageToImageMetricv4GetValueAndDerivativeThreader< ThreadedImageRegionPartitione
   typename VirtualImageType::ConstPointer virtualImage = this->m_Associate->GetVirtualImage();
   typedef ImageRegionConstIteratorWithIndex< VirtualImageType > IteratorType;
   VirtualPointType virtualPoint;
+  /* The samples are the offsets in the virtual region */
+  const bool useFixedSampleCache = this->m_Associate->GetUseFixedSampleCache();
   for( IteratorType it( virtualImage, imageSubRegion ); !it.IsAtEnd(); ++it )
     {
     const VirtualIndexType & virtualIndex = it.GetIndex();
     virtualImage->TransformIndexToPhysicalPoint( virtualIndex, virtualPoint );
+    if( useFixedSampleCache )
+      {
+      this->m_GetValueAndDerivativePerThreadVariables[threadId].Sample = virtualImage->ComputeOffset( virtualIndex );
+      }
     this->ProcessVirtualPoint( virtualIndex, virtualPoint, threadId );
     }
 }
@@ -57,6 +63,7 @@ ImageToImageMetricv4GetValueAndDerivativeThreader< ThreadedIndexedContainerParti
     {
     const VirtualPointType & virtualPoint = virtualSampledPointSet->GetPoint( i );
     virtualImage->TransformPhysicalPointToIndex( virtualPoint, virtualIndex );
+    this->m_GetValueAndDerivativePerThreadVariables[threadId].Sample = i;
     this->ProcessVirtualPoint( virtualIndex, virtualPoint, threadId );
     }
 }
@@ -177,6 +177,10 @@ protected:
     /** Pre-allocated transform jacobian objects, for use as needed by dervied
      * classes for efficiency. */
     JacobianType                 MovingTransformJacobian;
+    /** Sample of the domain being processed, which addresses the fixed
+     * sample cache of the metric. Out of the domain when not set by
+     * \c ThreadedExecution. */
+    SizeValueType                Sample;
     };
   itkPadStruct( ITK_CACHE_LINE_ALIGNMENT, GetValueAndDerivativePerThreadStruct,
                                             PaddedGetValueAndDerivativePerThreadStruct);
@@ -92,6 +92,7 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImag
     {
     this->m_GetValueAndDerivativePerThreadVariables[thread].NumberOfValidPoints = NumericTraits< SizeValueType >::Zero;
     this->m_GetValueAndDerivativePerThreadVariables[thread].Measure = NumericTraits< InternalComputationValueType >::Zero;
+    this->m_GetValueAndDerivativePerThreadVariables[thread].Sample = NumericTraits< SizeValueType >::max();
     if( this->m_Associate->GetComputeDerivative() )
       {
       if ( this->m_Associate->m_MovingTransform->GetTransformCategory() != MovingTransformType::DisplacementField )
@@ -192,13 +193,13 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImag
    * then we otherwise get when exceptions are caught in MultiThreader. */
   try
     {
-    pointIsValid = this->m_Associate->TransformAndEvaluateFixedPoint( virtualPoint, mappedFixedPoint, mappedFixedPixelValue);
-    if( pointIsValid &&
-        this->m_Associate->GetComputeDerivative() &&
-        this->m_Associate->GetGradientSourceIncludesFixed() )
-      {
-      this->m_Associate->ComputeFixedImageGradientAtPoint( mappedFixedPoint, mappedFixedImageGradient );
-      }
+    pointIsValid = this->m_Associate->TransformAndEvaluateFixedSample(
+                                   this->m_GetValueAndDerivativePerThreadVariables[threadId].Sample,
+                                   virtualPoint,
+                                   this->m_Associate->GetComputeDerivative() &&
+                                   this->m_Associate->GetGradientSourceIncludesFixed(),
+                                   mappedFixedPoint, mappedFixedPixelValue,
+                                   mappedFixedImageGradient );
     }
   catch( ExceptionObject & exc )
     {
@@ -187,6 +187,9 @@ protected:
   /** Standard PrintSelf method. */
   void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Copy the histogram settings. */
+  virtual typename LightObject::Pointer InternalClone() const ITK_OVERRIDE;
+
   /** Count of the number of valid histogram points. */
   SizeValueType   m_JointHistogramTotalCount;
 
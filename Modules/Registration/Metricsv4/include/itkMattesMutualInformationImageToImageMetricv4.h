@@ -71,7 +71,7 @@ namespace itk
  * Mattes MI metric, i.e. itkMattesMutualInformationImageToImageMetric.
  *
  * See
- *  MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader::ProcessPoint
+ *  MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader::ProcessSampleBlock
  *  for poritons of the algorithm implementation.
  *
  * See ImageToImageMetricv4 for details of common metric operation and options.
@@ -203,6 +203,9 @@ protected:
 
   void PrintSelf(std::ostream& os, Indent indent) const;
 
+  /** Copy the number of histogram bins. */
+  virtual typename LightObject::Pointer InternalClone() const ITK_OVERRIDE;
+
   typedef typename JointPDFType::IndexType             JointPDFIndexType;
   typedef typename JointPDFType::PixelType             JointPDFValueType;
   typedef typename JointPDFType::RegionType            JointPDFRegionType;
@@ -27,6 +27,10 @@ namespace itk
  * \brief Processes points for MattesMutualInformationImageToImageMetricv4 \c
  * GetValueAndDerivative.
  *
+ * The samples of each thread are gathered in blocks, and the Parzen window
+ * weights and the PDF updates of the samples of a block are computed
+ * together.
+ *
  * \ingroup ITKMetricsv4
  */
 template < typename TDomainPartitioner, typename TImageToImageMetric, typename TMattesMutualInformationMetric >
@@ -86,12 +90,39 @@ protected:
     m_MattesAssociate(ITK_NULLPTR)
   {}
 
+  /** Number of samples of a block. */
+  itkStaticConstMacro(SampleBlockSize, SizeValueType, 256);
+
+  /** Samples of a block, gathered by ProcessPoint(). Each component of the
+   * samples is held in its own array, so that the Parzen window terms and
+   * weights of the block are computed by loops over these arrays. */
+  struct SampleBlockStruct
+    {
+    SizeValueType                          NumberOfSamples;
+    std::vector< VirtualIndexType >        VirtualIndices;
+    std::vector< VirtualPointType >        VirtualPoints;
+    std::vector< FixedImagePixelType >     FixedImageValues;
+    std::vector< MovingImagePixelType >    MovingImageValues;
+    std::vector< MovingImageGradientType > MovingImageGradients;
+    std::vector< OffsetValueType >         FixedImageParzenWindowIndices;
+    std::vector< OffsetValueType >         PDFMovingIndices;
+    std::vector< PDFValueType >            Fractions;
+    std::vector< PDFValueType >            Weights[4];
+    std::vector< PDFValueType >            DerivativeWeights[4];
+    };
+
   virtual void BeforeThreadedExecution();
 
+  /** Walk through the given subdomain, gathering the samples in the block of
+   * the thread, and process the samples left in the block at the end. */
+  virtual void ThreadedExecution( const DomainType & subdomain,
+                                  const ThreadIdType threadId );
+
   virtual void AfterThreadedExecution();
 
-  /** This function computes the local voxel-wise contribution of
-   *  the metric to the global integral of the metric/derivative.
+  /** Add the sample to the block of the thread, and process the block when
+   * it is full. Returns false to avoid the storage of results in the
+   * parent class.
    */
   virtual bool ProcessPoint(
         const VirtualIndexType &          virtualIndex,
@@ -106,14 +137,29 @@ protected:
         DerivativeType &                  localDerivativeReturn,
         const ThreadIdType                threadID ) const;
 
-  /** Compute PDF derivative contribution for each parameter. */
+  /** Compute the contributions of the samples of the block of the thread to
+   * the marginal and joint PDFs, and to the PDF derivatives, then empty the
+   * block. */
+  virtual void ProcessSampleBlock( const ThreadIdType threadID ) const;
+
+  /** Compute the weights of the four bins of the cubic B-spline Parzen
+   * window of the moving image for each sample of the block, and of its
+   * derivative if \c computeDerivativeWeights is true, given the fractional
+   * parts of the Parzen window terms. This gives the values of
+   * CubicBSplineFunctionType and CubicBSplineDerivativeFunctionType in
+   * closed form, without a virtual call per bin. */
+  static void ComputeCubicBSplineWeights(SampleBlockStruct & block,
+                                         bool                computeDerivativeWeights);
+
+  /** Compute PDF derivative contribution for each parameter, for the four
+   * bins of the Parzen window starting at \c pdfMovingIndex, given the
+   * products of the transform Jacobian with the moving image gradient. */
   virtual void ComputePDFDerivatives(const ThreadIdType &    threadID,
                              const OffsetValueType &         fixedImageParzenWindowIndex,
-                             const JacobianType &            jacobian,
                              const OffsetValueType &         pdfMovingIndex,
-                             const MovingImageGradientType & movingGradient,
-                             const PDFValueType &            cubicBSplineDerivativeValue,
-                             DerivativeValueType *           localSupportDerivativeResultPtr) const;
+                             const DerivativeType &          innerProducts,
+                             const PDFValueType *            derivativeWeights,
+                             const OffsetValueType &         localDerivativeOffset) const;
 
 private:
   MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader( const Self & ); // purposely not implemented
@@ -122,6 +168,9 @@ private:
   /** Internal pointer to the Mattes metric object in use by this threader.
    *  This will avoid costly dynamic casting in tight loops. */
   TMattesMutualInformationMetric * m_MattesAssociate;
+
+  /** Block of samples of each thread. */
+  mutable std::vector< SampleBlockStruct > m_SampleBlocks;
 };
 
 } // end namespace itk
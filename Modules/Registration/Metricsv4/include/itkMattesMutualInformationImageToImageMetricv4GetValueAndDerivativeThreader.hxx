@@ -189,6 +189,39 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
       this->m_MattesAssociate->m_ThreaderJointPDFDerivatives[threadID]->FillBuffer(0.0F);
       }
     }
+
+  /* Allocate the blocks of samples of the threads. */
+  this->m_SampleBlocks.resize( localNumberOfThreadsUsed );
+  for( ThreadIdType threadID = 0; threadID < localNumberOfThreadsUsed; ++threadID )
+    {
+    SampleBlockStruct & block = this->m_SampleBlocks[threadID];
+    block.NumberOfSamples = 0;
+    block.VirtualIndices.resize( SampleBlockSize );
+    block.VirtualPoints.resize( SampleBlockSize );
+    block.FixedImageValues.resize( SampleBlockSize );
+    block.MovingImageValues.resize( SampleBlockSize );
+    block.MovingImageGradients.resize( SampleBlockSize );
+    block.FixedImageParzenWindowIndices.resize( SampleBlockSize );
+    block.PDFMovingIndices.resize( SampleBlockSize );
+    block.Fractions.resize( SampleBlockSize );
+    for( unsigned int movingParzenBin = 0; movingParzenBin < 4; ++movingParzenBin )
+      {
+      block.Weights[movingParzenBin].resize( SampleBlockSize );
+      block.DerivativeWeights[movingParzenBin].resize( SampleBlockSize );
+      }
+    }
+}
+
+template< typename TDomainPartitioner, typename TImageToImageMetric, typename TMattesMutualInformationMetric >
+void
+MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomainPartitioner, TImageToImageMetric, TMattesMutualInformationMetric >
+::ThreadedExecution( const DomainType & subdomain,
+                     const ThreadIdType threadId )
+{
+  Superclass::ThreadedExecution( subdomain, threadId );
+
+  // Process the samples left in the block of the thread
+  this->ProcessSampleBlock( threadId );
 }
 
 
@@ -207,11 +240,6 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
                 DerivativeType &,
                 const ThreadIdType                 threadID) const
 {
-  /**
-   * Compute this sample's contribution to the marginal
-   *   and joint distributions.
-   *
-   */
   if( movingImageValue < this->m_MattesAssociate->m_MovingImageTrueMin )
     {
     return false;
@@ -221,33 +249,73 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
     return false;
     }
 
-  // Determine parzen window arguments (see eqn 6 of Mattes paper [2]).
-  PDFValueType movingImageParzenWindowTerm = movingImageValue / this->m_MattesAssociate->m_MovingImageBinSize - this->m_MattesAssociate->m_MovingImageNormalizedMin;
-  OffsetValueType movingImageParzenWindowIndex = static_cast<OffsetValueType>( movingImageParzenWindowTerm );
+  SampleBlockStruct & block = this->m_SampleBlocks[threadID];
+  const SizeValueType sample = block.NumberOfSamples;
+  block.VirtualIndices[sample] = virtualIndex;
+  block.VirtualPoints[sample] = virtualPoint;
+  block.FixedImageValues[sample] = fixedImageValue;
+  block.MovingImageValues[sample] = movingImageValue;
+  if( this->m_MattesAssociate->GetComputeDerivative() )
+    {
+    block.MovingImageGradients[sample] = movingImageGradient;
+    }
+  if( ++block.NumberOfSamples == SampleBlockSize )
+    {
+    this->ProcessSampleBlock( threadID );
+    }
 
-  // Make sure the extreme values are in valid bins
-  if( movingImageParzenWindowIndex < 2 )
+  // Return false to avoid the storage of results in parent class.
+  return false;
+}
+
+/**
+ * ProcessSampleBlock
+ */
+template< typename TDomainPartitioner, typename TImageToImageMetric, typename TMattesMutualInformationMetric >
+void
+MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomainPartitioner, TImageToImageMetric, TMattesMutualInformationMetric >
+::ProcessSampleBlock( const ThreadIdType threadID ) const
+{
+  SampleBlockStruct & block = this->m_SampleBlocks[threadID];
+  const SizeValueType numberOfSamples = block.NumberOfSamples;
+  if( numberOfSamples == 0 )
     {
-    movingImageParzenWindowIndex = 2;
+    return;
     }
-  else
+
+  /**
+   * Compute the contributions of the samples to the marginal
+   *   and joint distributions.
+   *
+   */
+  const OffsetValueType numberOfHistogramBins = static_cast<OffsetValueType>( this->m_MattesAssociate->m_NumberOfHistogramBins );
+  const PDFValueType    movingImageBinSize = this->m_MattesAssociate->m_MovingImageBinSize;
+  const PDFValueType    movingImageNormalizedMin = this->m_MattesAssociate->m_MovingImageNormalizedMin;
+  for( SizeValueType sample = 0; sample < numberOfSamples; ++sample )
     {
-    const OffsetValueType nindex = static_cast<OffsetValueType>( this->m_MattesAssociate->m_NumberOfHistogramBins ) - 3;
-    if( movingImageParzenWindowIndex > nindex )
+    // Determine parzen window arguments (see eqn 6 of Mattes paper [2]).
+    const PDFValueType movingImageParzenWindowTerm = block.MovingImageValues[sample] / movingImageBinSize - movingImageNormalizedMin;
+    OffsetValueType movingImageParzenWindowIndex = static_cast<OffsetValueType>( movingImageParzenWindowTerm );
+
+    // Make sure the extreme values are in valid bins
+    if( movingImageParzenWindowIndex < 2 )
       {
-      movingImageParzenWindowIndex = nindex;
+      movingImageParzenWindowIndex = 2;
       }
-    }
-  // Move the pointer to the first affected bin
-  OffsetValueType pdfMovingIndex = static_cast<OffsetValueType>( movingImageParzenWindowIndex ) - 1;
-  const OffsetValueType pdfMovingIndexMax = static_cast<OffsetValueType>( movingImageParzenWindowIndex ) + 2;
+    else if( movingImageParzenWindowIndex > numberOfHistogramBins - 3 )
+      {
+      movingImageParzenWindowIndex = numberOfHistogramBins - 3;
+      }
+    // Move to the first affected bin
+    block.PDFMovingIndices[sample] = movingImageParzenWindowIndex - 1;
+    block.Fractions[sample] = movingImageParzenWindowTerm - static_cast<PDFValueType>( movingImageParzenWindowIndex );
 
-  const OffsetValueType fixedImageParzenWindowIndex = this->m_MattesAssociate->ComputeSingleFixedImageParzenWindowIndex( fixedImageValue );
+    block.FixedImageParzenWindowIndices[sample] =
+      this->m_MattesAssociate->ComputeSingleFixedImageParzenWindowIndex( block.FixedImageValues[sample] );
+    }
 
-  // Since a zero-order BSpline (box car) kernel is used for
-  // the fixed image marginal pdf, we need only increment the
-  // fixedImageParzenWindowIndex by value of 1.0.
-  this->m_MattesAssociate->m_ThreaderFixedImageMarginalPDF[threadID][fixedImageParzenWindowIndex] += 1;
+  const bool doComputeDerivative = this->m_MattesAssociate->GetComputeDerivative();
+  this->ComputeCubicBSplineWeights( block, doComputeDerivative );
 
   /**
     * The region of support of the parzen window determines which bins
@@ -260,126 +328,180 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
     * zero-th (column) dimension and the fixed image bins corresponds
     * to the first (row) dimension.
     */
-  PDFValueType movingImageParzenWindowArg = static_cast<PDFValueType>( pdfMovingIndex ) - static_cast<PDFValueType>( movingImageParzenWindowTerm );
+  std::vector<PDFValueType> & fixedImageMarginalPDF = this->m_MattesAssociate->m_ThreaderFixedImageMarginalPDF[threadID];
+  JointPDFValueType * const   jointPDFPtr = this->m_MattesAssociate->m_ThreaderJointPDF[threadID]->GetBufferPointer();
+  for( SizeValueType sample = 0; sample < numberOfSamples; ++sample )
+    {
+    const OffsetValueType fixedImageParzenWindowIndex = block.FixedImageParzenWindowIndices[sample];
 
-  // Pointer to affected bin to be updated
-  JointPDFValueType *pdfPtr = this->m_MattesAssociate->m_ThreaderJointPDF[threadID]->GetBufferPointer()
-                              + ( fixedImageParzenWindowIndex * this->m_MattesAssociate->m_NumberOfHistogramBins ) + pdfMovingIndex;
+    // Since a zero-order BSpline (box car) kernel is used for
+    // the fixed image marginal pdf, we need only increment the
+    // fixedImageParzenWindowIndex by value of 1.0.
+    fixedImageMarginalPDF[fixedImageParzenWindowIndex] += 1;
 
-  OffsetValueType localDerivativeOffset = 0;
-  // Store the pdf indecies for this point.
-  // Just store the starting pdfMovingIndex and we'll iterate later
-  // over the next four to collect results.
-  if( this->m_MattesAssociate->GetComputeDerivative() && ( this->m_MattesAssociate->HasLocalSupport() ) )
-    {
-    const OffsetValueType jointPdfIndex1D = pdfMovingIndex + (fixedImageParzenWindowIndex * this->m_MattesAssociate->m_NumberOfHistogramBins);
-    localDerivativeOffset = this->m_MattesAssociate->ComputeParameterOffsetFromVirtualIndex( virtualIndex, this->GetCachedNumberOfLocalParameters() );
-    for (NumberOfParametersType i=0, numLocalParameters = this->GetCachedNumberOfLocalParameters();
-      i < numLocalParameters; ++i)
+    // Pointer to affected bin to be updated
+    JointPDFValueType *pdfPtr = jointPDFPtr + ( fixedImageParzenWindowIndex * numberOfHistogramBins ) + block.PDFMovingIndices[sample];
+    for( unsigned int movingParzenBin = 0; movingParzenBin < 4; ++movingParzenBin )
       {
-      this->m_MattesAssociate->m_JointPdfIndex1DArray[localDerivativeOffset + i] = jointPdfIndex1D;
+      pdfPtr[movingParzenBin] += block.Weights[movingParzenBin][sample];
       }
     }
 
-  // Compute the transform Jacobian.
-  typedef JacobianType & JacobianReferenceType;
-  JacobianReferenceType jacobian = this->m_GetValueAndDerivativePerThreadVariables[threadID].MovingTransformJacobian;
-  if( this->m_MattesAssociate->GetComputeDerivative() )
+  if( doComputeDerivative )
     {
-    this->m_MattesAssociate->GetMovingTransform()->ComputeJacobianWithRespectToParameters( virtualPoint, jacobian);
-    }
-
-  SizeValueType movingParzenBin = 0;
-
-  const bool doComputeDerivative = this->m_MattesAssociate->GetComputeDerivative();
-  const bool transformIsDisplacement = this->m_MattesAssociate->m_MovingTransform->GetTransformCategory() == MovingTransformType::DisplacementField;
-  while( pdfMovingIndex <= pdfMovingIndexMax )
-    {
-    const PDFValueType val = static_cast<PDFValueType>( this->m_MattesAssociate->m_CubicBSplineKernel ->Evaluate( movingImageParzenWindowArg) );
-    *( pdfPtr++ ) += val;
-
-    if( doComputeDerivative )
+    const bool                   hasLocalSupport = this->m_MattesAssociate->HasLocalSupport();
+    const NumberOfParametersType numberOfLocalParameters = this->GetCachedNumberOfLocalParameters();
+
+    typedef JacobianType & JacobianReferenceType;
+    JacobianReferenceType jacobian = this->m_GetValueAndDerivativePerThreadVariables[threadID].MovingTransformJacobian;
+    // The local derivative is otherwise unused by this metric.
+    DerivativeType & innerProducts = this->m_GetValueAndDerivativePerThreadVariables[threadID].LocalDerivatives;
+    for( SizeValueType sample = 0; sample < numberOfSamples; ++sample )
       {
-      // Compute the cubicBSplineDerivative for later repeated use.
-      const PDFValueType cubicBSplineDerivativeValue = this->m_MattesAssociate->m_CubicBSplineDerivativeKernel->Evaluate(movingImageParzenWindowArg);
+      const OffsetValueType fixedImageParzenWindowIndex = block.FixedImageParzenWindowIndices[sample];
+      const OffsetValueType pdfMovingIndex = block.PDFMovingIndices[sample];
+
+      OffsetValueType localDerivativeOffset = 0;
+      // Store the pdf indecies for this point.
+      // Just store the starting pdfMovingIndex and we'll iterate later
+      // over the next four to collect results.
+      if( hasLocalSupport )
+        {
+        const OffsetValueType jointPdfIndex1D = pdfMovingIndex + ( fixedImageParzenWindowIndex * numberOfHistogramBins );
+        localDerivativeOffset = this->m_MattesAssociate->ComputeParameterOffsetFromVirtualIndex( block.VirtualIndices[sample], numberOfLocalParameters );
+        for( NumberOfParametersType i = 0; i < numberOfLocalParameters; ++i )
+          {
+          this->m_MattesAssociate->m_JointPdfIndex1DArray[localDerivativeOffset + i] = jointPdfIndex1D;
+          }
+        }
 
-      // Pointer to local derivative partial result container.
-      // Not used with global support transforms.
-      DerivativeValueType * localSupportDerivativeResultPtr = ITK_NULLPTR;
+      // Compute the transform Jacobian.
+      this->m_MattesAssociate->GetMovingTransform()->ComputeJacobianWithRespectToParameters( block.VirtualPoints[sample], jacobian );
 
-      if( transformIsDisplacement )
+      // The products of the Jacobian with the moving image gradient are the
+      // same for the four bins, so compute them once.
+      const MovingImageGradientType & movingImageGradient = block.MovingImageGradients[sample];
+      for( NumberOfParametersType mu = 0; mu < numberOfLocalParameters; ++mu )
         {
-        // ptr to where the derivative result should go, for efficiency
-        localSupportDerivativeResultPtr = &( this->m_MattesAssociate->m_LocalDerivativeByParzenBin[movingParzenBin][localDerivativeOffset] );
+        PDFValueType innerProduct = 0.0;
+        for( SizeValueType dim = 0, lastDim = this->m_MattesAssociate->MovingImageDimension; dim < lastDim; ++dim )
+          {
+          innerProduct += jacobian[dim][mu] * movingImageGradient[dim];
+          }
+        innerProducts[mu] = innerProduct;
         }
 
       // Compute PDF derivative contribution.
+      const PDFValueType derivativeWeights[4] = { block.DerivativeWeights[0][sample],
+                                                  block.DerivativeWeights[1][sample],
+                                                  block.DerivativeWeights[2][sample],
+                                                  block.DerivativeWeights[3][sample] };
       this->ComputePDFDerivatives(threadID,
         fixedImageParzenWindowIndex,
-        jacobian,
         pdfMovingIndex,
-        movingImageGradient,
-        cubicBSplineDerivativeValue,
-        localSupportDerivativeResultPtr);
+        innerProducts,
+        derivativeWeights,
+        localDerivativeOffset);
       }
-
-    movingImageParzenWindowArg += 1.0;
-    ++pdfMovingIndex;
-    ++movingParzenBin;
     }
 
-  // have to do this here since we're returning false
-  this->m_GetValueAndDerivativePerThreadVariables[threadID].NumberOfValidPoints++;
-
-  // Return false to avoid the storage of results in parent class.
-  return false;
+  // have to do this here since ProcessPoint returns false
+  this->m_GetValueAndDerivativePerThreadVariables[threadID].NumberOfValidPoints += numberOfSamples;
+  block.NumberOfSamples = 0;
 }
 
 /**
- * ComputePDFDerivative
+ * ComputeCubicBSplineWeights
  */
 template< typename TDomainPartitioner, typename TImageToImageMetric, typename TMattesMutualInformationMetric >
 void
 MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomainPartitioner, TImageToImageMetric, TMattesMutualInformationMetric >
-::ComputePDFDerivatives(const ThreadIdType &            threadID,
-                        const OffsetValueType &         fixedImageParzenWindowIndex,
-                        const JacobianType &            jacobian,
-                        const OffsetValueType &         pdfMovingIndex,
-                        const MovingImageGradientType & movingImageGradient,
-                        const PDFValueType &            cubicBSplineDerivativeValue,
-                        DerivativeValueType *           localSupportDerivativeResultPtr) const
+::ComputeCubicBSplineWeights(SampleBlockStruct & block,
+                             bool                computeDerivativeWeights)
 {
-  // Update bins in the PDF derivatives for the current intensity pair
-  const OffsetValueType pdfFixedIndex = fixedImageParzenWindowIndex;
-
-  const bool isDisplacementField = ( this->m_MattesAssociate->m_MovingTransform->GetTransformCategory() == MovingTransformType::DisplacementField );
-
-  JointPDFDerivativesValueType *derivPtr=ITK_NULLPTR;
-  if( ! isDisplacementField )
+  const SizeValueType  numberOfSamples = block.NumberOfSamples;
+  const PDFValueType * fractions = &block.Fractions[0];
+
+  // The bins are at -1 - fraction, -fraction, 1 - fraction and 2 - fraction
+  // of the parzen window term.
+  PDFValueType * weights0 = &block.Weights[0][0];
+  PDFValueType * weights1 = &block.Weights[1][0];
+  PDFValueType * weights2 = &block.Weights[2][0];
+  PDFValueType * weights3 = &block.Weights[3][0];
+  for( SizeValueType sample = 0; sample < numberOfSamples; ++sample )
     {
-    derivPtr = this->m_MattesAssociate->m_ThreaderJointPDFDerivatives[threadID]->GetBufferPointer()
-      + ( pdfFixedIndex  * this->m_MattesAssociate->m_ThreaderJointPDFDerivatives[threadID]->GetOffsetTable()[2] )
-      + ( pdfMovingIndex * this->m_MattesAssociate->m_ThreaderJointPDFDerivatives[threadID]->GetOffsetTable()[1] );
+    const PDFValueType f = fractions[sample];
+    const PDFValueType g = 1.0 - f;
+    const PDFValueType f2 = f * f;
+    const PDFValueType g2 = g * g;
+    weights0[sample] = g2 * g / 6.0;
+    weights1[sample] = ( 4.0 - 6.0 * f2 + 3.0 * f2 * f ) / 6.0;
+    weights2[sample] = ( 4.0 - 6.0 * g2 + 3.0 * g2 * g ) / 6.0;
+    weights3[sample] = f2 * f / 6.0;
     }
 
-  for( NumberOfParametersType mu = 0, maxElement=this->GetCachedNumberOfLocalParameters(); mu < maxElement; ++mu )
+  if( computeDerivativeWeights )
     {
-    PDFValueType innerProduct = 0.0;
-    for( SizeValueType dim = 0, lastDim = this->m_MattesAssociate->MovingImageDimension; dim < lastDim; ++dim )
+    PDFValueType * derivativeWeights0 = &block.DerivativeWeights[0][0];
+    PDFValueType * derivativeWeights1 = &block.DerivativeWeights[1][0];
+    PDFValueType * derivativeWeights2 = &block.DerivativeWeights[2][0];
+    PDFValueType * derivativeWeights3 = &block.DerivativeWeights[3][0];
+    for( SizeValueType sample = 0; sample < numberOfSamples; ++sample )
       {
-      innerProduct += jacobian[dim][mu] * movingImageGradient[dim];
+      const PDFValueType f = fractions[sample];
+      const PDFValueType g = 1.0 - f;
+      derivativeWeights0[sample] = 0.5 * g * g;
+      derivativeWeights1[sample] = 2.0 * f - 1.5 * f * f;
+      derivativeWeights2[sample] = -2.0 * g + 1.5 * g * g;
+      derivativeWeights3[sample] = -0.5 * f * f;
       }
+    }
+}
 
-    const PDFValueType derivativeContribution = innerProduct * cubicBSplineDerivativeValue;
-    if( isDisplacementField )
+/**
+ * ComputePDFDerivative
+ */
+template< typename TDomainPartitioner, typename TImageToImageMetric, typename TMattesMutualInformationMetric >
+void
+MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomainPartitioner, TImageToImageMetric, TMattesMutualInformationMetric >
+::ComputePDFDerivatives(const ThreadIdType &            threadID,
+                        const OffsetValueType &         fixedImageParzenWindowIndex,
+                        const OffsetValueType &         pdfMovingIndex,
+                        const DerivativeType &          innerProducts,
+                        const PDFValueType *            derivativeWeights,
+                        const OffsetValueType &         localDerivativeOffset) const
+{
+  const NumberOfParametersType numberOfLocalParameters = this->GetCachedNumberOfLocalParameters();
+  const DerivativeValueType *  innerProductsPtr = innerProducts.data_block();
+
+  if( this->m_MattesAssociate->m_MovingTransform->GetTransformCategory() == MovingTransformType::DisplacementField )
+    {
+    for( unsigned int movingParzenBin = 0; movingParzenBin < 4; ++movingParzenBin )
       {
-      *( localSupportDerivativeResultPtr ) += derivativeContribution;
-      localSupportDerivativeResultPtr++;
+      DerivativeValueType * localSupportDerivativeResultPtr =
+        &( this->m_MattesAssociate->m_LocalDerivativeByParzenBin[movingParzenBin][localDerivativeOffset] );
+      const PDFValueType derivativeWeight = derivativeWeights[movingParzenBin];
+      for( NumberOfParametersType mu = 0; mu < numberOfLocalParameters; ++mu )
+        {
+        localSupportDerivativeResultPtr[mu] += innerProductsPtr[mu] * derivativeWeight;
+        }
       }
-    else
+    }
+  else
+    {
+    // The derivatives of the four bins of the fixed image bin are
+    // contiguous, and are updated in memory order.
+    JointPDFDerivativesValueType * derivPtr = this->m_MattesAssociate->m_ThreaderJointPDFDerivatives[threadID]->GetBufferPointer()
+      + ( fixedImageParzenWindowIndex * this->m_MattesAssociate->m_ThreaderJointPDFDerivatives[threadID]->GetOffsetTable()[2] )
+      + ( pdfMovingIndex * this->m_MattesAssociate->m_ThreaderJointPDFDerivatives[threadID]->GetOffsetTable()[1] );
+    for( unsigned int movingParzenBin = 0; movingParzenBin < 4; ++movingParzenBin )
       {
-      *( derivPtr ) -= derivativeContribution;
-      ++derivPtr;
+      const PDFValueType derivativeWeight = derivativeWeights[movingParzenBin];
+      for( NumberOfParametersType mu = 0; mu < numberOfLocalParameters; ++mu )
+        {
+        derivPtr[mu] -= innerProductsPtr[mu] * derivativeWeight;
+        }
+      derivPtr += numberOfLocalParameters;
       }
     }
 }
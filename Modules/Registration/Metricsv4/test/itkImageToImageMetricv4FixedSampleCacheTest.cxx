@@ -0,0 +1,171 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkCorrelationImageToImageMetricv4.h"
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkTranslationTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTimeProbe.h"
+#include "itkTestingMacros.h"
+
+/*
+ * Check that a metric evaluates to the same values and derivatives with and
+ * without the fixed sample cache, with dense and sparse sampling, as the
+ * moving and fixed transforms change.
+ */
+
+namespace
+{
+const unsigned int Dimension = 2;
+typedef itk::Image< double, Dimension >                ImageType;
+typedef itk::TranslationTransform< double, Dimension > TransformType;
+
+ImageType::Pointer CreateImage(double centerX, double centerY)
+{
+  ImageType::SizeType size;
+  size.Fill( 64 );
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const double x = it.GetIndex()[0] - centerX;
+    const double y = it.GetIndex()[1] - centerY;
+    it.Set( 100.0 * std::exp( -( x * x + 2.0 * y * y ) / 200.0 ) + 0.1 * it.GetIndex()[0] );
+    }
+  return image;
+}
+
+template< typename TMetric >
+int TestMetric(const char *name, bool sparse)
+{
+  std::cout << name << ( sparse ? " sparse" : " dense" ) << std::endl;
+
+  ImageType::Pointer fixedImage = CreateImage( 30.0, 32.0 );
+  ImageType::Pointer movingImage = CreateImage( 34.0, 30.0 );
+
+  typedef typename TMetric::FixedSampledPointSetType PointSetType;
+  typename PointSetType::Pointer pointSet = PointSetType::New();
+  itk::SizeValueType numberOfPoints = 0;
+  itk::ImageRegionIteratorWithIndex< ImageType > it( fixedImage, fixedImage->GetLargestPossibleRegion() );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    if( ( it.GetIndex()[0] + 2 * it.GetIndex()[1] ) % 3 == 0 )
+      {
+      typename PointSetType::PointType point;
+      fixedImage->TransformIndexToPhysicalPoint( it.GetIndex(), point );
+      pointSet->SetPoint( numberOfPoints++, point );
+      }
+    }
+
+  TransformType::Pointer fixedTransform[2];
+  TransformType::Pointer movingTransform[2];
+  typename TMetric::Pointer metric[2];
+  for( unsigned int m = 0; m < 2; ++m )
+    {
+    fixedTransform[m] = TransformType::New();
+    fixedTransform[m]->SetIdentity();
+    movingTransform[m] = TransformType::New();
+    movingTransform[m]->SetIdentity();
+    metric[m] = TMetric::New();
+    metric[m]->SetFixedImage( fixedImage );
+    metric[m]->SetMovingImage( movingImage );
+    metric[m]->SetFixedTransform( fixedTransform[m] );
+    metric[m]->SetMovingTransform( movingTransform[m] );
+    metric[m]->SetFixedSampledPointSet( pointSet );
+    metric[m]->SetUseFixedSampledPointSet( sparse );
+    metric[m]->SetUseFixedSampleCache( m == 1 );
+    metric[m]->Initialize();
+    }
+  TEST_EXPECT_TRUE( !metric[0]->GetUseFixedSampleCache() );
+  TEST_EXPECT_TRUE( metric[1]->GetUseFixedSampleCache() );
+
+  typename TMetric::DerivativeType step( Dimension );
+  step[0] = 0.3;
+  step[1] = -0.2;
+  itk::TimeProbe probe[2];
+  for( unsigned int iteration = 0; iteration < 10; ++iteration )
+    {
+    // Move the fixed side as well, which clears the cache
+    if( iteration == 6 )
+      {
+      TransformType::ParametersType fixedParameters( Dimension );
+      fixedParameters[0] = -0.5;
+      fixedParameters[1] = 0.25;
+      fixedTransform[0]->SetParameters( fixedParameters );
+      fixedTransform[1]->SetParameters( fixedParameters );
+      }
+
+    typename TMetric::MeasureType    value[2];
+    typename TMetric::DerivativeType derivative[2];
+    for( unsigned int m = 0; m < 2; ++m )
+      {
+      probe[m].Start();
+      metric[m]->GetValueAndDerivative( value[m], derivative[m] );
+      probe[m].Stop();
+      }
+    TEST_EXPECT_EQUAL( metric[0]->GetNumberOfValidPoints(), metric[1]->GetNumberOfValidPoints() );
+    if( std::fabs( value[0] - value[1] ) > 1e-12 * std::fabs( value[0] ) )
+      {
+      std::cerr << "Value " << value[1] << " with the cache instead of " << value[0]
+                << " at iteration " << iteration << std::endl;
+      return EXIT_FAILURE;
+      }
+    for( unsigned int p = 0; p < derivative[0].Size(); ++p )
+      {
+      if( std::fabs( derivative[0][p] - derivative[1][p] ) > 1e-12 * derivative[0].magnitude() )
+        {
+        std::cerr << "Derivative " << derivative[1] << " with the cache instead of " << derivative[0]
+                  << " at iteration " << iteration << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    TEST_EXPECT_EQUAL( metric[0]->GetValue(), metric[1]->GetValue() );
+
+    for( unsigned int m = 0; m < 2; ++m )
+      {
+      metric[m]->UpdateTransformParameters( step, 1.0 );
+      }
+    }
+  std::cout << "  without cache: " << probe[0].GetTotal() << " s, with cache: "
+            << probe[1].GetTotal() << " s" << std::endl;
+
+  return EXIT_SUCCESS;
+}
+}
+
+int itkImageToImageMetricv4FixedSampleCacheTest(int, char *[])
+{
+  typedef itk::MeanSquaresImageToImageMetricv4< ImageType, ImageType >        MeanSquaresType;
+  typedef itk::CorrelationImageToImageMetricv4< ImageType, ImageType >        CorrelationType;
+  typedef itk::MattesMutualInformationImageToImageMetricv4< ImageType, ImageType > MattesType;
+
+  for( unsigned int sparse = 0; sparse < 2; ++sparse )
+    {
+    if( TestMetric< MeanSquaresType >( "MeanSquares", sparse ) == EXIT_FAILURE ||
+        TestMetric< CorrelationType >( "Correlation", sparse ) == EXIT_FAILURE ||
+        TestMetric< MattesType >( "MattesMutualInformation", sparse ) == EXIT_FAILURE )
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
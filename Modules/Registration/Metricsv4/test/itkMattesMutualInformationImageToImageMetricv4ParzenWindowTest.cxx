@@ -0,0 +1,419 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkAffineTransform.h"
+#include "itkBSplineDerivativeKernelFunction.h"
+#include "itkBSplineKernelFunction.h"
+#include "itkDisplacementFieldTransform.h"
+#include "itkImageFileReader.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+/*
+ * Compare the value and derivative of the Mattes mutual information,
+ * whose threader evaluates the Parzen windows of blocks of samples, with
+ * those computed sample by sample with the cubic B-spline kernel functions,
+ * as the threader did before. Affine and displacement field transforms are
+ * checked, over the whole virtual domain and over a sampled point set.
+ * The volumes are read from files when given, e.g. brain volumes, and are
+ * synthetic otherwise.
+ */
+
+namespace
+{
+typedef itk::Image< float, 3 >                                                             MattesParzenWindowTestImageType;
+typedef itk::MattesMutualInformationImageToImageMetricv4< MattesParzenWindowTestImageType,
+                                                          MattesParzenWindowTestImageType > MattesParzenWindowTestMetricType;
+
+const unsigned int MattesParzenWindowTestNumberOfHistogramBins = 32;
+
+MattesParzenWindowTestImageType::Pointer
+MattesParzenWindowTestCreateImage( int imageSize, double shift )
+{
+  MattesParzenWindowTestImageType::SizeType size;
+  size.Fill( imageSize );
+  MattesParzenWindowTestImageType::Pointer image = MattesParzenWindowTestImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< MattesParzenWindowTestImageType > it( image, image->GetLargestPossibleRegion() );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    double r2 = 0.0;
+    for( unsigned int d = 0; d < 3; ++d )
+      {
+      const double x = ( it.GetIndex()[d] - shift ) / imageSize - 0.5;
+      r2 += x * x;
+      }
+    // Nested shells of different intensities
+    it.Set( static_cast< float >( 100.0 * std::cos( 20.0 * r2 ) * std::exp( -4.0 * r2 ) + it.GetIndex()[2] ) );
+    }
+  return image;
+}
+
+void
+MattesParzenWindowTestMinMax( const MattesParzenWindowTestImageType * image, double & min, double & max )
+{
+  itk::ImageRegionConstIteratorWithIndex< MattesParzenWindowTestImageType > it( image, image->GetBufferedRegion() );
+  min = itk::NumericTraits< double >::max();
+  max = itk::NumericTraits< double >::NonpositiveMin();
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    min = std::min( min, static_cast< double >( it.Get() ) );
+    max = std::max( max, static_cast< double >( it.Get() ) );
+    }
+}
+
+long
+MattesParzenWindowTestBin( double term )
+{
+  const long bin = static_cast< long >( term );
+  return std::max( 2L, std::min( bin, static_cast< long >( MattesParzenWindowTestNumberOfHistogramBins ) - 3 ) );
+}
+
+// Compute the value and derivative of the metric at the virtual points one
+// sample at a time, evaluating the kernel functions for each bin.
+void
+MattesParzenWindowTestReference( MattesParzenWindowTestMetricType * metric,
+                                 const std::vector< MattesParzenWindowTestMetricType::VirtualPointType > & virtualPoints,
+                                 double & value,
+                                 MattesParzenWindowTestMetricType::DerivativeType & derivative )
+{
+  typedef MattesParzenWindowTestMetricType          MetricType;
+  typedef MetricType::MovingTransformType           TransformType;
+  typedef itk::BSplineKernelFunction< 3, double >   KernelType;
+  typedef itk::BSplineDerivativeKernelFunction< 3 > DerivativeKernelType;
+
+  const long bins = MattesParzenWindowTestNumberOfHistogramBins;
+  const double padding = 2.0;
+  double fixedMin, fixedMax, movingMin, movingMax;
+  MattesParzenWindowTestMinMax( metric->GetFixedImage(), fixedMin, fixedMax );
+  MattesParzenWindowTestMinMax( metric->GetMovingImage(), movingMin, movingMax );
+  const double fixedBinSize = ( fixedMax - fixedMin ) / ( bins - 2 * padding );
+  const double fixedNormalizedMin = fixedMin / fixedBinSize - padding;
+  const double movingBinSize = ( movingMax - movingMin ) / ( bins - 2 * padding );
+  const double movingNormalizedMin = movingMin / movingBinSize - padding;
+
+  KernelType::Pointer           kernel = KernelType::New();
+  DerivativeKernelType::Pointer derivativeKernel = DerivativeKernelType::New();
+
+  TransformType *             transform = metric->GetModifiableMovingTransform();
+  const bool                  localSupport = transform->GetTransformCategory() == TransformType::DisplacementField;
+  const unsigned int          numberOfLocalParameters = transform->GetNumberOfLocalParameters();
+  TransformType::JacobianType jacobian;
+  std::vector< double >       innerProducts( numberOfLocalParameters );
+
+  std::vector< double > jointPDF( bins * bins, 0.0 );
+  std::vector< double > fixedMarginalPDF( bins, 0.0 );
+  std::vector< double > jointPDFDerivatives( localSupport ? 0 : bins * bins * numberOfLocalParameters, 0.0 );
+  // With local support, the derivative contributions of the samples, their
+  // first parameter and the first bin of their Parzen window
+  std::vector< double > localContributions;
+  std::vector< long >   localOffsets;
+  std::vector< long >   localBins;
+  double                numberOfValidPoints = 0.0;
+  for( size_t p = 0; p < virtualPoints.size(); ++p )
+    {
+    const MetricType::VirtualPointType & virtualPoint = virtualPoints[p];
+    const MetricType::FixedImagePointType fixedPoint = metric->GetFixedTransform()->TransformPoint( virtualPoint );
+    const MetricType::MovingImagePointType movingPoint = transform->TransformPoint( virtualPoint );
+    if( !metric->GetFixedInterpolator()->IsInsideBuffer( fixedPoint ) ||
+        !metric->GetMovingInterpolator()->IsInsideBuffer( movingPoint ) )
+      {
+      continue;
+      }
+    const double fixedValue = metric->GetFixedInterpolator()->Evaluate( fixedPoint );
+    const double movingValue = metric->GetMovingInterpolator()->Evaluate( movingPoint );
+    if( movingValue < movingMin || movingValue > movingMax )
+      {
+      continue;
+      }
+    ++numberOfValidPoints;
+
+    const long fixedBin = MattesParzenWindowTestBin( fixedValue / fixedBinSize - fixedNormalizedMin );
+    fixedMarginalPDF[fixedBin] += 1.0;
+
+    const double movingTerm = movingValue / movingBinSize - movingNormalizedMin;
+    const long   firstMovingBin = MattesParzenWindowTestBin( movingTerm ) - 1;
+
+    const MetricType::MovingImageGradientType gradient =
+      metric->GetModifiableMovingImageGradientCalculator()->Evaluate( movingPoint );
+    transform->ComputeJacobianWithRespectToParameters( virtualPoint, jacobian );
+    for( unsigned int mu = 0; mu < numberOfLocalParameters; ++mu )
+      {
+      innerProducts[mu] = 0.0;
+      for( unsigned int dim = 0; dim < 3; ++dim )
+        {
+        innerProducts[mu] += jacobian[dim][mu] * gradient[dim];
+        }
+      }
+    if( localSupport )
+      {
+      MetricType::VirtualIndexType virtualIndex;
+      metric->GetVirtualImage()->TransformPhysicalPointToIndex( virtualPoint, virtualIndex );
+      localOffsets.push_back( metric->GetVirtualImage()->ComputeOffset( virtualIndex ) * numberOfLocalParameters );
+      localBins.push_back( fixedBin * bins + firstMovingBin );
+      }
+
+    for( long movingBin = firstMovingBin; movingBin < firstMovingBin + 4; ++movingBin )
+      {
+      const double arg = movingBin - movingTerm;
+      jointPDF[fixedBin * bins + movingBin] += kernel->Evaluate( arg );
+      const double derivativeWeight = derivativeKernel->Evaluate( arg );
+      for( unsigned int mu = 0; mu < numberOfLocalParameters; ++mu )
+        {
+        if( localSupport )
+          {
+          localContributions.push_back( innerProducts[mu] * derivativeWeight );
+          }
+        else
+          {
+          jointPDFDerivatives[( fixedBin * bins + movingBin ) * numberOfLocalParameters + mu] -=
+            innerProducts[mu] * derivativeWeight;
+          }
+        }
+      }
+    }
+
+  double jointPDFSum = 0.0;
+  for( long i = 0; i < bins * bins; ++i )
+    {
+    jointPDFSum += jointPDF[i];
+    }
+  std::vector< double > movingMarginalPDF( bins, 0.0 );
+  for( long i = 0; i < bins * bins; ++i )
+    {
+    jointPDF[i] /= jointPDFSum;
+    movingMarginalPDF[i % bins] += jointPDF[i];
+    }
+  for( long i = 0; i < bins; ++i )
+    {
+    fixedMarginalPDF[i] /= numberOfValidPoints;
+    }
+
+  const double          nFactor = 1.0 / ( movingBinSize * numberOfValidPoints );
+  const double          closeToZero = std::numeric_limits< double >::epsilon();
+  std::vector< double > pRatios( bins * bins, 0.0 );
+  double                sum = 0.0;
+  derivative.SetSize( transform->GetNumberOfParameters() );
+  derivative.Fill( 0.0 );
+  for( long fixedBin = 0; fixedBin < bins; ++fixedBin )
+    {
+    for( long movingBin = 0; movingBin < bins; ++movingBin )
+      {
+      const long bin = fixedBin * bins + movingBin;
+      if( !( jointPDF[bin] > closeToZero && movingMarginalPDF[movingBin] > closeToZero ) )
+        {
+        continue;
+        }
+      pRatios[bin] = std::log( jointPDF[bin] / movingMarginalPDF[movingBin] );
+      if( fixedMarginalPDF[fixedBin] > closeToZero )
+        {
+        sum += jointPDF[bin] * ( pRatios[bin] - std::log( fixedMarginalPDF[fixedBin] ) );
+        }
+      for( unsigned int mu = 0; !localSupport && mu < numberOfLocalParameters; ++mu )
+        {
+        derivative[mu] += jointPDFDerivatives[bin * numberOfLocalParameters + mu] * nFactor * pRatios[bin];
+        }
+      }
+    }
+  for( size_t s = 0; s < localOffsets.size(); ++s )
+    {
+    for( long movingBin = 0; movingBin < 4; ++movingBin )
+      {
+      for( unsigned int mu = 0; mu < numberOfLocalParameters; ++mu )
+        {
+        derivative[localOffsets[s] + mu] -= localContributions[( s * 4 + movingBin ) * numberOfLocalParameters + mu]
+          * pRatios[localBins[s] + movingBin] * nFactor;
+        }
+      }
+    }
+  value = -sum;
+}
+
+bool
+MattesParzenWindowTestCheck( const char * name,
+                             MattesParzenWindowTestMetricType * metric,
+                             const std::vector< MattesParzenWindowTestMetricType::VirtualPointType > & virtualPoints )
+{
+  MattesParzenWindowTestMetricType::MeasureType    value;
+  MattesParzenWindowTestMetricType::DerivativeType derivative;
+  metric->GetValueAndDerivative( value, derivative );
+  const MattesParzenWindowTestMetricType::MeasureType valueOnly = metric->GetValue();
+
+  double                                           referenceValue;
+  MattesParzenWindowTestMetricType::DerivativeType referenceDerivative;
+  MattesParzenWindowTestReference( metric, virtualPoints, referenceValue, referenceDerivative );
+
+  const double tolerance = 1e-6;
+  double       derivativeMagnitude = 0.0;
+  double       derivativeDifference = 0.0;
+  for( unsigned int i = 0; i < derivative.Size(); ++i )
+    {
+    derivativeMagnitude = std::max( derivativeMagnitude, std::abs( referenceDerivative[i] ) );
+    derivativeDifference = std::max( derivativeDifference, std::abs( derivative[i] - referenceDerivative[i] ) );
+    }
+  std::cout << name << ": value " << value << ", reference " << referenceValue
+            << ", largest derivative difference " << derivativeDifference
+            << " of " << derivativeMagnitude << std::endl;
+
+  bool passed = true;
+  if( std::abs( value - referenceValue ) > tolerance * std::abs( referenceValue )
+      || std::abs( valueOnly - referenceValue ) > tolerance * std::abs( referenceValue ) )
+    {
+    std::cerr << name << ": the value " << value << " (" << valueOnly << " without derivative)"
+              << " differs from the reference " << referenceValue << std::endl;
+    passed = false;
+    }
+  if( derivative.Size() != referenceDerivative.Size()
+      || !( derivativeMagnitude > 0.0 )
+      || derivativeDifference > tolerance * derivativeMagnitude )
+    {
+    std::cerr << name << ": the derivative differs from the reference" << std::endl;
+    passed = false;
+    }
+  return passed;
+}
+
+MattesParzenWindowTestMetricType::Pointer
+MattesParzenWindowTestCreateMetric( const MattesParzenWindowTestImageType * fixedImage,
+                                    const MattesParzenWindowTestImageType * movingImage,
+                                    MattesParzenWindowTestMetricType::MovingTransformType * transform )
+{
+  MattesParzenWindowTestMetricType::Pointer metric = MattesParzenWindowTestMetricType::New();
+  metric->SetNumberOfHistogramBins( MattesParzenWindowTestNumberOfHistogramBins );
+  metric->SetFixedImage( fixedImage );
+  metric->SetMovingImage( movingImage );
+  metric->SetMovingTransform( transform );
+  // The reference evaluates the gradient with the calculator of the metric
+  metric->SetUseFixedImageGradientFilter( false );
+  metric->SetUseMovingImageGradientFilter( false );
+  return metric;
+}
+}
+
+int itkMattesMutualInformationImageToImageMetricv4ParzenWindowTest( int argc, char *argv[] )
+{
+  if( argc < 2 )
+    {
+    std::cerr << "usage: " << argv[0] << " image-size [fixed-image moving-image]" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const int imageSize = atoi( argv[1] );
+
+  typedef MattesParzenWindowTestImageType  ImageType;
+  typedef MattesParzenWindowTestMetricType MetricType;
+
+  ImageType::Pointer fixedImage;
+  ImageType::Pointer movingImage;
+  if( argc > 3 )
+    {
+    typedef itk::ImageFileReader< ImageType > ReaderType;
+    ReaderType::Pointer fixedReader = ReaderType::New();
+    fixedReader->SetFileName( argv[2] );
+    ReaderType::Pointer movingReader = ReaderType::New();
+    movingReader->SetFileName( argv[3] );
+    try
+      {
+      fixedReader->Update();
+      movingReader->Update();
+      }
+    catch( itk::ExceptionObject & exc )
+      {
+      std::cerr << exc << std::endl;
+      return EXIT_FAILURE;
+      }
+    fixedImage = fixedReader->GetOutput();
+    movingImage = movingReader->GetOutput();
+    }
+  else
+    {
+    fixedImage = MattesParzenWindowTestCreateImage( imageSize, 0.0 );
+    movingImage = MattesParzenWindowTestCreateImage( imageSize, 1.5 );
+    }
+  std::cout << "image size: " << fixedImage->GetLargestPossibleRegion().GetSize() << std::endl;
+
+  // The virtual domain is the fixed image, and the sampled point set takes
+  // every third point of it
+  std::vector< MetricType::VirtualPointType > virtualPoints;
+  std::vector< MetricType::VirtualPointType > sampledPoints;
+  MetricType::FixedSampledPointSetType::Pointer pointSet = MetricType::FixedSampledPointSetType::New();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( fixedImage, fixedImage->GetLargestPossibleRegion() );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    MetricType::VirtualPointType point;
+    fixedImage->TransformIndexToPhysicalPoint( it.GetIndex(), point );
+    virtualPoints.push_back( point );
+    if( virtualPoints.size() % 3 == 0 )
+      {
+      pointSet->SetPoint( sampledPoints.size(), point );
+      sampledPoints.push_back( point );
+      }
+    }
+
+  bool testPassed = true;
+
+  typedef itk::AffineTransform< double, 3 > AffineTransformType;
+  AffineTransformType::Pointer affineTransform = AffineTransformType::New();
+  AffineTransformType::MatrixType matrix;
+  matrix.SetIdentity();
+  matrix[0][1] = 0.05;
+  matrix[2][0] = -0.03;
+  affineTransform->SetMatrix( matrix );
+  AffineTransformType::OutputVectorType translation;
+  translation.Fill( 0.5 );
+  affineTransform->SetTranslation( translation );
+
+  MetricType::Pointer metric = MattesParzenWindowTestCreateMetric( fixedImage, movingImage, affineTransform );
+  metric->Initialize();
+  testPassed &= MattesParzenWindowTestCheck( "affine", metric, virtualPoints );
+
+  MetricType::Pointer sampledMetric = MattesParzenWindowTestCreateMetric( fixedImage, movingImage, affineTransform );
+  sampledMetric->SetFixedSampledPointSet( pointSet );
+  sampledMetric->SetUseFixedSampledPointSet( true );
+  sampledMetric->Initialize();
+  testPassed &= MattesParzenWindowTestCheck( "affine, sampled points", sampledMetric, sampledPoints );
+
+  typedef itk::DisplacementFieldTransform< double, 3 > DisplacementFieldTransformType;
+  typedef DisplacementFieldTransformType::DisplacementFieldType FieldType;
+  FieldType::Pointer field = FieldType::New();
+  field->CopyInformation( fixedImage );
+  field->SetRegions( fixedImage->GetLargestPossibleRegion() );
+  field->Allocate();
+  itk::ImageRegionIteratorWithIndex< FieldType > fieldIt( field, field->GetLargestPossibleRegion() );
+  for( fieldIt.GoToBegin(); !fieldIt.IsAtEnd(); ++fieldIt )
+    {
+    FieldType::PixelType displacement;
+    displacement[0] = 0.5 + 0.3 * std::sin( 0.2 * fieldIt.GetIndex()[1] );
+    displacement[1] = -0.25;
+    displacement[2] = 0.4 * std::cos( 0.3 * fieldIt.GetIndex()[0] );
+    fieldIt.Set( displacement );
+    }
+  DisplacementFieldTransformType::Pointer displacementFieldTransform = DisplacementFieldTransformType::New();
+  displacementFieldTransform->SetDisplacementField( field );
+
+  MetricType::Pointer fieldMetric = MattesParzenWindowTestCreateMetric( fixedImage, movingImage, displacementFieldTransform );
+  fieldMetric->Initialize();
+  testPassed &= MattesParzenWindowTestCheck( "displacement field", fieldMetric, virtualPoints );
+
+  if( !testPassed )
+    {
+    std::cerr << "Test failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
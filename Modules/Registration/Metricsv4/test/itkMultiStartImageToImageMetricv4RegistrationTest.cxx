@@ -215,6 +215,21 @@ int itkMultiStartImageToImageMetricv4RegistrationTest(int argc, char *argv[])
   MOptimizer->SetParametersList( parametersList );
   MOptimizer->SetLocalOptimizer(optimizer);
   MOptimizer->StartOptimization();
+
+  // Optimizing the starts concurrently finds the same best start
+  MOptimizerType::Pointer  concurrentMOptimizer = MOptimizerType::New();
+  concurrentMOptimizer->SetMetric( metric );
+  concurrentMOptimizer->SetParametersList( parametersList );
+  concurrentMOptimizer->SetLocalOptimizer( optimizer );
+  concurrentMOptimizer->SetMaximumNumberOfConcurrentStarts( 4 );
+  concurrentMOptimizer->StartOptimization();
+  std::cout << " best index with concurrent starts " << concurrentMOptimizer->GetBestParametersIndex() << std::endl;
+  if ( concurrentMOptimizer->GetBestParametersIndex() != MOptimizer->GetBestParametersIndex() )
+    {
+    std::cerr << "The best index with concurrent starts is not " << MOptimizer->GetBestParametersIndex() << std::endl;
+    return EXIT_FAILURE;
+    }
+
   affineTransform->SetParameters(MOptimizer->GetBestParameters());
 
   MOptimizerType::MetricValuesListType  metlist=MOptimizer->GetMetricValuesList();
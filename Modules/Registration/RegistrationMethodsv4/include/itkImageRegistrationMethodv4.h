@@ -26,7 +26,10 @@
 #include "itkObjectToObjectMultiMetricv4.h"
 #include "itkObjectToObjectOptimizerBase.h"
 #include "itkImageToImageMetricv4.h"
+#include "itkImageRegistrationPyramidCache.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
 #include "itkShrinkImageFilter.h"
+#include "itkThreadPool.h"
 #include "itkTransform.h"
 #include "itkTransformParametersAdaptor.h"
 
@@ -78,6 +81,15 @@ namespace itk
  * given stage so typical use will be to assign the base adaptor class to
  * level 0 of all stages but we leave that open to the user.
  *
+ * Pyramid computation:  The smoothed images and the virtual domain of a
+ * level are computed, by default, at the start of the level.  They can
+ * instead be computed for all the levels at once, in parallel, or for the
+ * next level while the current one is optimized (see
+ * SetPyramidComputationStrategy()).  When the same fixed images are
+ * registered to many moving images, a pyramid cache set on each of the
+ * registrations computes the fixed side of the levels only once (see
+ * SetFixedImagePyramidCache()).
+ *
  * Output: The output is the updated transform.
  *
  * \author Nick Tustison
@@ -130,6 +142,7 @@ public:
   typedef typename MetricType::Pointer                                MetricPointer;
 
   typedef TVirtualImage                                               VirtualImageType;
+  typedef typename VirtualImageType::Pointer                          VirtualImagePointer;
 
   typedef ObjectToObjectMultiMetricv4<ImageDimension, ImageDimension, VirtualImageType, RealType>  MultiMetricType;
   typedef ImageToImageMetricv4<FixedImageType, MovingImageType, VirtualImageType, RealType>        ImageMetricType;
@@ -146,6 +159,9 @@ public:
 
   typedef Array<SizeValueType>                                        ShrinkFactorsArrayType;
 
+  typedef ImageRegistrationPyramidCache<FixedImageType, VirtualImageType>  FixedImagePyramidCacheType;
+  typedef typename FixedImagePyramidCacheType::Pointer                FixedImagePyramidCachePointer;
+
   typedef Array<RealType>                                             SmoothingSigmasArrayType;
   typedef Array<RealType>                                             MetricSamplingPercentageArrayType;
 
@@ -161,10 +177,28 @@ public:
   /** Weights type for the optimizer. */
   typedef typename OptimizerType::ScalesType                          OptimizerWeightsType;
 
-  /** enum type for metric sampling strategy */
-  enum MetricSamplingStrategyType { NONE, REGULAR, RANDOM };
+  /** enum type for metric sampling strategy.
+   * NONE uses every voxel of the virtual domain, REGULAR and RANDOM draw a
+   * point set once per level.  STOCHASTIC draws a new random point set at
+   * each iteration of the optimizer, as in the stochastic gradient descent
+   * of Klein et al., "Evaluation of optimization methods for nonrigid
+   * medical image registration using mutual information and B-splines",
+   * IEEE TIP 2007.  The number of samples of each draw is set by the
+   * metric sampling percentage, e.g. a few thousand points on volumes of
+   * millions of voxels. */
+  enum MetricSamplingStrategyType { NONE, REGULAR, RANDOM, STOCHASTIC };
+
+  /** enum type for the computation of the multi-resolution levels.
+   * PER_LEVEL smooths the images and shrinks the virtual domain of a level
+   * at the start of the level.  ALL_LEVELS computes all the levels at the
+   * start of the registration, in parallel.  NEXT_LEVEL computes the next
+   * level in the background while the current one is optimized.  The
+   * levels are the same with all the strategies; ALL_LEVELS and NEXT_LEVEL
+   * keep up to all the levels, or two of them, in memory at once. */
+  enum PyramidComputationStrategyType { PER_LEVEL, ALL_LEVELS, NEXT_LEVEL };
 
   typedef typename ImageMetricType::FixedSampledPointSetType          MetricSamplePointSetType;
+  typedef Statistics::MersenneTwisterRandomVariateGenerator::IntegerType  MetricSamplingSeedType;
 
   /** Set/get the fixed images. */
   virtual void SetFixedImage( const FixedImageType *image )
@@ -216,6 +250,14 @@ public:
   /** Set the metric sampling percentage. */
   void SetMetricSamplingPercentage( const RealType );
 
+  /**
+   * Set/Get the seed of the random metric sampling.  The same seed draws the
+   * same samples, whatever the number of threads drawing them.
+   * Default is 1234.
+   */
+  itkSetMacro( MetricSamplingSeed, MetricSamplingSeedType );
+  itkGetConstMacro( MetricSamplingSeed, MetricSamplingSeedType );
+
   /** Set the metric sampling percentage. */
   itkSetMacro( MetricSamplingPercentagePerLevel, MetricSamplingPercentageArrayType );
   itkGetConstMacro( MetricSamplingPercentagePerLevel, MetricSamplingPercentageArrayType );
@@ -300,6 +342,24 @@ public:
   itkGetConstMacro( SmoothingSigmasAreSpecifiedInPhysicalUnits, bool );
   itkBooleanMacro( SmoothingSigmasAreSpecifiedInPhysicalUnits );
 
+  /**
+   * Set/Get when the smoothed images and the virtual domain of each level
+   * are computed.  Default is PER_LEVEL.
+   */
+  itkSetMacro( PyramidComputationStrategy, PyramidComputationStrategyType );
+  itkGetConstMacro( PyramidComputationStrategy, PyramidComputationStrategyType );
+
+  /**
+   * Set/Get the cache of the smoothed fixed images and virtual domains of
+   * the levels.  The levels found in the cache for the same fixed images,
+   * shrink factors and smoothing are not computed again, and the computed
+   * ones are stored in it.  Sharing a cache between registrations of the
+   * same fixed images, e.g. an atlas registered to many subjects, computes
+   * the fixed side of the pyramid once.  Default is no cache.
+   */
+  itkSetObjectMacro( FixedImagePyramidCache, FixedImagePyramidCacheType );
+  itkGetModifiableObjectMacro( FixedImagePyramidCache, FixedImagePyramidCacheType );
+
   /** Make a DataObject of the correct type to be used as the specified output. */
   typedef ProcessObject::DataObjectPointerArraySizeType DataObjectPointerArraySizeType;
   using Superclass::MakeOutput;
@@ -364,6 +424,11 @@ protected:
   /** Get metric samples. */
   virtual void SetMetricSamplePoints();
 
+  /** Draw new metric samples and map them to the virtual domain of the
+   * initialized metric.  Called at each optimizer iteration with the
+   * STOCHASTIC sampling strategy. */
+  virtual void UpdateStochasticMetricSamplePoints();
+
   SizeValueType                                                   m_CurrentLevel;
   SizeValueType                                                   m_NumberOfLevels;
   SizeValueType                                                   m_CurrentIteration;
@@ -383,11 +448,16 @@ protected:
   MetricPointer                                                   m_Metric;
   MetricSamplingStrategyType                                      m_MetricSamplingStrategy;
   MetricSamplingPercentageArrayType                               m_MetricSamplingPercentagePerLevel;
+  MetricSamplingSeedType                                          m_MetricSamplingSeed;
+  SizeValueType                                                   m_NumberOfMetricSamplingDraws;
 
   std::vector<ShrinkFactorsPerDimensionContainerType>             m_ShrinkFactorsPerLevel;
   SmoothingSigmasArrayType                                        m_SmoothingSigmasPerLevel;
   bool                                                            m_SmoothingSigmasAreSpecifiedInPhysicalUnits;
 
+  PyramidComputationStrategyType                                  m_PyramidComputationStrategy;
+  FixedImagePyramidCachePointer                                   m_FixedImagePyramidCache;
+
   InitialTransformPointer                                         m_MovingInitialTransform;
   InitialTransformPointer                                         m_FixedInitialTransform;
 
@@ -398,6 +468,59 @@ protected:
   OutputTransformPointer                                          m_OutputTransform;
 
 private:
+  /** Draw sampleCount uniformly random points of the virtual domain, in
+   * parallel.  The samples are drawn in fixed size chunks, each with its own
+   * generator seeded from the given seed, so that the points do not depend
+   * on the number of threads. */
+  void DrawRandomMetricSamplePoints( const VirtualImageType *, SizeValueType sampleCount,
+                                     MetricSamplingSeedType seed, MetricSamplePointSetType * );
+
+  struct RandomSamplingThreadStruct
+    {
+    const VirtualImageType                                 *VirtualImage;
+    typename MetricSamplePointSetType::PointsContainer     *Points;
+    SizeValueType                                           NumberOfChunks;
+    SizeValueType                                           SamplesPerChunk;
+    MetricSamplingSeedType                                  Seed;
+    };
+
+  static ITK_THREAD_RETURN_TYPE RandomSamplingThreaderCallback( void * );
+
+  /** Smooth the images of a level and shrink its virtual domain, unless the
+   * fixed side was found in the pyramid cache.  Only reads the inputs
+   * through views of them, to be run concurrently for several levels. */
+  void ComputeLevelImages( SizeValueType level );
+
+  /** Look up the fixed side of a level in the pyramid cache. */
+  void FetchLevelImagesFromCache( SizeValueType level );
+
+  /** Start the computation of the images of a level in the thread pool. */
+  void StartLevelImagesJob( SizeValueType level );
+
+  /** Wait for the images of a level, computing them if no job was started. */
+  void WaitForLevelImages( SizeValueType level );
+
+  /** Wait for all the started jobs, ignoring their errors. */
+  void WaitForAllLevelImagesJobs();
+
+  struct LevelImagesJobStruct
+    {
+    Self                                *Registration;
+    SizeValueType                        Level;
+    bool                                 Pending;
+    ThreadPool::ThreadJobIdType          JobId;
+    bool                                 ExceptionOccurred;
+    std::string                          ExceptionDescription;
+    };
+
+  static ITK_THREAD_RETURN_TYPE LevelImagesJobCallback( void * );
+
+  std::vector<FixedImagesContainerType>                           m_FixedSmoothImagesPerLevel;
+  std::vector<MovingImagesContainerType>                          m_MovingSmoothImagesPerLevel;
+  std::vector<VirtualImagePointer>                                m_VirtualDomainImagesPerLevel;
+  std::vector<unsigned char>                                      m_FixedLevelImagesAreCached;
+  std::vector<LevelImagesJobStruct>                               m_LevelImagesJobs;
+
   ImageRegistrationMethodv4( const Self & );   //purposely not implemented
   void operator=( const Self & );                  //purposely not implemented
 };
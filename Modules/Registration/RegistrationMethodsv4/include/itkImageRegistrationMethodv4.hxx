@@ -20,6 +20,7 @@
 
 #include "itkImageRegistrationMethodv4.h"
 
+#include "itkCommand.h"
 #include "itkDiscreteGaussianImageFilter.h"
 #include "itkGradientDescentOptimizerv4.h"
 #include "itkImageRandomConstIteratorWithIndex.h"
@@ -109,15 +110,21 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>
 
   this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits = true;
 
+  this->m_PyramidComputationStrategy = PER_LEVEL;
+
   this->m_MetricSamplingStrategy = NONE;
   this->m_MetricSamplingPercentagePerLevel.SetSize( this->m_NumberOfLevels );
   this->m_MetricSamplingPercentagePerLevel.Fill( 1.0 );
+  this->m_MetricSamplingSeed = 1234;
+  this->m_NumberOfMetricSamplingDraws = 0;
 }
 
 template<typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
 ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>
 ::~ImageRegistrationMethodv4()
 {
+  // The level images jobs still running refer to this registration
+  this->WaitForAllLevelImagesJobs();
 }
 
 template<typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
@@ -335,24 +342,78 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>
   // At each resolution and for each image pair, we can
   //   1. subsample the reference domain (typically the fixed image) and/or
   //   2. smooth the fixed and moving images.
+  // Depending on the pyramid computation strategy, the images of a level are
+  // computed here, or were computed, or are being computed, in the thread pool.
+
+  if( level == 0 )
+    {
+    this->WaitForAllLevelImagesJobs();
+
+    this->m_FixedSmoothImagesPerLevel.clear();
+    this->m_FixedSmoothImagesPerLevel.resize( this->m_NumberOfLevels );
+    this->m_MovingSmoothImagesPerLevel.clear();
+    this->m_MovingSmoothImagesPerLevel.resize( this->m_NumberOfLevels );
+    this->m_VirtualDomainImagesPerLevel.clear();
+    this->m_VirtualDomainImagesPerLevel.resize( this->m_NumberOfLevels );
+    this->m_FixedLevelImagesAreCached.assign( this->m_NumberOfLevels, 0 );
+
+    LevelImagesJobStruct job;
+    job.Registration = this;
+    job.Level = 0;
+    job.Pending = false;
+    job.JobId = 0;
+    job.ExceptionOccurred = false;
+    this->m_LevelImagesJobs.assign( this->m_NumberOfLevels, job );
+
+    if( this->m_PyramidComputationStrategy == ALL_LEVELS )
+      {
+      for( SizeValueType jobLevel = 0; jobLevel < this->m_NumberOfLevels; jobLevel++ )
+        {
+        this->StartLevelImagesJob( jobLevel );
+        }
+      }
+    }
+
+  this->WaitForLevelImages( level );
+
+  if( this->m_FixedImagePyramidCache.IsNotNull() && !this->m_FixedLevelImagesAreCached[level] )
+    {
+    typename FixedImagePyramidCacheType::FixedImagesConstContainerType fixedImages;
+    for( SizeValueType n = 0; n < numberOfImagePairs; n++ )
+      {
+      fixedImages.push_back( this->GetFixedImage( n ) );
+      }
+    this->m_FixedImagePyramidCache->SetLevel( level, fixedImages, this->m_ShrinkFactorsPerLevel[level],
+      vnl_math_sqr( this->m_SmoothingSigmasPerLevel[level] ), this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits,
+      this->m_FixedSmoothImagesPerLevel[level], this->m_VirtualDomainImagesPerLevel[level] );
+    }
 
-  typename ShrinkFilterType::Pointer shrinkFilter = ShrinkFilterType::New();
-  shrinkFilter->SetShrinkFactors( this->m_ShrinkFactorsPerLevel[level] );
-  shrinkFilter->SetInput( this->GetFixedImage( 0 ) );
-  shrinkFilter->Update();
+  this->m_FixedSmoothImages = this->m_FixedSmoothImagesPerLevel[level];
+  this->m_MovingSmoothImages = this->m_MovingSmoothImagesPerLevel[level];
+  VirtualImagePointer virtualDomainImage = this->m_VirtualDomainImagesPerLevel[level];
+
+  // Only the current level, and the next ones being computed, are kept
+  this->m_FixedSmoothImagesPerLevel[level].clear();
+  this->m_MovingSmoothImagesPerLevel[level].clear();
+  this->m_VirtualDomainImagesPerLevel[level] = ITK_NULLPTR;
+
+  if( this->m_PyramidComputationStrategy == NEXT_LEVEL && level + 1 < this->m_NumberOfLevels )
+    {
+    this->StartLevelImagesJob( level + 1 );
+    }
 
   typename MultiMetricType::Pointer multiMetric2 = dynamic_cast<MultiMetricType *>( this->m_Metric.GetPointer() );
   if( multiMetric2 )
     {
     multiMetric2->SetFixedTransform( this->m_FixedInitialTransform );
     multiMetric2->SetMovingTransform( this->m_CompositeTransform );
-    multiMetric2->SetVirtualDomainFromImage( shrinkFilter->GetOutput() );
+    multiMetric2->SetVirtualDomainFromImage( virtualDomainImage );
     for( unsigned int n = 0; n < multiMetric2->GetNumberOfMetrics(); n++ )
       {
       typename ImageMetricType::Pointer imageMetric = dynamic_cast<ImageMetricType *>( multiMetric2->GetMetricQueue()[n].GetPointer() );
       if( imageMetric.IsNotNull() )
         {
-        imageMetric->SetVirtualDomainFromImage( shrinkFilter->GetOutput() );
+        imageMetric->SetVirtualDomainFromImage( virtualDomainImage );
         }
       else
         {
@@ -367,7 +428,7 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>
       {
       imageMetric->SetFixedTransform( this->m_FixedInitialTransform );
       imageMetric->SetMovingTransform( this->m_CompositeTransform );
-      imageMetric->SetVirtualDomainFromImage( shrinkFilter->GetOutput() );
+      imageMetric->SetVirtualDomainFromImage( virtualDomainImage );
       }
     else
       {
@@ -375,47 +436,8 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>
       }
     }
 
-  this->m_FixedSmoothImages.clear();
-  this->m_MovingSmoothImages.clear();
-
   for( unsigned int n = 0; n < numberOfImagePairs; n++ )
     {
-    typedef DiscreteGaussianImageFilter<FixedImageType, FixedImageType> FixedImageSmoothingFilterType;
-    typename FixedImageSmoothingFilterType::Pointer fixedImageSmoothingFilter = FixedImageSmoothingFilterType::New();
-    if( this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits == true )
-      {
-      fixedImageSmoothingFilter->SetUseImageSpacingOn();
-      }
-    else
-      {
-      fixedImageSmoothingFilter->SetUseImageSpacingOff();
-      }
-    fixedImageSmoothingFilter->SetVariance( vnl_math_sqr( this->m_SmoothingSigmasPerLevel[level] ) );
-    fixedImageSmoothingFilter->SetMaximumError( 0.01 );
-    fixedImageSmoothingFilter->SetInput( this->GetFixedImage( n ) );
-
-    this->m_FixedSmoothImages.push_back( fixedImageSmoothingFilter->GetOutput() );
-    this->m_FixedSmoothImages[n]->Update();
-    this->m_FixedSmoothImages[n]->DisconnectPipeline();
-
-    typedef DiscreteGaussianImageFilter<MovingImageType, MovingImageType> MovingImageSmoothingFilterType;
-    typename MovingImageSmoothingFilterType::Pointer movingImageSmoothingFilter = MovingImageSmoothingFilterType::New();
-    if( this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits == true )
-      {
-      movingImageSmoothingFilter->SetUseImageSpacingOn();
-      }
-    else
-      {
-      movingImageSmoothingFilter->SetUseImageSpacingOff();
-      }
-    movingImageSmoothingFilter->SetVariance( vnl_math_sqr( this->m_SmoothingSigmasPerLevel[level] ) );
-    movingImageSmoothingFilter->SetMaximumError( 0.01 );
-    movingImageSmoothingFilter->SetInput( this->GetMovingImage( n ) );
-
-    this->m_MovingSmoothImages.push_back( movingImageSmoothingFilter->GetOutput() );
-    this->m_MovingSmoothImages[n]->Update();
-    this->m_MovingSmoothImages[n]->DisconnectPipeline();
-
     // Update the image metric
 
     typename MultiMetricType::Pointer multiMetric3 = dynamic_cast<MultiMetricType *>( this->m_Metric.GetPointer() );
@@ -474,13 +496,44 @@ void
 ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>
 ::GenerateData()
 {
-  for( this->m_CurrentLevel = 0; this->m_CurrentLevel < this->m_NumberOfLevels; this->m_CurrentLevel++ )
+  this->m_NumberOfMetricSamplingDraws = 0;
+
+  // With stochastic sampling, new samples are drawn after each optimizer
+  // iteration, i.e. after each update of the transform.
+  bool isObservingOptimizer = false;
+  unsigned long optimizerObserverTag = 0;
+  if( this->m_MetricSamplingStrategy == STOCHASTIC )
+    {
+    typedef SimpleMemberCommand<Self> SamplingCommandType;
+    typename SamplingCommandType::Pointer samplingCommand = SamplingCommandType::New();
+    samplingCommand->SetCallbackFunction( this, &Self::UpdateStochasticMetricSamplePoints );
+    optimizerObserverTag = this->m_Optimizer->AddObserver( IterationEvent(), samplingCommand );
+    isObservingOptimizer = true;
+    }
+
+  try
     {
-    this->InitializeRegistrationAtEachLevel( this->m_CurrentLevel );
+    for( this->m_CurrentLevel = 0; this->m_CurrentLevel < this->m_NumberOfLevels; this->m_CurrentLevel++ )
+      {
+      this->InitializeRegistrationAtEachLevel( this->m_CurrentLevel );
 
-    this->m_Metric->Initialize();
+      this->m_Metric->Initialize();
 
-    this->m_Optimizer->StartOptimization();
+      this->m_Optimizer->StartOptimization();
+      }
+    }
+  catch( ... )
+    {
+    if( isObservingOptimizer )
+      {
+      this->m_Optimizer->RemoveObserver( optimizerObserverTag );
+      }
+    throw;
+    }
+
+  if( isObservingOptimizer )
+    {
+    this->m_Optimizer->RemoveObserver( optimizerObserverTag );
     }
 }
 
@@ -610,7 +663,7 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>
 
     typedef typename Statistics::MersenneTwisterRandomVariateGenerator RandomizerType;
     typename RandomizerType::Pointer randomizer = RandomizerType::New();
-    randomizer->SetSeed( 1234 );
+    randomizer->SetSeed( this->m_MetricSamplingSeed );
 
     unsigned long index = 0;
 
@@ -662,6 +715,18 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>
           }
         break;
         }
+      case STOCHASTIC:
+        {
+        const SizeValueType totalVirtualDomainVoxels = virtualDomainRegion.GetNumberOfPixels();
+        const SizeValueType sampleCount = std::max( static_cast<SizeValueType>( static_cast<float>( totalVirtualDomainVoxels ) * this->m_MetricSamplingPercentagePerLevel[this->m_CurrentLevel] ),
+                                                    static_cast<SizeValueType>( 1 ) );
+        // Each draw of each metric has its own stream of seeds
+        const SizeValueType stream = this->m_NumberOfMetricSamplingDraws * numberOfLocalMetrics + n;
+        this->DrawRandomMetricSamplePoints( virtualImage, sampleCount,
+                                            this->m_MetricSamplingSeed + static_cast<MetricSamplingSeedType>( stream * sampleCount ),
+                                            samplePointSet );
+        break;
+        }
       default:
         {
         itkExceptionMacro( "Invalid sampling strategy requested." );
@@ -679,6 +744,301 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>
       dynamic_cast<ImageMetricType *>( multiMetric->GetMetricQueue()[n].GetPointer() )->SetUseFixedSampledPointSet( true );
       }
     }
+
+  if( this->m_MetricSamplingStrategy == STOCHASTIC )
+    {
+    ++this->m_NumberOfMetricSamplingDraws;
+    }
+}
+
+/**
+ * Draw new metric samples for the next iteration
+ */
+template<typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+void
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>
+::UpdateStochasticMetricSamplePoints()
+{
+  this->SetMetricSamplePoints();
+
+  // The metric is already initialized, only the samples need to be mapped
+  typename MultiMetricType::Pointer multiMetric = dynamic_cast<MultiMetricType *>( this->m_Metric.GetPointer() );
+  if( multiMetric )
+    {
+    for( unsigned int n = 0; n < multiMetric->GetNumberOfMetrics(); n++ )
+      {
+      dynamic_cast<ImageMetricType *>( multiMetric->GetMetricQueue()[n].GetPointer() )->UpdateVirtualSampledPointSet();
+      }
+    }
+  else
+    {
+    dynamic_cast<ImageMetricType *>( this->m_Metric.GetPointer() )->UpdateVirtualSampledPointSet();
+    }
+}
+
+template<typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+void
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>
+::DrawRandomMetricSamplePoints( const VirtualImageType *virtualImage, SizeValueType sampleCount,
+                                MetricSamplingSeedType seed, MetricSamplePointSetType *samplePointSet )
+{
+  typedef typename MetricSamplePointSetType::PointsContainer PointsContainerType;
+  typename PointsContainerType::Pointer points = PointsContainerType::New();
+  points->Reserve( sampleCount );
+
+  RandomSamplingThreadStruct str;
+  str.VirtualImage = virtualImage;
+  str.Points = points;
+  str.SamplesPerChunk = 4096;
+  str.NumberOfChunks = ( sampleCount + str.SamplesPerChunk - 1 ) / str.SamplesPerChunk;
+  str.Seed = seed;
+
+  this->GetMultiThreader()->SetNumberOfThreads( std::min( static_cast<SizeValueType>( this->GetNumberOfThreads() ),
+                                                          str.NumberOfChunks ) );
+  this->GetMultiThreader()->SetSingleMethod( this->RandomSamplingThreaderCallback, &str );
+  this->GetMultiThreader()->SingleMethodExecute();
+
+  samplePointSet->SetPoints( points );
+}
+
+template<typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+ITK_THREAD_RETURN_TYPE
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>
+::RandomSamplingThreaderCallback( void *arg )
+{
+  const ThreadIdType threadId = ( (MultiThreader::ThreadInfoStruct *)( arg ) )->ThreadID;
+  const ThreadIdType threadCount = ( (MultiThreader::ThreadInfoStruct *)( arg ) )->NumberOfThreads;
+
+  RandomSamplingThreadStruct *str =
+    (RandomSamplingThreadStruct *)( ( (MultiThreader::ThreadInfoStruct *)( arg ) )->UserData );
+
+  const VirtualImageType *virtualImage = str->VirtualImage;
+  const typename VirtualImageType::RegionType & region = virtualImage->GetRequestedRegion();
+  const typename VirtualImageType::SpacingType oneThirdVirtualSpacing = virtualImage->GetSpacing() / 3.0;
+  typename MetricSamplePointSetType::PointsContainer::STLContainerType & points = str->Points->CastToSTLContainer();
+
+  typedef Statistics::MersenneTwisterRandomVariateGenerator RandomizerType;
+  RandomizerType::Pointer randomizer = RandomizerType::New();
+
+  for( SizeValueType chunk = threadId; chunk < str->NumberOfChunks; chunk += threadCount )
+    {
+    randomizer->SetSeed( str->Seed + static_cast<MetricSamplingSeedType>( chunk ) );
+    const SizeValueType begin = chunk * str->SamplesPerChunk;
+    const SizeValueType end = std::min( begin + str->SamplesPerChunk, static_cast<SizeValueType>( points.size() ) );
+    for( SizeValueType i = begin; i < end; ++i )
+      {
+      typename VirtualImageType::IndexType index;
+      for( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        index[d] = region.GetIndex()[d] + static_cast<IndexValueType>(
+          randomizer->GetIntegerVariate( static_cast<RandomizerType::IntegerType>( region.GetSize()[d] - 1 ) ) );
+        }
+      typename MetricSamplePointSetType::PointType point;
+      virtualImage->TransformIndexToPhysicalPoint( index, point );
+
+      // randomly perturb the point within a voxel (approximately)
+      for( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        point[d] += randomizer->GetNormalVariate() * oneThirdVirtualSpacing[d];
+        }
+      points[i] = point;
+      }
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+/*
+ * Compute the smoothed images and the virtual domain of a level
+ */
+template<typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+void
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>
+::ComputeLevelImages( SizeValueType level )
+{
+  // The filters of concurrent levels read the inputs through their own views,
+  // since updating a pipeline sets the requested region of its input.
+
+  const SizeValueType numberOfImagePairs = static_cast<unsigned int>( 0.5 * this->GetNumberOfInputs() );
+  const double variance = vnl_math_sqr( this->m_SmoothingSigmasPerLevel[level] );
+
+  if( !this->m_FixedLevelImagesAreCached[level] )
+    {
+    typename FixedImageType::Pointer fixedImageView = FixedImageType::New();
+    fixedImageView->Graft( this->GetFixedImage( 0 ) );
+
+    typename ShrinkFilterType::Pointer shrinkFilter = ShrinkFilterType::New();
+    shrinkFilter->SetShrinkFactors( this->m_ShrinkFactorsPerLevel[level] );
+    shrinkFilter->SetInput( fixedImageView );
+    shrinkFilter->Update();
+    this->m_VirtualDomainImagesPerLevel[level] = shrinkFilter->GetOutput();
+    this->m_VirtualDomainImagesPerLevel[level]->DisconnectPipeline();
+
+    FixedImagesContainerType & fixedSmoothImages = this->m_FixedSmoothImagesPerLevel[level];
+    fixedSmoothImages.clear();
+    for( unsigned int n = 0; n < numberOfImagePairs; n++ )
+      {
+      fixedImageView = FixedImageType::New();
+      fixedImageView->Graft( this->GetFixedImage( n ) );
+
+      typedef DiscreteGaussianImageFilter<FixedImageType, FixedImageType> FixedImageSmoothingFilterType;
+      typename FixedImageSmoothingFilterType::Pointer fixedImageSmoothingFilter = FixedImageSmoothingFilterType::New();
+      if( this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits == true )
+        {
+        fixedImageSmoothingFilter->SetUseImageSpacingOn();
+        }
+      else
+        {
+        fixedImageSmoothingFilter->SetUseImageSpacingOff();
+        }
+      fixedImageSmoothingFilter->SetVariance( variance );
+      fixedImageSmoothingFilter->SetMaximumError( 0.01 );
+      fixedImageSmoothingFilter->SetInput( fixedImageView );
+
+      fixedSmoothImages.push_back( fixedImageSmoothingFilter->GetOutput() );
+      fixedSmoothImages[n]->Update();
+      fixedSmoothImages[n]->DisconnectPipeline();
+      }
+    }
+
+  MovingImagesContainerType & movingSmoothImages = this->m_MovingSmoothImagesPerLevel[level];
+  movingSmoothImages.clear();
+  for( unsigned int n = 0; n < numberOfImagePairs; n++ )
+    {
+    typename MovingImageType::Pointer movingImageView = MovingImageType::New();
+    movingImageView->Graft( this->GetMovingImage( n ) );
+
+    typedef DiscreteGaussianImageFilter<MovingImageType, MovingImageType> MovingImageSmoothingFilterType;
+    typename MovingImageSmoothingFilterType::Pointer movingImageSmoothingFilter = MovingImageSmoothingFilterType::New();
+    if( this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits == true )
+      {
+      movingImageSmoothingFilter->SetUseImageSpacingOn();
+      }
+    else
+      {
+      movingImageSmoothingFilter->SetUseImageSpacingOff();
+      }
+    movingImageSmoothingFilter->SetVariance( variance );
+    movingImageSmoothingFilter->SetMaximumError( 0.01 );
+    movingImageSmoothingFilter->SetInput( movingImageView );
+
+    movingSmoothImages.push_back( movingImageSmoothingFilter->GetOutput() );
+    movingSmoothImages[n]->Update();
+    movingSmoothImages[n]->DisconnectPipeline();
+    }
+}
+
+template<typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+void
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>
+::FetchLevelImagesFromCache( SizeValueType level )
+{
+  if( this->m_FixedImagePyramidCache.IsNull() )
+    {
+    return;
+    }
+
+  const SizeValueType numberOfImagePairs = static_cast<unsigned int>( 0.5 * this->GetNumberOfInputs() );
+  typename FixedImagePyramidCacheType::FixedImagesConstContainerType fixedImages;
+  for( SizeValueType n = 0; n < numberOfImagePairs; n++ )
+    {
+    fixedImages.push_back( this->GetFixedImage( n ) );
+    }
+  if( this->m_FixedImagePyramidCache->GetLevel( level, fixedImages, this->m_ShrinkFactorsPerLevel[level],
+        vnl_math_sqr( this->m_SmoothingSigmasPerLevel[level] ), this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits,
+        this->m_FixedSmoothImagesPerLevel[level], this->m_VirtualDomainImagesPerLevel[level] ) )
+    {
+    itkDebugMacro( "Reusing the fixed images of level " << level << " from the pyramid cache." );
+    this->m_FixedLevelImagesAreCached[level] = 1;
+    }
+}
+
+template<typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+void
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>
+::StartLevelImagesJob( SizeValueType level )
+{
+  this->FetchLevelImagesFromCache( level );
+
+  LevelImagesJobStruct & job = this->m_LevelImagesJobs[level];
+  job.Registration = this;
+  job.Level = level;
+  job.ExceptionOccurred = false;
+  job.ExceptionDescription.clear();
+
+  ThreadPool::ThreadJob threadJob;
+  threadJob.m_ThreadFunction = this->LevelImagesJobCallback;
+  threadJob.m_UserData = &job;
+  job.JobId = ThreadPool::GetInstance()->AddWork( threadJob );
+  job.Pending = true;
+}
+
+template<typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+void
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>
+::WaitForLevelImages( SizeValueType level )
+{
+  LevelImagesJobStruct & job = this->m_LevelImagesJobs[level];
+  if( job.Pending )
+    {
+    ThreadPool::GetInstance()->WaitForJob( job.JobId );
+    job.Pending = false;
+    if( job.ExceptionOccurred )
+      {
+      itkExceptionMacro( "Computing the images of level " << level << " failed: " << job.ExceptionDescription );
+      }
+    }
+  else
+    {
+    this->FetchLevelImagesFromCache( level );
+    this->ComputeLevelImages( level );
+    }
+}
+
+template<typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+void
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>
+::WaitForAllLevelImagesJobs()
+{
+  for( SizeValueType level = 0; level < this->m_LevelImagesJobs.size(); level++ )
+    {
+    if( this->m_LevelImagesJobs[level].Pending )
+      {
+      ThreadPool::GetInstance()->WaitForJob( this->m_LevelImagesJobs[level].JobId );
+      this->m_LevelImagesJobs[level].Pending = false;
+      }
+    }
+}
+
+template<typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage>
+ITK_THREAD_RETURN_TYPE
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>
+::LevelImagesJobCallback( void *arg )
+{
+  LevelImagesJobStruct *job = static_cast<LevelImagesJobStruct *>( arg );
+
+  // The thread pool does not report the exceptions of its jobs
+  try
+    {
+    job->Registration->ComputeLevelImages( job->Level );
+    }
+  catch( ExceptionObject & exc )
+    {
+    job->ExceptionOccurred = true;
+    job->ExceptionDescription = exc.GetDescription();
+    }
+  catch( std::exception & exc )
+    {
+    job->ExceptionOccurred = true;
+    job->ExceptionDescription = exc.what();
+    }
+  catch( ... )
+    {
+    job->ExceptionOccurred = true;
+    job->ExceptionDescription = "Unknown exception.";
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
 }
 
 /*
@@ -722,6 +1082,14 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage>
     os << this->m_MetricSamplingPercentagePerLevel[i] << " ";
     }
   os << std::endl;
+  os << indent << "Metric sampling seed: " << this->m_MetricSamplingSeed << std::endl;
+
+  os << indent << "Pyramid computation strategy: " << this->m_PyramidComputationStrategy << std::endl;
+  if( this->m_FixedImagePyramidCache.IsNotNull() )
+    {
+    os << indent << "Fixed image pyramid cache: " << std::endl;
+    this->m_FixedImagePyramidCache->Print( os, indent.GetNextIndent() );
+    }
 }
 
 /*
@@ -0,0 +1,135 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageRegistrationPyramidCache_h
+#define __itkImageRegistrationPyramidCache_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkShrinkImageFilter.h"
+#include "itkSimpleFastMutexLock.h"
+
+#include <vector>
+
+namespace itk
+{
+
+/** \class ImageRegistrationPyramidCache
+ * \brief Keeps the fixed side of the multi-resolution levels of a
+ * registration, to reuse it in the next registrations of the same fixed
+ * images.
+ *
+ * At each level, ImageRegistrationMethodv4 smooths the fixed and moving
+ * images and shrinks the fixed image into the virtual domain.  When the
+ * same fixed images are registered to many moving images, e.g. an atlas to
+ * many subjects, the fixed side is the same for all the registrations.
+ * Setting the same cache on these registrations computes it once.
+ *
+ * A level is stored with the fixed images, their modification times, the
+ * shrink factors and the smoothing it was computed from, and is only
+ * returned for the same ones.  The methods of the cache lock a mutex, so
+ * the registrations sharing it can run one after another as well as
+ * concurrently.  A level which is not stored yet may then be computed by
+ * several concurrent registrations, and the last one computed is kept.
+ *
+ * \sa ImageRegistrationMethodv4::SetFixedImagePyramidCache()
+ *
+ * \ingroup ITKRegistrationMethodsv4
+ */
+template<typename TFixedImage, typename TVirtualImage = TFixedImage>
+class ImageRegistrationPyramidCache : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ImageRegistrationPyramidCache       Self;
+  typedef Object                              Superclass;
+  typedef SmartPointer<Self>                  Pointer;
+  typedef SmartPointer<const Self>            ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( ImageRegistrationPyramidCache, Object );
+
+  typedef TFixedImage                                                 FixedImageType;
+  typedef typename FixedImageType::Pointer                            FixedImagePointer;
+  typedef typename FixedImageType::ConstPointer                       FixedImageConstPointer;
+  typedef std::vector<FixedImagePointer>                              FixedImagesContainerType;
+  typedef std::vector<FixedImageConstPointer>                         FixedImagesConstContainerType;
+
+  typedef TVirtualImage                                               VirtualImageType;
+  typedef typename VirtualImageType::Pointer                          VirtualImagePointer;
+
+  typedef typename ShrinkImageFilter<FixedImageType, VirtualImageType>::ShrinkFactorsType ShrinkFactorsType;
+
+  /** Get the smoothed fixed images and the virtual domain image of a level,
+   * if they were stored from the same fixed images, shrink factors and
+   * smoothing.  Returns false otherwise. */
+  bool GetLevel( SizeValueType level, const FixedImagesConstContainerType & fixedImages,
+                 const ShrinkFactorsType & shrinkFactors, double smoothingVariance, bool smoothingUsesImageSpacing,
+                 FixedImagesContainerType & smoothImages, VirtualImagePointer & virtualDomainImage ) const;
+
+  /** Store the smoothed fixed images and the virtual domain image of a
+   * level, computed from the given fixed images, shrink factors and
+   * smoothing. */
+  void SetLevel( SizeValueType level, const FixedImagesConstContainerType & fixedImages,
+                 const ShrinkFactorsType & shrinkFactors, double smoothingVariance, bool smoothingUsesImageSpacing,
+                 const FixedImagesContainerType & smoothImages, VirtualImageType * virtualDomainImage );
+
+  /** Remove all the levels. */
+  void Clear();
+
+  /** Get the number of levels stored. */
+  SizeValueType GetNumberOfLevels() const;
+
+  /** Get the number of levels returned by GetLevel() since the creation of
+   * the cache. */
+  SizeValueType GetNumberOfReusedLevels() const;
+
+protected:
+  ImageRegistrationPyramidCache();
+  virtual ~ImageRegistrationPyramidCache() {}
+
+  virtual void PrintSelf( std::ostream & os, Indent indent ) const ITK_OVERRIDE;
+
+private:
+  ImageRegistrationPyramidCache( const Self & ); //purposely not implemented
+  void operator=( const Self & );               //purposely not implemented
+
+  struct LevelType
+    {
+    FixedImagesConstContainerType  FixedImages;
+    std::vector<ModifiedTimeType>  FixedImageTimes;
+    ShrinkFactorsType              ShrinkFactors;
+    double                         SmoothingVariance;
+    bool                           SmoothingUsesImageSpacing;
+    FixedImagesContainerType       SmoothImages;
+    VirtualImagePointer            VirtualDomainImage;
+    };
+
+  std::vector<LevelType>           m_Levels;
+  mutable SizeValueType            m_NumberOfReusedLevels;
+  mutable SimpleFastMutexLock      m_Mutex;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkImageRegistrationPyramidCache.hxx"
+#endif
+
+#endif
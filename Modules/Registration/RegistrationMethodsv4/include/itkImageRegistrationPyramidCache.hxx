@@ -0,0 +1,178 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageRegistrationPyramidCache_hxx
+#define __itkImageRegistrationPyramidCache_hxx
+
+#include "itkImageRegistrationPyramidCache.h"
+#include "itkMutexLockHolder.h"
+
+namespace itk
+{
+/**
+ * Constructor
+ */
+template<typename TFixedImage, typename TVirtualImage>
+ImageRegistrationPyramidCache<TFixedImage, TVirtualImage>
+::ImageRegistrationPyramidCache() :
+  m_NumberOfReusedLevels( 0 )
+{
+}
+
+/**
+ * Get the images of a level computed with the same settings
+ */
+template<typename TFixedImage, typename TVirtualImage>
+bool
+ImageRegistrationPyramidCache<TFixedImage, TVirtualImage>
+::GetLevel( SizeValueType level, const FixedImagesConstContainerType & fixedImages,
+            const ShrinkFactorsType & shrinkFactors, double smoothingVariance, bool smoothingUsesImageSpacing,
+            FixedImagesContainerType & smoothImages, VirtualImagePointer & virtualDomainImage ) const
+{
+  MutexLockHolder<SimpleFastMutexLock> holder( this->m_Mutex );
+  if( level >= this->m_Levels.size() || this->m_Levels[level].VirtualDomainImage.IsNull() )
+    {
+    return false;
+    }
+  const LevelType & stored = this->m_Levels[level];
+  if( stored.FixedImages.size() != fixedImages.size() ||
+      stored.ShrinkFactors != shrinkFactors ||
+      stored.SmoothingVariance != smoothingVariance ||
+      stored.SmoothingUsesImageSpacing != smoothingUsesImageSpacing )
+    {
+    return false;
+    }
+  for( SizeValueType n = 0; n < fixedImages.size(); n++ )
+    {
+    if( stored.FixedImages[n] != fixedImages[n] || stored.FixedImageTimes[n] != fixedImages[n]->GetMTime() )
+      {
+      return false;
+      }
+    }
+
+  smoothImages = stored.SmoothImages;
+  virtualDomainImage = stored.VirtualDomainImage;
+  this->m_NumberOfReusedLevels++;
+  return true;
+}
+
+/**
+ * Store the images of a level
+ */
+template<typename TFixedImage, typename TVirtualImage>
+void
+ImageRegistrationPyramidCache<TFixedImage, TVirtualImage>
+::SetLevel( SizeValueType level, const FixedImagesConstContainerType & fixedImages,
+            const ShrinkFactorsType & shrinkFactors, double smoothingVariance, bool smoothingUsesImageSpacing,
+            const FixedImagesContainerType & smoothImages, VirtualImageType * virtualDomainImage )
+{
+  if( fixedImages.size() != smoothImages.size() )
+    {
+    itkExceptionMacro( "The number of fixed images and smoothed fixed images differ." );
+    }
+  {
+  MutexLockHolder<SimpleFastMutexLock> holder( this->m_Mutex );
+  if( level >= this->m_Levels.size() )
+    {
+    this->m_Levels.resize( level + 1 );
+    }
+  LevelType & stored = this->m_Levels[level];
+  stored.FixedImages = fixedImages;
+  stored.FixedImageTimes.resize( fixedImages.size() );
+  for( SizeValueType n = 0; n < fixedImages.size(); n++ )
+    {
+    stored.FixedImageTimes[n] = fixedImages[n]->GetMTime();
+    }
+  stored.ShrinkFactors = shrinkFactors;
+  stored.SmoothingVariance = smoothingVariance;
+  stored.SmoothingUsesImageSpacing = smoothingUsesImageSpacing;
+  stored.SmoothImages = smoothImages;
+  stored.VirtualDomainImage = virtualDomainImage;
+  }
+  // The observers of Modified() may call the cache
+  this->Modified();
+}
+
+/**
+ * Remove all the levels
+ */
+template<typename TFixedImage, typename TVirtualImage>
+void
+ImageRegistrationPyramidCache<TFixedImage, TVirtualImage>
+::Clear()
+{
+  bool cleared = false;
+  {
+  MutexLockHolder<SimpleFastMutexLock> holder( this->m_Mutex );
+  cleared = !this->m_Levels.empty();
+  this->m_Levels.clear();
+  }
+  if( cleared )
+    {
+    this->Modified();
+    }
+}
+
+/**
+ * Get the number of levels stored
+ */
+template<typename TFixedImage, typename TVirtualImage>
+SizeValueType
+ImageRegistrationPyramidCache<TFixedImage, TVirtualImage>
+::GetNumberOfLevels() const
+{
+  MutexLockHolder<SimpleFastMutexLock> holder( this->m_Mutex );
+  SizeValueType numberOfLevels = 0;
+  for( SizeValueType level = 0; level < this->m_Levels.size(); level++ )
+    {
+    if( this->m_Levels[level].VirtualDomainImage.IsNotNull() )
+      {
+      numberOfLevels++;
+      }
+    }
+  return numberOfLevels;
+}
+
+/**
+ * Get the number of levels returned by GetLevel()
+ */
+template<typename TFixedImage, typename TVirtualImage>
+SizeValueType
+ImageRegistrationPyramidCache<TFixedImage, TVirtualImage>
+::GetNumberOfReusedLevels() const
+{
+  MutexLockHolder<SimpleFastMutexLock> holder( this->m_Mutex );
+  return this->m_NumberOfReusedLevels;
+}
+
+/**
+ * PrintSelf
+ */
+template<typename TFixedImage, typename TVirtualImage>
+void
+ImageRegistrationPyramidCache<TFixedImage, TVirtualImage>
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "Number of levels: " << this->GetNumberOfLevels() << std::endl;
+  os << indent << "Number of reused levels: " << this->GetNumberOfReusedLevels() << std::endl;
+}
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,206 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageRegistrationMethodv4.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkGradientDescentOptimizerv4.h"
+#include "itkTranslationTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMultiThreader.h"
+#include "itkTestingMacros.h"
+
+/*
+ * Register two translated blobs in three levels with each pyramid computation
+ * strategy, and check that the results are the same.  Then register other
+ * moving images to the same fixed image through a shared pyramid cache, and
+ * check that the fixed side of the levels is reused, also by registrations
+ * run concurrently.
+ */
+
+namespace
+{
+const unsigned int Dimension = 2;
+typedef itk::Image< double, Dimension >                ImageType;
+typedef itk::TranslationTransform< double, Dimension > TransformType;
+typedef itk::ImageRegistrationMethodv4< ImageType, ImageType, TransformType > RegistrationType;
+
+ImageType::Pointer CreateImage(double centerX, double centerY)
+{
+  ImageType::SizeType size;
+  size.Fill( 96 );
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const double x = it.GetIndex()[0] - centerX;
+    const double y = it.GetIndex()[1] - centerY;
+    it.Set( 100.0 * std::exp( -( x * x + 2.0 * y * y ) / 400.0 ) );
+    }
+  return image;
+}
+
+TransformType::ParametersType
+RunRegistration(const ImageType *fixedImage, const ImageType *movingImage,
+                RegistrationType::PyramidComputationStrategyType strategy,
+                RegistrationType::FixedImagePyramidCacheType *cache)
+{
+  RegistrationType::Pointer registration = RegistrationType::New();
+  registration->SetFixedImage( fixedImage );
+  registration->SetMovingImage( movingImage );
+  registration->SetPyramidComputationStrategy( strategy );
+  registration->SetFixedImagePyramidCache( cache );
+
+  typedef itk::MeanSquaresImageToImageMetricv4< ImageType, ImageType > MetricType;
+  MetricType::Pointer metric = MetricType::New();
+  registration->SetMetric( metric );
+
+  typedef itk::GradientDescentOptimizerv4 OptimizerType;
+  OptimizerType::Pointer optimizer = OptimizerType::New();
+  optimizer->SetLearningRate( 0.01 );
+  optimizer->SetDoEstimateLearningRateOnce( false );
+  optimizer->SetDoEstimateLearningRateAtEachIteration( false );
+  optimizer->SetNumberOfIterations( 50 );
+  registration->SetOptimizer( optimizer );
+
+  registration->SetNumberOfLevels( 3 );
+  RegistrationType::ShrinkFactorsArrayType shrinkFactors( 3 );
+  shrinkFactors[0] = 4;
+  shrinkFactors[1] = 2;
+  shrinkFactors[2] = 1;
+  registration->SetShrinkFactorsPerLevel( shrinkFactors );
+  RegistrationType::SmoothingSigmasArrayType smoothingSigmas( 3 );
+  smoothingSigmas[0] = 2.0;
+  smoothingSigmas[1] = 1.0;
+  smoothingSigmas[2] = 0.0;
+  registration->SetSmoothingSigmasPerLevel( smoothingSigmas );
+
+  registration->Update();
+  const TransformType::ParametersType parameters = registration->GetOutput()->Get()->GetParameters();
+  std::cout << "strategy " << strategy << ( cache ? ", cached: " : ": " ) << parameters << std::endl;
+  return parameters;
+}
+
+// Registrations of moving images run concurrently with a shared cache
+struct ConcurrentRegistrationsStruct
+{
+  const ImageType *                              FixedImage;
+  const ImageType *                              MovingImages[2];
+  RegistrationType::FixedImagePyramidCacheType * Cache;
+  TransformType::ParametersType                  Parameters[2];
+  bool                                           Failed[2];
+};
+
+ITK_THREAD_RETURN_TYPE ConcurrentRegistrationsCallback(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct *info = static_cast< itk::MultiThreader::ThreadInfoStruct * >( arg );
+  ConcurrentRegistrationsStruct *       str = static_cast< ConcurrentRegistrationsStruct * >( info->UserData );
+  const itk::ThreadIdType               threadId = info->ThreadID;
+  try
+    {
+    str->Parameters[threadId] = RunRegistration( str->FixedImage, str->MovingImages[threadId],
+                                                 RegistrationType::PER_LEVEL, str->Cache );
+    str->Failed[threadId] = false;
+    }
+  catch( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+}
+
+int itkImageRegistrationMethodv4PyramidTest(int, char *[])
+{
+  RegistrationType::Pointer registration = RegistrationType::New();
+  TEST_EXPECT_EQUAL( registration->GetPyramidComputationStrategy(), RegistrationType::PER_LEVEL );
+  TEST_EXPECT_TRUE( registration->GetFixedImagePyramidCache() == ITK_NULLPTR );
+  registration->SetPyramidComputationStrategy( RegistrationType::NEXT_LEVEL );
+  TEST_EXPECT_EQUAL( registration->GetPyramidComputationStrategy(), RegistrationType::NEXT_LEVEL );
+  registration->SetFixedImagePyramidCache( RegistrationType::FixedImagePyramidCacheType::New() );
+  registration->Print( std::cout );
+
+  ImageType::Pointer fixedImage = CreateImage( 46.0, 48.0 );
+  ImageType::Pointer movingImage = CreateImage( 49.0, 46.0 );
+
+  // The levels do not depend on when they are computed
+  const TransformType::ParametersType perLevel =
+    RunRegistration( fixedImage, movingImage, RegistrationType::PER_LEVEL, ITK_NULLPTR );
+  const TransformType::ParametersType allLevels =
+    RunRegistration( fixedImage, movingImage, RegistrationType::ALL_LEVELS, ITK_NULLPTR );
+  const TransformType::ParametersType nextLevel =
+    RunRegistration( fixedImage, movingImage, RegistrationType::NEXT_LEVEL, ITK_NULLPTR );
+  TEST_EXPECT_EQUAL( perLevel, allLevels );
+  TEST_EXPECT_EQUAL( perLevel, nextLevel );
+  if( std::fabs( perLevel[0] - 3.0 ) > 0.3 || std::fabs( perLevel[1] + 2.0 ) > 0.3 )
+    {
+    std::cerr << "The translation " << perLevel << " is not [3, -2]" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The first registration fills the cache, the next ones reuse it
+  RegistrationType::FixedImagePyramidCacheType::Pointer cache = RegistrationType::FixedImagePyramidCacheType::New();
+  const TransformType::ParametersType cached =
+    RunRegistration( fixedImage, movingImage, RegistrationType::PER_LEVEL, cache );
+  TEST_EXPECT_EQUAL( cache->GetNumberOfLevels(), 3u );
+  TEST_EXPECT_EQUAL( cache->GetNumberOfReusedLevels(), 0u );
+  TEST_EXPECT_EQUAL( perLevel, cached );
+
+  ImageType::Pointer otherMovingImage = CreateImage( 44.0, 50.0 );
+  const TransformType::ParametersType other =
+    RunRegistration( fixedImage, otherMovingImage, RegistrationType::PER_LEVEL, ITK_NULLPTR );
+  const TransformType::ParametersType otherCached =
+    RunRegistration( fixedImage, otherMovingImage, RegistrationType::NEXT_LEVEL, cache );
+  TEST_EXPECT_EQUAL( cache->GetNumberOfReusedLevels(), 3u );
+  TEST_EXPECT_EQUAL( other, otherCached );
+
+  // A modified fixed image is not taken from the cache
+  fixedImage->Modified();
+  RunRegistration( fixedImage, otherMovingImage, RegistrationType::ALL_LEVELS, cache );
+  TEST_EXPECT_EQUAL( cache->GetNumberOfReusedLevels(), 3u );
+  TEST_EXPECT_EQUAL( cache->GetNumberOfLevels(), 3u );
+
+  cache->Clear();
+  TEST_EXPECT_EQUAL( cache->GetNumberOfLevels(), 0u );
+
+  // Two registrations share the cache at the same time
+  RegistrationType::FixedImagePyramidCacheType::Pointer sharedCache =
+    RegistrationType::FixedImagePyramidCacheType::New();
+  ConcurrentRegistrationsStruct str;
+  str.FixedImage = fixedImage;
+  str.MovingImages[0] = movingImage;
+  str.MovingImages[1] = otherMovingImage;
+  str.Cache = sharedCache;
+  str.Failed[0] = true;
+  str.Failed[1] = true;
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  // The registrations use the thread pool themselves
+  threader->UseThreadPoolOff();
+  threader->SetNumberOfThreads( 2 );
+  threader->SetSingleMethod( ConcurrentRegistrationsCallback, &str );
+  threader->SingleMethodExecute();
+  TEST_EXPECT_TRUE( !str.Failed[0] && !str.Failed[1] );
+  TEST_EXPECT_EQUAL( str.Parameters[0], perLevel );
+  TEST_EXPECT_EQUAL( str.Parameters[1], other );
+  TEST_EXPECT_EQUAL( sharedCache->GetNumberOfLevels(), 3u );
+  RunRegistration( fixedImage, movingImage, RegistrationType::PER_LEVEL, sharedCache );
+  TEST_EXPECT_TRUE( sharedCache->GetNumberOfReusedLevels() >= 3u );
+
+  return EXIT_SUCCESS;
+}
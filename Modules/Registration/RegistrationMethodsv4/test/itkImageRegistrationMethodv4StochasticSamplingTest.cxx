@@ -0,0 +1,194 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageRegistrationMethodv4.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkGradientDescentOptimizerv4.h"
+#include "itkRegistrationParameterScalesFromPhysicalShift.h"
+#include "itkTranslationTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+/*
+ * Register two translated blobs with the stochastic sampling strategy, which
+ * draws new samples at each iteration, and check that the samples do not
+ * depend on the number of threads, but on the seed.
+ */
+
+namespace
+{
+const unsigned int Dimension = 2;
+typedef itk::Image< double, Dimension >                ImageType;
+typedef itk::TranslationTransform< double, Dimension > TransformType;
+typedef itk::ImageRegistrationMethodv4< ImageType, ImageType, TransformType > RegistrationType;
+typedef itk::MeanSquaresImageToImageMetricv4< ImageType, ImageType >          MetricType;
+
+ImageType::Pointer CreateImage(double centerX, double centerY)
+{
+  ImageType::SizeType size;
+  size.Fill( 128 );
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( size );
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetLargestPossibleRegion() );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const double x = it.GetIndex()[0] - centerX;
+    const double y = it.GetIndex()[1] - centerY;
+    it.Set( 100.0 * std::exp( -( x * x + 2.0 * y * y ) / 800.0 ) );
+    }
+  return image;
+}
+
+/** Record the samples of the metric at each iteration. */
+class StochasticSamplingTestCommand : public itk::Command
+{
+public:
+  typedef StochasticSamplingTestCommand Self;
+  typedef itk::Command                  Superclass;
+  typedef itk::SmartPointer< Self >     Pointer;
+  itkNewMacro( Self );
+
+  virtual void Execute(itk::Object *caller, const itk::EventObject & event) ITK_OVERRIDE
+    {
+    this->Execute( (const itk::Object *) caller, event );
+    }
+
+  virtual void Execute(const itk::Object *, const itk::EventObject & event) ITK_OVERRIDE
+    {
+    if( typeid( event ) != typeid( itk::IterationEvent ) )
+      {
+      return;
+      }
+    const MetricType::FixedSampledPointSetType * points = m_Metric->GetFixedSampledPointSet();
+    const MetricType::FixedSampledPointSetType::PointType first = points->GetPoint( 0 );
+    if( m_NumberOfIterations > 0 && first == m_FirstPoint )
+      {
+      ++m_NumberOfRepeatedSamples;
+      }
+    m_FirstPoint = first;
+    for( itk::SizeValueType i = 0; i < points->GetNumberOfPoints(); ++i )
+      {
+      m_Checksum += points->GetPoint( i )[0] + 1000.0 * points->GetPoint( i )[1];
+      }
+    m_NumberOfPoints = points->GetNumberOfPoints();
+    ++m_NumberOfIterations;
+    }
+
+  MetricType::Pointer                          m_Metric;
+  MetricType::FixedSampledPointSetType::PointType m_FirstPoint;
+  itk::SizeValueType                           m_NumberOfIterations;
+  itk::SizeValueType                           m_NumberOfRepeatedSamples;
+  itk::SizeValueType                           m_NumberOfPoints;
+  double                                       m_Checksum;
+
+protected:
+  StochasticSamplingTestCommand() :
+    m_NumberOfIterations( 0 ),
+    m_NumberOfRepeatedSamples( 0 ),
+    m_NumberOfPoints( 0 ),
+    m_Checksum( 0.0 )
+    {}
+};
+
+StochasticSamplingTestCommand::Pointer
+RunRegistration(RegistrationType::MetricSamplingSeedType seed, itk::ThreadIdType numberOfThreads,
+                TransformType::ParametersType & parameters)
+{
+  RegistrationType::Pointer registration = RegistrationType::New();
+  registration->SetFixedImage( CreateImage( 60.0, 64.0 ) );
+  registration->SetMovingImage( CreateImage( 64.0, 61.0 ) );
+  registration->SetNumberOfThreads( numberOfThreads );
+
+  MetricType::Pointer metric = MetricType::New();
+  registration->SetMetric( metric );
+
+  typedef itk::RegistrationParameterScalesFromPhysicalShift< MetricType > ScalesEstimatorType;
+  ScalesEstimatorType::Pointer scalesEstimator = ScalesEstimatorType::New();
+  scalesEstimator->SetMetric( metric );
+  typedef itk::GradientDescentOptimizerv4 OptimizerType;
+  OptimizerType::Pointer optimizer = OptimizerType::New();
+  optimizer->SetLearningRate( 1.0 );
+  optimizer->SetMaximumStepSizeInPhysicalUnits( 0.25 );
+  optimizer->SetDoEstimateLearningRateOnce( false );
+  optimizer->SetDoEstimateLearningRateAtEachIteration( true );
+  optimizer->SetScalesEstimator( scalesEstimator );
+  optimizer->SetNumberOfIterations( 100 );
+  optimizer->SetConvergenceWindowSize( 100 );
+  registration->SetOptimizer( optimizer );
+
+  registration->SetNumberOfLevels( 1 );
+  RegistrationType::ShrinkFactorsArrayType shrinkFactors( 1 );
+  shrinkFactors.Fill( 1 );
+  registration->SetShrinkFactorsPerLevel( shrinkFactors );
+  RegistrationType::SmoothingSigmasArrayType smoothingSigmas( 1 );
+  smoothingSigmas.Fill( 0.0 );
+  registration->SetSmoothingSigmasPerLevel( smoothingSigmas );
+
+  registration->SetMetricSamplingStrategy( RegistrationType::STOCHASTIC );
+  registration->SetMetricSamplingPercentage( 0.05 );
+  registration->SetMetricSamplingSeed( seed );
+
+  StochasticSamplingTestCommand::Pointer command = StochasticSamplingTestCommand::New();
+  command->m_Metric = metric;
+  optimizer->AddObserver( itk::IterationEvent(), command );
+
+  registration->Update();
+  parameters = registration->GetOutput()->Get()->GetParameters();
+  std::cout << "seed " << seed << ", " << numberOfThreads << " threads: " << parameters
+            << " after " << command->m_NumberOfIterations << " iterations" << std::endl;
+  return command;
+}
+}
+
+int itkImageRegistrationMethodv4StochasticSamplingTest(int, char *[])
+{
+  RegistrationType::Pointer registration = RegistrationType::New();
+  TEST_EXPECT_EQUAL( registration->GetMetricSamplingSeed(), 1234u );
+  registration->SetMetricSamplingSeed( 42 );
+  TEST_EXPECT_EQUAL( registration->GetMetricSamplingSeed(), 42u );
+  registration->SetMetricSamplingStrategy( RegistrationType::STOCHASTIC );
+  registration->Print( std::cout );
+
+  TransformType::ParametersType parameters[3];
+  StochasticSamplingTestCommand::Pointer single = RunRegistration( 1234, 1, parameters[0] );
+  StochasticSamplingTestCommand::Pointer multiple = RunRegistration( 1234, 4, parameters[1] );
+  StochasticSamplingTestCommand::Pointer other = RunRegistration( 5678, 4, parameters[2] );
+
+  // 5% of the 128x128 virtual domain at each iteration
+  TEST_EXPECT_EQUAL( single->m_NumberOfPoints, 819u );
+  TEST_EXPECT_TRUE( single->m_NumberOfIterations > 10 );
+  TEST_EXPECT_EQUAL( single->m_NumberOfRepeatedSamples, 0u );
+
+  // The same samples are drawn by any number of threads
+  TEST_EXPECT_EQUAL( single->m_NumberOfIterations, multiple->m_NumberOfIterations );
+  TEST_EXPECT_EQUAL( single->m_Checksum, multiple->m_Checksum );
+  TEST_EXPECT_TRUE( single->m_Checksum != other->m_Checksum );
+
+  // The translation is recovered whatever the samples
+  for( unsigned int r = 0; r < 3; ++r )
+    {
+    if( std::fabs( parameters[r][0] - 4.0 ) > 0.3 || std::fabs( parameters[r][1] + 3.0 ) > 0.3 )
+      {
+      std::cerr << "The translation " << parameters[r] << " is not [4, -3]" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}